@@ -0,0 +1,182 @@
+#include "codegen.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+/**
+ * Writes a string in a C string literal, without the quotes.
+ */
+static void emitEscapedString(const char *string, FILE *out) {
+    for (const char *c = string;*c != '\0';++c) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        }
+        else if (isprint((unsigned char) *c)) {
+            fputc(*c, out);
+        }
+        else {
+            fprintf(out, "\\%03o", (unsigned char) *c);
+        }
+    }
+}
+
+/**
+ * Writes the constant of a terminal : the prefix in uppercase then its name.
+ *
+ * Characters that can not be used in an identifier are replaced by an underscore.
+ */
+static void emitTerminalConstant(const lex_Lexer *lexer, uint32_t terminal, const char *prefix, FILE *out) {
+    for (const char *c = prefix;*c != '\0';++c) {
+        fputc(toupper((unsigned char) *c), out);
+    }
+
+    const lex_Terminal *lexTerminal = lex_getTerminal(lexer, terminal);
+
+    if (!lexTerminal->token) {
+        fprintf(out, "_LITERAL_%u", terminal - (uint32_t) lexer->tokenCount);
+        return;
+    }
+
+    fputc('_', out);
+
+    for (const char *c = lexTerminal->name;*c != '\0';++c) {
+        fputc((isalnum((unsigned char) *c)) ? toupper((unsigned char) *c) : '_', out);
+    }
+}
+
+static void emitDeclarations(const lex_Lexer *lexer, const char *prefix, FILE *out) {
+    uint32_t terminalCount = (uint32_t) lexer->terminals.size;
+
+    fprintf(out, "enum {\n");
+
+    for (uint32_t terminal = 0;terminal < terminalCount;++terminal) {
+        fprintf(out, "    ");
+        emitTerminalConstant(lexer, terminal, prefix, out);
+        fprintf(out, " = %u,\n", terminal);
+    }
+
+    fprintf(out, "    ");
+
+    for (const char *c = prefix;*c != '\0';++c) {
+        fputc(toupper((unsigned char) *c), out);
+    }
+
+    fprintf(out, "_TERMINAL_COUNT = %u\n};\n\n", terminalCount);
+
+    fprintf(out, "const char *const %s_terminalNames[] = {\n", prefix);
+
+    for (uint32_t terminal = 0;terminal < terminalCount;++terminal) {
+        fprintf(out, "    \"");
+        emitEscapedString(lex_getTerminal(lexer, terminal)->name, out);
+        fprintf(out, "\",\n");
+    }
+
+    fprintf(out, "    0\n};\n\n");
+
+    fprintf(out, "typedef struct %s_Token {\n"
+                 "    int terminal;\n"
+                 "    size_t offset;\n"
+                 "    size_t length;\n"
+                 "} %s_Token;\n\n", prefix, prefix);
+}
+
+/**
+ * Writes the label of a state, its accepted terminal and the switch on the next byte.
+ *
+ * Bytes that go to the same state share their case labels, bytes that go
+ * to the dead state end the match.
+ */
+static void emitState(const dfa_Automaton *dfa, uint32_t state, FILE *out) {
+    fprintf(out, "    state%u:\n", state);
+
+    if (dfa->accepts[state] != DFA_NO_TERMINAL) {
+        fprintf(out, "        terminal = %u;\n"
+                     "        end = i;\n", dfa->accepts[state]);
+    }
+
+    fprintf(out, "        if (i == length) {\n"
+                 "            goto done;\n"
+                 "        }\n"
+                 "        switch ((unsigned char) input[i++]) {\n");
+
+    bool emitted[256] = { false };
+
+    for (int c = 0;c < 256;++c) {
+        uint32_t target = dfa_step(dfa, state, c);
+
+        if (emitted[c] || target == DFA_DEAD_STATE) {
+            continue;
+        }
+
+        for (int other = c;other < 256;++other) {
+            if (dfa_step(dfa, state, other) == target) {
+                fprintf(out, "            case %d:\n", other);
+                emitted[other] = true;
+            }
+        }
+
+        fprintf(out, "                goto state%u;\n", target);
+    }
+
+    fprintf(out, "            default:\n"
+                 "                goto done;\n"
+                 "        }\n\n");
+}
+
+static void emitNextToken(const lex_Lexer *lexer, const char *prefix, FILE *out) {
+    const dfa_Automaton *dfa = &lexer->dfa;
+
+    fprintf(out, "int %s_nextToken(const char *input, size_t length, size_t *pPos, %s_Token *token) {\n"
+                 "    size_t pos = *pPos;\n\n"
+                 "    while (pos < length) {\n"
+                 "        size_t i = pos;\n"
+                 "        size_t end = pos;\n"
+                 "        int terminal = -1;\n\n"
+                 "        goto state%u;\n\n", prefix, prefix, dfa->start);
+
+    // The dead state is never reached, its bytes go to done
+    for (uint32_t state = 1;state < dfa->stateCount;++state) {
+        emitState(dfa, state, out);
+    }
+
+    fprintf(out, "    done:\n"
+                 "        if (terminal >= 0 && end > pos) {\n"
+                 "            token->terminal = terminal;\n"
+                 "            token->offset = pos;\n"
+                 "            token->length = end - pos;\n"
+                 "            *pPos = end;\n"
+                 "            return 1;\n"
+                 "        }\n\n"
+                 "        switch (input[pos]) {\n"
+                 "            case ' ': case '\\t': case '\\n': case '\\v': case '\\f': case '\\r':\n"
+                 "                ++pos;\n"
+                 "                break;\n"
+                 "            default:\n"
+                 "                *pPos = pos;\n"
+                 "                return -1;\n"
+                 "        }\n"
+                 "    }\n\n"
+                 "    *pPos = pos;\n\n"
+                 "    return 0;\n"
+                 "}\n");
+}
+
+bool cg_emitLexer(const lex_Lexer *lexer, const char *prefix, FILE *out) {
+    assert(lexer);
+    assert(prefix);
+    assert(out);
+
+    // States of a lazy automaton are not all known
+    if (lexer->lazyDfa) {
+        return false;
+    }
+
+    fprintf(out, "/* Lexer generated by parser --emit-lexer, do not edit. */\n\n"
+                 "#include <stddef.h>\n\n");
+
+    emitDeclarations(lexer, prefix, out);
+    emitNextToken(lexer, prefix, out);
+
+    return !ferror(out);
+}
@@ -0,0 +1,43 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+/**
+ * @file
+ * Generates the C source of a lexer, ahead of time.
+ *
+ * Each state of the lexer's automaton becomes a label : the next byte is
+ * read, a switch jumps to the label of the next state, accepting states
+ * save their terminal and the end of the match. There is no table and no
+ * indirect call, the generated file only depends on the C standard library
+ * headers stddef.h.
+ *
+ * For a prefix `lexer`, the generated file defines :
+ *
+ * - `LEXER_<NAME>` : one constant per terminal, string items are named `LEXER_LITERAL_<n>`
+ * - `LEXER_TERMINAL_COUNT` and `lexer_terminalNames`
+ * - `lexer_Token` : terminal, offset and length of a token
+ * - `int lexer_nextToken(const char *input, size_t length, size_t *pPos, lexer_Token *token)`,
+ *   it returns 1 for a token, 0 at the end of the input and -1 on an unexpected byte, like lex_nextToken
+ */
+
+#include "lexer.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define CG_DEFAULT_PREFIX "lexer"
+
+/**
+ * Writes the C source of a lexer.
+ *
+ * The prefix is used for all generated names, it must be a valid C identifier.
+ * Lazy lexers can not be written, false is returned.
+ *
+ * @param lexer a pointer to a lexer
+ * @param prefix prefix of the generated names
+ * @param out stream that receives the source
+ * @return true if the source has been written, otherwise false
+ */
+bool cg_emitLexer(const lex_Lexer *lexer, const char *prefix, FILE *out);
+
+#endif // CODEGEN_H
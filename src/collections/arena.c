@@ -0,0 +1,186 @@
+#include "arena.h"
+
+#include "../stats.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Chunks size stops growing after this limit
+#define MAX_CHUNK_SIZE (8 * 1024 * 1024)
+
+#define alignUp(n, alignment) (((n) + ((alignment) - 1)) & ~((size_t) (alignment) - 1))
+
+typedef struct ar_Chunk {
+    struct ar_Chunk *next;
+    size_t capacity;
+    size_t used;
+} ar_Chunk;
+
+// Data starts right after the header, on an aligned address
+#define CHUNK_HEADER_SIZE alignUp(sizeof(ar_Chunk), AR_ALIGNMENT)
+#define chunkData(chunk) ((char*) (chunk) + CHUNK_HEADER_SIZE)
+
+void ar_createArena(ar_Arena *arena, size_t chunkSize) {
+    assert(arena);
+    assert(chunkSize > 0);
+
+    arena->chunks = NULL;
+    arena->chunkSize = chunkSize;
+    arena->chunkCount = 0;
+    arena->allocatedBytes = 0;
+}
+
+static ar_Chunk *createChunk(size_t capacity) {
+    ar_Chunk *chunk = malloc(CHUNK_HEADER_SIZE + capacity);
+
+    if (!chunk) {
+        return NULL;
+    }
+
+    st_recordAllocation(CHUNK_HEADER_SIZE + capacity);
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+static void *allocate(ar_Arena *arena, size_t size, size_t alignment) {
+    assert(arena);
+
+    ar_Chunk *current = arena->chunks;
+
+    if (current) {
+        size_t start = alignUp(current->used, alignment);
+
+        if (start + size <= current->capacity) {
+            current->used = start + size;
+            arena->allocatedBytes += size;
+            return chunkData(current) + start;
+        }
+    }
+
+    if (size > arena->chunkSize / 2) {
+        // Big blocks get their own chunk, placed behind the current one
+        // to keep using the free space that remains in it.
+        ar_Chunk *chunk = createChunk(size);
+
+        if (!chunk) {
+            return NULL;
+        }
+
+        chunk->used = size;
+
+        if (current) {
+            chunk->next = current->next;
+            current->next = chunk;
+        }
+        else {
+            arena->chunks = chunk;
+        }
+
+        ++arena->chunkCount;
+        arena->allocatedBytes += size;
+
+        return chunkData(chunk);
+    }
+
+    ar_Chunk *chunk = createChunk(arena->chunkSize);
+
+    if (!chunk) {
+        return NULL;
+    }
+
+    chunk->next = current;
+    chunk->used = size;
+    arena->chunks = chunk;
+
+    ++arena->chunkCount;
+    arena->allocatedBytes += size;
+
+    if (arena->chunkSize < MAX_CHUNK_SIZE) {
+        arena->chunkSize *= 2;
+    }
+
+    return chunkData(chunk);
+}
+
+void *ar_alloc(ar_Arena *arena, size_t size) {
+    return allocate(arena, size, AR_ALIGNMENT);
+}
+
+void *ar_calloc(ar_Arena *arena, size_t count, size_t size) {
+    assert(arena);
+
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    void *data = allocate(arena, count * size, AR_ALIGNMENT);
+
+    if (data) {
+        memset(data, 0, count * size);
+    }
+
+    return data;
+}
+
+char *ar_strndup(ar_Arena *arena, const char *string, size_t n) {
+    assert(arena);
+    assert(string);
+
+    // Strings do not need any alignment
+    char *copy = allocate(arena, n + 1, 1);
+
+    if (copy) {
+        memcpy(copy, string, n);
+        copy[n] = '\0';
+    }
+
+    return copy;
+}
+
+void ar_resetArena(ar_Arena *arena) {
+    assert(arena);
+
+    ar_Chunk *first = arena->chunks;
+
+    if (!first) {
+        return;
+    }
+
+    // Dedicated chunks are always placed behind the current one,
+    // the head of the list is the last regular chunk.
+    ar_Chunk *current = first->next;
+
+    while (current) {
+        ar_Chunk *next = current->next;
+        free(current);
+        current = next;
+    }
+
+    first->next = NULL;
+    first->used = 0;
+
+    arena->chunkCount = 1;
+    arena->allocatedBytes = 0;
+}
+
+void ar_freeArena(ar_Arena *arena) {
+    if (arena) {
+        ar_Chunk *current = arena->chunks;
+
+        while (current) {
+            ar_Chunk *next = current->next;
+            free(current);
+            current = next;
+        }
+
+        arena->chunks = NULL;
+        arena->chunkCount = 0;
+        arena->allocatedBytes = 0;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/**
+ * @file
+ * Bump pointer allocator.
+ *
+ * Objects allocated in an arena are never freed one by one : the whole
+ * arena is released at once, in a number of operations that only depends
+ * on the number of chunks.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Alignment of every block returned by {@link ar_alloc}.
+ */
+#define AR_ALIGNMENT 16
+
+struct ar_Chunk;
+
+typedef struct ar_Arena {
+    struct ar_Chunk *chunks;
+    size_t chunkSize;
+    size_t chunkCount;
+    size_t allocatedBytes;
+} ar_Arena;
+
+/**
+ * Creates an empty arena.
+ *
+ * No memory is allocated until the first allocation request.
+ * Each chunk is twice as big as the previous one, the size of
+ * the first one is given by chunkSize.
+ *
+ * @param arena a pointer to an arena
+ * @param chunkSize size of the first chunk in bytes, must not be null
+ */
+void ar_createArena(ar_Arena *arena, size_t chunkSize);
+
+/**
+ * Allocates a block of memory in the given arena.
+ *
+ * The block is aligned on AR_ALIGNMENT bytes. Its content is not initialized.
+ * If the arena can not get a new chunk, then NULL will be returned.
+ *
+ * @param arena a pointer to an arena
+ * @param size size of the block
+ * @return a pointer to the block or NULL
+ */
+void *ar_alloc(ar_Arena *arena, size_t size);
+
+/**
+ * Allocates a zero initialized array in the given arena.
+ *
+ * @param arena a pointer to an arena
+ * @param count number of elements
+ * @param size size of an element
+ * @return a pointer to the array or NULL
+ */
+void *ar_calloc(ar_Arena *arena, size_t count, size_t size);
+
+/**
+ * Copies n chars of a string into the given arena.
+ *
+ * The copy will be null terminated. The string does not need to be
+ * null terminated.
+ *
+ * @param arena a pointer to an arena
+ * @param string string to copy
+ * @param n number of chars to copy
+ * @return a pointer to the copy or NULL
+ */
+char *ar_strndup(ar_Arena *arena, const char *string, size_t n);
+
+/**
+ * Releases every block of the given arena but keeps its last chunk.
+ *
+ * Every pointer returned by the arena becomes invalid. The kept chunk
+ * is the biggest regular one : an arena that is reset after each use
+ * stops allocating memory once it has reached its working size.
+ *
+ * @param arena a pointer to an arena
+ */
+void ar_resetArena(ar_Arena *arena);
+
+/**
+ * Frees all the chunks of the given arena.
+ *
+ * Every pointer returned by the arena becomes invalid.
+ * The given pointer will not be freed, the arena can be used again.
+ *
+ * @param arena a pointer to an arena
+ */
+void ar_freeArena(ar_Arena *arena);
+
+#endif // ARENA_H
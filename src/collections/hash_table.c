@@ -1,51 +1,48 @@
 #include "hash_table.h"
 
-#include "linked_list.h"
+#include "../stats.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
-static void pairDestructor(void *data, void *args) {
-    ht_Table *table = args;
-    ht_KVPair *pair = data;
+#define MIN_CAPACITY 8
 
-    if (table->destructor) {
-        table->destructor(pair->key, pair->value);
+// The table grows when it is more than 7/8 full
+#define isOverloaded(size, capacity) ((size) * 8 > (capacity) * 7)
+
+static bool keysEqual(const ht_Table *table, const void *k1, const void *k2) {
+    if (table->keyComparator) {
+        return table->keyComparator(k1, k2) == 0;
     }
-    free(pair);
-}
 
-struct ComparatorArgument {
-    const ht_Table *table;
-    const void *key;
-};
+    return k1 == k2;
+}
 
-static int pairComparator(const void *data1, const void *data2) {
-    const struct ComparatorArgument *arg = data1;
-    const ht_KVPair *p2 = data2;
+static size_t roundCapacity(size_t capacity) {
+    size_t rounded = MIN_CAPACITY;
 
-    if (arg->table->keyComparator) {
-        return arg->table->keyComparator(arg->key, p2->key);
-    }
-    else {
-        return arg->key == p2->key;
+    while (rounded < capacity) {
+        rounded *= 2;
     }
+
+    return rounded;
 }
 
 bool ht_createTable(ht_Table *table, size_t capacity, ht_HashFunction *hashFunction, ht_KeyComparator *keyComparator, ht_KVPairDestructor *destructor) {
     assert(table);
     assert(hashFunction);
 
-    ll_LinkedList *buckets = calloc(capacity, sizeof(*buckets));
+    capacity = roundCapacity(capacity);
+
+    // A null distance marks an empty bucket
+    ht_Bucket *buckets = calloc(capacity, sizeof(*buckets));
 
     if (!buckets) {
         return false;
     }
 
-    for (size_t i = 0;i < capacity;i++) {
-        ll_createLinkedList(buckets + i, pairDestructor);
-    }
-
+    st_recordAllocation(capacity * sizeof(*buckets));
     table->buckets = buckets;
     table->capacity = capacity;
     table->size = 0;
@@ -56,13 +53,21 @@ bool ht_createTable(ht_Table *table, size_t capacity, ht_HashFunction *hashFunct
     return true;
 }
 
-void ht_freeTable(ht_Table *table) {
-    if (table) {
+static void destroyPairs(ht_Table *table) {
+    if (table->destructor) {
         for (size_t i = 0;i < table->capacity;++i) {
-            ll_LinkedList *buckets = table->buckets + i;
+            ht_Bucket *bucket = table->buckets + i;
 
-            ll_freeLinkedList(buckets, table);
+            if (bucket->distance > 0) {
+                table->destructor(bucket->pair.key, bucket->pair.value);
+            }
         }
+    }
+}
+
+void ht_freeTable(ht_Table *table) {
+    if (table) {
+        destroyPairs(table);
 
         free(table->buckets);
         table->buckets = NULL;
@@ -70,74 +75,160 @@ void ht_freeTable(ht_Table *table) {
     }
 }
 
-static ll_LinkedList *getBucket(ht_Table *table, const void *key) {
+void ht_clear(ht_Table *table) {
     assert(table);
-    assert(key);
 
-    uint32_t hash = table->hashFunction(key);
-    size_t index = hash % table->capacity;
+    destroyPairs(table);
+
+    if (table->buckets) {
+        memset(table->buckets, 0, table->capacity * sizeof(*table->buckets));
+    }
 
-    return table->buckets + index;
+    table->size = 0;
 }
 
-static ht_KVPair *getPairByKey(ht_Table *table, ll_LinkedList *bucket, const void *key) {
-    assert(table);
-    assert(bucket);
-    assert(key);
+/**
+ * Finds the bucket of a key.
+ *
+ * The search stops as soon as a pair is closer to its ideal bucket than the
+ * key would be : with Robin Hood hashing, the key can not be further.
+ *
+ * @return a pointer to the bucket or NULL if the key does not exist
+ */
+static ht_Bucket *findBucket(const ht_Table *table, const void *key, uint32_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+    uint32_t distance = 1;
+
+    while (table->buckets[index].distance >= distance) {
+        ht_Bucket *bucket = table->buckets + index;
+
+        if (bucket->hash == hash && keysEqual(table, key, bucket->pair.key)) {
+            return bucket;
+        }
+
+        index = (index + 1) & mask;
+        ++distance;
+    }
+
+    return NULL;
+}
+
+/**
+ * Places a new pair, the key must not exist in the table.
+ */
+static void placeBucket(ht_Bucket *buckets, size_t capacity, ht_Bucket entry) {
+    size_t mask = capacity - 1;
+    size_t index = entry.hash & mask;
+    entry.distance = 1;
+
+    while (buckets[index].distance > 0) {
+        // The poorest pair takes the bucket, the richest one goes on probing
+        if (buckets[index].distance < entry.distance) {
+            ht_Bucket displaced = buckets[index];
+            buckets[index] = entry;
+            entry = displaced;
+        }
+
+        index = (index + 1) & mask;
+        ++entry.distance;
+    }
+
+    buckets[index] = entry;
+}
+
+static bool grow(ht_Table *table) {
+    size_t capacity = table->capacity * 2;
+    ht_Bucket *buckets = calloc(capacity, sizeof(*buckets));
 
-    struct ComparatorArgument arg = { .table = table, .key = key };
-    return ll_findItem(bucket, &arg, pairComparator);
+    if (!buckets) {
+        return false;
+    }
+
+    st_recordAllocation(capacity * sizeof(*buckets));
+
+    for (size_t i = 0;i < table->capacity;++i) {
+        if (table->buckets[i].distance > 0) {
+            placeBucket(buckets, capacity, table->buckets[i]);
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = buckets;
+    table->capacity = capacity;
+
+    return true;
 }
 
-void ht_insertElement(ht_Table *table, void *key, void *value) {
+bool ht_insertElement(ht_Table *table, void *key, void *value) {
     assert(table);
     assert(key);
     assert(value);
 
-    ll_LinkedList *bucket = getBucket(table, key);
-    ht_KVPair *existingPair = getPairByKey(table, bucket, key);
+    uint32_t hash = table->hashFunction(key);
+    ht_Bucket *existingBucket = findBucket(table, key, hash);
 
-    if (existingPair) {
-        existingPair->value = value;
+    if (existingBucket) {
+        existingBucket->pair.value = value;
+        return true;
     }
-    else {
-        ht_KVPair *pair = malloc(sizeof(*pair));
-        pair->key = key;
-        pair->value = value;
-        ll_pushBack(bucket, pair);
-        ++table->size;
+
+    // If the table can not grow, then it is filled up to its capacity
+    if (isOverloaded(table->size + 1, table->capacity) && !grow(table) && table->size == table->capacity) {
+        return false;
     }
-}
 
+    ht_Bucket entry = { .pair = { .key = key, .value = value }, .hash = hash };
+    placeBucket(table->buckets, table->capacity, entry);
+    ++table->size;
 
+    return true;
+}
 
 void ht_removeElement(ht_Table *table, const void *key) {
     assert(table);
     assert(key);
 
-    ll_LinkedList *bucket = getBucket(table, key);
+    ht_Bucket *bucket = findBucket(table, key, table->hashFunction(key));
 
-    struct ComparatorArgument arg = { .table = table, .key = key };
+    if (!bucket) {
+        return;
+    }
 
-    if (ll_removeItem(bucket, &arg, pairComparator, table)) {
-        --table->size;
+    if (table->destructor) {
+        table->destructor(bucket->pair.key, bucket->pair.value);
     }
+
+    // Backward shift deletion : the following pairs get closer to their ideal bucket
+    size_t mask = table->capacity - 1;
+    size_t index = bucket - table->buckets;
+    size_t next = (index + 1) & mask;
+
+    while (table->buckets[next].distance > 1) {
+        table->buckets[index] = table->buckets[next];
+        --table->buckets[index].distance;
+
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    table->buckets[index].distance = 0;
+    --table->size;
 }
 
 void *ht_getValue(ht_Table *table, const void *key) {
     assert(table);
     assert(key);
 
-    ll_LinkedList *bucket = getBucket(table, key);
-    ht_KVPair *pair = getPairByKey(table, bucket, key);
+    ht_Bucket *bucket = findBucket(table, key, table->hashFunction(key));
 
-    return (pair) ? pair->value : NULL;
+    return (bucket) ? bucket->pair.value : NULL;
 }
 
-static size_t firstNonEmptyBucketIndex(ll_LinkedList *buckets, size_t offset, size_t limit) {
+static size_t firstNonEmptyBucketIndex(ht_Bucket *buckets, size_t offset, size_t limit) {
     size_t index = offset;
 
-    while (index < limit && buckets[index].size == 0) {
+    while (index < limit && buckets[index].distance == 0) {
         ++index;
     }
 
@@ -150,6 +241,12 @@ void **ht_getValues(ht_Table *table) {
     // We have one additional item to facilitate the iteration
     // over the items. The item will be NULL.
     void **values = malloc(sizeof(*values) * (table->size + 1));
+
+    if (!values) {
+        return NULL;
+    }
+
+    st_recordAllocation(sizeof(*values) * (table->size + 1));
     void **current = values;
 
     ht_Iterator it;
@@ -172,36 +269,22 @@ void ht_createIterator(ht_Iterator *it, ht_Table *table) {
     assert(table);
     assert(table->capacity > 0);
 
-    // Looking for the first non empty bucket
-    size_t index = firstNonEmptyBucketIndex(table->buckets, 0, table->capacity);
-
     it->table = table;
-    it->bucketIndex = index;
-
-    if (index < table->capacity) {
-        ll_initIterator(&it->internalIt, table->buckets + index);
-    }
+    it->bucketIndex = firstNonEmptyBucketIndex(table->buckets, 0, table->capacity);
 }
 
 bool ht_iteratorHasNext(ht_Iterator *it) {
     assert(it);
 
-    return it->bucketIndex < it->table->capacity && ll_iteratorHasNext(&it->internalIt);
+    return it->bucketIndex < it->table->capacity;
 }
 
 ht_KVPair *ht_iteratorNext(ht_Iterator *it) {
     assert(it);
     assert(ht_iteratorHasNext(it));
 
-    ht_KVPair *current = ll_iteratorNext(&it->internalIt);
-
-    if (!ll_iteratorHasNext(&it->internalIt)) {
-        it->bucketIndex = firstNonEmptyBucketIndex(it->table->buckets, it->bucketIndex + 1, it->table->capacity);
-
-        if (it->bucketIndex < it->table->capacity) {
-            ll_initIterator(&it->internalIt, it->table->buckets + it->bucketIndex);
-        }
-    }
+    ht_KVPair *current = &it->table->buckets[it->bucketIndex].pair;
+    it->bucketIndex = firstNonEmptyBucketIndex(it->table->buckets, it->bucketIndex + 1, it->table->capacity);
 
     return current;
-}
\ No newline at end of file
+}
@@ -4,10 +4,14 @@
 /**
  * @file
  * Hash table definition.
+ *
+ * The table uses open addressing with Robin Hood hashing : a pair that is far
+ * from its ideal bucket takes the place of a pair that is closer to its own.
+ * Probe sequences stay short, and a deletion shifts the next pairs back instead
+ * of leaving a tombstone. The capacity is always a power of two, the table
+ * grows when it is more than 7/8 full.
  */
 
-#include "linked_list.h"
-
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -21,8 +25,20 @@ typedef struct ht_KVPair {
     void *value;
 } ht_KVPair;
 
+/**
+ * A slot of the table.
+ *
+ * The distance is the position of the pair in its probe sequence, starting
+ * at 1 for the ideal bucket. An empty bucket has a null distance.
+ */
+typedef struct ht_Bucket {
+    ht_KVPair pair;
+    uint32_t hash;
+    uint32_t distance;
+} ht_Bucket;
+
 typedef struct ht_Table {
-    ll_LinkedList *buckets;
+    ht_Bucket *buckets;
     size_t capacity;
     size_t size;
     ht_HashFunction *hashFunction;
@@ -33,12 +49,13 @@ typedef struct ht_Table {
 typedef struct ht_Iterator {
     ht_Table *table;
     size_t bucketIndex;
-    ll_Iterator internalIt;
 } ht_Iterator;
 
 /**
  * Initializes ht_Table structure with an initial capacity.
  *
+ * The capacity is rounded up to the next power of two (8 at least).
+ *
  * If the allocation of the table' records failed then false will
  * be returned.
  *
@@ -67,23 +84,35 @@ bool ht_createTable(ht_Table *table, size_t capacity, ht_HashFunction *hashFunct
  */
 void ht_freeTable(ht_Table *table);
 
+/**
+ * Removes all pairs from the table but keeps its capacity.
+ *
+ * The destructor is called for each pair.
+ *
+ * @param table a pointer to a hash table structure
+ */
+void ht_clear(ht_Table *table);
+
 /**
  * Inserts a pair (key/value) into the table.
  *
  * The key and the value can't be NULL.
  *
- * This hash table uses separate chaining to manage collisions.
- * If a pair will same hash already exists, then the new one will be added
- * at the end of the same bucket.
+ * Collisions are managed with Robin Hood probing. The hash of each pair
+ * is stored, so the table can grow without calling the hash function again.
  *
  * If a pair with same key (according to the given key comparator)
  * already exists, then its value will be modified with the new one.
  *
+ * If the table is full and can not grow, then the pair will not be
+ * inserted and false will be returned.
+ *
  * @param table a pointer to a hash table structure
  * @param key
  * @param value
+ * @return true if the pair is in the table, otherwise false
  */
-void ht_insertElement(ht_Table *table, void *key, void *value);
+bool ht_insertElement(ht_Table *table, void *key, void *value);
 
 /**
  * Removes a pair from the table.
@@ -91,6 +120,9 @@ void ht_insertElement(ht_Table *table, void *key, void *value);
  * If no pair with the given key exists, then
  * nothing will be done.
  *
+ * The following pairs of the probe sequence are shifted back,
+ * no tombstone is left in the table.
+ *
  * @param table a pointer to a hash table
  * @param key
  */
@@ -115,7 +147,7 @@ void *ht_getValue(ht_Table *table, const void *key);
  * The user has the responsability to free the array.
  *
  * @param table a pointer to a hash table
- * @return an array of values
+ * @return an array of values, NULL if it cannot be allocated
  */
 void **ht_getValues(ht_Table *table);
 
@@ -141,6 +173,8 @@ bool ht_iteratorHasNext(ht_Iterator *it);
  * Gets the next pair at the current iterator's position.
  *
  * The iterator must not be at the end !
+ * The pair belongs to the table : it is invalidated by the next
+ * insertion or removal.
  *
  * @param it a pointer to an iterator
  * @return a pair key / value
@@ -1,5 +1,8 @@
 #include "linked_list.h"
 
+#include "arena.h"
+#include "../stats.h"
+
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,6 +11,34 @@ void ll_createLinkedList(ll_LinkedList *list, ll_DataDestructor *destructor) {
     list->front = list->back = NULL;
     list->size = 0;
     list->destructor = destructor;
+    list->arena = NULL;
+}
+
+void ll_createArenaLinkedList(ll_LinkedList *list, ar_Arena *arena) {
+    assert(arena);
+
+    ll_createLinkedList(list, NULL);
+    list->arena = arena;
+}
+
+static ll_LinkedListItem *allocateItem(ll_LinkedList *list) {
+    if (list->arena) {
+        return ar_alloc(list->arena, sizeof(ll_LinkedListItem));
+    }
+
+    ll_LinkedListItem *item = malloc(sizeof(ll_LinkedListItem));
+
+    if (item) {
+        st_recordAllocation(sizeof(ll_LinkedListItem));
+    }
+
+    return item;
+}
+
+static void freeItem(ll_LinkedList *list, ll_LinkedListItem *item) {
+    if (!list->arena) {
+        free(item);
+    }
 }
 
 void ll_freeLinkedList(ll_LinkedList *list, void *args) {
@@ -24,7 +55,7 @@ void ll_freeLinkedList(ll_LinkedList *list, void *args) {
             list->destructor(current->data, args);
         }
 
-        free(current);
+        freeItem(list, current);
         current = next;
     }
 
@@ -70,7 +101,7 @@ void ll_pushBack(ll_LinkedList *list, void *data) {
     assert(list);
     assert(data);
 
-    ll_LinkedListItem *item = malloc(sizeof(*item));
+    ll_LinkedListItem *item = allocateItem(list);
 
     if (!item) {
         return;
@@ -148,7 +179,7 @@ bool ll_removeItem(ll_LinkedList *list, const void *item, ll_DataComparator *com
             if (list->destructor) {
                 list->destructor(currentItem->data, args);
             }
-            free(currentItem);
+            freeItem(list, currentItem);
 
             --list->size;
 
@@ -198,7 +229,7 @@ void ll_iteratorInsert(ll_Iterator *it, void *data) {
     assert(it);
     assert(data);
 
-    ll_LinkedListItem *item = malloc(sizeof(*item));
+    ll_LinkedListItem *item = allocateItem(it->list);
     item->data = data;
 
     ll_LinkedListItem *next = *it->pEntry;
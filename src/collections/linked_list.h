@@ -19,11 +19,14 @@ typedef struct ll_LinkedListItem {
     struct ll_LinkedListItem *next;
 } ll_LinkedListItem;
 
+struct ar_Arena;
+
 typedef struct ll_LinkedList {
     ll_LinkedListItem *front;
     ll_LinkedListItem *back;
     size_t size;
     ll_DataDestructor *destructor;
+    struct ar_Arena *arena;
 } ll_LinkedList;
 
 typedef struct ll_Iterator {
@@ -40,6 +43,18 @@ typedef struct ll_Iterator {
  */
 void ll_createLinkedList(ll_LinkedList *list, ll_DataDestructor *destructor);
 
+/**
+ * Creates an empty linked list whose nodes are allocated in an arena.
+ *
+ * Nodes are not freed by {@link ll_freeLinkedList} or {@link ll_removeItem},
+ * they will be released with the arena. The list has no destructor : its elements
+ * are expected to be owned by the arena too.
+ *
+ * @param list a pointer to a linked list
+ * @param arena a pointer to the arena that will hold the nodes
+ */
+void ll_createArenaLinkedList(ll_LinkedList *list, struct ar_Arena *arena);
+
 /**
  * Frees allocated memory and empty a linked list.
  *
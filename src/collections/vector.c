@@ -0,0 +1,147 @@
+#include "vector.h"
+
+#include "../stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_CAPACITY 8
+
+bool vec_createVector(vec_Vector *vector, size_t elementSize, size_t capacity, vec_DataDestructor *destructor) {
+    assert(vector);
+    assert(elementSize > 0);
+
+    vector->data = NULL;
+    vector->elementSize = elementSize;
+    vector->size = 0;
+    vector->capacity = 0;
+    vector->destructor = destructor;
+
+    if (capacity > 0) {
+        vector->data = malloc(capacity * elementSize);
+
+        if (!vector->data) {
+            return false;
+        }
+
+        st_recordAllocation(capacity * elementSize);
+        vector->capacity = capacity;
+    }
+
+    return true;
+}
+
+void vec_clear(vec_Vector *vector, void *args) {
+    assert(vector);
+
+    if (vector->destructor) {
+        for (size_t i = 0;i < vector->size;++i) {
+            vector->destructor(vector->data + i * vector->elementSize, args);
+        }
+    }
+
+    vector->size = 0;
+}
+
+void vec_freeVector(vec_Vector *vector, void *args) {
+    if (!vector) {
+        return;
+    }
+
+    vec_clear(vector, args);
+
+    free(vector->data);
+    vector->data = NULL;
+    vector->capacity = 0;
+}
+
+bool vec_reserve(vec_Vector *vector, size_t capacity) {
+    assert(vector);
+
+    if (capacity <= vector->capacity) {
+        return true;
+    }
+
+    char *newData = realloc(vector->data, capacity * vector->elementSize);
+
+    if (!newData) {
+        return false;
+    }
+
+    st_recordAllocation(capacity * vector->elementSize);
+    vector->data = newData;
+    vector->capacity = capacity;
+
+    return true;
+}
+
+void *vec_pushBack(vec_Vector *vector, const void *element) {
+    assert(vector);
+    assert(element);
+
+    if (vector->size == vector->capacity) {
+        size_t newCapacity = (vector->capacity < MIN_CAPACITY) ? MIN_CAPACITY : vector->capacity * 2;
+        char *newData = realloc(vector->data, newCapacity * vector->elementSize);
+
+        if (!newData) {
+            return NULL;
+        }
+
+        st_recordAllocation(newCapacity * vector->elementSize);
+        vector->data = newData;
+        vector->capacity = newCapacity;
+    }
+
+    void *slot = vector->data + vector->size * vector->elementSize;
+    memcpy(slot, element, vector->elementSize);
+    ++vector->size;
+
+    return slot;
+}
+
+void *vec_at(vec_Vector *vector, size_t index) {
+    assert(vector);
+    assert(index < vector->size);
+
+    return vector->data + index * vector->elementSize;
+}
+
+bool vec_isEqual(vec_Vector *v1, vec_Vector *v2, vec_DataComparator *comparator) {
+    assert(v1);
+    assert(v2);
+    assert(comparator);
+
+    if (v1->size != v2->size) {
+        return false;
+    }
+
+    for (size_t i = 0;i < v1->size;++i) {
+        if (comparator(vec_at(v1, i), vec_at(v2, i)) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+vec_Cursor vec_createCursor(vec_Vector *vector) {
+    assert(vector);
+
+    return (vec_Cursor){ .vector = vector, .index = 0 };
+}
+
+bool vec_cursorHasNext(vec_Cursor *cursor) {
+    assert(cursor);
+
+    return cursor->index < cursor->vector->size;
+}
+
+void *vec_cursorNext(vec_Cursor *cursor) {
+    assert(cursor);
+    assert(vec_cursorHasNext(cursor));
+
+    vec_Vector *vector = cursor->vector;
+
+    return vector->data + (cursor->index++) * vector->elementSize;
+}
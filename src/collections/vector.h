@@ -0,0 +1,141 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+/**
+ * @file
+ * Growable array definition.
+ *
+ * Elements are stored by value in a contiguous buffer. Pointers to
+ * elements are invalidated when the vector grows.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef int vec_DataComparator(const void*, const void*);
+typedef void vec_DataDestructor(void*, void*);
+
+typedef struct vec_Vector {
+    char *data;
+    size_t elementSize;
+    size_t size;
+    size_t capacity;
+    vec_DataDestructor *destructor;
+} vec_Vector;
+
+typedef struct vec_Cursor {
+    vec_Vector *vector;
+    size_t index;
+} vec_Cursor;
+
+/**
+ * Creates an empty vector.
+ *
+ * The destructor receives a pointer to each element, it must not free
+ * this pointer : the element's storage belongs to the vector.
+ *
+ * If the allocation of the initial capacity failed then false will be returned.
+ *
+ * @param vector a pointer to a vector
+ * @param elementSize size of an element in bytes
+ * @param capacity initial capacity, can be 0
+ * @param destructor pointer to a function destructor, can be null
+ * @return true if the vector has been created, otherwise false
+ */
+bool vec_createVector(vec_Vector *vector, size_t elementSize, size_t capacity, vec_DataDestructor *destructor);
+
+/**
+ * Frees allocated memory and empty a vector.
+ *
+ * Additional args for the destructor function can be a NULL pointer.
+ * The vector can be used again after this call.
+ *
+ * @param vector a pointer to a vector
+ * @param args additional args that will be passed to the destructor
+ */
+void vec_freeVector(vec_Vector *vector, void *args);
+
+/**
+ * Removes all elements from a vector but keeps its capacity.
+ *
+ * @param vector a pointer to a vector
+ * @param args additional args that will be passed to the destructor
+ */
+void vec_clear(vec_Vector *vector, void *args);
+
+/**
+ * Grows the capacity of a vector to hold at least the given number of elements.
+ *
+ * Nothing is done if the capacity is already large enough. If the allocation
+ * failed then false will be returned and the vector is unchanged.
+ *
+ * @param vector a pointer to a vector
+ * @param capacity minimum capacity
+ * @return true if the vector can hold the given number of elements, otherwise false
+ */
+bool vec_reserve(vec_Vector *vector, size_t capacity);
+
+/**
+ * Copies an element at the end of the vector.
+ *
+ * The capacity is doubled when the vector is full.
+ * If the allocation failed then NULL will be returned.
+ *
+ * @param vector a pointer to a vector
+ * @param element pointer to the element to copy
+ * @return a pointer to the copy in the vector or NULL
+ */
+void *vec_pushBack(vec_Vector *vector, const void *element);
+
+/**
+ * Gets a pointer to the element at the given index.
+ *
+ * The index must be lower than the vector's size.
+ *
+ * @param vector a pointer to a vector
+ * @param index index of the element
+ * @return a pointer to the element
+ */
+void *vec_at(vec_Vector *vector, size_t index);
+
+/**
+ * Checks if two vectors are equal.
+ *
+ * If they do not have the same size then false will be returned.
+ * Each elements are compared with the given comparator function.
+ *
+ * @param v1 a pointer to a vector
+ * @param v2 a pointer to a vector
+ * @param comparator pointer to a comparator function
+ * @return true if the two given vectors are equal, otherwise false
+ */
+bool vec_isEqual(vec_Vector *v1, vec_Vector *v2, vec_DataComparator *comparator);
+
+/**
+ * Creates a cursor set on the first element of the vector.
+ *
+ * @param vector a pointer to a vector
+ * @return a cursor
+ */
+vec_Cursor vec_createCursor(vec_Vector *vector);
+
+/**
+ * Checks if one or more elements are available at the cursor's position.
+ *
+ * @param cursor pointer to a cursor
+ * @return true if there is one more element, otherwise false
+ */
+bool vec_cursorHasNext(vec_Cursor *cursor);
+
+/**
+ * Moves the cursor to the next element and returns the current one.
+ *
+ * The cursor must not be at the end of the vector, otherwise an assertion will
+ * be triggered.
+ *
+ * @param cursor pointer to a cursor
+ * @return a pointer to the current element
+ */
+void *vec_cursorNext(vec_Cursor *cursor);
+
+#endif // VECTOR_H
@@ -0,0 +1,682 @@
+#include "dfa.h"
+
+#include "collections/arena.h"
+#include "collections/hash_table.h"
+#include "collections/vector.h"
+#include "hash.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALPHABET_SIZE 256
+
+/**
+ * Sorted set of NFA states that makes a DFA state.
+ *
+ * Epsilon states are not kept : two sets that only differ by
+ * their epsilon states are the same DFA state.
+ */
+typedef struct StateSet {
+    uint32_t hash;
+    uint32_t size;
+    uint32_t states[];
+} StateSet;
+
+typedef struct Builder {
+    const nfa_Automaton *nfa;
+    const uint32_t *ranks;
+
+    // StateSet -> DFA state + 1
+    ht_Table stateIds;
+    vec_Vector sets;
+    ar_Arena arena;
+
+    vec_Vector transitions;
+    vec_Vector accepts;
+
+    // Closure computation
+    uint32_t *marks;
+    uint32_t generation;
+    vec_Vector stack;
+    StateSet *probe;
+    prs_CharClass *blocks;
+} Builder;
+
+static uint32_t stateSetHash(const StateSet *set) {
+    return set->hash;
+}
+
+static int stateSetComparator(const StateSet *s1, const StateSet *s2) {
+    if (s1->size != s2->size) {
+        return 1;
+    }
+
+    return memcmp(s1->states, s2->states, s1->size * sizeof(*s1->states));
+}
+
+static int stateIdComparator(const void *d1, const void *d2) {
+    uint32_t id1 = *((const uint32_t*) d1);
+    uint32_t id2 = *((const uint32_t*) d2);
+
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * Computes the closure of the states on the stack into the probe set.
+ *
+ * @return false if an allocation failed, the stack is then cleared
+ */
+static bool computeClosure(Builder *builder) {
+    StateSet *probe = builder->probe;
+    probe->size = 0;
+
+    ++builder->generation;
+
+    while (builder->stack.size > 0) {
+        uint32_t id = *((uint32_t*) vec_at(&builder->stack, builder->stack.size - 1));
+        --builder->stack.size;
+
+        if (id == NFA_NONE || builder->marks[id] == builder->generation) {
+            continue;
+        }
+
+        builder->marks[id] = builder->generation;
+        const nfa_State *state = nfa_getState(builder->nfa, id);
+
+        if (state->type == NFA_EPSILON_STATE) {
+            if (!vec_pushBack(&builder->stack, &state->out) || !vec_pushBack(&builder->stack, &state->alt)) {
+                builder->stack.size = 0;
+                return false;
+            }
+        }
+        else {
+            probe->states[probe->size++] = id;
+        }
+    }
+
+    qsort(probe->states, probe->size, sizeof(*probe->states), stateIdComparator);
+    probe->hash = murmurhash3_32(probe->states, probe->size * sizeof(*probe->states));
+
+    return true;
+}
+
+static uint32_t computeAccept(Builder *builder, const StateSet *set) {
+    uint32_t accept = DFA_NO_TERMINAL;
+    uint32_t acceptRank = UINT32_MAX;
+
+    for (uint32_t i = 0;i < set->size;++i) {
+        const nfa_State *state = nfa_getState(builder->nfa, set->states[i]);
+
+        if (state->type == NFA_ACCEPT_STATE) {
+            uint32_t rank = (builder->ranks) ? builder->ranks[state->terminal] : state->terminal;
+
+            if (rank < acceptRank) {
+                accept = state->terminal;
+                acceptRank = rank;
+            }
+        }
+    }
+
+    return accept;
+}
+
+/**
+ * Gets the DFA state of the probe set, a new state is added if needed.
+ *
+ * @return the state or DFA_DEAD_STATE if an allocation failed
+ */
+static uint32_t getProbeState(Builder *builder, bool *pFailed) {
+    StateSet *probe = builder->probe;
+    void *value = ht_getValue(&builder->stateIds, probe);
+
+    if (value) {
+        return (uint32_t) ((uintptr_t) value - 1);
+    }
+
+    size_t setSize = sizeof(*probe) + probe->size * sizeof(*probe->states);
+    StateSet *set = ar_alloc(&builder->arena, setSize);
+    uint32_t accept = computeAccept(builder, probe);
+
+    // The new row is filled when the state is processed
+    uint32_t row[ALPHABET_SIZE] = { 0 };
+
+    if (!set || !vec_pushBack(&builder->sets, &set) || !vec_pushBack(&builder->accepts, &accept)
+        || !vec_pushBack(&builder->transitions, row)) {
+        *pFailed = true;
+        return DFA_DEAD_STATE;
+    }
+
+    memcpy(set, probe, setSize);
+
+    uint32_t id = (uint32_t) (builder->sets.size - 1);
+
+    if (!ht_insertElement(&builder->stateIds, set, (void*) ((uintptr_t) id + 1))) {
+        *pFailed = true;
+    }
+
+    return id;
+}
+
+/**
+ * Splits all bytes into blocks : the bytes of a block are in the same classes of the set.
+ *
+ * Each class splits the blocks it overlaps into their intersection and their difference.
+ *
+ * @return the number of blocks
+ */
+static size_t splitAlphabet(Builder *builder, const StateSet *set) {
+    prs_CharClass *blocks = builder->blocks;
+    size_t blockCount = 1;
+
+    prs_clearCharClass(blocks);
+    prs_charClassComplement(blocks, blocks);
+
+    for (uint32_t i = 0;i < set->size;++i) {
+        const nfa_State *state = nfa_getState(builder->nfa, set->states[i]);
+
+        if (state->type != NFA_RANGE_STATE) {
+            continue;
+        }
+
+        size_t previousCount = blockCount;
+
+        for (size_t b = 0;b < previousCount;++b) {
+            prs_CharClass inside;
+            prs_charClassIntersection(&inside, blocks + b, &state->charClass);
+
+            if (prs_charClassIsEmpty(&inside) || prs_charClassEquals(&inside, blocks + b)) {
+                continue;
+            }
+
+            prs_charClassDifference(blocks + blockCount++, blocks + b, &state->charClass);
+            blocks[b] = inside;
+        }
+    }
+
+    return blockCount;
+}
+
+/**
+ * Computes the transitions of a DFA state.
+ *
+ * All bytes of a block of the alphabet go to the same state.
+ */
+static bool computeTransitions(Builder *builder, uint32_t id) {
+    const StateSet *set = *((StateSet**) vec_at(&builder->sets, id));
+    size_t blockCount = splitAlphabet(builder, set);
+
+    uint32_t row[ALPHABET_SIZE];
+    bool failed = false;
+
+    for (size_t b = 0;b < blockCount;++b) {
+        const prs_CharClass *block = builder->blocks + b;
+        int first = prs_charClassFirst(block);
+
+        // A block is included in a class or does not overlap it, its first byte is enough
+        for (uint32_t j = 0;j < set->size;++j) {
+            const nfa_State *state = nfa_getState(builder->nfa, set->states[j]);
+
+            if (state->type == NFA_RANGE_STATE && prs_charClassContains(&state->charClass, first)
+                && !vec_pushBack(&builder->stack, &state->out)) {
+                builder->stack.size = 0;
+                return false;
+            }
+        }
+
+        if (!computeClosure(builder)) {
+            return false;
+        }
+
+        uint32_t target = getProbeState(builder, &failed);
+
+        for (int word = 0;word < PRS_CHAR_CLASS_WORDS;++word) {
+            for (uint64_t bits = block->words[word];bits != 0;bits &= bits - 1) {
+                row[(word << 6) + __builtin_ctzll(bits)] = target;
+            }
+        }
+    }
+
+    memcpy(vec_at(&builder->transitions, id), row, sizeof(row));
+
+    return !failed;
+}
+
+static void freeBuilder(Builder *builder) {
+    ht_freeTable(&builder->stateIds);
+    vec_freeVector(&builder->sets, NULL);
+    vec_freeVector(&builder->transitions, NULL);
+    vec_freeVector(&builder->accepts, NULL);
+    vec_freeVector(&builder->stack, NULL);
+    ar_freeArena(&builder->arena);
+    free(builder->marks);
+    free(builder->probe);
+    free(builder->blocks);
+}
+
+static bool createBuilder(Builder *builder, const nfa_Automaton *nfa, const uint32_t *ranks) {
+    size_t nfaStateCount = nfa->states.size;
+
+    *builder = (Builder) { .nfa = nfa, .ranks = ranks, .generation = 0 };
+    ar_createArena(&builder->arena, 64 * 1024);
+    vec_createVector(&builder->sets, sizeof(StateSet*), 64, NULL);
+    vec_createVector(&builder->transitions, ALPHABET_SIZE * sizeof(uint32_t), 64, NULL);
+    vec_createVector(&builder->accepts, sizeof(uint32_t), 64, NULL);
+    vec_createVector(&builder->stack, sizeof(uint32_t), 64, NULL);
+
+    bool created = ht_createTable(&builder->stateIds, 64, (ht_HashFunction*) stateSetHash,
+                                  (ht_KeyComparator*) stateSetComparator, NULL);
+
+    builder->marks = calloc(nfaStateCount + 1, sizeof(*builder->marks));
+    builder->probe = malloc(sizeof(StateSet) + nfaStateCount * sizeof(uint32_t));
+    builder->blocks = malloc(ALPHABET_SIZE * sizeof(*builder->blocks));
+
+    if (!created || !builder->marks || !builder->probe || !builder->blocks) {
+        freeBuilder(builder);
+        return false;
+    }
+
+    st_recordAllocation((nfaStateCount + 1) * sizeof(*builder->marks));
+    st_recordAllocation(sizeof(StateSet) + nfaStateCount * sizeof(uint32_t));
+    st_recordAllocation(ALPHABET_SIZE * sizeof(*builder->blocks));
+
+    return true;
+}
+
+bool dfa_createFromNfa(dfa_Automaton *dfa, const nfa_Automaton *nfa, const uint32_t *ranks) {
+    assert(dfa);
+    assert(nfa);
+
+    Builder builder;
+
+    if (!createBuilder(&builder, nfa, ranks)) {
+        return false;
+    }
+
+    bool failed = false;
+
+    // The empty set is the dead state
+    builder.probe->size = 0;
+    builder.probe->hash = murmurhash3_32(builder.probe->states, 0);
+    getProbeState(&builder, &failed);
+
+    for (size_t i = 0;!failed && i < nfa->starts.size;++i) {
+        failed = !vec_pushBack(&builder.stack, vec_at((vec_Vector*) &nfa->starts, i));
+    }
+
+    failed = failed || !computeClosure(&builder);
+    uint32_t start = (failed) ? DFA_DEAD_STATE : getProbeState(&builder, &failed);
+
+    // The dead state loops on itself, its row is already filled with 0
+    for (uint32_t id = 1;!failed && id < builder.sets.size;++id) {
+        failed = !computeTransitions(&builder, id);
+    }
+
+    if (failed) {
+        freeBuilder(&builder);
+        return false;
+    }
+
+    // Tables are taken from the builder
+    dfa->transitions = (uint32_t*) builder.transitions.data;
+    dfa->accepts = (uint32_t*) builder.accepts.data;
+    dfa->stateCount = (uint32_t) builder.sets.size;
+    dfa->start = start;
+
+    builder.transitions.data = NULL;
+    builder.accepts.data = NULL;
+    builder.transitions.size = builder.accepts.size = 0;
+    freeBuilder(&builder);
+
+    return true;
+}
+
+// A signature is made by the accepted terminal, the class and the class of each target
+#define SIGNATURE_SIZE (ALPHABET_SIZE + 2)
+
+static uint32_t signatureHash(const uint32_t *signature) {
+    return murmurhash3_32(signature, SIGNATURE_SIZE * sizeof(*signature));
+}
+
+static int signatureComparator(const uint32_t *s1, const uint32_t *s2) {
+    return memcmp(s1, s2, SIGNATURE_SIZE * sizeof(*s1));
+}
+
+/**
+ * Splits the classes of states with different signatures.
+ *
+ * Classes are numbered in order of their first state, so the dead
+ * state always stays in the class 0.
+ *
+ * @return the number of classes or 0 if an allocation failed
+ */
+static uint32_t refineClasses(const dfa_Automaton *dfa, uint32_t *classes, uint32_t *signatures) {
+    ht_Table classIds;
+
+    if (!ht_createTable(&classIds, dfa->stateCount, (ht_HashFunction*) signatureHash,
+                        (ht_KeyComparator*) signatureComparator, NULL)) {
+        return 0;
+    }
+
+    for (uint32_t state = 0;state < dfa->stateCount;++state) {
+        uint32_t *signature = signatures + (size_t) state * SIGNATURE_SIZE;
+        const uint32_t *row = dfa->transitions + ((size_t) state << 8);
+
+        signature[0] = dfa->accepts[state];
+        signature[1] = classes[state];
+
+        for (size_t c = 0;c < ALPHABET_SIZE;++c) {
+            signature[c + 2] = classes[row[c]];
+        }
+    }
+
+    uint32_t classCount = 0;
+
+    for (uint32_t state = 0;state < dfa->stateCount;++state) {
+        uint32_t *signature = signatures + (size_t) state * SIGNATURE_SIZE;
+        void *value = ht_getValue(&classIds, signature);
+
+        if (!value) {
+            value = (void*) ((uintptr_t) ++classCount);
+
+            if (!ht_insertElement(&classIds, signature, value)) {
+                ht_freeTable(&classIds);
+                return 0;
+            }
+        }
+
+        // Every signature has been computed with the previous classes
+        classes[state] = (uint32_t) ((uintptr_t) value - 1);
+    }
+
+    ht_freeTable(&classIds);
+
+    return classCount;
+}
+
+bool dfa_minimize(dfa_Automaton *dfa) {
+    assert(dfa);
+
+    uint32_t *classes = calloc(dfa->stateCount, sizeof(*classes));
+    uint32_t *signatures = malloc((size_t) dfa->stateCount * SIGNATURE_SIZE * sizeof(*signatures));
+
+    if (!classes || !signatures) {
+        free(classes);
+        free(signatures);
+        return false;
+    }
+
+    st_recordAllocation(dfa->stateCount * sizeof(*classes));
+    st_recordAllocation((size_t) dfa->stateCount * SIGNATURE_SIZE * sizeof(*signatures));
+
+    // Moore's algorithm : classes are split until they are stable
+    uint32_t classCount = 1;
+    uint32_t previousCount = 0;
+
+    while (classCount != previousCount && classCount > 0) {
+        previousCount = classCount;
+        classCount = refineClasses(dfa, classes, signatures);
+    }
+
+    free(signatures);
+
+    uint32_t *transitions = (classCount > 0) ? malloc(((size_t) classCount << 8) * sizeof(*transitions)) : NULL;
+    uint32_t *accepts = (classCount > 0) ? malloc(classCount * sizeof(*accepts)) : NULL;
+
+    if (!transitions || !accepts) {
+        free(classes);
+        free(transitions);
+        free(accepts);
+        return false;
+    }
+
+    st_recordAllocation(((size_t) classCount << 8) * sizeof(*transitions));
+    st_recordAllocation(classCount * sizeof(*accepts));
+
+    // The first state of each class gives its transitions
+    for (uint32_t state = dfa->stateCount;state-- > 0;) {
+        uint32_t class = classes[state];
+        const uint32_t *row = dfa->transitions + ((size_t) state << 8);
+        uint32_t *newRow = transitions + ((size_t) class << 8);
+
+        for (size_t c = 0;c < ALPHABET_SIZE;++c) {
+            newRow[c] = classes[row[c]];
+        }
+
+        accepts[class] = dfa->accepts[state];
+    }
+
+    dfa->start = classes[dfa->start];
+    dfa->stateCount = classCount;
+
+    free(dfa->transitions);
+    free(dfa->accepts);
+    free(classes);
+
+    dfa->transitions = transitions;
+    dfa->accepts = accepts;
+
+    return true;
+}
+
+void dfa_freeAutomaton(dfa_Automaton *dfa) {
+    if (dfa) {
+        free(dfa->transitions);
+        free(dfa->accepts);
+        dfa->transitions = NULL;
+        dfa->accepts = NULL;
+        dfa->stateCount = 0;
+    }
+}
+
+struct dfa_LazyCache {
+    Builder builder;
+    // Start set of the automaton, it is added again after each flush
+    StateSet *startSet;
+};
+
+/**
+ * Adds a set as the next state of a lazy automaton, the cache must not be full.
+ *
+ * @return the state or DFA_UNKNOWN_STATE if an allocation failed
+ */
+static uint32_t addLazyState(dfa_LazyAutomaton *dfa, const StateSet *set) {
+    assert(dfa->stateCount < dfa->maxStateCount);
+
+    Builder *builder = &dfa->cache->builder;
+    size_t setSize = sizeof(*set) + set->size * sizeof(*set->states);
+    StateSet *copy = ar_alloc(&builder->arena, setSize);
+
+    if (!copy) {
+        return DFA_UNKNOWN_STATE;
+    }
+
+    memcpy(copy, set, setSize);
+
+    uint32_t id = dfa->stateCount;
+
+    // The vector of sets has the capacity of the cache
+    if (!ht_insertElement(&builder->stateIds, copy, (void*) ((uintptr_t) id + 1))
+        || !vec_pushBack(&builder->sets, &copy)) {
+        return DFA_UNKNOWN_STATE;
+    }
+
+    // The dead state loops on itself, transitions of other states are computed later
+    uint32_t *row = dfa->transitions + ((size_t) id << 8);
+    memset(row, (id == DFA_DEAD_STATE) ? 0 : 0xFF, ALPHABET_SIZE * sizeof(*row));
+    dfa->accepts[id] = computeAccept(builder, copy);
+    ++dfa->stateCount;
+
+    return id;
+}
+
+/**
+ * Removes all states of a lazy automaton but the dead and start states.
+ */
+static bool flushCache(dfa_LazyAutomaton *dfa) {
+    Builder *builder = &dfa->cache->builder;
+
+    ht_clear(&builder->stateIds);
+    vec_clear(&builder->sets, NULL);
+    ar_resetArena(&builder->arena);
+    dfa->stateCount = 0;
+
+    StateSet dead = { .hash = 0, .size = 0 };
+    dead.hash = murmurhash3_32(dead.states, 0);
+
+    return addLazyState(dfa, &dead) == DFA_DEAD_STATE
+           && addLazyState(dfa, dfa->cache->startSet) == DFA_LAZY_START_STATE;
+}
+
+static void freeLazyCache(struct dfa_LazyCache *cache) {
+    if (cache) {
+        freeBuilder(&cache->builder);
+        free(cache->startSet);
+        free(cache);
+    }
+}
+
+bool dfa_createLazyAutomaton(dfa_LazyAutomaton *dfa, const nfa_Automaton *nfa, const uint32_t *ranks,
+                             uint32_t maxStateCount) {
+    assert(dfa);
+    assert(nfa);
+
+    if (maxStateCount < DFA_MIN_CACHE_STATE_COUNT) {
+        maxStateCount = DFA_MIN_CACHE_STATE_COUNT;
+    }
+
+    *dfa = (dfa_LazyAutomaton) { .transitions = NULL, .accepts = NULL, .stateCount = 0,
+                                 .maxStateCount = maxStateCount, .counters = { 0, 0, 0 }, .cache = NULL };
+
+    struct dfa_LazyCache *cache = calloc(1, sizeof(*cache));
+
+    if (!cache) {
+        return false;
+    }
+
+    st_recordAllocation(sizeof(*cache));
+
+    if (!createBuilder(&cache->builder, nfa, ranks)) {
+        free(cache);
+        return false;
+    }
+
+    dfa->cache = cache;
+
+    Builder *builder = &cache->builder;
+
+    bool failed = false;
+
+    for (size_t i = 0;!failed && i < nfa->starts.size;++i) {
+        failed = !vec_pushBack(&builder->stack, vec_at((vec_Vector*) &nfa->starts, i));
+    }
+
+    if (failed || !computeClosure(builder)) {
+        dfa_freeLazyAutomaton(dfa);
+        return false;
+    }
+
+    size_t startSize = sizeof(StateSet) + builder->probe->size * sizeof(uint32_t);
+    cache->startSet = malloc(startSize);
+    dfa->transitions = malloc(((size_t) maxStateCount << 8) * sizeof(*dfa->transitions));
+    dfa->accepts = malloc(maxStateCount * sizeof(*dfa->accepts));
+
+    if (!cache->startSet || !dfa->transitions || !dfa->accepts || !vec_reserve(&builder->sets, maxStateCount)) {
+        dfa_freeLazyAutomaton(dfa);
+        return false;
+    }
+
+    st_recordAllocation(startSize);
+    st_recordAllocation(((size_t) maxStateCount << 8) * sizeof(*dfa->transitions));
+    st_recordAllocation(maxStateCount * sizeof(*dfa->accepts));
+
+    memcpy(cache->startSet, builder->probe, startSize);
+
+    if (!flushCache(dfa)) {
+        dfa_freeLazyAutomaton(dfa);
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t dfa_computeLazyTransition(dfa_LazyAutomaton *dfa, uint32_t state, uint8_t byte) {
+    assert(dfa);
+    assert(state < dfa->stateCount);
+
+    ++dfa->counters.misses;
+
+    Builder *builder = &dfa->cache->builder;
+    const StateSet *set = *((StateSet**) vec_at(&builder->sets, state));
+
+    // Bytes of the block go to the same state : they are in the same classes as the byte
+    prs_CharClass block;
+    prs_clearCharClass(&block);
+    prs_charClassComplement(&block, &block);
+
+    for (uint32_t i = 0;i < set->size;++i) {
+        const nfa_State *nfaState = nfa_getState(builder->nfa, set->states[i]);
+
+        if (nfaState->type != NFA_RANGE_STATE) {
+            continue;
+        }
+
+        if (prs_charClassContains(&nfaState->charClass, byte)) {
+            if (!vec_pushBack(&builder->stack, &nfaState->out)) {
+                builder->stack.size = 0;
+                return DFA_UNKNOWN_STATE;
+            }
+
+            prs_charClassIntersection(&block, &block, &nfaState->charClass);
+        }
+        else {
+            prs_charClassDifference(&block, &block, &nfaState->charClass);
+        }
+    }
+
+    if (!computeClosure(builder)) {
+        return DFA_UNKNOWN_STATE;
+    }
+
+    void *value = ht_getValue(&builder->stateIds, builder->probe);
+    uint32_t target;
+
+    if (value) {
+        target = (uint32_t) ((uintptr_t) value - 1);
+    }
+    else if (dfa->stateCount < dfa->maxStateCount) {
+        target = addLazyState(dfa, builder->probe);
+    }
+    else {
+        // The source state does not exist after the flush, its row is not filled
+        ++dfa->counters.flushes;
+        return flushCache(dfa) ? addLazyState(dfa, builder->probe) : DFA_UNKNOWN_STATE;
+    }
+
+    if (target == DFA_UNKNOWN_STATE) {
+        return target;
+    }
+
+    uint32_t *row = dfa->transitions + ((size_t) state << 8);
+
+    for (int word = 0;word < PRS_CHAR_CLASS_WORDS;++word) {
+        for (uint64_t bits = block.words[word];bits != 0;bits &= bits - 1) {
+            row[(word << 6) + __builtin_ctzll(bits)] = target;
+        }
+    }
+
+    return target;
+}
+
+void dfa_freeLazyAutomaton(dfa_LazyAutomaton *dfa) {
+    if (dfa) {
+        freeLazyCache(dfa->cache);
+        free(dfa->transitions);
+        free(dfa->accepts);
+        dfa->cache = NULL;
+        dfa->transitions = NULL;
+        dfa->accepts = NULL;
+        dfa->stateCount = 0;
+    }
+}
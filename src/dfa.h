@@ -0,0 +1,167 @@
+#ifndef DFA_H
+#define DFA_H
+
+/**
+ * @file
+ * Defines a deterministic finite automaton over bytes.
+ *
+ * The automaton is stored as a dense transition table : each state has
+ * 256 transitions, one per byte. The state 0 is a dead state, it can not
+ * accept anything and all of its transitions go back to itself.
+ *
+ * A lazy automaton builds its states the first time the input reaches them,
+ * one transition at a time. States are kept in a cache of a fixed number of
+ * states : when it is full, the cache is flushed and the states are built
+ * again when they are needed. The memory does not depend on the number of
+ * states of the whole automaton and states that are used often run at table
+ * speed.
+ */
+
+#include "nfa.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DFA_DEAD_STATE 0
+
+/**
+ * Terminal of a state that does not accept anything.
+ */
+#define DFA_NO_TERMINAL UINT32_MAX
+
+/**
+ * Transition of a lazy automaton that has not been computed yet.
+ */
+#define DFA_UNKNOWN_STATE UINT32_MAX
+
+/**
+ * Start state of a lazy automaton, it is added again after each flush.
+ */
+#define DFA_LAZY_START_STATE 1
+
+// The cache must hold the dead state, the start state and the state being added
+#define DFA_MIN_CACHE_STATE_COUNT 4
+// 4 MiB of transitions
+#define DFA_DEFAULT_CACHE_STATE_COUNT 4096
+
+typedef struct dfa_Automaton {
+    uint32_t *transitions;
+    uint32_t *accepts;
+    uint32_t stateCount;
+    uint32_t start;
+} dfa_Automaton;
+
+typedef struct dfa_CacheCounters {
+    // Transitions read from the cache
+    uint64_t hits;
+    // Transitions computed from the nondeterministic automaton
+    uint64_t misses;
+    uint64_t flushes;
+} dfa_CacheCounters;
+
+struct dfa_LazyCache;
+
+typedef struct dfa_LazyAutomaton {
+    // Rows of the cached states, DFA_UNKNOWN_STATE for transitions that have not been computed
+    uint32_t *transitions;
+    uint32_t *accepts;
+    uint32_t stateCount;
+    uint32_t maxStateCount;
+    dfa_CacheCounters counters;
+    // Sets of nondeterministic states of the cached states
+    struct dfa_LazyCache *cache;
+} dfa_LazyAutomaton;
+
+/**
+ * Gets the state reached from a state with a byte.
+ */
+#define dfa_step(dfa, state, byte) ((dfa)->transitions[((size_t) (state) << 8) | (uint8_t) (byte)])
+
+/**
+ * Gets the state reached from a state of a lazy automaton with a byte.
+ *
+ * The transition is computed if it is not in the cache. Arguments are evaluated more than once.
+ */
+#define dfa_lazyStep(dfa, state, byte) \
+    ((dfa_step(dfa, state, byte) != DFA_UNKNOWN_STATE) \
+     ? (++(dfa)->counters.hits, dfa_step(dfa, state, byte)) \
+     : dfa_computeLazyTransition((dfa), (state), (uint8_t) (byte)))
+
+/**
+ * Builds a deterministic automaton from a nondeterministic one (subset construction).
+ *
+ * When a state accepts several terminals, the terminal with the lowest rank
+ * wins. If ranks is NULL, then a terminal's rank is its value.
+ *
+ * If an allocation failed then false will be returned.
+ *
+ * @param dfa a pointer to the automaton to create
+ * @param nfa a pointer to a nondeterministic automaton
+ * @param ranks rank of each terminal, can be NULL
+ * @return true if the automaton has been created, otherwise false
+ */
+bool dfa_createFromNfa(dfa_Automaton *dfa, const nfa_Automaton *nfa, const uint32_t *ranks);
+
+/**
+ * Merges equivalent states of an automaton.
+ *
+ * Two states are equivalent when they accept the same terminal and
+ * go to equivalent states on each byte. The dead state stays the state 0.
+ *
+ * @param dfa a pointer to an automaton
+ * @return true if no allocation error occurs, otherwise false
+ */
+bool dfa_minimize(dfa_Automaton *dfa);
+
+/**
+ * Frees allocated memory for the given automaton.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param dfa a pointer to an automaton
+ */
+void dfa_freeAutomaton(dfa_Automaton *dfa);
+
+/**
+ * Creates a lazy automaton from a nondeterministic one.
+ *
+ * Only the dead state and the start state (DFA_LAZY_START_STATE) are built.
+ * The nondeterministic automaton and the ranks are referenced : they must
+ * outlive the lazy automaton. Ranks work as in dfa_createFromNfa.
+ *
+ * If an allocation failed then false will be returned.
+ *
+ * @param dfa a pointer to the automaton to create
+ * @param nfa a pointer to a nondeterministic automaton
+ * @param ranks rank of each terminal, can be NULL
+ * @param maxStateCount number of states of the cache, at least DFA_MIN_CACHE_STATE_COUNT
+ * @return true if the automaton has been created, otherwise false
+ */
+bool dfa_createLazyAutomaton(dfa_LazyAutomaton *dfa, const nfa_Automaton *nfa, const uint32_t *ranks,
+                             uint32_t maxStateCount);
+
+/**
+ * Computes a transition of a lazy automaton and keeps it in the cache.
+ *
+ * If the cache is full, then it is flushed first : the given state and every
+ * state other than the dead and start states are no longer valid, only the
+ * returned state is. If an allocation failed then DFA_UNKNOWN_STATE will be
+ * returned.
+ *
+ * @param dfa a pointer to a lazy automaton
+ * @param state a state of the cache
+ * @param byte the byte read from this state
+ * @return the reached state or DFA_UNKNOWN_STATE
+ */
+uint32_t dfa_computeLazyTransition(dfa_LazyAutomaton *dfa, uint32_t state, uint8_t byte);
+
+/**
+ * Frees allocated memory for the given lazy automaton.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param dfa a pointer to a lazy automaton
+ */
+void dfa_freeLazyAutomaton(dfa_LazyAutomaton *dfa);
+
+#endif // DFA_H
@@ -0,0 +1,645 @@
+#include "earley.h"
+
+#include "hash.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EA_VECTOR_CAPACITY 64
+
+#define NO_LINK UINT32_MAX
+#define NO_LEO UINT32_MAX
+#define NO_ITEM UINT32_MAX
+
+// Keys of the item indexes are the tuples (LR(0) item, origin), they need 64 bits pointers
+#define makeItemKey(item, origin) ((void*) (uintptr_t) (((uint64_t) (origin) << 32) | ((uint64_t) (item) + 1)))
+
+#define getItem(parser, index) ((ea_Item*) vec_at(&(parser)->items, index))
+#define getSetStart(parser, set) (*((uint32_t*) vec_at(&(parser)->setStarts, set)))
+#define getItemRule(parser, item) ((parser)->grammar->productions[(parser)->itemProductions[item]].rule)
+
+typedef enum LinkType {
+    TOKEN_LINK,
+    COMPLETION_LINK,
+    NULLED_LINK,
+    LEO_LINK
+} LinkType;
+
+/**
+ * Way an item has been added : the item whose dot has been advanced and the symbol it has been advanced over.
+ */
+typedef struct Link {
+    LinkType type;
+    // Item before the dot was advanced, the Leo item of a Leo link
+    uint32_t predecessor;
+    // Complete item of the rule before the dot, for a completion or a Leo link
+    uint32_t cause;
+    uint32_t next;
+} Link;
+
+/**
+ * Topmost item that a completion of a rule reaches through the right recursive items that wait for it.
+ */
+typedef struct LeoItem {
+    uint32_t rule;
+    // Only item of the set that waits for the rule, the rule is its last symbol
+    uint32_t waiter;
+    // Leo item of the set where the waiter started, NO_LEO at the top of the chain
+    uint32_t next;
+    uint32_t topItem;
+    uint32_t topOrigin;
+} LeoItem;
+
+typedef struct Task {
+    sppf_Node *node;
+    // Item of an intermediate node, NO_ITEM for the node of a rule
+    uint32_t item;
+} Task;
+
+static uint32_t itemKeyHash(const void *key) {
+    uint64_t value = (uintptr_t) key;
+
+    return murmurhash3_32(&value, sizeof(value));
+}
+
+prs_ErrCode ea_createParser(ea_Parser *parser, const ga_Grammar *grammar) {
+    assert(parser);
+    assert(grammar);
+    assert(sizeof(void*) >= sizeof(uint64_t));
+
+    parser->grammar = grammar;
+    parser->itemCount = (uint32_t) grammar->symbolCount + grammar->productionCount;
+    vec_createVector(&parser->items, sizeof(ea_Item), EA_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->setStarts, sizeof(uint32_t), EA_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->links, sizeof(Link), EA_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->leoItems, sizeof(LeoItem), 0, NULL);
+    vec_createVector(&parser->leoStarts, sizeof(uint32_t), EA_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->waitedRules, sizeof(uint32_t), 0, NULL);
+    vec_createVector(&parser->tasks, sizeof(Task), EA_VECTOR_CAPACITY, NULL);
+    bool created = ht_createTable(&parser->itemIndexes, 0, itemKeyHash, NULL, NULL);
+
+    parser->firstItems = malloc(grammar->productionCount * sizeof(*parser->firstItems));
+    parser->itemSymbols = malloc(parser->itemCount * sizeof(*parser->itemSymbols));
+    parser->itemProductions = malloc(parser->itemCount * sizeof(*parser->itemProductions));
+    parser->predictedSets = malloc(grammar->ruleCount * sizeof(*parser->predictedSets));
+    parser->waiterCounts = calloc(grammar->ruleCount, sizeof(*parser->waiterCounts));
+    parser->waiters = malloc(grammar->ruleCount * sizeof(*parser->waiters));
+
+    if (!created || !parser->firstItems || !parser->itemSymbols || !parser->itemProductions || !parser->predictedSets
+        || !parser->waiterCounts || !parser->waiters) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    st_recordAllocation(grammar->productionCount * sizeof(*parser->firstItems)
+                        + parser->itemCount * (sizeof(*parser->itemSymbols) + sizeof(*parser->itemProductions))
+                        + grammar->ruleCount * (sizeof(*parser->predictedSets) + sizeof(*parser->waiterCounts)
+                                                + sizeof(*parser->waiters)));
+
+    uint32_t item = 0;
+
+    for (uint32_t p = 0;p < grammar->productionCount;++p) {
+        const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+        parser->firstItems[p] = item;
+
+        for (uint32_t i = 0;i < grammar->productions[p].length;++i) {
+            parser->itemSymbols[item] = symbols[i];
+            parser->itemProductions[item++] = p;
+        }
+
+        parser->itemSymbols[item] = EA_NO_SYMBOL;
+        parser->itemProductions[item++] = p;
+    }
+
+    return PRS_OK;
+}
+
+void ea_freeParser(ea_Parser *parser) {
+    if (parser) {
+        free(parser->firstItems);
+        free(parser->itemSymbols);
+        free(parser->itemProductions);
+        free(parser->predictedSets);
+        free(parser->waiterCounts);
+        free(parser->waiters);
+        parser->firstItems = NULL;
+        parser->itemSymbols = NULL;
+        parser->itemProductions = NULL;
+        parser->predictedSets = NULL;
+        parser->waiterCounts = NULL;
+        parser->waiters = NULL;
+        vec_freeVector(&parser->items, NULL);
+        vec_freeVector(&parser->setStarts, NULL);
+        vec_freeVector(&parser->links, NULL);
+        vec_freeVector(&parser->leoItems, NULL);
+        vec_freeVector(&parser->leoStarts, NULL);
+        vec_freeVector(&parser->waitedRules, NULL);
+        vec_freeVector(&parser->tasks, NULL);
+        ht_freeTable(&parser->itemIndexes);
+    }
+}
+
+/**
+ * Adds an item to the current set, unless the set already has it, then the link is added to the item.
+ */
+static bool addItem(ea_Parser *parser, uint32_t item, uint32_t origin, const Link *link) {
+    void *key = makeItemKey(item, origin);
+    uintptr_t value = (uintptr_t) ht_getValue(&parser->itemIndexes, key);
+    uint32_t index = (uint32_t) value - 1;
+
+    if (value == 0) {
+        ea_Item entry = { .item = item, .origin = origin, .firstLink = NO_LINK };
+        index = (uint32_t) parser->items.size;
+
+        if (!vec_pushBack(&parser->items, &entry)
+            || !ht_insertElement(&parser->itemIndexes, key, (void*) ((uintptr_t) index + 1))) {
+            return false;
+        }
+    }
+
+    if (!link) {
+        return true;
+    }
+
+    Link entry = *link;
+    ea_Item *target = getItem(parser, index);
+    entry.next = target->firstLink;
+    target->firstLink = (uint32_t) parser->links.size;
+
+    return vec_pushBack(&parser->links, &entry) != NULL;
+}
+
+/**
+ * Adds the items of the productions of a rule to a set, unless the rule has already been predicted in the set.
+ */
+static bool predict(ea_Parser *parser, uint32_t set, uint32_t rule) {
+    const ga_Grammar *grammar = parser->grammar;
+
+    // Items before the first symbol only come from predictions, they are not indexed
+    if (parser->predictedSets[rule] == set + 1) {
+        return true;
+    }
+
+    parser->predictedSets[rule] = set + 1;
+
+    for (uint32_t p = grammar->firstProductions[rule];p < grammar->firstProductions[rule + 1];++p) {
+        ea_Item entry = { .item = parser->firstItems[p], .origin = set, .firstLink = NO_LINK };
+
+        if (!vec_pushBack(&parser->items, &entry)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Finds the Leo item of a rule in a complete set.
+ */
+static uint32_t findLeoItem(ea_Parser *parser, uint32_t set, uint32_t rule) {
+    uint32_t end = *((uint32_t*) vec_at(&parser->leoStarts, set + 1));
+
+    for (uint32_t l = *((uint32_t*) vec_at(&parser->leoStarts, set));l < end;++l) {
+        if (((LeoItem*) vec_at(&parser->leoItems, l))->rule == rule) {
+            return l;
+        }
+    }
+
+    return NO_LEO;
+}
+
+/**
+ * Advances the items of the origin set that wait for the rule of a complete item.
+ */
+static bool complete(ea_Parser *parser, uint32_t set, uint32_t index) {
+    ea_Item item = *getItem(parser, index);
+    uint32_t rule = getItemRule(parser, item.item);
+
+    if (item.origin < set) {
+        uint32_t leo = findLeoItem(parser, item.origin, rule);
+
+        if (leo != NO_LEO) {
+            const LeoItem *leoItem = vec_at(&parser->leoItems, leo);
+            Link link = { .type = LEO_LINK, .predecessor = leo, .cause = index };
+
+            return addItem(parser, leoItem->topItem, leoItem->topOrigin, &link);
+        }
+    }
+
+    ga_Symbol symbol = ga_getRuleSymbol(parser->grammar, rule);
+
+    // The set of the origin is still growing if the rule derived the empty string
+    for (uint32_t w = getSetStart(parser, item.origin);
+         w < ((item.origin == set) ? parser->items.size : getSetStart(parser, item.origin + 1));++w) {
+        ea_Item waiter = *getItem(parser, w);
+
+        if (parser->itemSymbols[waiter.item] == symbol) {
+            Link link = { .type = COMPLETION_LINK, .predecessor = w, .cause = index };
+
+            if (!addItem(parser, waiter.item + 1, waiter.origin, &link)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Predicts the productions of the rule after the dot of an item, or completes its rule.
+ */
+static bool processItem(ea_Parser *parser, uint32_t set, uint32_t index) {
+    const ga_Grammar *grammar = parser->grammar;
+    ea_Item item = *getItem(parser, index);
+    ga_Symbol symbol = parser->itemSymbols[item.item];
+
+    if (symbol == EA_NO_SYMBOL) {
+        return complete(parser, set, index);
+    }
+
+    if (!ga_isRule(grammar, symbol)) {
+        return true;
+    }
+
+    uint32_t rule = ga_getRule(grammar, symbol);
+
+    if (!predict(parser, set, rule)) {
+        return false;
+    }
+
+    // Aycock and Horspool : a nullable rule is also skipped
+    if (grammar->nullable[rule]) {
+        Link link = { .type = NULLED_LINK, .predecessor = index, .cause = NO_ITEM };
+
+        return addItem(parser, item.item + 1, item.origin, &link);
+    }
+
+    return true;
+}
+
+/**
+ * Adds the Leo items of a complete set : a rule waited by one item only, that ends with it.
+ */
+static bool addLeoItems(ea_Parser *parser, uint32_t set) {
+    vec_Vector *waitedRules = &parser->waitedRules;
+    vec_clear(waitedRules, NULL);
+
+    for (uint32_t w = getSetStart(parser, set);w < parser->items.size;++w) {
+        ga_Symbol symbol = parser->itemSymbols[getItem(parser, w)->item];
+
+        if (symbol == EA_NO_SYMBOL || !ga_isRule(parser->grammar, symbol)) {
+            continue;
+        }
+
+        uint32_t rule = ga_getRule(parser->grammar, symbol);
+
+        if (parser->waiterCounts[rule]++ == 0) {
+            parser->waiters[rule] = w;
+
+            if (!vec_pushBack(waitedRules, &rule)) {
+                return false;
+            }
+        }
+    }
+
+    bool added = true;
+
+    for (size_t i = 0;i < waitedRules->size;++i) {
+        uint32_t rule = *((uint32_t*) vec_at(waitedRules, i));
+        const ea_Item *waiter = getItem(parser, parser->waiters[rule]);
+        // The complete items of the entry rule from the start accept the input, no chain skips them
+        bool accepting = set == 0 && rule == parser->grammar->entry;
+
+        if (added && !accepting && parser->waiterCounts[rule] == 1
+            && parser->itemSymbols[waiter->item + 1] == EA_NO_SYMBOL) {
+            uint32_t next = (waiter->origin < set) ? findLeoItem(parser, waiter->origin, getItemRule(parser, waiter->item))
+                                                   : NO_LEO;
+            const LeoItem *nextItem = (next != NO_LEO) ? vec_at(&parser->leoItems, next) : NULL;
+            LeoItem leoItem = {
+                .rule = rule,
+                .waiter = parser->waiters[rule],
+                .next = next,
+                .topItem = nextItem ? nextItem->topItem : waiter->item + 1,
+                .topOrigin = nextItem ? nextItem->topOrigin : waiter->origin
+            };
+
+            added = vec_pushBack(&parser->leoItems, &leoItem) != NULL;
+        }
+
+        parser->waiterCounts[rule] = 0;
+    }
+
+    uint32_t end = (uint32_t) parser->leoItems.size;
+
+    return added && vec_pushBack(&parser->leoStarts, &end);
+}
+
+/**
+ * Advances the items of a set that wait for the terminal of the next token into the next set.
+ */
+static bool scan(ea_Parser *parser, uint32_t set, uint32_t terminal) {
+    uint32_t end = getSetStart(parser, set + 1);
+
+    for (uint32_t w = getSetStart(parser, set);w < end;++w) {
+        ea_Item waiter = *getItem(parser, w);
+
+        if (parser->itemSymbols[waiter.item] == terminal) {
+            Link link = { .type = TOKEN_LINK, .predecessor = w, .cause = NO_ITEM };
+
+            if (!addItem(parser, waiter.item + 1, waiter.origin, &link)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the node of a symbol, the node of a rule is expanded later from its complete items.
+ */
+static sppf_Node *addSymbolNode(ea_Parser *parser, sppf_Forest *forest, ga_Symbol symbol, uint32_t start,
+                                uint32_t end) {
+    bool created;
+    sppf_Node *node = sppf_addNode(forest, symbol, start, end, &created);
+
+    if (node && created && ga_isRule(parser->grammar, symbol)) {
+        Task task = { .node = node, .item = NO_ITEM };
+
+        if (!vec_pushBack(&parser->tasks, &task)) {
+            return NULL;
+        }
+    }
+
+    return node;
+}
+
+/**
+ * Gets the node of the symbols before the dot of an item of a set : NULL if there is none,
+ * the node of the symbol if there is one, otherwise an intermediate node expanded later.
+ */
+static bool addPrefixNode(ea_Parser *parser, sppf_Forest *forest, uint32_t index, uint32_t set, sppf_Node **pNode) {
+    const ea_Item *item = getItem(parser, index);
+    uint32_t dot = item->item - parser->firstItems[parser->itemProductions[item->item]];
+
+    if (dot == 0) {
+        *pNode = NULL;
+        return true;
+    }
+
+    if (dot == 1) {
+        *pNode = addSymbolNode(parser, forest, parser->itemSymbols[item->item - 1], item->origin, set);
+        return *pNode != NULL;
+    }
+
+    bool created;
+    *pNode = sppf_addNode(forest, SPPF_INTERMEDIATE | item->item, item->origin, set, &created);
+
+    if (!*pNode) {
+        return false;
+    }
+
+    Task task = { .node = *pNode, .item = index };
+
+    return !created || vec_pushBack(&parser->tasks, &task);
+}
+
+static bool addPackedNode(sppf_Forest *forest, sppf_Node *node, uint32_t production, sppf_Node *prefix,
+                          sppf_Node *last) {
+    sppf_Node *children[] = { prefix, last };
+
+    return prefix ? sppf_addPackedNode(forest, node, production, children, 2)
+                  : sppf_addPackedNode(forest, node, production, children + 1, 1);
+}
+
+/**
+ * Adds the derivations of the right recursive items that a Leo link has skipped, the last one derives the node.
+ *
+ * Each item of a chain is the only one of its set that waits for its rule, so the nodes of the skipped items
+ * are only used below the top item of the chain : expanding the top item gives them all their derivations. The
+ * entry rule is never skipped, the root is always a top item.
+ */
+static bool expandLeoLink(ea_Parser *parser, sppf_Forest *forest, const Link *link, sppf_Node *node) {
+    const ea_Item *cause = getItem(parser, link->cause);
+    sppf_Node *last = addSymbolNode(parser, forest, ga_getRuleSymbol(parser->grammar, getItemRule(parser, cause->item)),
+                                    cause->origin, node->end);
+
+    for (uint32_t l = link->predecessor;last;) {
+        const LeoItem *leoItem = vec_at(&parser->leoItems, l);
+        const ea_Item *waiter = getItem(parser, leoItem->waiter);
+        sppf_Node *prefix;
+
+        if (!addPrefixNode(parser, forest, leoItem->waiter, last->start, &prefix)) {
+            return false;
+        }
+
+        sppf_Node *target = (leoItem->next == NO_LEO) ? node
+                            : addSymbolNode(parser, forest,
+                                            ga_getRuleSymbol(parser->grammar, getItemRule(parser, waiter->item)),
+                                            waiter->origin, node->end);
+
+        if (!target || !addPackedNode(forest, target, parser->itemProductions[waiter->item], prefix, last)) {
+            return false;
+        }
+
+        if (leoItem->next == NO_LEO) {
+            return true;
+        }
+
+        last = target;
+        l = leoItem->next;
+    }
+
+    return false;
+}
+
+/**
+ * Adds the derivations of an item of a set to its node, one per link.
+ */
+static bool expandItem(ea_Parser *parser, sppf_Forest *forest, uint32_t index, sppf_Node *node) {
+    const ea_Item *item = getItem(parser, index);
+    uint32_t production = parser->itemProductions[item->item];
+    uint32_t set = node->end;
+
+    if (parser->grammar->productions[production].length == 0) {
+        return sppf_addPackedNode(forest, node, production, NULL, 0);
+    }
+
+    ga_Symbol symbol = parser->itemSymbols[item->item - 1];
+
+    for (uint32_t l = item->firstLink;l != NO_LINK;) {
+        const Link *link = vec_at(&parser->links, l);
+        uint32_t predecessorSet = set;
+        sppf_Node *last;
+        l = link->next;
+
+        switch (link->type) {
+            case TOKEN_LINK:
+                predecessorSet = set - 1;
+                last = sppf_addNode(forest, symbol, predecessorSet, set, NULL);
+                break;
+            case COMPLETION_LINK:
+                predecessorSet = getItem(parser, link->cause)->origin;
+                last = addSymbolNode(parser, forest, symbol, predecessorSet, set);
+                break;
+            case NULLED_LINK:
+                last = addSymbolNode(parser, forest, symbol, set, set);
+                break;
+            default:
+                if (!expandLeoLink(parser, forest, link, node)) {
+                    return false;
+                }
+
+                continue;
+        }
+
+        sppf_Node *prefix;
+
+        if (!last || !addPrefixNode(parser, forest, link->predecessor, predecessorSet, &prefix)
+            || !addPackedNode(forest, node, production, prefix, last)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Adds the derivations of the complete items of the rule of a node.
+ */
+static bool expandRuleNode(ea_Parser *parser, sppf_Forest *forest, sppf_Node *node) {
+    uint32_t rule = ga_getRule(parser->grammar, node->label);
+    uint32_t end = getSetStart(parser, node->end + 1);
+
+    for (uint32_t c = getSetStart(parser, node->end);c < end;++c) {
+        const ea_Item *item = getItem(parser, c);
+
+        if (parser->itemSymbols[item->item] == EA_NO_SYMBOL && item->origin == node->start
+            && getItemRule(parser, item->item) == rule && !expandItem(parser, forest, c, node)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Builds the forest of the parsed tokens from the node of the entry rule, without recursion.
+ */
+static bool buildForest(ea_Parser *parser, sppf_Forest *forest, uint32_t tokenCount) {
+    vec_Vector *tasks = &parser->tasks;
+    sppf_clearForest(forest);
+    vec_clear(tasks, NULL);
+
+    forest->root = addSymbolNode(parser, forest, ga_getRuleSymbol(parser->grammar, parser->grammar->entry), 0,
+                                 tokenCount);
+
+    if (!forest->root) {
+        return false;
+    }
+
+    while (tasks->size > 0) {
+        Task task = *((Task*) vec_at(tasks, tasks->size - 1));
+        --tasks->size;
+
+        bool expanded = (task.item == NO_ITEM) ? expandRuleNode(parser, forest, task.node)
+                                               : expandItem(parser, forest, task.item, task.node);
+
+        if (!expanded) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ea_Result ea_parse(ea_Parser *parser, const tb_TokenBuffer *tokens, sppf_Forest *forest, size_t *pErrorIndex) {
+    assert(parser);
+    assert(parser->firstItems);
+    assert(tokens);
+
+    const ga_Grammar *grammar = parser->grammar;
+    uint32_t zero = 0;
+    vec_clear(&parser->items, NULL);
+    vec_clear(&parser->setStarts, NULL);
+    vec_clear(&parser->links, NULL);
+    vec_clear(&parser->leoItems, NULL);
+    vec_clear(&parser->leoStarts, NULL);
+    ht_clear(&parser->itemIndexes);
+    memset(parser->predictedSets, 0, grammar->ruleCount * sizeof(*parser->predictedSets));
+
+    if (!vec_pushBack(&parser->setStarts, &zero) || !vec_pushBack(&parser->leoStarts, &zero)
+        || !predict(parser, 0, grammar->entry)) {
+        return EA_ALLOCATION_ERROR;
+    }
+
+    uint32_t set = 0;
+
+    for (;;) {
+        // The set is its own work list
+        for (uint32_t i = getSetStart(parser, set);i < parser->items.size;++i) {
+            if (!processItem(parser, set, i)) {
+                return EA_ALLOCATION_ERROR;
+            }
+        }
+
+        uint32_t nextStart = (uint32_t) parser->items.size;
+
+        if (!addLeoItems(parser, set) || !vec_pushBack(&parser->setStarts, &nextStart)) {
+            return EA_ALLOCATION_ERROR;
+        }
+
+        // Only the items of the next set are looked up, the index stays as small as a set
+        for (uint32_t i = getSetStart(parser, set);i < nextStart;++i) {
+            const ea_Item *item = getItem(parser, i);
+
+            if (parser->firstItems[parser->itemProductions[item->item]] != item->item) {
+                ht_removeElement(&parser->itemIndexes, makeItemKey(item->item, item->origin));
+            }
+        }
+
+        if (set == tokens->size) {
+            break;
+        }
+
+        if (!scan(parser, set, tb_getTerminal(tokens, set))) {
+            return EA_ALLOCATION_ERROR;
+        }
+
+        if (parser->items.size == nextStart) {
+            if (pErrorIndex) {
+                *pErrorIndex = set;
+            }
+
+            return EA_SYNTAX_ERROR;
+        }
+
+        ++set;
+    }
+
+    uint32_t c = getSetStart(parser, set);
+
+    for (;c < parser->items.size;++c) {
+        const ea_Item *item = getItem(parser, c);
+
+        if (parser->itemSymbols[item->item] == EA_NO_SYMBOL && item->origin == 0
+            && getItemRule(parser, item->item) == grammar->entry) {
+            break;
+        }
+    }
+
+    if (c == parser->items.size) {
+        if (pErrorIndex) {
+            *pErrorIndex = tokens->size;
+        }
+
+        return EA_SYNTAX_ERROR;
+    }
+
+    if (forest && !buildForest(parser, forest, set)) {
+        return EA_ALLOCATION_ERROR;
+    }
+
+    return EA_ACCEPTED;
+}
@@ -0,0 +1,115 @@
+#ifndef EARLEY_H
+#define EARLEY_H
+
+/**
+ * @file
+ * Defines an Earley parser of a flat grammar (grammar_analysis.h) that builds a shared packed parse forest (sppf.h).
+ *
+ * Any grammar is accepted, ambiguous ones included. An Earley item is a
+ * tuple of three integers : an LR(0) item (a production and a dot), the
+ * position where the production started and the first link to the items it
+ * comes from. Items of all positions are kept in one array, the set of
+ * position i is items[setStarts[i]] to items[setStarts[i + 1] - 1].
+ *
+ * A rule that can derive the empty string is skipped as soon as it is
+ * predicted (Aycock and Horspool). Right recursion completes through Leo
+ * items : when the only item of a set that waits for a rule ends with it,
+ * the completion jumps to the topmost item of the chain instead of adding
+ * one item per level, so right recursive rules are parsed in linear time.
+ *
+ * The forest is built after the input is recognized, from the links of the
+ * items it reaches, Leo chains are expanded there. Its packed nodes are
+ * binary : the prefix of a production is an intermediate node.
+ */
+
+#include "collections/hash_table.h"
+#include "collections/vector.h"
+#include "grammar_analysis.h"
+#include "parser_errors.h"
+#include "sppf.h"
+#include "token_buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Symbol after the dot of a complete item.
+ */
+#define EA_NO_SYMBOL UINT32_MAX
+
+typedef struct ea_Item {
+    // LR(0) item
+    uint32_t item;
+    uint32_t origin;
+    uint32_t firstLink;
+} ea_Item;
+
+typedef struct ea_Parser {
+    const ga_Grammar *grammar;
+    // LR(0) items of production p are firstItems[p] (dot before the first symbol) to firstItems[p] + length
+    uint32_t *firstItems;
+    ga_Symbol *itemSymbols;
+    uint32_t *itemProductions;
+    uint32_t itemCount;
+    // Vectors of ea_Item and uint32_t, Earley sets of the last parse
+    vec_Vector items;
+    vec_Vector setStarts;
+    // Vectors of private links and Leo items, Leo items of set i are leoItems[leoStarts[i]] to leoItems[leoStarts[i + 1] - 1]
+    vec_Vector links;
+    vec_Vector leoItems;
+    vec_Vector leoStarts;
+    // Index of the items of the current set by tuple (LR(0) item, origin)
+    ht_Table itemIndexes;
+    // Set + 1 where each rule has been predicted last
+    uint32_t *predictedSets;
+    // Items that wait for each rule while Leo items are searched
+    uint32_t *waiterCounts;
+    uint32_t *waiters;
+    vec_Vector waitedRules;
+    // Vector of private tasks of the forest construction
+    vec_Vector tasks;
+} ea_Parser;
+
+typedef enum ea_Result {
+    EA_ACCEPTED,
+    EA_SYNTAX_ERROR,
+    EA_ALLOCATION_ERROR
+} ea_Result;
+
+/**
+ * Numbers the LR(0) items of a flat grammar.
+ *
+ * @param parser a pointer to the parser to create
+ * @param grammar a pointer to a flat grammar, it must outlive the parser
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode ea_createParser(ea_Parser *parser, const ga_Grammar *grammar);
+
+/**
+ * Frees allocated memory for the given parser.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param parser a pointer to a parser
+ */
+void ea_freeParser(ea_Parser *parser);
+
+/**
+ * Parses a sequence of tokens from the entry rule of the grammar.
+ *
+ * If a forest is given, it is cleared and receives every derivation of the
+ * tokens, its root is the node of the entry rule.
+ *
+ * If a token is not expected, then EA_SYNTAX_ERROR will be returned and
+ * pErrorIndex will receive its index, tokens->size if the input ended too soon.
+ *
+ * @param parser a pointer to a parser
+ * @param tokens tokens of the input, lexed by the lexer of the grammar
+ * @param forest a pointer to a forest that receives the derivations, can be NULL
+ * @param pErrorIndex pointer that receives the index of an unexpected token, can be NULL
+ * @return EA_ACCEPTED if the tokens have been parsed, otherwise a different result
+ */
+ea_Result ea_parse(ea_Parser *parser, const tb_TokenBuffer *tokens, sppf_Forest *forest, size_t *pErrorIndex);
+
+#endif // EARLEY_H
@@ -1,6 +1,5 @@
 #include "formal_grammar.h"
 
-#include "hash.h"
 #include "parser.h"
 
 #include <assert.h>
@@ -9,45 +8,138 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void tokenDestructor(void *key, void *value) {
-    // As the key (string) is the same pointer as
-    // the one in the token (name field), we don't need to free it.
-    // fg_freeToken will be in charge of it.
-    key;
-    fg_freeToken((fg_Token*) value);
-    free(value);
-}
-
-static void ruleDestructor(void *key, void *value) {
-    // As the key (string) is the same pointer as
-    // the one in the rule (name field), we don't need to free it.
-    // fg_freeRule will be in charge of it.
-    key;
-    fg_freeRule((fg_Rule*) value);
-    free(value);
-}
-
 void fg_createGrammar(fg_Grammar *g) {
     g->entry = NULL;
-    ht_createTable(&g->tokens, 10, (ht_HashFunction*) hashString, (ht_KeyComparator*) strcmp, tokenDestructor);
-    ht_createTable(&g->rules, 10, (ht_HashFunction*) hashString, (ht_KeyComparator*) strcmp, ruleDestructor);
+    ar_createArena(&g->arena, FG_ARENA_CHUNK_SIZE);
+
+    // Tokens, rules and names belong to the arena
+    sym_createSymbolTable(&g->symbols, &g->arena);
+    vec_createVector(&g->definitions, sizeof(fg_Definition), 0, NULL);
+    vec_createVector(&g->tokens, sizeof(fg_Token*), 0, NULL);
+    vec_createVector(&g->rules, sizeof(fg_Rule*), 0, NULL);
 }
 
 void fg_freeGrammar(fg_Grammar *g) {
     if (g) {
-        ht_freeTable(&g->rules);
-        ht_freeTable(&g->tokens);
+        vec_freeVector(&g->rules, NULL);
+        vec_freeVector(&g->tokens, NULL);
+        vec_freeVector(&g->definitions, NULL);
+        sym_freeSymbolTable(&g->symbols);
+        ar_freeArena(&g->arena);
         g->entry = NULL;
     }
 }
 
+/**
+ * Gets the definitions of a symbol, they are created if needed.
+ */
+static fg_Definition *getDefinition(fg_Grammar *g, sym_Id id) {
+    static const fg_Definition emptyDefinition = { .token = NULL, .rule = NULL };
+
+    while (g->definitions.size <= id) {
+        if (!vec_pushBack(&g->definitions, &emptyDefinition)) {
+            return NULL;
+        }
+    }
+
+    return vec_at(&g->definitions, id);
+}
+
+prs_ErrCode fg_addToken(fg_Grammar *g, fg_Token *token) {
+    assert(g);
+    assert(token);
+
+    fg_Definition *definition = getDefinition(g, token->id);
+
+    if (!definition) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    if (definition->token) {
+        return FG_TOKEN_EXISTS;
+    }
+
+    token->index = (uint32_t) g->tokens.size;
+
+    if (!vec_pushBack(&g->tokens, &token)) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    definition->token = token;
+
+    return PRS_OK;
+}
+
+prs_ErrCode fg_addRule(fg_Grammar *g, fg_Rule *rule) {
+    assert(g);
+    assert(rule);
+
+    fg_Definition *definition = getDefinition(g, rule->id);
+
+    if (!definition) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    if (definition->rule) {
+        return FG_RULE_EXISTS;
+    }
+
+    rule->index = (uint32_t) g->rules.size;
+
+    if (!vec_pushBack(&g->rules, &rule)) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    definition->rule = rule;
+
+    return PRS_OK;
+}
+
+fg_Token *fg_getTokenById(fg_Grammar *g, sym_Id id) {
+    assert(g);
+
+    return (id < g->definitions.size) ? ((fg_Definition*) vec_at(&g->definitions, id))->token : NULL;
+}
+
+fg_Rule *fg_getRuleById(fg_Grammar *g, sym_Id id) {
+    assert(g);
+
+    return (id < g->definitions.size) ? ((fg_Definition*) vec_at(&g->definitions, id))->rule : NULL;
+}
+
+fg_Token *fg_getToken(fg_Grammar *g, const char *name) {
+    assert(g);
+    assert(name);
+
+    return fg_getTokenById(g, sym_find(&g->symbols, name, strlen(name)));
+}
+
+fg_Rule *fg_getRule(fg_Grammar *g, const char *name) {
+    assert(g);
+    assert(name);
+
+    return fg_getRuleById(g, sym_find(&g->symbols, name, strlen(name)));
+}
+
+/**
+ * Interns the name of an item and keeps its position.
+ */
+static fg_SymbolRef createSymbolRef(fg_Grammar *g, const prs_StringItem *stringItem) {
+    return (fg_SymbolRef) {
+            .id = sym_intern(&g->symbols, stringItem->item, strlen(stringItem->item)),
+            .line = stringItem->line,
+            .column = stringItem->column
+    };
+}
+
 #define expectCharFromIt(it, expected, ret) do { \
-    if (!ll_iteratorHasNext((it)) || *((prs_StringItem*) ll_iteratorNext((it)))->item != (expected)) { \
+    if (!vec_cursorHasNext((it)) || *((prs_StringItem*) vec_cursorNext((it)))->item != (expected)) { \
         return (ret);                                   \
     }                                                   \
 } while(0)
 
-prs_ErrCode fg_extractToken(fg_Token *token, ll_Iterator *it, prs_StringItem *tokenNameItem) {
+prs_ErrCode fg_extractToken(fg_Grammar *g, fg_Token *token, vec_Cursor *it, prs_StringItem *tokenNameItem) {
+    assert(g);
     assert(token);
     assert(it);
     assert(tokenNameItem);
@@ -55,64 +147,66 @@ prs_ErrCode fg_extractToken(fg_Token *token, ll_Iterator *it, prs_StringItem *to
     // We don't need the prefix (%)
     const char *tokenName = tokenNameItem->item + 1;
 
-    token->name = calloc(strlen(tokenName) + 1, 1);
-    strcpy(token->name, tokenName);
+    token->id = sym_intern(&g->symbols, tokenName, strlen(tokenName));
+
+    if (token->id == SYM_NONE) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    token->name = sym_getName(&g->symbols, token->id);
 
     expectCharFromIt(it, '=', FG_TOKEN_INVALID);
 
-    if (!ll_iteratorHasNext(it)) {
-        fg_freeToken(token);
+    if (!vec_cursorHasNext(it)) {
         return FG_TOKEN_MISSING_VALUE;
     }
 
-    prs_StringItem *tokenValueItem = ll_iteratorNext((it));
+    prs_StringItem *tokenValueItem = vec_cursorNext(it);
     char *tokenValue = tokenValueItem->item;
 
     if (*tokenValue == ';') {
-        fg_freeToken(token);
         return FG_TOKEN_MISSING_VALUE;
     }
 
     if (*tokenValue == '`') {
+        // We don't need the 2 "`" chars before and after the string
         size_t length = strlen(tokenValue);
-        char *string = calloc(length - 1, 1); // +1 for the null character, -2 for the 2 "`" chars before and after the string
-        strncpy(string, tokenValue + 1, length - 2);
 
         token->type = FG_STRING_TOKEN;
-        token->value.string = string;
+        token->value.string = ar_strndup(&g->arena, tokenValue + 1, length - 2);
     }
     else if (*tokenValue == '[') {
         token->type = FG_RANGE_TOKEN;
 
         // lex_extractRanges expects a string without square brackets : [...]
-        prs_ErrCode errCode = prs_extractRanges(&token->value.rangeArray, tokenValue + 1, strlen(tokenValue) - 2);
+        prs_ErrCode errCode = prs_extractRanges(&token->value.rangeArray, tokenValue + 1, strlen(tokenValue) - 2, &g->arena);
 
         if (errCode != PRS_OK) {
-            fg_freeToken(token);
             return errCode;
         }
     }
     else if (isalpha(*tokenValue) && isupper(*tokenValue)) {
         if (strcmp(tokenValue, tokenName) == 0) {
-            fg_freeToken(token);
             return FG_TOKEN_SELF_REF;
         }
 
         token->type = FG_REF_TOKEN;
-        token->value.refToken.symbol = tokenValueItem;
+        token->value.refToken.symbol = createSymbolRef(g, tokenValueItem);
+
+        if (token->value.refToken.symbol.id == SYM_NONE) {
+            return PRS_ALLOCATION_ERROR;
+        }
     }
     else {
-        fg_freeToken(token);
         return FG_TOKEN_UNKNOWN_VALUE_TYPE;
     }
 
-    if (!ll_iteratorHasNext(it)) {
-        fg_freeToken(token);
+    if (!vec_cursorHasNext(it)) {
         return FG_TOKEN_MISSING_END;
     }
 
-    char c = *((prs_StringItem *) ll_iteratorNext(it))->item;
-    prs_RangeQuantifier quantifier = -1;
+    char c = *((prs_StringItem *) vec_cursorNext(it))->item;
+    prs_RangeQuantifier quantifier = PRS_NO_QUANTIFIER;
 
     switch (c) {
         case '+':
@@ -130,23 +224,24 @@ prs_ErrCode fg_extractToken(fg_Token *token, ll_Iterator *it, prs_StringItem *to
         case ';':
             break;
         default:
-            fg_freeToken(token);
             return FG_RULE_MISSING_END;
     }
 
-    if (quantifier >= 0) {
-        token->quantifier = quantifier;
-    }
+    token->quantifier = quantifier;
 
     return PRS_OK;
 }
 
+static bool symbolRefEquals(const fg_SymbolRef *ref1, const fg_SymbolRef *ref2) {
+    return ref1->id == ref2->id && ref1->line == ref2->line && ref1->column == ref2->column;
+}
+
 bool fg_tokenEquals(fg_Token *t1, fg_Token *t2) {
     if (t1 == t2) {
         return true;
     }
 
-    if (t1->type != t2->type || strcmp(t1->name, t2->name) != 0 || t1->quantifier != t2->quantifier) {
+    if (t1->type != t2->type || t1->id != t2->id || t1->quantifier != t2->quantifier) {
         return false;
     }
 
@@ -154,37 +249,14 @@ bool fg_tokenEquals(fg_Token *t1, fg_Token *t2) {
         case FG_RANGE_TOKEN:
             return prs_rangeArrayEquals(&t1->value.rangeArray, &t2->value.rangeArray);
         case FG_REF_TOKEN:
-            return prs_stringItemEquals(t1->value.refToken.symbol, t2->value.refToken.symbol);
+            return symbolRefEquals(&t1->value.refToken.symbol, &t2->value.refToken.symbol);
         case FG_STRING_TOKEN:
             return strcmp(t1->value.string, t2->value.string) == 0;
     }
 }
 
-void fg_freeToken(fg_Token *token) {
-    if (token) {
-        free(token->name);
-
-        switch (token->type) {
-            case FG_RANGE_TOKEN:
-                prs_freeRangeArray(&token->value.rangeArray);
-                break;
-            case FG_STRING_TOKEN:
-                free(token->value.string);
-                break;
-            default:
-                break;
-        }
-
-        memset(token, 0, sizeof(*token));
-    }
-}
-
-static void prItemDestructor(fg_PRItem *prItem) {
-    fg_freePRItem(prItem);
-    free(prItem);
-}
-
-prs_ErrCode fg_extractRule(fg_Rule *rule, ll_Iterator *it, prs_StringItem *ruleNameItem) {
+prs_ErrCode fg_extractRule(fg_Grammar *g, fg_Rule *rule, vec_Cursor *it, prs_StringItem *ruleNameItem) {
+    assert(g);
     assert(rule);
     assert(it);
     assert(ruleNameItem);
@@ -192,16 +264,21 @@ prs_ErrCode fg_extractRule(fg_Rule *rule, ll_Iterator *it, prs_StringItem *ruleN
     // We don't need the prefix (%)
     const char *ruleName = ruleNameItem->item + 1;
 
-    rule->name = calloc(strlen(ruleName) + 1, 1);
-    strcpy(rule->name, ruleName);
+    rule->id = sym_intern(&g->symbols, ruleName, strlen(ruleName));
+
+    if (rule->id == SYM_NONE) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    rule->name = sym_getName(&g->symbols, rule->id);
 
     expectCharFromIt(it, '=', FG_RULE_INVALID);
 
     bool hasEnd = false;
     int extractedProductionRules = 0;
 
-    while (ll_iteratorHasNext(it)) {
-        prs_StringItem *currentStringItem = ll_iteratorNext(it);
+    while (vec_cursorHasNext(it)) {
+        prs_StringItem *currentStringItem = vec_cursorNext(it);
         char *currentItem = currentStringItem->item;
 
         if (*currentItem == ';') {
@@ -209,15 +286,13 @@ prs_ErrCode fg_extractRule(fg_Rule *rule, ll_Iterator *it, prs_StringItem *ruleN
             break;
         }
 
-        ll_LinkedList *productionRule = malloc(sizeof(*productionRule));
-        ll_createLinkedList(productionRule, (ll_DataDestructor*) prItemDestructor);
+        ll_LinkedList *productionRule = ar_alloc(&g->arena, sizeof(*productionRule));
+        ll_createArenaLinkedList(productionRule, &g->arena);
 
         prs_StringItem *lastStringItem = NULL;
-        int errCode = fg_extractProductionRule(productionRule, it, currentStringItem, &lastStringItem);
+        int errCode = fg_extractProductionRule(g, productionRule, it, currentStringItem, &lastStringItem);
 
         if (errCode != PRS_OK) {
-            free(productionRule);
-            fg_freeRule(rule);
             return errCode;
         }
 
@@ -231,26 +306,24 @@ prs_ErrCode fg_extractRule(fg_Rule *rule, ll_Iterator *it, prs_StringItem *ruleN
     }
 
     if (extractedProductionRules == 0) {
-        fg_freeRule(rule);
         return FG_RULE_EMPTY;
     }
 
     if (!hasEnd) {
-        fg_freeRule(rule);
         return FG_RULE_MISSING_END;
     }
 
     return PRS_OK;
 }
 
-static void productionRuleDestructor(ll_LinkedList *pr) {
-    ll_freeLinkedList(pr, NULL);
-    free(pr);
-}
+void fg_createRule(fg_Grammar *g, fg_Rule *rule) {
+    assert(g);
+    assert(rule);
 
-void fg_createRule(fg_Rule *rule) {
+    rule->id = SYM_NONE;
+    rule->index = 0;
     rule->name = NULL;
-    ll_createLinkedList(&rule->productionRuleList, (ll_DataDestructor*) productionRuleDestructor);
+    ll_createArenaLinkedList(&rule->productionRuleList, &g->arena);
 }
 
 static int productionRuleListComparator(ll_LinkedList *prList1, ll_LinkedList *prList2) {
@@ -262,19 +335,11 @@ bool fg_ruleEquals(fg_Rule *r1, fg_Rule *r2) {
         return true;
     }
 
-    return strcmp(r1->name, r2->name) == 0 && ll_isEqual(&r1->productionRuleList, &r2->productionRuleList, (ll_DataComparator*) productionRuleListComparator);
+    return r1->id == r2->id && ll_isEqual(&r1->productionRuleList, &r2->productionRuleList, (ll_DataComparator*) productionRuleListComparator);
 }
 
-void fg_freeRule(fg_Rule *rule) {
-    if (rule) {
-        free(rule->name);
-        ll_freeLinkedList(&rule->productionRuleList, NULL);
-
-        rule->name = NULL;
-    }
-}
-
-prs_ErrCode fg_extractProductionRule(ll_LinkedList *prItemList, ll_Iterator *it, prs_StringItem *currentStringItem, prs_StringItem **pLastStringItem) {
+prs_ErrCode fg_extractProductionRule(fg_Grammar *g, ll_LinkedList *prItemList, vec_Cursor *it, prs_StringItem *currentStringItem, prs_StringItem **pLastStringItem) {
+    assert(g);
     assert(prItemList);
     assert(it);
     assert(currentStringItem);
@@ -291,22 +356,19 @@ prs_ErrCode fg_extractProductionRule(ll_LinkedList *prItemList, ll_Iterator *it,
             break;
         }
 
-        fg_PRItem *prItem = malloc(sizeof(*prItem));
-        memset(prItem, 0, sizeof(*prItem));
+        fg_PRItem *prItem = ar_calloc(&g->arena, 1, sizeof(*prItem));
 
-        prs_ErrCode errCode = fg_extractPRItem(prItem, currentStringItem);
+        prs_ErrCode errCode = fg_extractPRItem(g, prItem, currentStringItem);
 
         if (errCode != PRS_OK) {
             prs_setErrorState(currentStringItem);
-            fg_freePRItem(prItem);
-            free(prItem);
             ll_freeLinkedList(prItemList, NULL);
             return errCode;
         }
 
         ll_pushBack(prItemList, prItem);
         ++extractedItems;
-    } while (ll_iteratorHasNext(it) && (currentStringItem = ll_iteratorNext(it)));
+    } while (vec_cursorHasNext(it) && (currentStringItem = vec_cursorNext(it)));
 
     if (extractedItems == 0) {
         return FG_PR_EMPTY;
@@ -325,7 +387,8 @@ bool fg_productionRuleEquals(ll_LinkedList *pr1, ll_LinkedList *pr2) {
     return pr1 == pr2 || ll_isEqual(pr1, pr2, (ll_DataComparator*) prItemComparator);
 }
 
-prs_ErrCode fg_extractPRItem(fg_PRItem *prItem, prs_StringItem *stringItem) {
+prs_ErrCode fg_extractPRItem(fg_Grammar *g, fg_PRItem *prItem, prs_StringItem *stringItem) {
+    assert(g);
     assert(prItem);
     assert(stringItem);
 
@@ -343,15 +406,18 @@ prs_ErrCode fg_extractPRItem(fg_PRItem *prItem, prs_StringItem *stringItem) {
         }
 
         prItem->type = FG_STRING_ITEM;
-        prItem->value.string = calloc(blockLength + 1, 1);
-        strncpy(prItem->value.string, item + 1, blockLength - 2);
+        prItem->value.string = ar_strndup(&g->arena, item + 1, blockLength - 2);
     }
     else if (!isalpha(*item)) {
         return FG_PRITEM_UNKNOWN_TYPE;
     }
     else {
         prItem->type = (islower(*item)) ? FG_RULE_ITEM : FG_TOKEN_ITEM;
-        prItem->symbol = stringItem;
+        prItem->symbol = createSymbolRef(g, stringItem);
+
+        if (prItem->symbol.id == SYM_NONE) {
+            return PRS_ALLOCATION_ERROR;
+        }
     }
 
     return PRS_OK;
@@ -378,16 +444,3 @@ bool fg_PRItemEquals(fg_PRItem *prItem1, fg_PRItem *prItem2) {
             return fg_tokenEquals(prItem1->value.token, prItem2->value.token);
     }
 }
-
-void fg_freePRItem(fg_PRItem *prItem) {
-    if (prItem) {
-        switch (prItem->type) {
-            case FG_STRING_ITEM:
-                free(prItem->value.string);
-                break;
-            default:
-                prItem->symbol = NULL;
-                break;
-        }
-    }
-}
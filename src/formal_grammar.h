@@ -6,10 +6,14 @@
  * Defines structures and functions for storing a formal grammar in memory.
  */
 
-#include "collections/hash_table.h"
+#include "collections/arena.h"
 #include "collections/linked_list.h"
+#include "collections/vector.h"
 #include "parser_errors.h"
 #include "range.h"
+#include "symbol_table.h"
+
+#include <stdint.h>
 
 typedef enum fg_TokenType {
     FG_RANGE_TOKEN,
@@ -20,8 +24,17 @@ typedef enum fg_TokenType {
 struct fg_Token;
 struct prs_StringItem;
 
+/**
+ * Reference to a symbol, and its position for error messages.
+ */
+typedef struct fg_SymbolRef {
+    sym_Id id;
+    int line;
+    int column;
+} fg_SymbolRef;
+
 struct fg_RefToken {
-    struct prs_StringItem *symbol;
+    fg_SymbolRef symbol;
     struct fg_Token *token;
 };
 
@@ -33,13 +46,17 @@ union fg_TokenValue {
 
 typedef struct fg_Token {
     fg_TokenType type;
-    char *name;
+    sym_Id id;
+    uint32_t index;
+    const char *name;
     prs_RangeQuantifier quantifier;
     union fg_TokenValue value;
 } fg_Token;
 
 typedef struct fg_Rule {
-    char *name;
+    sym_Id id;
+    uint32_t index;
+    const char *name;
     ll_LinkedList productionRuleList;
 } fg_Rule;
 
@@ -57,14 +74,42 @@ union fg_PRItemValue {
 
 typedef struct fg_PRItem {
     fg_PrItemType type;
-    struct prs_StringItem *symbol;
+    fg_SymbolRef symbol;
     union fg_PRItemValue value;
 } fg_PRItem;
 
+/**
+ * Size of the first chunk of a grammar's arena.
+ */
+#define FG_ARENA_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Token and rule declared with the name of a symbol.
+ */
+typedef struct fg_Definition {
+    fg_Token *token;
+    fg_Rule *rule;
+} fg_Definition;
+
+/**
+ * A grammar and the memory of everything it contains.
+ *
+ * Tokens, rules, production rules, their items and the lists that hold them
+ * are allocated in the grammar's arena. Items extracted from the source can
+ * be allocated in it too, so that the whole grammar is released at once.
+ *
+ * Names are interned in the symbol table : tokens, rules and references
+ * only hold symbol IDs. The definitions vector is indexed by symbol ID.
+ * The tokens and rules vectors keep declaration order, the index field of
+ * a token or a rule is its position in these vectors.
+ */
 typedef struct fg_Grammar {
-    ht_Table tokens;
-    ht_Table rules;
+    sym_SymbolTable symbols;
+    vec_Vector definitions;
+    vec_Vector tokens;
+    vec_Vector rules;
     fg_Rule *entry;
+    ar_Arena arena;
 } fg_Grammar;
 
 /**
@@ -74,9 +119,70 @@ typedef struct fg_Grammar {
  */
 void fg_createGrammar(fg_Grammar *g);
 
+/**
+ * Adds a token to a grammar.
+ *
+ * If a token with the same name already exists then FG_TOKEN_EXISTS
+ * will be returned.
+ *
+ * @param g a pointer to a grammar
+ * @param token a token extracted with {@link fg_extractToken}
+ * @return PRS_OK if the token has been added, otherwise a different error code
+ */
+prs_ErrCode fg_addToken(fg_Grammar *g, fg_Token *token);
+
+/**
+ * Adds a rule to a grammar.
+ *
+ * If a rule with the same name already exists then FG_RULE_EXISTS
+ * will be returned.
+ *
+ * @param g a pointer to a grammar
+ * @param rule a rule extracted with {@link fg_extractRule}
+ * @return PRS_OK if the rule has been added, otherwise a different error code
+ */
+prs_ErrCode fg_addRule(fg_Grammar *g, fg_Rule *rule);
+
+/**
+ * Gets the token declared with the given symbol.
+ *
+ * @param g a pointer to a grammar
+ * @param id a symbol ID
+ * @return the token or NULL if there is no token with this symbol
+ */
+fg_Token *fg_getTokenById(fg_Grammar *g, sym_Id id);
+
+/**
+ * Gets the rule declared with the given symbol.
+ *
+ * @param g a pointer to a grammar
+ * @param id a symbol ID
+ * @return the rule or NULL if there is no rule with this symbol
+ */
+fg_Rule *fg_getRuleById(fg_Grammar *g, sym_Id id);
+
+/**
+ * Gets a token by its name.
+ *
+ * @param g a pointer to a grammar
+ * @param name a null terminated name, without prefix
+ * @return the token or NULL if it does not exist
+ */
+fg_Token *fg_getToken(fg_Grammar *g, const char *name);
+
+/**
+ * Gets a rule by its name.
+ *
+ * @param g a pointer to a grammar
+ * @param name a null terminated name, without prefix
+ * @return the rule or NULL if it does not exist
+ */
+fg_Rule *fg_getRule(fg_Grammar *g, const char *name);
+
 /**
  * Frees allocated memory for the given grammar.
  *
+ * Every object allocated in the grammar's arena will be released.
  * The given pointer will not be freed.
  *
  * @param g a pointer to a grammar
@@ -104,25 +210,19 @@ void fg_freeGrammar(fg_Grammar *g);
  *
  * Other error codes can be returned by {@link prs_extractRanges}.
  *
+ * The token's name and the referenced symbol are interned in the grammar's
+ * symbol table. Its value is allocated in the grammar's arena.
+ *
+ * @param g grammar that owns the token's memory
  * @param token pointer to a structure that will receive values
- * @param it iterator to a list that contains items
+ * @param it cursor on a vector that contains items
  * @param tokenNameItem pointer to the string item
  * @return FG_OK if not error occurs
  */
-prs_ErrCode fg_extractToken(fg_Token *token, ll_Iterator *it, struct prs_StringItem *tokenNameItem);
+prs_ErrCode fg_extractToken(fg_Grammar *g, fg_Token *token, vec_Cursor *it, struct prs_StringItem *tokenNameItem);
 
 bool fg_tokenEquals(fg_Token *t1, fg_Token *t2);
 
-/**
- * Frees allocated memory in a token.
- *
- * Pointers name and string will be set to NULL.
- * The given pointer will not be freed.
- *
- * @param token pointer to a token structure
- */
-void fg_freeToken(fg_Token *token);
-
 /**
  * Extracts a rule from a list of items.
  *
@@ -137,31 +237,28 @@ void fg_freeToken(fg_Token *token);
  *
  * Other error codes can be returned by {@link fg_extractProductionRule}.
  *
+ * The rule must have been created with {@link fg_createRule}.
+ *
+ * @param g grammar that owns the rule's memory
  * @param rule a pointer to a rule structure
- * @param it pointer to an iterator over a list of prs_StringItem
+ * @param it pointer to a cursor over a vector of prs_StringItem
  * @param ruleNameItem pointer to a StringItem that represents the rule's name
  * @return PRS_OK if not error occurs, otherwise a different error code
  */
-prs_ErrCode fg_extractRule(fg_Rule *rule, ll_Iterator *it, struct prs_StringItem *ruleNameItem);
+prs_ErrCode fg_extractRule(fg_Grammar *g, fg_Rule *rule, vec_Cursor *it, struct prs_StringItem *ruleNameItem);
 
 /**
  * Creates a new rule with default values.
  *
+ * The list of production rules will be allocated in the grammar's arena.
+ *
+ * @param g grammar that owns the rule's memory
  * @param rule a pointer to a rule
  */
-void fg_createRule(fg_Rule *rule);
+void fg_createRule(fg_Grammar *g, fg_Rule *rule);
 
 bool fg_ruleEquals(fg_Rule *r1, fg_Rule *r2);
 
-/**
- * Frees allocated memory for the given rule.
- *
- * The given pointer will not be freed.
- *
- * @param rule a pointer to a rule
- */
-void fg_freeRule(fg_Rule *rule);
-
 /**
  * Extracts a production rule from a list of items.
  *
@@ -171,13 +268,16 @@ void fg_freeRule(fg_Rule *rule);
  *
  * Other error codes can be returned by {@link fg_extractPRItem}.
  *
+ * Production rule items are allocated in the grammar's arena.
+ *
+ * @param g grammar that owns the production rule's memory
  * @param prItemList pointer to a production rule
- * @param it a pointer to an iterator over a list of prs_StringItem
+ * @param it a pointer to a cursor over a vector of prs_StringItem
  * @param currentStringItem the current string item
  * @param pLastStringItem pointer to the last string item that not belongs to the production rule
  * @return PRS_OK if no error occurs, otherwise a different error code
  */
-prs_ErrCode fg_extractProductionRule(ll_LinkedList *prItemList, ll_Iterator *it, struct prs_StringItem *currentStringItem, struct prs_StringItem **pLastStringItem);
+prs_ErrCode fg_extractProductionRule(fg_Grammar *g, ll_LinkedList *prItemList, vec_Cursor *it, struct prs_StringItem *currentStringItem, struct prs_StringItem **pLastStringItem);
 
 bool fg_productionRuleEquals(ll_LinkedList *pr1, ll_LinkedList *pr2);
 
@@ -194,22 +294,15 @@ bool fg_productionRuleEquals(ll_LinkedList *pr1, ll_LinkedList *pr2);
  *
  * If it is a reference to a rule / token, then this function will not check if the
  * reference exists. This step will be done by {@link prs_resolveSymbols}.
+ * The name of the reference is interned in the grammar's symbol table.
  *
+ * @param g grammar that owns the string block's copy
  * @param prItem a pointer to a production rule item
  * @param stringItem stringItem that should be converted into a fg_PRItem
  * @return PRS_OK if no error occurs, otherwise a different error code
  */
-prs_ErrCode fg_extractPRItem(fg_PRItem *prItem, struct prs_StringItem *stringItem);
+prs_ErrCode fg_extractPRItem(fg_Grammar *g, fg_PRItem *prItem, struct prs_StringItem *stringItem);
 
 bool fg_PRItemEquals(fg_PRItem *prItem1, fg_PRItem *prItem2);
 
-/**
- * Frees allocated memory for the given production rule item.
- *
- * The given pointer will not be freed.
- *
- * @param prItem a pointer to a production rule item
- */
-void fg_freePRItem(fg_PRItem *prItem);
-
 #endif //FORMAL_GRAMMAR_H
@@ -0,0 +1,488 @@
+#include "glr_parser.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLR_VECTOR_CAPACITY 64
+
+#define NO_STATE UINT32_MAX
+#define NO_NODE UINT32_MAX
+
+#define getNode(parser, index) ((Node*) (parser)->nodes.data + (index))
+
+/**
+ * Node of the graph-structured stack : a state reached after the tokens before a position, and its first edge.
+ *
+ * An edge goes from a node to a node below it, over the symbol of the state of its source. The other edges of a node
+ * are entries of their own, without state, so that the edge of a node has its index.
+ */
+typedef struct Node {
+    // NO_STATE for an edge that is not the first one of its node
+    uint32_t state;
+    uint32_t position;
+    // NO_NODE for the start node
+    uint32_t target;
+    // Next edge of the node, NO_NODE if there is none
+    uint32_t next;
+    // Forest node of the symbol, NULL without forest
+    sppf_Node *label;
+} Node;
+
+/**
+ * Reduction of a production whose paths go down through the given edge first.
+ */
+typedef struct Reduction {
+    uint32_t edge;
+    uint32_t production;
+} Reduction;
+
+typedef struct Shift {
+    uint32_t node;
+    uint32_t state;
+} Shift;
+
+/**
+ * Checks if a conflict rejects an action that the table or a previous conflict of its cell already gives.
+ */
+static bool isRedundantConflict(const lr_Table *table, size_t index) {
+    const lr_Conflict *conflicts = (const lr_Conflict*) table->conflicts.data;
+    const lr_Conflict *conflict = &conflicts[index];
+
+    if (lr_getAction(table, conflict->state, conflict->terminal) == conflict->actions[1]) {
+        return true;
+    }
+
+    for (size_t i = 0;i < index;++i) {
+        if (conflicts[i].state == conflict->state && conflicts[i].terminal == conflict->terminal
+            && conflicts[i].actions[1] == conflict->actions[1]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Checks if a rule derives itself through unit productions : rules that only reach removed rules are removed until
+ * none is left.
+ */
+static bool hasUnitCycle(const ga_Grammar *grammar, bool *removed) {
+    uint32_t removedCount = 0;
+    bool changed = true;
+    memset(removed, 0, grammar->ruleCount * sizeof(*removed));
+
+    while (changed) {
+        changed = false;
+
+        for (uint32_t r = 0;r < grammar->ruleCount;++r) {
+            uint32_t p = grammar->firstProductions[r];
+
+            for (;!removed[r] && p < grammar->firstProductions[r + 1];++p) {
+                const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+
+                if (grammar->productions[p].length == 1 && ga_isRule(grammar, symbols[0])
+                    && !removed[ga_getRule(grammar, symbols[0])]) {
+                    break;
+                }
+            }
+
+            if (!removed[r] && p == grammar->firstProductions[r + 1]) {
+                removed[r] = changed = true;
+                ++removedCount;
+            }
+        }
+    }
+
+    return removedCount < grammar->ruleCount;
+}
+
+prs_ErrCode glr_createParser(glr_Parser *parser, const lr_Table *table) {
+    assert(parser);
+    assert(table);
+
+    const ga_Grammar *grammar = table->grammar;
+    size_t conflictCount = table->conflicts.size;
+    uint32_t maxLength = 1;
+
+    for (uint32_t p = 0;p < grammar->productionCount;++p) {
+        if (grammar->productions[p].length > maxLength) {
+            maxLength = grammar->productions[p].length;
+        }
+    }
+
+    parser->table = table;
+    vec_createVector(&parser->nodes, sizeof(Node), GLR_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->reductions, sizeof(Reduction), GLR_VECTOR_CAPACITY, NULL);
+    vec_createVector(&parser->shifts, sizeof(Shift), GLR_VECTOR_CAPACITY, NULL);
+
+    parser->conflictStarts = calloc(table->stateCount + 1, sizeof(*parser->conflictStarts));
+    parser->conflictTerminals = malloc((conflictCount + 1) * sizeof(*parser->conflictTerminals));
+    parser->conflictActions = malloc((conflictCount + 1) * sizeof(*parser->conflictActions));
+    parser->stateNodes = malloc(table->stateCount * sizeof(*parser->stateNodes));
+    parser->stateStamps = malloc(table->stateCount * sizeof(*parser->stateStamps));
+    parser->path = malloc(maxLength * sizeof(*parser->path));
+    parser->children = malloc(maxLength * sizeof(*parser->children));
+    bool *removed = malloc(grammar->ruleCount * sizeof(*removed));
+
+    if (!parser->conflictStarts || !parser->conflictTerminals || !parser->conflictActions || !parser->stateNodes
+        || !parser->stateStamps || !parser->path || !parser->children || !removed) {
+        free(removed);
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    st_recordAllocation((table->stateCount + 1) * sizeof(*parser->conflictStarts)
+                        + (conflictCount + 1) * (sizeof(*parser->conflictTerminals) + sizeof(*parser->conflictActions))
+                        + table->stateCount * (sizeof(*parser->stateNodes) + sizeof(*parser->stateStamps))
+                        + maxLength * (sizeof(*parser->path) + sizeof(*parser->children)));
+
+    // A cycle of reductions at one position stops at an edge that exists, the nodes must be kept
+    parser->dropsNodes = !hasUnitCycle(grammar, removed);
+    free(removed);
+
+    // Rejected actions are counted, then placed by state, stateNodes holds the next slot of each state
+    for (size_t i = 0;i < conflictCount;++i) {
+        if (!isRedundantConflict(table, i)) {
+            ++parser->conflictStarts[((const lr_Conflict*) table->conflicts.data + i)->state + 1];
+        }
+    }
+
+    for (uint32_t s = 0;s < table->stateCount;++s) {
+        parser->conflictStarts[s + 1] += parser->conflictStarts[s];
+        parser->stateNodes[s] = parser->conflictStarts[s];
+    }
+
+    for (size_t i = 0;i < conflictCount;++i) {
+        const lr_Conflict *conflict = (const lr_Conflict*) table->conflicts.data + i;
+
+        if (!isRedundantConflict(table, i)) {
+            uint32_t slot = parser->stateNodes[conflict->state]++;
+            parser->conflictTerminals[slot] = conflict->terminal;
+            parser->conflictActions[slot] = conflict->actions[1];
+        }
+    }
+
+    return PRS_OK;
+}
+
+void glr_freeParser(glr_Parser *parser) {
+    if (parser) {
+        vec_freeVector(&parser->nodes, NULL);
+        vec_freeVector(&parser->reductions, NULL);
+        vec_freeVector(&parser->shifts, NULL);
+        free(parser->conflictStarts);
+        free(parser->conflictTerminals);
+        free(parser->conflictActions);
+        free(parser->stateNodes);
+        free(parser->stateStamps);
+        free(parser->path);
+        free(parser->children);
+        parser->conflictStarts = NULL;
+        parser->conflictTerminals = NULL;
+        parser->conflictActions = NULL;
+        parser->stateNodes = NULL;
+        parser->stateStamps = NULL;
+        parser->path = NULL;
+        parser->children = NULL;
+    }
+}
+
+/**
+ * Queues an action of a state for the current position : a reduction goes through the given edge, shifts and the
+ * acceptance are only queued for a new node, whose first edge has its index.
+ */
+static bool queueAction(glr_Parser *parser, lr_Action action, uint32_t edge, bool created, uint32_t *pAccepting) {
+    switch (lr_getActionType(action)) {
+        case LR_SHIFT_ACTION: {
+            Shift shift = { .node = edge, .state = lr_getActionValue(action) };
+
+            return !created || vec_pushBack(&parser->shifts, &shift);
+        }
+        case LR_REDUCE_ACTION: {
+            Reduction reduction = { .edge = edge, .production = lr_getActionValue(action) };
+
+            return vec_pushBack(&parser->reductions, &reduction) != NULL;
+        }
+        case LR_ACCEPT_ACTION:
+            if (created) {
+                *pAccepting = edge;
+            }
+
+            return true;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Queues the action of the table and the rejected actions of a state for a terminal.
+ */
+static bool queueActions(glr_Parser *parser, uint32_t state, uint32_t edge, ga_Symbol terminal, bool created,
+                         uint32_t *pAccepting) {
+    if (!queueAction(parser, lr_getAction(parser->table, state, terminal), edge, created, pAccepting)) {
+        return false;
+    }
+
+    for (uint32_t c = parser->conflictStarts[state];c < parser->conflictStarts[state + 1];++c) {
+        if (parser->conflictTerminals[c] == terminal
+            && !queueAction(parser, parser->conflictActions[c], edge, created, pAccepting)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the edge from the node of a state at a position to a node below, NO_NODE if there is none.
+ */
+static uint32_t findEdge(glr_Parser *parser, uint32_t position, uint32_t state, uint32_t target) {
+    if (parser->stateStamps[state] != position + 1) {
+        return NO_NODE;
+    }
+
+    uint32_t e = parser->stateNodes[state];
+
+    for (;e != NO_NODE && getNode(parser, e)->target != target;e = getNode(parser, e)->next);
+
+    return e;
+}
+
+/**
+ * Adds a new edge from the node of a state at a position to a node below, the node is added if the state has none.
+ */
+static bool addEdge(glr_Parser *parser, uint32_t position, ga_Symbol terminal, uint32_t state, uint32_t target,
+                    sppf_Node *label, uint32_t *pAccepting) {
+    uint32_t edge = (uint32_t) parser->nodes.size;
+    Node added = { .state = state, .position = position, .target = target, .next = NO_NODE, .label = label };
+    bool created = parser->stateStamps[state] != position + 1;
+
+    if (!created) {
+        // The edge is linked after the first one of the node
+        uint32_t node = parser->stateNodes[state];
+        added.state = NO_STATE;
+        added.next = getNode(parser, node)->next;
+
+        if (!vec_pushBack(&parser->nodes, &added)) {
+            return false;
+        }
+
+        getNode(parser, node)->next = edge;
+
+        return queueActions(parser, state, edge, terminal, false, pAccepting);
+    }
+
+    if (!vec_pushBack(&parser->nodes, &added)) {
+        return false;
+    }
+
+    parser->stateNodes[state] = edge;
+    parser->stateStamps[state] = position + 1;
+
+    return queueActions(parser, state, edge, terminal, true, pAccepting);
+}
+
+/**
+ * Reduces the path of edges of a production : the rule is pushed on the node the path ends at.
+ */
+static bool reducePath(glr_Parser *parser, sppf_Forest *forest, uint32_t position, ga_Symbol terminal,
+                       uint32_t production, bool popped, uint32_t *pAccepting) {
+    const ga_Grammar *grammar = parser->table->grammar;
+    const ga_Production *reduced = &grammar->productions[production];
+    ga_Symbol symbol = ga_getRuleSymbol(grammar, reduced->rule);
+    uint32_t target = getNode(parser, parser->path[reduced->length - 1])->target;
+    const Node *below = getNode(parser, target);
+    lr_Action action = lr_getAction(parser->table, below->state, symbol);
+    uint32_t state = lr_getActionValue(action);
+
+    // The nodes of the path are dropped like the states of an LR stack, their entries are read until the next one
+    if (popped) {
+        parser->stateStamps[getNode(parser, parser->path[0])->state] = 0;
+        parser->nodes.size -= reduced->length;
+    }
+
+    uint32_t edge = findEdge(parser, position, state, target);
+    // The symbol of an edge is the one of the state of its source, its label is the node of the rule
+    sppf_Node *label = (edge != NO_NODE) ? getNode(parser, edge)->label : NULL;
+
+    assert(lr_getActionType(action) == LR_SHIFT_ACTION);
+
+    if (forest) {
+        // The path goes from the last symbol to the first one
+        for (uint32_t i = 0;i < reduced->length;++i) {
+            parser->children[i] = getNode(parser, parser->path[reduced->length - 1 - i])->label;
+        }
+
+        // Entries are sorted by position, the rule can only reach the only node of a position through this edge
+        bool alone = (target == 0 || getNode(parser, target - 1)->position != below->position)
+                     && (target + 1 == parser->nodes.size || getNode(parser, target + 1)->position != below->position);
+
+        if (!label) {
+            label = (alone) ? sppf_addUniqueNode(forest, symbol, below->position, position)
+                            : sppf_addNode(forest, symbol, below->position, position, NULL);
+        }
+
+        if (!label || !sppf_addPackedNode(forest, label, production, parser->children, reduced->length)) {
+            return false;
+        }
+    }
+
+    return edge != NO_NODE || addEdge(parser, position, terminal, state, target, label, pAccepting);
+}
+
+/**
+ * Checks if a path is the only stack left : its nodes are the last entries, the only ones of their positions, and
+ * nothing waits for them.
+ */
+static bool isPoppable(glr_Parser *parser, uint32_t length, uint32_t accepting) {
+    uint32_t last = (uint32_t) parser->nodes.size - 1;
+
+    if (!parser->dropsNodes || parser->reductions.size > 0 || parser->shifts.size > 0 || accepting != NO_NODE) {
+        return false;
+    }
+
+    for (uint32_t d = 0;d < length;++d) {
+        const Node *node = getNode(parser, parser->path[d]);
+
+        if (parser->path[d] != last - d || node->state == NO_STATE || node->next != NO_NODE) {
+            return false;
+        }
+    }
+
+    return getNode(parser, last - length)->position < getNode(parser, last - length + 1)->position;
+}
+
+/**
+ * Does a reduction along each path that goes down through its edge, without recursion.
+ */
+static bool reduce(glr_Parser *parser, sppf_Forest *forest, uint32_t position, ga_Symbol terminal,
+                   const Reduction *reduction, uint32_t *pAccepting) {
+    uint32_t length = parser->table->grammar->productions[reduction->production].length;
+    uint32_t *path = parser->path;
+    uint32_t depth = 1;
+
+    assert(length > 0);
+    path[0] = reduction->edge;
+
+    for (;;) {
+        // A single stack has one way down
+        for (;depth < length;++depth) {
+            path[depth] = getNode(parser, path[depth - 1])->target;
+            assert(path[depth] != NO_NODE);
+        }
+
+        bool popped = isPoppable(parser, length, *pAccepting);
+
+        if (!reducePath(parser, forest, position, terminal, reduction->production, popped, pAccepting)) {
+            return false;
+        }
+
+        if (popped) {
+            return true;
+        }
+
+        // The deepest edge that has a sibling leads to the next path, the first edge is fixed
+        for (;depth > 1 && getNode(parser, path[depth - 1])->next == NO_NODE;--depth);
+
+        if (depth == 1) {
+            return true;
+        }
+
+        path[depth - 1] = getNode(parser, path[depth - 1])->next;
+    }
+}
+
+glr_Result glr_parse(glr_Parser *parser, const tb_TokenBuffer *tokens, sppf_Forest *forest, size_t *pErrorIndex) {
+    assert(parser);
+    assert(parser->conflictStarts);
+    assert(tokens);
+
+    const ga_Grammar *grammar = parser->table->grammar;
+    uint32_t tokenCount = (uint32_t) tokens->size;
+    ga_Symbol terminal = (tokenCount > 0) ? tb_getTerminal(tokens, 0) : grammar->endTerminal;
+    uint32_t accepting = NO_NODE;
+
+    vec_clear(&parser->nodes, NULL);
+    vec_clear(&parser->reductions, NULL);
+    vec_clear(&parser->shifts, NULL);
+    memset(parser->stateStamps, 0, parser->table->stateCount * sizeof(*parser->stateStamps));
+
+    if (forest) {
+        sppf_clearForest(forest);
+    }
+
+    // The start state has no reduction, only its shifts are queued
+    Node start = { .state = 0, .position = 0, .target = NO_NODE, .next = NO_NODE, .label = NULL };
+
+    if (!vec_pushBack(&parser->nodes, &start) || !queueActions(parser, 0, 0, terminal, true, &accepting)) {
+        return GLR_ALLOCATION_ERROR;
+    }
+
+    parser->stateNodes[0] = 0;
+    parser->stateStamps[0] = 1;
+
+    for (uint32_t position = 0;;++position) {
+        while (parser->reductions.size > 0) {
+            Reduction reduction = *((Reduction*) vec_at(&parser->reductions, parser->reductions.size - 1));
+            --parser->reductions.size;
+
+            if (!reduce(parser, forest, position, terminal, &reduction, &accepting)) {
+                return GLR_ALLOCATION_ERROR;
+            }
+        }
+
+        if (position == tokenCount) {
+            break;
+        }
+
+        if (parser->shifts.size == 0) {
+            if (pErrorIndex) {
+                *pErrorIndex = position;
+            }
+
+            return GLR_SYNTAX_ERROR;
+        }
+
+        sppf_Node *label = (forest) ? sppf_addUniqueNode(forest, terminal, position, position + 1) : NULL;
+        terminal = (position + 1 < tokenCount) ? tb_getTerminal(tokens, position + 1) : grammar->endTerminal;
+
+        if (forest && !label) {
+            return GLR_ALLOCATION_ERROR;
+        }
+
+        // Nodes of the next position queue their shifts after the ones of this position
+        size_t shiftCount = parser->shifts.size;
+
+        for (size_t i = 0;i < shiftCount;++i) {
+            Shift shift = *((Shift*) vec_at(&parser->shifts, i));
+
+            if (!addEdge(parser, position + 1, terminal, shift.state, shift.node, label, &accepting)) {
+                return GLR_ALLOCATION_ERROR;
+            }
+        }
+
+        parser->shifts.size -= shiftCount;
+        memmove(parser->shifts.data, (Shift*) parser->shifts.data + shiftCount, parser->shifts.size * sizeof(Shift));
+    }
+
+    if (accepting == NO_NODE) {
+        if (pErrorIndex) {
+            *pErrorIndex = tokenCount;
+        }
+
+        return GLR_SYNTAX_ERROR;
+    }
+
+    if (forest) {
+        // The accepting state is the goto of the entry rule from the start node
+        uint32_t edge = accepting;
+
+        for (;getNode(parser, edge)->target != 0;edge = getNode(parser, edge)->next);
+
+        forest->root = getNode(parser, edge)->label;
+    }
+
+    return GLR_ACCEPTED;
+}
@@ -0,0 +1,104 @@
+#ifndef GLR_PARSER_H
+#define GLR_PARSER_H
+
+/**
+ * @file
+ * Defines a generalized LR parser driven by an LALR(1) table (lr_table.h) that builds a shared packed parse forest
+ * (sppf.h).
+ *
+ * A cell of the table can have several actions : the one kept in the table and
+ * the ones its conflicts have rejected. The parser follows all of them on a
+ * graph-structured stack : the stacks that reach the same state after the same
+ * token share their node, and an edge goes from a node to the node below it.
+ * The tokens are read one at a time, all the reductions of a position are done
+ * before its shifts (Tomita).
+ *
+ * A reduction goes down every path of the length of its production. When an
+ * edge is added to a node that already exists, the reductions of this node
+ * are done again through the new edge only, as in the RNGLR algorithm. The
+ * grammar has no empty production, so that each path below a new node only
+ * goes through nodes of the previous positions.
+ *
+ * A cell without conflict has a single action, so that a conflict-free input
+ * keeps a single stack : each action adds one node, that holds its only edge,
+ * and each path has one way down. While nothing else waits, a reduction drops
+ * the nodes of its path like an LR parser pops its states, the graph keeps the
+ * depth of the stack instead of growing with the input. Edges are labelled with the forest nodes of their symbols, a
+ * reduction adds a packed node with one child per symbol of its production.
+ */
+
+#include "collections/vector.h"
+#include "lr_table.h"
+#include "parser_errors.h"
+#include "sppf.h"
+#include "token_buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct glr_Parser {
+    const lr_Table *table;
+    // Rejected actions of state s are conflictActions[conflictStarts[s]] to conflictActions[conflictStarts[s + 1] - 1]
+    uint32_t *conflictStarts;
+    uint32_t *conflictTerminals;
+    lr_Action *conflictActions;
+    // Vector of private nodes, graph-structured stack of the last parse, each edge after the first one of a node is an
+    // entry of its own
+    vec_Vector nodes;
+    // Vectors of private reductions and shifts that wait for the current position
+    vec_Vector reductions;
+    vec_Vector shifts;
+    // Nodes of a single stack are dropped by its reductions, unless a rule derives itself through unit productions
+    bool dropsNodes;
+    // Node of each state at the position stateStamps[state] - 1
+    uint32_t *stateNodes;
+    uint32_t *stateStamps;
+    // Edges of the path being reduced and the forest nodes of their symbols, one per symbol of the longest production
+    uint32_t *path;
+    sppf_Node **children;
+} glr_Parser;
+
+typedef enum glr_Result {
+    GLR_ACCEPTED,
+    GLR_SYNTAX_ERROR,
+    GLR_ALLOCATION_ERROR
+} glr_Result;
+
+/**
+ * Indexes the conflicts of a table by state.
+ *
+ * @param parser a pointer to the parser to create
+ * @param table a pointer to a table, it must outlive the parser
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode glr_createParser(glr_Parser *parser, const lr_Table *table);
+
+/**
+ * Frees allocated memory for the given parser.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param parser a pointer to a parser
+ */
+void glr_freeParser(glr_Parser *parser);
+
+/**
+ * Parses a sequence of tokens from the entry rule of the grammar.
+ *
+ * If a forest is given, it is cleared and receives every derivation of the
+ * tokens, its root is the node of the entry rule. Nodes of the stacks that
+ * did not reach the end of the input can be left in the forest.
+ *
+ * If no stack can shift a token, then GLR_SYNTAX_ERROR will be returned and
+ * pErrorIndex will receive its index, tokens->size if the input ended too soon.
+ *
+ * @param parser a pointer to a parser
+ * @param tokens tokens of the input, lexed by the lexer of the grammar
+ * @param forest a pointer to a forest that receives the derivations, can be NULL
+ * @param pErrorIndex pointer that receives the index of an unexpected token, can be NULL
+ * @return GLR_ACCEPTED if the tokens have been parsed, otherwise a different result
+ */
+glr_Result glr_parse(glr_Parser *parser, const tb_TokenBuffer *tokens, sppf_Forest *forest, size_t *pErrorIndex);
+
+#endif // GLR_PARSER_H
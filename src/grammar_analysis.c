@@ -0,0 +1,306 @@
+#include "grammar_analysis.h"
+
+#include "literal_set.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define ANALYSIS_ARENA_CHUNK_SIZE 4096
+
+/**
+ * Counts the productions and the items of all rules.
+ */
+static void countSymbols(fg_Grammar *g, size_t *pProductionCount, size_t *pSymbolCount) {
+    *pProductionCount = 0;
+    *pSymbolCount = 0;
+
+    for (size_t i = 0;i < g->rules.size;++i) {
+        fg_Rule *rule = *((fg_Rule**) vec_at(&g->rules, i));
+        ll_Iterator prIt = ll_createIterator(&rule->productionRuleList);
+
+        while (ll_iteratorHasNext(&prIt)) {
+            ll_LinkedList *productionRule = ll_iteratorNext(&prIt);
+            ++*pProductionCount;
+            *pSymbolCount += productionRule->size;
+        }
+    }
+}
+
+/**
+ * Gets the symbol of a production rule item.
+ */
+static prs_ErrCode getItemSymbol(const ga_Grammar *grammar, const fg_PRItem *prItem, ga_Symbol *pSymbol) {
+    switch (prItem->type) {
+        case FG_RULE_ITEM:
+            if (!prItem->value.rule) {
+                return FG_UNKNOWN_RULE;
+            }
+
+            *pSymbol = ga_getRuleSymbol(grammar, prItem->value.rule->index);
+            return PRS_OK;
+        case FG_TOKEN_ITEM:
+            if (!prItem->value.token) {
+                return FG_UNKNOWN_TOKEN;
+            }
+
+            *pSymbol = prItem->value.token->index;
+            return PRS_OK;
+        case FG_STRING_ITEM:
+            *pSymbol = lex_getLiteralTerminal(grammar->lexer, prItem->value.string);
+            return (*pSymbol == LIT_NONE) ? PRS_UNKNOWN_ITEM : PRS_OK;
+        default:
+            return FG_PRITEM_UNKNOWN_TYPE;
+    }
+}
+
+/**
+ * Copies the production rules of the grammar into the arrays of symbols.
+ */
+static prs_ErrCode flattenRules(ga_Grammar *grammar) {
+    uint32_t productionIndex = 0;
+    uint32_t symbolIndex = 0;
+
+    for (uint32_t r = 0;r < grammar->ruleCount;++r) {
+        fg_Rule *rule = *((fg_Rule**) vec_at(&grammar->g->rules, r));
+        ll_Iterator prIt = ll_createIterator(&rule->productionRuleList);
+
+        grammar->firstProductions[r] = productionIndex;
+
+        while (ll_iteratorHasNext(&prIt)) {
+            ga_Production *production = &grammar->productions[productionIndex++];
+            production->rule = r;
+            production->start = symbolIndex;
+
+            ll_Iterator it = ll_createIterator(ll_iteratorNext(&prIt));
+
+            while (ll_iteratorHasNext(&it)) {
+                prs_ErrCode errCode = getItemSymbol(grammar, ll_iteratorNext(&it), &grammar->symbols[symbolIndex]);
+
+                if (errCode != PRS_OK) {
+                    return errCode;
+                }
+
+                ++symbolIndex;
+            }
+
+            production->length = symbolIndex - production->start;
+        }
+    }
+
+    grammar->firstProductions[grammar->ruleCount] = productionIndex;
+
+    return PRS_OK;
+}
+
+/**
+ * Adds a set to another one.
+ *
+ * @return true if the destination has changed
+ */
+static bool mergeSets(uint64_t *destination, const uint64_t *source, size_t wordCount) {
+    bool changed = false;
+
+    for (size_t i = 0;i < wordCount;++i) {
+        uint64_t merged = destination[i] | source[i];
+        changed |= (merged != destination[i]);
+        destination[i] = merged;
+    }
+
+    return changed;
+}
+
+static void computeNullable(ga_Grammar *grammar) {
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        for (uint32_t p = 0;p < grammar->productionCount;++p) {
+            const ga_Production *production = &grammar->productions[p];
+
+            if (grammar->nullable[production->rule]) {
+                continue;
+            }
+
+            const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+            bool nullable = true;
+
+            for (uint32_t i = 0;nullable && i < production->length;++i) {
+                nullable = ga_isRule(grammar, symbols[i]) && grammar->nullable[ga_getRule(grammar, symbols[i])];
+            }
+
+            if (nullable) {
+                grammar->nullable[production->rule] = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+static void computeFirst(ga_Grammar *grammar) {
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        for (uint32_t p = 0;p < grammar->productionCount;++p) {
+            const ga_Production *production = &grammar->productions[p];
+            const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+            uint64_t *first = ga_getFirst(grammar, production->rule);
+
+            for (uint32_t i = 0;i < production->length;++i) {
+                if (!ga_isRule(grammar, symbols[i])) {
+                    changed |= !ga_setContains(first, symbols[i]);
+                    ga_setAdd(first, symbols[i]);
+                    break;
+                }
+
+                uint32_t rule = ga_getRule(grammar, symbols[i]);
+                changed |= mergeSets(first, ga_getFirst(grammar, rule), grammar->setWordCount);
+
+                if (!grammar->nullable[rule]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Computes FOLLOW sets, each production is read from its end with the set of terminals that can follow its suffix.
+ */
+static void computeFollow(ga_Grammar *grammar, uint64_t *trailer) {
+    size_t wordCount = grammar->setWordCount;
+    ga_setAdd(ga_getFollow(grammar, grammar->entry), grammar->endTerminal);
+
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        for (uint32_t p = 0;p < grammar->productionCount;++p) {
+            const ga_Production *production = &grammar->productions[p];
+            const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+
+            memcpy(trailer, ga_getFollow(grammar, production->rule), wordCount * sizeof(*trailer));
+
+            for (uint32_t i = production->length;i > 0;--i) {
+                ga_Symbol symbol = symbols[i - 1];
+
+                if (!ga_isRule(grammar, symbol)) {
+                    memset(trailer, 0, wordCount * sizeof(*trailer));
+                    ga_setAdd(trailer, symbol);
+                    continue;
+                }
+
+                uint32_t rule = ga_getRule(grammar, symbol);
+                changed |= mergeSets(ga_getFollow(grammar, rule), trailer, wordCount);
+
+                if (!grammar->nullable[rule]) {
+                    memset(trailer, 0, wordCount * sizeof(*trailer));
+                }
+
+                mergeSets(trailer, ga_getFirst(grammar, rule), wordCount);
+            }
+        }
+    }
+}
+
+prs_ErrCode ga_createGrammar(ga_Grammar *grammar, fg_Grammar *g, const lex_Lexer *lexer) {
+    assert(grammar);
+    assert(g);
+    assert(lexer);
+
+    memset(grammar, 0, sizeof(*grammar));
+    ar_createArena(&grammar->arena, ANALYSIS_ARENA_CHUNK_SIZE);
+    grammar->g = g;
+    grammar->lexer = lexer;
+
+    if (!g->entry || g->rules.size == 0) {
+        return FG_NO_RULE;
+    }
+
+    size_t productionCount;
+    size_t symbolCount;
+    countSymbols(g, &productionCount, &symbolCount);
+
+    grammar->endTerminal = (uint32_t) lexer->terminals.size;
+    grammar->terminalCount = grammar->endTerminal + 1;
+    grammar->ruleCount = (uint32_t) g->rules.size;
+    grammar->entry = g->entry->index;
+    grammar->productionCount = (uint32_t) productionCount;
+    grammar->symbolCount = symbolCount;
+    grammar->setWordCount = (grammar->terminalCount + 63) / 64;
+
+    size_t setSize = grammar->ruleCount * grammar->setWordCount;
+
+    grammar->productions = ar_calloc(&grammar->arena, productionCount + 1, sizeof(*grammar->productions));
+    grammar->firstProductions = ar_calloc(&grammar->arena, grammar->ruleCount + 1, sizeof(*grammar->firstProductions));
+    grammar->symbols = ar_calloc(&grammar->arena, symbolCount + 1, sizeof(*grammar->symbols));
+    grammar->nullable = ar_calloc(&grammar->arena, grammar->ruleCount, sizeof(*grammar->nullable));
+    grammar->first = ar_calloc(&grammar->arena, setSize, sizeof(*grammar->first));
+    grammar->follow = ar_calloc(&grammar->arena, setSize, sizeof(*grammar->follow));
+    uint64_t *trailer = ar_calloc(&grammar->arena, grammar->setWordCount, sizeof(*trailer));
+
+    if (!grammar->productions || !grammar->firstProductions || !grammar->symbols || !grammar->nullable
+        || !grammar->first || !grammar->follow || !trailer) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    prs_ErrCode errCode = flattenRules(grammar);
+
+    if (errCode != PRS_OK) {
+        return errCode;
+    }
+
+    computeNullable(grammar);
+    computeFirst(grammar);
+    computeFollow(grammar, trailer);
+
+    return PRS_OK;
+}
+
+void ga_freeGrammar(ga_Grammar *grammar) {
+    if (grammar) {
+        ar_freeArena(&grammar->arena);
+        grammar->productions = NULL;
+        grammar->symbols = NULL;
+        grammar->productionCount = 0;
+        grammar->ruleCount = 0;
+    }
+}
+
+bool ga_addFirst(const ga_Grammar *grammar, const ga_Symbol *symbols, size_t length, uint64_t *set) {
+    assert(grammar);
+
+    for (size_t i = 0;i < length;++i) {
+        if (!ga_isRule(grammar, symbols[i])) {
+            ga_setAdd(set, symbols[i]);
+            return false;
+        }
+
+        uint32_t rule = ga_getRule(grammar, symbols[i]);
+        mergeSets(set, ga_getFirst(grammar, rule), grammar->setWordCount);
+
+        if (!grammar->nullable[rule]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const char *ga_getSymbolName(const ga_Grammar *grammar, ga_Symbol symbol) {
+    assert(grammar);
+
+    if (ga_isRule(grammar, symbol)) {
+        const fg_Rule *rule = *((fg_Rule**) vec_at(&grammar->g->rules, ga_getRule(grammar, symbol)));
+        return rule->name;
+    }
+
+    if (symbol == grammar->endTerminal) {
+        return "$end";
+    }
+
+    return lex_getTerminal(grammar->lexer, symbol)->name;
+}
@@ -0,0 +1,145 @@
+#ifndef GRAMMAR_ANALYSIS_H
+#define GRAMMAR_ANALYSIS_H
+
+/**
+ * @file
+ * Defines the flat form of a grammar's rules and their nullable, FIRST and FOLLOW sets.
+ *
+ * Production rules are copied into arrays of symbols : a symbol lower than
+ * terminalCount is a terminal of the lexer, the others are rules. String
+ * items and token items take the terminal the lexer gives them, so that
+ * symbols can be compared to the terminals of lexed tokens. The last terminal
+ * is the end of the input, it is not a terminal of the lexer.
+ *
+ * Productions of a rule are contiguous and keep their declaration order.
+ * Sets of terminals are bitsets of setWordCount words, one per rule.
+ */
+
+#include "collections/arena.h"
+#include "formal_grammar.h"
+#include "lexer.h"
+#include "parser_errors.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t ga_Symbol;
+
+typedef struct ga_Production {
+    uint32_t rule;
+    // Symbols of the production are symbols[start] to symbols[start + length - 1]
+    uint32_t start;
+    uint32_t length;
+} ga_Production;
+
+typedef struct ga_Grammar {
+    fg_Grammar *g;
+    const lex_Lexer *lexer;
+    // Terminals of the lexer and the end of the input
+    uint32_t terminalCount;
+    uint32_t endTerminal;
+    uint32_t ruleCount;
+    uint32_t entry;
+    ga_Production *productions;
+    uint32_t productionCount;
+    // Productions of rule r are firstProductions[r] to firstProductions[r + 1] - 1
+    uint32_t *firstProductions;
+    ga_Symbol *symbols;
+    size_t symbolCount;
+    bool *nullable;
+    uint64_t *first;
+    uint64_t *follow;
+    size_t setWordCount;
+    ar_Arena arena;
+} ga_Grammar;
+
+/**
+ * Checks if a symbol is a rule.
+ */
+#define ga_isRule(grammar, symbol) ((symbol) >= (grammar)->terminalCount)
+
+/**
+ * Gets the index of the rule of a symbol.
+ */
+#define ga_getRule(grammar, symbol) ((uint32_t) ((symbol) - (grammar)->terminalCount))
+
+/**
+ * Gets the symbol of a rule.
+ */
+#define ga_getRuleSymbol(grammar, rule) ((ga_Symbol) ((grammar)->terminalCount + (rule)))
+
+/**
+ * Gets a pointer to the first symbol of a production.
+ */
+#define ga_getProductionSymbols(grammar, production) \
+    ((grammar)->symbols + (grammar)->productions[production].start)
+
+/**
+ * Gets the FIRST set of a rule.
+ */
+#define ga_getFirst(grammar, rule) ((grammar)->first + (size_t) (rule) * (grammar)->setWordCount)
+
+/**
+ * Gets the FOLLOW set of a rule.
+ */
+#define ga_getFollow(grammar, rule) ((grammar)->follow + (size_t) (rule) * (grammar)->setWordCount)
+
+/**
+ * Checks if a set contains a terminal.
+ */
+#define ga_setContains(set, terminal) (((set)[(terminal) / 64] >> ((terminal) % 64)) & 1)
+
+/**
+ * Adds a terminal to a set.
+ */
+#define ga_setAdd(set, terminal) ((set)[(terminal) / 64] |= (uint64_t) 1 << ((terminal) % 64))
+
+/**
+ * Flattens the rules of a grammar and computes their nullable, FIRST and FOLLOW sets.
+ *
+ * Symbols of the grammar must have been resolved and the lexer must have been
+ * created from the same grammar. The flat grammar references both of them :
+ * it must not outlive them. The entry rule is the grammar's entry, the end of
+ * the input follows it.
+ *
+ * If the grammar has no rule, then FG_NO_RULE will be returned,
+ * FG_UNKNOWN_RULE or FG_UNKNOWN_TOKEN if an item has not been resolved.
+ *
+ * @param grammar a pointer to the flat grammar to create
+ * @param g a pointer to a resolved grammar
+ * @param lexer a pointer to the lexer of the grammar
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode ga_createGrammar(ga_Grammar *grammar, fg_Grammar *g, const lex_Lexer *lexer);
+
+/**
+ * Frees allocated memory for the given flat grammar.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param grammar a pointer to a flat grammar
+ */
+void ga_freeGrammar(ga_Grammar *grammar);
+
+/**
+ * Adds the FIRST set of a sequence of symbols to a set.
+ *
+ * @param grammar a pointer to a flat grammar
+ * @param symbols first symbol of the sequence
+ * @param length number of symbols of the sequence
+ * @param set set of setWordCount words that receives the terminals
+ * @return true if the sequence can derive the empty string
+ */
+bool ga_addFirst(const ga_Grammar *grammar, const ga_Symbol *symbols, size_t length, uint64_t *set);
+
+/**
+ * Gets the name of a symbol : the name of a rule or of a terminal, "$end" for the end of the input.
+ *
+ * @param grammar a pointer to a flat grammar
+ * @param symbol a valid symbol
+ * @return the name of the symbol
+ */
+const char *ga_getSymbolName(const ga_Grammar *grammar, ga_Symbol symbol);
+
+#endif // GRAMMAR_ANALYSIS_H
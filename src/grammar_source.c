@@ -0,0 +1,104 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "grammar_source.h"
+
+#include "parser.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool prs_openGrammarFile(prs_GrammarSource *source, const char *path) {
+    assert(source);
+    assert(path);
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) == -1) {
+        int savedErrno = errno;
+        close(fd);
+        errno = savedErrno;
+        return false;
+    }
+
+    // Empty regular files can not be mapped, some of them (ex: /proc) also
+    // report a null size while having a content.
+    if (S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+        size_t length = (size_t) fileStat.st_size;
+        void *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        int savedErrno = errno;
+
+        close(fd);
+
+        if (data == MAP_FAILED) {
+            errno = savedErrno;
+            return false;
+        }
+
+        // The scanner reads the grammar from the start to the end, only once
+        posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+
+        source->data = data;
+        source->length = length;
+        source->mapped = true;
+
+        return true;
+    }
+
+    FILE *stream = fdopen(fd, "r");
+
+    if (!stream) {
+        int savedErrno = errno;
+        close(fd);
+        errno = savedErrno;
+        return false;
+    }
+
+    bool result = prs_loadGrammarStream(source, stream);
+    fclose(stream);
+
+    return result;
+}
+
+bool prs_loadGrammarStream(prs_GrammarSource *source, FILE *stream) {
+    assert(source);
+    assert(stream);
+
+    char *buffer = NULL;
+    ssize_t length = prs_readGrammar(stream, &buffer);
+
+    if (length == -1) {
+        return false;
+    }
+
+    source->data = buffer;
+    source->length = (size_t) length;
+    source->mapped = false;
+
+    return true;
+}
+
+void prs_closeGrammarSource(prs_GrammarSource *source) {
+    if (source) {
+        if (source->mapped) {
+            munmap((void*) source->data, source->length);
+        }
+        else {
+            free((void*) source->data);
+        }
+
+        source->data = NULL;
+        source->length = 0;
+        source->mapped = false;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef GRAMMAR_SOURCE_H
+#define GRAMMAR_SOURCE_H
+
+/**
+ * @file
+ * Defines functions to load a raw grammar from a file or a stream.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * A read-only view on a raw grammar.
+ *
+ * Regular files are memory mapped : the view is borrowed from the
+ * mapping and it is not null terminated. Other inputs are read into
+ * a null terminated buffer owned by the structure.
+ */
+typedef struct prs_GrammarSource {
+    const char *data;
+    size_t length;
+    bool mapped;
+} prs_GrammarSource;
+
+/**
+ * Opens a grammar file.
+ *
+ * If the path refers to a regular file, then it will be mapped read-only
+ * in memory with a sequential access hint. Otherwise (pipes, character devices, ...)
+ * the content will be read with {@link prs_loadGrammarStream}.
+ *
+ * If the file can not be opened or read, then false will be returned
+ * and errno will describe the error.
+ *
+ * @param source a pointer to a grammar source
+ * @param path path to the grammar file
+ * @return true if the grammar has been loaded, otherwise false
+ */
+bool prs_openGrammarFile(prs_GrammarSource *source, const char *path);
+
+/**
+ * Reads a grammar from a stream.
+ *
+ * The whole stream is read into a buffer that grows geometrically.
+ * If an allocation error occurs then false will be returned.
+ *
+ * @param source a pointer to a grammar source
+ * @param stream input stream
+ * @return true if the grammar has been loaded, otherwise false
+ */
+bool prs_loadGrammarStream(prs_GrammarSource *source, FILE *stream);
+
+/**
+ * Releases the mapping or the buffer of the given grammar source.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param source a pointer to a grammar source
+ */
+void prs_closeGrammarSource(prs_GrammarSource *source);
+
+#endif // GRAMMAR_SOURCE_H
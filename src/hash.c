@@ -26,11 +26,13 @@ uint32_t murmurhash3_32(const void *key, size_t len) {
     //----------
     // body
 
-    const uint32_t * blocks = (const uint32_t *)(data + nblocks*4);
+    const uint8_t * blocks = data + nblocks*4;
 
     for(i = -nblocks; i; i++)
     {
-        uint32_t k1 = blocks[i];
+        // Keys are not always aligned (ex: names in a source)
+        uint32_t k1;
+        memcpy(&k1, blocks + i*4, sizeof(k1));
 
         k1 *= c1;
         k1 = rot132(k1,15);
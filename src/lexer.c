@@ -0,0 +1,422 @@
+#include "lexer.h"
+
+#include "nfa.h"
+#include "token_ir.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+#define LEXER_ARENA_CHUNK_SIZE 4096
+
+/**
+ * Builds the fragment of a normalized token.
+ */
+static bool buildTokenFragment(nfa_Automaton *nfa, const tir_Token *token, nfa_Fragment *fragment) {
+    bool built = (token->type == TIR_CLASS_TOKEN) ? nfa_charClass(nfa, &token->charClass, fragment)
+                                                 : nfa_literal(nfa, token->string, token->length, fragment);
+
+    return built && nfa_quantify(nfa, *fragment, token->quantifier, fragment);
+}
+
+static bool addTerminal(lex_Lexer *lexer, const char *name, fg_Token *token) {
+    lex_Terminal terminal = { .name = name, .token = token };
+
+    return vec_pushBack(&lexer->terminals, &terminal) != NULL;
+}
+
+/**
+ * Gives a terminal to a literal.
+ *
+ * A literal that is added for the first time gets the given terminal, otherwise
+ * pTerminal receives the one it already has.
+ */
+static bool addLiteral(lex_Lexer *lexer, const char *literal, uint32_t terminal, uint32_t *pTerminal) {
+    size_t length = strlen(literal);
+
+    // Empty strings can not be matched, their tokens are ignored by the set
+    if (length == 0) {
+        *pTerminal = LEX_NO_TERMINAL;
+        return true;
+    }
+
+    *pTerminal = lit_addLiteral(&lexer->literals, literal, length, terminal);
+
+    return *pTerminal != LIT_NONE;
+}
+
+/**
+ * Adds the tokens and the string items of a grammar as terminals.
+ */
+static bool collectTerminals(lex_Lexer *lexer, fg_Grammar *g) {
+    for (size_t i = 0;i < g->tokens.size;++i) {
+        fg_Token *token = *((fg_Token**) vec_at(&g->tokens, i));
+
+        if (!addTerminal(lexer, token->name, token)) {
+            return false;
+        }
+
+        uint32_t literalTerminal;
+
+        // String items with the same value use this token
+        if (token->type == FG_STRING_TOKEN && token->quantifier == PRS_NO_QUANTIFIER
+            && !addLiteral(lexer, token->value.string, token->index, &literalTerminal)) {
+            return false;
+        }
+    }
+
+    lexer->tokenCount = g->tokens.size;
+
+    for (size_t i = 0;i < g->rules.size;++i) {
+        fg_Rule *rule = *((fg_Rule**) vec_at(&g->rules, i));
+
+        ll_Iterator prIt = ll_createIterator(&rule->productionRuleList);
+
+        while (ll_iteratorHasNext(&prIt)) {
+            ll_Iterator it = ll_createIterator(ll_iteratorNext(&prIt));
+
+            while (ll_iteratorHasNext(&it)) {
+                fg_PRItem *prItem = ll_iteratorNext(&it);
+
+                if (prItem->type != FG_STRING_ITEM) {
+                    continue;
+                }
+
+                uint32_t terminal = (uint32_t) lexer->terminals.size;
+                uint32_t literalTerminal;
+
+                if (!addLiteral(lexer, prItem->value.string, terminal, &literalTerminal)) {
+                    return false;
+                }
+
+                if (literalTerminal == terminal && !addTerminal(lexer, prItem->value.string, NULL)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return lit_build(&lexer->literals);
+}
+
+/**
+ * Builds the nondeterministic automaton of all terminals and the rank of each terminal.
+ */
+static bool buildNfa(lex_Lexer *lexer, const tir_TokenSet *irTokens, nfa_Automaton *nfa, uint32_t **pRanks) {
+    size_t terminalCount = lexer->terminals.size;
+    uint32_t *ranks = ar_calloc(&lexer->arena, terminalCount, sizeof(*ranks));
+
+    if (!ranks && terminalCount > 0) {
+        return false;
+    }
+
+    // String items are tried before tokens, then tokens keep their declaration order
+    size_t literalOnlyCount = terminalCount - lexer->tokenCount;
+
+    for (size_t terminal = 0;terminal < terminalCount;++terminal) {
+        const lex_Terminal *lexTerminal = lex_getTerminal(lexer, terminal);
+        nfa_Fragment fragment;
+        bool built;
+
+        if (lexTerminal->token) {
+            ranks[terminal] = (uint32_t) (literalOnlyCount + terminal);
+
+            // A duplicate would always lose against its canonical token
+            if (tir_isDuplicate(irTokens, terminal)) {
+                continue;
+            }
+
+            built = buildTokenFragment(nfa, &irTokens->tokens[terminal], &fragment);
+        }
+        else {
+            ranks[terminal] = (uint32_t) (terminal - lexer->tokenCount);
+            built = nfa_literal(nfa, lexTerminal->name, strlen(lexTerminal->name), &fragment);
+        }
+
+        if (!built || !nfa_accept(nfa, fragment, (uint32_t) terminal)) {
+            return false;
+        }
+    }
+
+    *pRanks = ranks;
+
+    return true;
+}
+
+/**
+ * Creates a run scanner for each state that loops on itself.
+ */
+static bool createRunScanners(lex_Lexer *lexer) {
+    const dfa_Automaton *dfa = &lexer->dfa;
+    lexer->runScanners = ar_calloc(&lexer->arena, dfa->stateCount, sizeof(*lexer->runScanners));
+
+    if (!lexer->runScanners) {
+        return false;
+    }
+
+    // The dead state loops on every byte but it is never kept
+    for (uint32_t state = 1;state < dfa->stateCount;++state) {
+        prs_CharClass loop;
+        prs_clearCharClass(&loop);
+
+        for (int c = 0;c < 256;++c) {
+            if (dfa_step(dfa, state, c) == state) {
+                prs_addCharInterval(&loop, (uint8_t) c, (uint8_t) c);
+            }
+        }
+
+        if (prs_charClassIsEmpty(&loop)) {
+            continue;
+        }
+
+        rs_RunScanner *scanner = ar_alloc(&lexer->arena, sizeof(*scanner));
+
+        if (!scanner) {
+            return false;
+        }
+
+        rs_createRunScanner(scanner, &loop);
+        lexer->runScanners[state] = scanner;
+    }
+
+    return true;
+}
+
+/**
+ * Compiles the tokens of a grammar, the automaton is lazy if the cache has states.
+ */
+static prs_ErrCode createLexer(lex_Lexer *lexer, fg_Grammar *g, uint32_t cacheStateCount) {
+    assert(lexer);
+    assert(g);
+
+    memset(&lexer->dfa, 0, sizeof(lexer->dfa));
+    lexer->runScanners = NULL;
+    lexer->lazyDfa = NULL;
+    nfa_createAutomaton(&lexer->nfa);
+    ar_createArena(&lexer->arena, LEXER_ARENA_CHUNK_SIZE);
+    vec_createVector(&lexer->terminals, sizeof(lex_Terminal), 0, NULL);
+    lexer->tokenCount = 0;
+
+    if (!lit_createLiteralSet(&lexer->literals) || !collectTerminals(lexer, g)) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    tir_TokenSet irTokens;
+    prs_ErrCode errCode = tir_createTokenSet(&irTokens, g);
+
+    if (errCode != PRS_OK) {
+        return errCode;
+    }
+
+    uint32_t *ranks = NULL;
+    bool built = buildNfa(lexer, &irTokens, &lexer->nfa, &ranks);
+
+    tir_freeTokenSet(&irTokens);
+
+    if (!built) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    if (cacheStateCount > 0) {
+        // The automaton of a lazy lexer needs the NFA, the ranks are in the lexer's arena
+        lexer->lazyDfa = ar_alloc(&lexer->arena, sizeof(*lexer->lazyDfa));
+
+        if (!lexer->lazyDfa || !dfa_createLazyAutomaton(lexer->lazyDfa, &lexer->nfa, ranks, cacheStateCount)) {
+            lexer->lazyDfa = NULL;
+            return PRS_ALLOCATION_ERROR;
+        }
+
+        lexer->dfa.start = DFA_LAZY_START_STATE;
+
+        return PRS_OK;
+    }
+
+    built = dfa_createFromNfa(&lexer->dfa, &lexer->nfa, ranks) && dfa_minimize(&lexer->dfa);
+    nfa_freeAutomaton(&lexer->nfa);
+
+    if (!built || !createRunScanners(lexer)) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    return PRS_OK;
+}
+
+prs_ErrCode lex_createLexer(lex_Lexer *lexer, fg_Grammar *g) {
+    return createLexer(lexer, g, 0);
+}
+
+prs_ErrCode lex_createLazyLexer(lex_Lexer *lexer, fg_Grammar *g, uint32_t cacheStateCount) {
+    if (cacheStateCount < DFA_MIN_CACHE_STATE_COUNT) {
+        cacheStateCount = DFA_MIN_CACHE_STATE_COUNT;
+    }
+
+    return createLexer(lexer, g, cacheStateCount);
+}
+
+void lex_freeLexer(lex_Lexer *lexer) {
+    if (lexer) {
+        dfa_freeAutomaton(&lexer->dfa);
+        dfa_freeLazyAutomaton(lexer->lazyDfa);
+        nfa_freeAutomaton(&lexer->nfa);
+        vec_freeVector(&lexer->terminals, NULL);
+        lit_freeLiteralSet(&lexer->literals);
+        ar_freeArena(&lexer->arena);
+    }
+}
+
+const lex_Terminal *lex_getTerminal(const lex_Lexer *lexer, uint32_t terminal) {
+    assert(lexer);
+
+    return vec_at((vec_Vector*) &lexer->terminals, terminal);
+}
+
+uint32_t lex_getLiteralTerminal(const lex_Lexer *lexer, const char *literal) {
+    assert(lexer);
+    assert(literal);
+
+    return lit_find(&lexer->literals, literal, strlen(literal));
+}
+
+/**
+ * Moves a lazy automaton on an input, states are built when they are reached.
+ */
+static bool runLazyAutomaton(dfa_LazyAutomaton *dfa, const char *input, size_t length, size_t pos, uint32_t *pState,
+                             uint32_t *pTerminal, size_t *pEnd) {
+    uint32_t state = *pState;
+
+    for (size_t i = pos;i < length;) {
+        uint8_t c = (uint8_t) input[i++];
+        state = dfa_lazyStep(dfa, state, c);
+
+        // An allocation error in the cache stops the automaton like the dead state, its state tells them apart
+        if (state == DFA_DEAD_STATE || state == DFA_UNKNOWN_STATE) {
+            *pState = state;
+            return true;
+        }
+
+        if (dfa->accepts[state] != DFA_NO_TERMINAL) {
+            *pTerminal = dfa->accepts[state];
+            *pEnd = i;
+        }
+    }
+
+    *pState = state;
+
+    return false;
+}
+
+bool lex_runAutomaton(const lex_Lexer *lexer, const char *input, size_t length, size_t pos, uint32_t *pState,
+                      uint32_t *pTerminal, size_t *pEnd) {
+    assert(lexer);
+    assert(input || length == 0);
+    assert(pState);
+    assert(pTerminal);
+    assert(pEnd);
+
+    if (lexer->lazyDfa) {
+        return runLazyAutomaton(lexer->lazyDfa, input, length, pos, pState, pTerminal, pEnd);
+    }
+
+    const dfa_Automaton *dfa = &lexer->dfa;
+    uint32_t state = *pState;
+
+    // Longest match : the last accepting state is kept until the dead state
+    for (size_t i = pos;i < length;) {
+        state = dfa_step(dfa, state, input[i++]);
+
+        if (state == DFA_DEAD_STATE) {
+            *pState = state;
+            return true;
+        }
+
+        const rs_RunScanner *scanner = lexer->runScanners[state];
+
+        // Bytes of the run do not leave the state, the scanner is only called for runs of two bytes or more
+        if (scanner && i < length && dfa_step(dfa, state, input[i]) == state) {
+            i += 1 + rs_scanRun(scanner, input + i + 1, length - i - 1);
+        }
+
+        if (dfa->accepts[state] != DFA_NO_TERMINAL) {
+            *pTerminal = dfa->accepts[state];
+            *pEnd = i;
+        }
+    }
+
+    *pState = state;
+
+    return false;
+}
+
+lex_Result lex_nextToken(const lex_Lexer *lexer, const char *input, size_t length, size_t *pPos, lex_Token *token) {
+    assert(lexer);
+    assert(input || length == 0);
+    assert(pPos);
+    assert(token);
+
+    size_t pos = *pPos;
+
+    while (pos < length) {
+        uint32_t state = lexer->dfa.start;
+        uint32_t terminal = LEX_NO_TERMINAL;
+        size_t end = pos;
+
+        lex_runAutomaton(lexer, input, length, pos, &state, &terminal, &end);
+
+        if (state == DFA_UNKNOWN_STATE) {
+            *pPos = pos;
+            return LEX_ALLOCATION_ERROR;
+        }
+
+        if (terminal != LEX_NO_TERMINAL) {
+            token->terminal = terminal;
+            token->offset = pos;
+            token->length = end - pos;
+            *pPos = end;
+
+            return LEX_TOKEN;
+        }
+
+        if (!isspace((unsigned char) input[pos])) {
+            *pPos = pos;
+            return LEX_ERROR;
+        }
+
+        ++pos;
+    }
+
+    *pPos = pos;
+
+    return LEX_END;
+}
+
+ssize_t lex_tokenize(const lex_Lexer *lexer, const char *input, size_t length, vec_Vector *tokens, size_t *pErrorOffset) {
+    assert(lexer);
+    assert(tokens);
+
+    size_t pos = 0;
+    ssize_t tokenCount = 0;
+    lex_Token token;
+    lex_Result result;
+
+    while ((result = lex_nextToken(lexer, input, length, &pos, &token)) == LEX_TOKEN) {
+        if (!vec_pushBack(tokens, &token)) {
+            return LEX_TOKENIZE_ALLOCATION_ERROR;
+        }
+
+        ++tokenCount;
+    }
+
+    if (result == LEX_ERROR) {
+        if (pErrorOffset) {
+            *pErrorOffset = pos;
+        }
+
+        return LEX_TOKENIZE_ERROR;
+    }
+
+    if (result == LEX_ALLOCATION_ERROR) {
+        return LEX_TOKENIZE_ALLOCATION_ERROR;
+    }
+
+    return tokenCount;
+}
@@ -0,0 +1,208 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+/**
+ * @file
+ * Defines a lexer compiled from the tokens of a grammar.
+ *
+ * Terminals of the lexer are the grammar's tokens (a token's terminal is its
+ * index) followed by the string items of production rules that are not
+ * already declared as a token without quantifier.
+ *
+ * The lexer reads the longest match at each position. When several terminals
+ * match the same text, string items win over tokens, then the first declared
+ * token wins. Whitespaces that are not matched by a terminal are skipped.
+ *
+ * Tokens are normalized before being compiled (token_ir.h) : references are
+ * already flattened and a token defined like a previous one is not compiled
+ * again, since it can never win against it.
+ *
+ * States of the automaton that loop on themselves (ex: the state reached
+ * after a digit of `[0-9]+`) have a run scanner : the run of bytes that keep
+ * the lexer in this state is skipped with SIMD instead of one step per byte.
+ */
+
+#include "collections/arena.h"
+#include "collections/vector.h"
+#include "dfa.h"
+#include "formal_grammar.h"
+#include "literal_set.h"
+#include "nfa.h"
+#include "parser_errors.h"
+#include "run_scanner.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define LEX_NO_TERMINAL DFA_NO_TERMINAL
+
+// Results of lex_tokenize when the input has not been read until its end
+#define LEX_TOKENIZE_ERROR (-1)
+#define LEX_TOKENIZE_ALLOCATION_ERROR (-2)
+
+/**
+ * A terminal is either a token of the grammar or a string item.
+ */
+typedef struct lex_Terminal {
+    const char *name;
+    fg_Token *token;
+} lex_Terminal;
+
+typedef struct lex_Lexer {
+    // Only the start state is set for a lazy lexer
+    dfa_Automaton dfa;
+    // Automaton of a lexer created by lex_createLazyLexer, otherwise NULL
+    dfa_LazyAutomaton *lazyDfa;
+    // Kept for the lazy automaton only
+    nfa_Automaton nfa;
+    // Run scanner of each state, NULL if the state does not loop on itself
+    rs_RunScanner **runScanners;
+    vec_Vector terminals;
+    size_t tokenCount;
+    // Strings of the grammar : unquantified string tokens and string items
+    lit_LiteralSet literals;
+    ar_Arena arena;
+} lex_Lexer;
+
+typedef struct lex_Token {
+    uint32_t terminal;
+    size_t offset;
+    size_t length;
+} lex_Token;
+
+typedef enum lex_Result {
+    LEX_END,
+    LEX_TOKEN,
+    LEX_ERROR,
+    LEX_ALLOCATION_ERROR
+} lex_Result;
+
+/**
+ * Compiles the tokens of a grammar into a minimized deterministic automaton.
+ *
+ * Symbols of the grammar must have been resolved. The lexer references the
+ * grammar's tokens : it must not outlive the grammar.
+ *
+ * If tokens reference each other in a cycle, then FG_TOKEN_REF_CYCLE
+ * will be returned.
+ *
+ * The lexer must be freed with lex_freeLexer even if an error is returned,
+ * the parts built before the error are kept in it.
+ *
+ * @param lexer a pointer to the lexer to create
+ * @param g a pointer to a resolved grammar
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode lex_createLexer(lex_Lexer *lexer, fg_Grammar *g);
+
+/**
+ * Compiles the tokens of a grammar into a lazy automaton.
+ *
+ * States are built while the input is read and kept in a cache of the given
+ * number of states (see dfa.h), so the memory of the lexer does not depend on
+ * the size of the whole automaton. Run scanners are not used. Counters of the
+ * cache are in lazyDfa->counters.
+ *
+ * The cache is modified by each read : a lazy lexer must be used by one reader
+ * (thread, stream, ...) at a time. It can not be given to cg_emitLexer and
+ * lex_tokenizeParallel reads with a single thread.
+ *
+ * As with lex_createLexer, the lexer must be freed even if an error is returned.
+ *
+ * @param lexer a pointer to the lexer to create
+ * @param g a pointer to a resolved grammar
+ * @param cacheStateCount number of states of the cache, ex: DFA_DEFAULT_CACHE_STATE_COUNT
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode lex_createLazyLexer(lex_Lexer *lexer, fg_Grammar *g, uint32_t cacheStateCount);
+
+/**
+ * Frees allocated memory for the given lexer.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param lexer a pointer to a lexer
+ */
+void lex_freeLexer(lex_Lexer *lexer);
+
+/**
+ * Gets a terminal of the lexer.
+ *
+ * @param lexer a pointer to a lexer
+ * @param terminal a valid terminal
+ * @return a pointer to the terminal
+ */
+const lex_Terminal *lex_getTerminal(const lex_Lexer *lexer, uint32_t terminal);
+
+/**
+ * Gets the terminal that matches a string item of a production rule.
+ *
+ * @param lexer a pointer to a lexer
+ * @param literal content of the string item (without backticks)
+ * @return the terminal or LEX_NO_TERMINAL if the literal is unknown
+ */
+uint32_t lex_getLiteralTerminal(const lex_Lexer *lexer, const char *literal);
+
+/**
+ * Moves the automaton of a lexer on an input until the dead state or the end of the input.
+ *
+ * The automaton starts from the given state, the last reached state is given back.
+ * If an accepting state is reached, pTerminal and pEnd receive its terminal and
+ * the position after its last byte, otherwise they are unchanged.
+ *
+ * If a state of a lazy automaton can not be allocated, then the automaton stops
+ * like in the dead state and pState receives DFA_UNKNOWN_STATE.
+ *
+ * @param lexer a pointer to a lexer
+ * @param input input text
+ * @param length length of the input
+ * @param pos position of the first byte to read
+ * @param pState pointer to the current state
+ * @param pTerminal pointer to the terminal of the last accepting state
+ * @param pEnd pointer to the end of the last accepting state
+ * @return true if the dead state has been reached or an allocation failed, false if the input has been read until
+ *         its end
+ */
+bool lex_runAutomaton(const lex_Lexer *lexer, const char *input, size_t length, size_t pos, uint32_t *pState,
+                      uint32_t *pTerminal, size_t *pEnd);
+
+/**
+ * Reads the next token of an input.
+ *
+ * The automaton goes through the input once, with one table lookup per
+ * byte or one run scanner call per run. The position is moved after the token. If no terminal matches the
+ * input at the position, then LEX_ERROR will be returned and the position
+ * will be the one of the unexpected byte. If the cache of a lazy lexer can not
+ * allocate a state, then LEX_ALLOCATION_ERROR will be returned and the position
+ * will be the one of the token being read.
+ *
+ * @param lexer a pointer to a lexer
+ * @param input input text
+ * @param length length of the input
+ * @param pPos pointer to the current position
+ * @param token a pointer to the token that will receive the match
+ * @return LEX_TOKEN if a token has been read, LEX_END at the end of the input, otherwise LEX_ERROR or
+ *         LEX_ALLOCATION_ERROR
+ */
+lex_Result lex_nextToken(const lex_Lexer *lexer, const char *input, size_t length, size_t *pPos, lex_Token *token);
+
+/**
+ * Reads all tokens of an input into a vector of lex_Token.
+ *
+ * If an unexpected byte is found, then LEX_TOKENIZE_ERROR will be returned and
+ * its offset will be given by pErrorOffset. If the vector can not grow or a
+ * state of a lazy lexer can not be allocated, then LEX_TOKENIZE_ALLOCATION_ERROR
+ * will be returned without offset. In both cases,
+ * the tokens before the error are in the vector.
+ *
+ * @param lexer a pointer to a lexer
+ * @param input input text
+ * @param length length of the input
+ * @param tokens vector of lex_Token
+ * @param pErrorOffset pointer that receives the offset of an unexpected byte, can be NULL
+ * @return number of read tokens, otherwise LEX_TOKENIZE_ERROR or LEX_TOKENIZE_ALLOCATION_ERROR
+ */
+ssize_t lex_tokenize(const lex_Lexer *lexer, const char *input, size_t length, vec_Vector *tokens, size_t *pErrorOffset);
+
+#endif // LEXER_H
@@ -0,0 +1,273 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "lexer_parallel.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct Chunk {
+    const lex_Lexer *lexer;
+    const char *input;
+    size_t length;
+    // Tokens of the chunk start in [start, end)
+    size_t start;
+    size_t end;
+
+    // Tokens read speculatively from the start of the chunk
+    vec_Vector tokens;
+    // Tokens read again while stitching, they are followed by the speculative ones from `first`
+    vec_Vector fixedTokens;
+    size_t first;
+
+    // Position of the first token after the chunk, or of the unexpected byte
+    size_t exit;
+    lex_Result result;
+
+    // Destination of the tokens of the chunk
+    lex_Token *output;
+
+    // Thread that runs the chunk, if it has been started
+    pthread_t thread;
+    bool started;
+} Chunk;
+
+/**
+ * Reads the tokens that start in a chunk from the given position.
+ *
+ * If known tokens are given, the reading stops at the first token that starts at the
+ * same position as one of them : LEX_TOKEN is returned and pFirst receives its index.
+ * Otherwise the exit position of the chunk is given and LEX_END, LEX_ERROR or
+ * LEX_ALLOCATION_ERROR is returned.
+ */
+static lex_Result lexChunk(const Chunk *chunk, size_t pos, vec_Vector *tokens, vec_Vector *known, size_t *pFirst,
+                           size_t *pExit) {
+    size_t knownIndex = 0;
+
+    while (true) {
+        lex_Token token;
+        lex_Result result = lex_nextToken(chunk->lexer, chunk->input, chunk->length, &pos, &token);
+
+        if (result == LEX_END) {
+            *pExit = pos;
+            return LEX_END;
+        }
+
+        if (result == LEX_ERROR) {
+            *pExit = pos;
+            // The unexpected byte belongs to the next chunk
+            return (pos < chunk->end) ? LEX_ERROR : LEX_END;
+        }
+
+        if (result == LEX_ALLOCATION_ERROR) {
+            return LEX_ALLOCATION_ERROR;
+        }
+
+        if (token.offset >= chunk->end) {
+            *pExit = token.offset;
+            return LEX_END;
+        }
+
+        if (known) {
+            while (knownIndex < known->size && ((lex_Token*) vec_at(known, knownIndex))->offset < token.offset) {
+                ++knownIndex;
+            }
+
+            if (knownIndex < known->size && ((lex_Token*) vec_at(known, knownIndex))->offset == token.offset) {
+                *pFirst = knownIndex;
+                return LEX_TOKEN;
+            }
+        }
+
+        if (!vec_pushBack(tokens, &token)) {
+            return LEX_ALLOCATION_ERROR;
+        }
+    }
+}
+
+static void *lexSpeculatively(void *args) {
+    Chunk *chunk = args;
+    chunk->result = lexChunk(chunk, chunk->start, &chunk->tokens, NULL, NULL, &chunk->exit);
+
+    return NULL;
+}
+
+static void *copyTokens(void *args) {
+    Chunk *chunk = args;
+    size_t fixedSize = chunk->fixedTokens.size * sizeof(lex_Token);
+
+    if (fixedSize > 0) {
+        memcpy(chunk->output, chunk->fixedTokens.data, fixedSize);
+    }
+
+    if (chunk->first < chunk->tokens.size) {
+        memcpy(chunk->output + chunk->fixedTokens.size, vec_at(&chunk->tokens, chunk->first),
+               (chunk->tokens.size - chunk->first) * sizeof(lex_Token));
+    }
+
+    return NULL;
+}
+
+/**
+ * Runs a function on each chunk, the first chunk is run by the calling thread.
+ *
+ * A chunk is run by the calling thread if its thread can not be created.
+ */
+static void runChunks(Chunk *chunks, size_t chunkCount, void *(*function)(void*)) {
+    for (size_t i = 1;i < chunkCount;++i) {
+        chunks[i].started = (pthread_create(&chunks[i].thread, NULL, function, &chunks[i]) == 0);
+    }
+
+    function(&chunks[0]);
+
+    for (size_t i = 1;i < chunkCount;++i) {
+        if (chunks[i].started) {
+            pthread_join(chunks[i].thread, NULL);
+        }
+        else {
+            function(&chunks[i]);
+        }
+    }
+}
+
+/**
+ * Fixes the first tokens of each chunk from the exit of the previous one.
+ *
+ * @return number of chunks until the first error (included)
+ */
+static size_t stitchChunks(Chunk *chunks, size_t chunkCount) {
+    chunks[0].first = 0;
+
+    for (size_t i = 1;i < chunkCount;++i) {
+        const Chunk *previous = &chunks[i - 1];
+
+        if (previous->result != LEX_END) {
+            return i;
+        }
+
+        Chunk *chunk = &chunks[i];
+        size_t pos = previous->exit;
+
+        // A token of the previous chunk goes over this one
+        if (pos >= chunk->end) {
+            chunk->first = chunk->tokens.size;
+            chunk->exit = pos;
+            chunk->result = LEX_END;
+            continue;
+        }
+
+        if (chunk->result == LEX_ALLOCATION_ERROR) {
+            return i + 1;
+        }
+
+        size_t first, exitPos;
+        lex_Result result = lexChunk(chunk, pos, &chunk->fixedTokens, &chunk->tokens, &first, &exitPos);
+
+        if (result == LEX_TOKEN) {
+            chunk->first = first;
+        }
+        else {
+            chunk->first = chunk->tokens.size;
+            chunk->exit = exitPos;
+            chunk->result = result;
+        }
+    }
+
+    return chunkCount;
+}
+
+unsigned lex_getThreadCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count < 1) ? 1 : (unsigned) count;
+}
+
+ssize_t lex_tokenizeParallel(const lex_Lexer *lexer, const char *input, size_t length, unsigned threadCount,
+                             vec_Vector *tokens, size_t *pErrorOffset) {
+    assert(lexer);
+    assert(tokens);
+    assert(tokens->elementSize == sizeof(lex_Token));
+
+    if (threadCount == 0) {
+        threadCount = lex_getThreadCount();
+    }
+
+    size_t chunkCount = length / LEX_PARALLEL_MIN_CHUNK_SIZE;
+
+    if (chunkCount > threadCount) {
+        chunkCount = threadCount;
+    }
+
+    // The cache of a lazy automaton can not be shared
+    if (chunkCount <= 1 || lexer->lazyDfa) {
+        return lex_tokenize(lexer, input, length, tokens, pErrorOffset);
+    }
+
+    Chunk *chunks = malloc(chunkCount * sizeof(Chunk));
+
+    if (!chunks) {
+        return LEX_TOKENIZE_ALLOCATION_ERROR;
+    }
+
+    st_recordAllocation(chunkCount * sizeof(Chunk));
+
+    for (size_t i = 0;i < chunkCount;++i) {
+        Chunk *chunk = &chunks[i];
+        *chunk = (Chunk) { .lexer = lexer, .input = input, .length = length,
+                           .start = length / chunkCount * i,
+                           .end = (i + 1 == chunkCount) ? length : length / chunkCount * (i + 1),
+                           .first = 0, .exit = length, .result = LEX_END, .output = NULL, .started = false };
+
+        vec_createVector(&chunk->tokens, sizeof(lex_Token), 0, NULL);
+        vec_createVector(&chunk->fixedTokens, sizeof(lex_Token), 0, NULL);
+    }
+
+    runChunks(chunks, chunkCount, lexSpeculatively);
+    size_t usedChunkCount = stitchChunks(chunks, chunkCount);
+
+    const Chunk *last = &chunks[usedChunkCount - 1];
+    size_t tokenCount = 0;
+
+    for (size_t i = 0;i < usedChunkCount;++i) {
+        tokenCount += chunks[i].fixedTokens.size + chunks[i].tokens.size - chunks[i].first;
+    }
+
+    ssize_t result = LEX_TOKENIZE_ALLOCATION_ERROR;
+
+    if (last->result != LEX_ALLOCATION_ERROR && vec_reserve(tokens, tokens->size + tokenCount)) {
+        lex_Token *output = (lex_Token*) tokens->data + tokens->size;
+
+        for (size_t i = 0;i < usedChunkCount;++i) {
+            chunks[i].output = output;
+            output += chunks[i].fixedTokens.size + chunks[i].tokens.size - chunks[i].first;
+        }
+
+        runChunks(chunks, usedChunkCount, copyTokens);
+        tokens->size += tokenCount;
+
+        if (last->result == LEX_ERROR) {
+            if (pErrorOffset) {
+                *pErrorOffset = last->exit;
+            }
+
+            result = LEX_TOKENIZE_ERROR;
+        }
+        else {
+            result = (ssize_t) tokenCount;
+        }
+    }
+
+    for (size_t i = 0;i < chunkCount;++i) {
+        vec_freeVector(&chunks[i].tokens, NULL);
+        vec_freeVector(&chunks[i].fixedTokens, NULL);
+    }
+
+    free(chunks);
+
+    return result;
+}
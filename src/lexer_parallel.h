@@ -0,0 +1,57 @@
+#ifndef LEXER_PARALLEL_H
+#define LEXER_PARALLEL_H
+
+/**
+ * @file
+ * Defines a lexer that reads a large input with several threads.
+ *
+ * The input is split into one chunk per thread. Between two tokens the
+ * automaton is always back to its start state, so the only unknown part of a
+ * chunk is the position of its first token : it can be in the middle of a
+ * token that started in the previous chunk. Each chunk is read speculatively,
+ * as if a token started at its first byte.
+ *
+ * Chunks are then stitched in order : the true lexing continues from the end
+ * of the previous chunk until it reaches a token that the speculative lexing
+ * has also read. From this token, both lexings go through the same positions
+ * and the speculative tokens are kept. A few tokens are usually read again
+ * for each chunk, the whole chunk is read again if they never meet.
+ *
+ * Tokens and errors are the same as lex_tokenize.
+ */
+
+#include "collections/vector.h"
+#include "lexer.h"
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Chunks are not split below this size, the threads would cost more than the lexing
+#define LEX_PARALLEL_MIN_CHUNK_SIZE 4096
+
+/**
+ * Gets the number of threads that can run at the same time.
+ *
+ * @return number of online processors, at least 1
+ */
+unsigned lex_getThreadCount(void);
+
+/**
+ * Reads all tokens of an input into a vector of lex_Token with several threads.
+ *
+ * Fewer threads are used if chunks would be smaller than
+ * LEX_PARALLEL_MIN_CHUNK_SIZE, a single one for a lazy lexer. Errors are the
+ * ones of lex_tokenize, the tokens before an unexpected byte are in the vector.
+ *
+ * @param lexer a pointer to a lexer
+ * @param input input text
+ * @param length length of the input
+ * @param threadCount maximum number of threads, 0 for lex_getThreadCount()
+ * @param tokens vector of lex_Token
+ * @param pErrorOffset pointer that receives the offset of an unexpected byte, can be NULL
+ * @return number of read tokens, otherwise LEX_TOKENIZE_ERROR or LEX_TOKENIZE_ALLOCATION_ERROR
+ */
+ssize_t lex_tokenizeParallel(const lex_Lexer *lexer, const char *input, size_t length, unsigned threadCount,
+                             vec_Vector *tokens, size_t *pErrorOffset);
+
+#endif // LEXER_PARALLEL_H
@@ -0,0 +1,298 @@
+#include "lexer_stream.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool emitToken(lex_Stream *stream, uint32_t terminal, size_t offset, const char *text, size_t length) {
+    lex_Token token = { .terminal = terminal, .offset = offset, .length = length };
+
+    if (stream->callback) {
+        stream->callback(&token, text, stream->args);
+    }
+    else if (!vec_pushBack(stream->args, &token)) {
+        return false;
+    }
+
+    ++stream->tokenCount;
+
+    return true;
+}
+
+static lex_Result setError(lex_Stream *stream, lex_Result error, size_t offset) {
+    stream->error = error;
+    stream->errorOffset = offset;
+
+    return error;
+}
+
+/**
+ * Grows a buffer so that it can hold the given number of bytes.
+ */
+static bool reserve(char **pBuffer, size_t *pCapacity, size_t capacity) {
+    if (capacity <= *pCapacity) {
+        return true;
+    }
+
+    size_t newCapacity = (*pCapacity < 64) ? 64 : *pCapacity;
+
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    char *buffer = realloc(*pBuffer, newCapacity);
+
+    if (!buffer) {
+        return false;
+    }
+
+    st_recordAllocation(newCapacity);
+
+    *pBuffer = buffer;
+    *pCapacity = newCapacity;
+
+    return true;
+}
+
+static bool appendPending(lex_Stream *stream, const char *bytes, size_t length) {
+    if (!reserve(&stream->pending, &stream->pendingCapacity, stream->pendingLength + length)) {
+        return false;
+    }
+
+    memcpy(stream->pending + stream->pendingLength, bytes, length);
+    stream->pendingLength += length;
+
+    return true;
+}
+
+/**
+ * Reads the tokens of a buffer whose first byte starts a token.
+ *
+ * If the input is not final, the last token is kept as pending when the
+ * automaton has not reached its dead state at the end of the buffer.
+ */
+static lex_Result lexBuffer(lex_Stream *stream, const char *data, size_t length, size_t offset, bool final) {
+    const lex_Lexer *lexer = stream->lexer;
+    size_t pos = 0;
+
+    while (pos < length) {
+        uint32_t state = lexer->dfa.start;
+        uint32_t terminal = LEX_NO_TERMINAL;
+        size_t end = pos;
+
+        bool dead = lex_runAutomaton(lexer, data, length, pos, &state, &terminal, &end);
+
+        if (state == DFA_UNKNOWN_STATE) {
+            return setError(stream, LEX_ALLOCATION_ERROR, offset + pos);
+        }
+
+        if (!dead && !final) {
+            // The next chunk may continue the token
+            stream->pendingLength = 0;
+
+            if (!appendPending(stream, data + pos, length - pos)) {
+                return setError(stream, LEX_ALLOCATION_ERROR, offset + pos);
+            }
+
+            stream->pendingOffset = offset + pos;
+            stream->state = state;
+            stream->terminal = terminal;
+            stream->matchLength = end - pos;
+
+            return LEX_END;
+        }
+
+        if (terminal != LEX_NO_TERMINAL) {
+            if (!emitToken(stream, terminal, offset + pos, data + pos, end - pos)) {
+                return setError(stream, LEX_ALLOCATION_ERROR, offset + pos);
+            }
+
+            pos = end;
+        }
+        else if (isspace((unsigned char) data[pos])) {
+            ++pos;
+        }
+        else {
+            return setError(stream, LEX_ERROR, offset + pos);
+        }
+    }
+
+    return LEX_END;
+}
+
+/**
+ * Reads again the pending bytes after the first pending token (or skipped byte).
+ *
+ * Pending bytes are moved to the spare buffer, so that the new pending token
+ * can be written while they are read.
+ */
+static lex_Result relexPending(lex_Stream *stream, size_t consumed, bool final) {
+    char *bytes = stream->pending;
+    size_t capacity = stream->pendingCapacity;
+    size_t length = stream->pendingLength;
+    size_t offset = stream->pendingOffset;
+
+    stream->pending = stream->spare;
+    stream->pendingCapacity = stream->spareCapacity;
+    stream->pendingLength = 0;
+    stream->spare = bytes;
+    stream->spareCapacity = capacity;
+
+    return lexBuffer(stream, bytes + consumed, length - consumed, offset + consumed, final);
+}
+
+/**
+ * Ends the pending token, the automaton has reached its dead state after it.
+ *
+ * @return the number of bytes of the chunk that belong to the token
+ */
+static lex_Result closePending(lex_Stream *stream, const char *chunk, size_t *pConsumed, bool final) {
+    *pConsumed = 0;
+
+    // The token also takes bytes of the chunk
+    if (stream->terminal != LEX_NO_TERMINAL && stream->matchLength > stream->pendingLength) {
+        size_t tail = stream->matchLength - stream->pendingLength;
+
+        if (!appendPending(stream, chunk, tail)) {
+            return setError(stream, LEX_ALLOCATION_ERROR, stream->offset);
+        }
+
+        if (!emitToken(stream, stream->terminal, stream->pendingOffset, stream->pending, stream->matchLength)) {
+            return setError(stream, LEX_ALLOCATION_ERROR, stream->pendingOffset);
+        }
+
+        stream->pendingLength = 0;
+        *pConsumed = tail;
+
+        return LEX_END;
+    }
+
+    size_t consumed;
+
+    if (stream->terminal != LEX_NO_TERMINAL) {
+        if (!emitToken(stream, stream->terminal, stream->pendingOffset, stream->pending, stream->matchLength)) {
+            return setError(stream, LEX_ALLOCATION_ERROR, stream->pendingOffset);
+        }
+
+        consumed = stream->matchLength;
+    }
+    else if (isspace((unsigned char) stream->pending[0])) {
+        consumed = 1;
+    }
+    else {
+        return setError(stream, LEX_ERROR, stream->pendingOffset);
+    }
+
+    // Bytes after the token start the next one, the chunk will be read again
+    return relexPending(stream, consumed, final);
+}
+
+void lex_createStream(lex_Stream *stream, const lex_Lexer *lexer, lex_TokenCallback *callback, void *args) {
+    assert(stream);
+    assert(lexer);
+    assert(callback || args);
+
+    *stream = (lex_Stream) {
+            .lexer = lexer,
+            .callback = callback,
+            .args = args,
+            .pending = NULL,
+            .pendingLength = 0,
+            .pendingCapacity = 0,
+            .pendingOffset = 0,
+            .spare = NULL,
+            .spareCapacity = 0,
+            .state = lexer->dfa.start,
+            .terminal = LEX_NO_TERMINAL,
+            .matchLength = 0,
+            .offset = 0,
+            .tokenCount = 0,
+            .errorOffset = 0,
+            .error = LEX_END
+    };
+}
+
+void lex_freeStream(lex_Stream *stream) {
+    if (stream) {
+        free(stream->pending);
+        free(stream->spare);
+
+        stream->pending = stream->spare = NULL;
+        stream->pendingLength = stream->pendingCapacity = stream->spareCapacity = 0;
+    }
+}
+
+lex_Result lex_feedStream(lex_Stream *stream, const char *chunk, size_t length) {
+    assert(stream);
+    assert(chunk || length == 0);
+
+    if (stream->error != LEX_END) {
+        return stream->error;
+    }
+
+    size_t pos = 0;
+    lex_Result result = LEX_END;
+
+    while (result == LEX_END && stream->pendingLength > 0) {
+        uint32_t terminal = LEX_NO_TERMINAL;
+        size_t end = pos;
+
+        bool dead = lex_runAutomaton(stream->lexer, chunk, length, pos, &stream->state, &terminal, &end);
+
+        if (stream->state == DFA_UNKNOWN_STATE) {
+            result = setError(stream, LEX_ALLOCATION_ERROR, stream->pendingOffset);
+            break;
+        }
+
+        // The chunk position is relative to the pending bytes
+        if (terminal != LEX_NO_TERMINAL) {
+            stream->terminal = terminal;
+            stream->matchLength = stream->pendingLength + end - pos;
+        }
+
+        if (!dead) {
+            // The whole chunk belongs to the pending token
+            if (!appendPending(stream, chunk + pos, length - pos)) {
+                result = setError(stream, LEX_ALLOCATION_ERROR, stream->offset + pos);
+            }
+
+            pos = length;
+            break;
+        }
+
+        size_t consumed;
+        result = closePending(stream, chunk + pos, &consumed, false);
+        pos += consumed;
+    }
+
+    if (result == LEX_END && pos < length) {
+        result = lexBuffer(stream, chunk + pos, length - pos, stream->offset + pos, false);
+    }
+
+    stream->offset += length;
+
+    return result;
+}
+
+lex_Result lex_flushStream(lex_Stream *stream) {
+    assert(stream);
+
+    lex_Result result = stream->error;
+
+    // The end of the input is the dead state of the pending token
+    while (result == LEX_END && stream->pendingLength > 0) {
+        size_t consumed;
+        result = closePending(stream, NULL, &consumed, true);
+    }
+
+    stream->pendingLength = 0;
+    stream->state = stream->lexer->dfa.start;
+    stream->terminal = LEX_NO_TERMINAL;
+    stream->offset = 0;
+    stream->error = LEX_END;
+
+    return result;
+}
@@ -0,0 +1,104 @@
+#ifndef LEXER_STREAM_H
+#define LEXER_STREAM_H
+
+/**
+ * @file
+ * Defines a push-mode lexer : the input is given by chunks.
+ *
+ * Tokens are read as soon as they are complete and given to a callback.
+ * A token is complete when the automaton reaches its dead state, so the last
+ * token of a chunk is kept until the next chunk (or the flush) tells where it ends.
+ * Only the bytes of this pending token are copied, with the state of the
+ * automaton and its last match : the next chunk continues from there.
+ *
+ * Tokens and errors have the same results as lex_tokenize on the whole input.
+ */
+
+#include "collections/vector.h"
+#include "lexer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Receives a token of a stream.
+ *
+ * The offset of the token is its position from the start of the stream. The text
+ * of the token is only valid during the call : it can be in the chunk or in the
+ * pending bytes of the stream.
+ */
+typedef void lex_TokenCallback(const lex_Token *token, const char *text, void *args);
+
+typedef struct lex_Stream {
+    const lex_Lexer *lexer;
+    lex_TokenCallback *callback;
+    void *args;
+
+    // Bytes of the pending token, read from previous chunks
+    char *pending;
+    size_t pendingLength;
+    size_t pendingCapacity;
+    size_t pendingOffset;
+    // Pending bytes are moved to this buffer when they are read again
+    char *spare;
+    size_t spareCapacity;
+
+    // State of the automaton after the pending bytes and its last match
+    uint32_t state;
+    uint32_t terminal;
+    size_t matchLength;
+
+    // Position of the next chunk from the start of the stream
+    size_t offset;
+    size_t tokenCount;
+    size_t errorOffset;
+    lex_Result error;
+} lex_Stream;
+
+/**
+ * Creates a stream that gives its tokens to a callback.
+ *
+ * If the callback is NULL, then args must be a vector of lex_Token :
+ * tokens are pushed to it.
+ *
+ * @param stream a pointer to the stream to create
+ * @param lexer a pointer to a lexer, it must outlive the stream
+ * @param callback function called for each token, can be NULL
+ * @param args additional args given to the callback or a vector of lex_Token
+ */
+void lex_createStream(lex_Stream *stream, const lex_Lexer *lexer, lex_TokenCallback *callback, void *args);
+
+/**
+ * Frees allocated memory of a stream.
+ *
+ * @param stream a pointer to a stream
+ */
+void lex_freeStream(lex_Stream *stream);
+
+/**
+ * Reads the tokens of the next chunk of the input.
+ *
+ * The chunk is not kept after the call. Once an error has been returned,
+ * the stream returns it again.
+ *
+ * @param stream a pointer to a stream
+ * @param chunk bytes of the input, can be NULL if length is 0
+ * @param length number of bytes
+ * @return LEX_END if the chunk has been read, LEX_ERROR on an unexpected byte (see errorOffset)
+ *         or LEX_ALLOCATION_ERROR
+ */
+lex_Result lex_feedStream(lex_Stream *stream, const char *chunk, size_t length);
+
+/**
+ * Reads the pending token at the end of the input.
+ *
+ * The stream can be used for another input after this call.
+ *
+ * @param stream a pointer to a stream
+ * @return LEX_END if the input has been read, LEX_ERROR on an unexpected byte (see errorOffset)
+ *         or LEX_ALLOCATION_ERROR
+ */
+lex_Result lex_flushStream(lex_Stream *stream);
+
+#endif // LEXER_STREAM_H
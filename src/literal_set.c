@@ -0,0 +1,273 @@
+#include "literal_set.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROOT 0
+
+/**
+ * Children of a node before the set is built : a list of siblings.
+ */
+typedef struct Link {
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint8_t byte;
+} Link;
+
+static uint32_t addNode(lit_LiteralSet *set, uint8_t byte) {
+    lit_Node node = {
+            .terminal = LIT_NONE,
+            .firstEdge = 0,
+            .edgeCount = 0,
+            .dense = LIT_NONE
+    };
+
+    Link link = { .firstChild = LIT_NONE, .nextSibling = LIT_NONE, .byte = byte };
+
+    if (!vec_pushBack(&set->nodes, &node) || !vec_pushBack(&set->links, &link)) {
+        return LIT_NONE;
+    }
+
+    return (uint32_t) (set->nodes.size - 1);
+}
+
+static lit_Node *getNode(const lit_LiteralSet *set, uint32_t id) {
+    return ((lit_Node*) set->nodes.data) + id;
+}
+
+static Link *getLink(const lit_LiteralSet *set, uint32_t id) {
+    return ((Link*) set->links.data) + id;
+}
+
+bool lit_createLiteralSet(lit_LiteralSet *set) {
+    assert(set);
+
+    set->edgeBytes = NULL;
+    set->edgeTargets = NULL;
+    set->denseTables = NULL;
+    set->denseCount = 0;
+    set->literalCount = 0;
+    set->built = false;
+
+    vec_createVector(&set->nodes, sizeof(lit_Node), 0, NULL);
+    vec_createVector(&set->links, sizeof(Link), 0, NULL);
+
+    return addNode(set, 0) == ROOT;
+}
+
+void lit_freeLiteralSet(lit_LiteralSet *set) {
+    if (set) {
+        vec_freeVector(&set->nodes, NULL);
+        vec_freeVector(&set->links, NULL);
+        free(set->edgeBytes);
+        free(set->edgeTargets);
+        free(set->denseTables);
+
+        set->edgeBytes = NULL;
+        set->edgeTargets = NULL;
+        set->denseTables = NULL;
+        set->denseCount = 0;
+        set->literalCount = 0;
+    }
+}
+
+uint32_t lit_addLiteral(lit_LiteralSet *set, const char *literal, size_t length, uint32_t terminal) {
+    assert(set);
+    assert(literal);
+    assert(length > 0);
+    assert(!set->built);
+
+    uint32_t node = ROOT;
+
+    for (size_t i = 0;i < length;++i) {
+        uint8_t byte = (uint8_t) literal[i];
+        uint32_t child = getLink(set, node)->firstChild;
+
+        while (child != LIT_NONE && getLink(set, child)->byte != byte) {
+            child = getLink(set, child)->nextSibling;
+        }
+
+        if (child == LIT_NONE) {
+            child = addNode(set, byte);
+
+            if (child == LIT_NONE) {
+                return LIT_NONE;
+            }
+
+            // The vector may have moved
+            getLink(set, child)->nextSibling = getLink(set, node)->firstChild;
+            getLink(set, node)->firstChild = child;
+        }
+
+        node = child;
+    }
+
+    lit_Node *last = getNode(set, node);
+
+    if (last->terminal == LIT_NONE) {
+        last->terminal = terminal;
+        ++set->literalCount;
+    }
+
+    return last->terminal;
+}
+
+/**
+ * Gets the child of a node for a byte, ROOT if there is none.
+ */
+static uint32_t getChild(const lit_LiteralSet *set, const lit_Node *node, uint8_t byte) {
+    if (node->dense != LIT_NONE) {
+        return set->denseTables[((size_t) node->dense << 8) | byte];
+    }
+
+    // Nodes are sparse when they have a few children
+    const uint8_t *bytes = set->edgeBytes + node->firstEdge;
+
+    for (uint32_t i = 0;i < node->edgeCount;++i) {
+        if (bytes[i] == byte) {
+            return set->edgeTargets[node->firstEdge + i];
+        }
+
+        if (bytes[i] > byte) {
+            break;
+        }
+    }
+
+    return ROOT;
+}
+
+/**
+ * Stores the children of each node in the edge arrays, sorted by byte.
+ */
+static bool buildEdges(lit_LiteralSet *set) {
+    size_t nodeCount = set->nodes.size;
+    size_t edgeCount = nodeCount - 1;
+
+    set->edgeBytes = malloc(edgeCount + 1);
+    set->edgeTargets = malloc((edgeCount + 1) * sizeof(*set->edgeTargets));
+
+    if (!set->edgeBytes || !set->edgeTargets) {
+        return false;
+    }
+
+    st_recordAllocation(edgeCount + 1);
+    st_recordAllocation((edgeCount + 1) * sizeof(*set->edgeTargets));
+
+    size_t denseCount = 0;
+    uint32_t nextEdge = 0;
+
+    for (uint32_t id = 0;id < nodeCount;++id) {
+        lit_Node *node = getNode(set, id);
+        node->firstEdge = nextEdge;
+
+        // Insertion sort of the children by byte, lists are short
+        for (uint32_t child = getLink(set, id)->firstChild;child != LIT_NONE;child = getLink(set, child)->nextSibling) {
+            uint8_t byte = getLink(set, child)->byte;
+            uint32_t pos = nextEdge++;
+
+            while (pos > node->firstEdge && set->edgeBytes[pos - 1] > byte) {
+                set->edgeBytes[pos] = set->edgeBytes[pos - 1];
+                set->edgeTargets[pos] = set->edgeTargets[pos - 1];
+                --pos;
+            }
+
+            set->edgeBytes[pos] = byte;
+            set->edgeTargets[pos] = child;
+        }
+
+        node->edgeCount = nextEdge - node->firstEdge;
+
+        if (id == ROOT || node->edgeCount >= LIT_DENSE_MIN_EDGES) {
+            node->dense = (uint32_t) denseCount++;
+        }
+    }
+
+    set->denseTables = calloc(denseCount << 8, sizeof(*set->denseTables));
+    set->denseCount = denseCount;
+
+    if (!set->denseTables) {
+        return false;
+    }
+
+    st_recordAllocation((denseCount << 8) * sizeof(*set->denseTables));
+
+    for (uint32_t id = 0;id < nodeCount;++id) {
+        const lit_Node *node = getNode(set, id);
+
+        if (node->dense == LIT_NONE) {
+            continue;
+        }
+
+        uint32_t *table = set->denseTables + ((size_t) node->dense << 8);
+
+        for (uint32_t i = 0;i < node->edgeCount;++i) {
+            table[set->edgeBytes[node->firstEdge + i]] = set->edgeTargets[node->firstEdge + i];
+        }
+    }
+
+    return true;
+}
+
+bool lit_build(lit_LiteralSet *set) {
+    assert(set);
+    assert(!set->built);
+
+    if (!buildEdges(set)) {
+        return false;
+    }
+
+    vec_freeVector(&set->links, NULL);
+    set->built = true;
+
+    return true;
+}
+
+uint32_t lit_find(const lit_LiteralSet *set, const char *literal, size_t length) {
+    assert(set);
+    assert(set->built);
+    assert(literal || length == 0);
+
+    uint32_t id = ROOT;
+
+    for (size_t i = 0;i < length;++i) {
+        id = getChild(set, getNode(set, id), (uint8_t) literal[i]);
+
+        if (id == ROOT) {
+            return LIT_NONE;
+        }
+    }
+
+    return getNode(set, id)->terminal;
+}
+
+size_t lit_longestMatch(const lit_LiteralSet *set, const char *input, size_t length, uint32_t *pTerminal) {
+    assert(set);
+    assert(set->built);
+    assert(input || length == 0);
+    assert(pTerminal);
+
+    size_t matchLength = 0;
+    uint32_t id = ROOT;
+
+    *pTerminal = LIT_NONE;
+
+    for (size_t i = 0;i < length;++i) {
+        id = getChild(set, getNode(set, id), (uint8_t) input[i]);
+
+        if (id == ROOT) {
+            break;
+        }
+
+        const lit_Node *node = getNode(set, id);
+
+        if (node->terminal != LIT_NONE) {
+            *pTerminal = node->terminal;
+            matchLength = i + 1;
+        }
+    }
+
+    return matchLength;
+}
@@ -0,0 +1,113 @@
+#ifndef LITERAL_SET_H
+#define LITERAL_SET_H
+
+/**
+ * @file
+ * Defines a set of literals matched together (trie).
+ *
+ * Literals are the strings of the grammar : string tokens (%PLUS = `+`;) and
+ * string items of production rules. Each literal has a terminal.
+ *
+ * Literals are added to a trie, then the set is built : the children of a
+ * node are stored in a sorted array, hot nodes (the root and nodes with at
+ * least LIT_DENSE_MIN_EDGES children) get a dense table of 256 children.
+ * Each step costs a lookup in a dense table or a search in a few bytes, so
+ * the longest literal at a position is found in a time proportional to its
+ * length, whatever the number of literals.
+ */
+
+#include "collections/vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIT_NONE UINT32_MAX
+
+/**
+ * Minimum number of children of a node that gets a dense table.
+ */
+#define LIT_DENSE_MIN_EDGES 8
+
+typedef struct lit_Node {
+    uint32_t terminal;
+    uint32_t firstEdge;
+    uint32_t edgeCount;
+    // Index of the dense table, LIT_NONE for a sparse node
+    uint32_t dense;
+} lit_Node;
+
+typedef struct lit_LiteralSet {
+    vec_Vector nodes;
+    // Children of all nodes, sorted by byte, from firstEdge to firstEdge + edgeCount
+    uint8_t *edgeBytes;
+    uint32_t *edgeTargets;
+    // Dense tables of 256 children, 0 if there is no child (the root is never a child)
+    uint32_t *denseTables;
+    size_t denseCount;
+    // Children lists used before the set is built
+    vec_Vector links;
+    size_t literalCount;
+    bool built;
+} lit_LiteralSet;
+
+/**
+ * Creates an empty set of literals.
+ *
+ * @param set a pointer to a set
+ * @return true if the set has been created, otherwise false
+ */
+bool lit_createLiteralSet(lit_LiteralSet *set);
+
+/**
+ * Frees allocated memory of a set.
+ *
+ * @param set a pointer to a set
+ */
+void lit_freeLiteralSet(lit_LiteralSet *set);
+
+/**
+ * Adds a literal to a set that is not built yet.
+ *
+ * If the literal is already in the set, it keeps its terminal.
+ *
+ * @param set a pointer to a set
+ * @param literal a string, it is not kept
+ * @param length length of the string, greater than 0
+ * @param terminal terminal of the literal
+ * @return the terminal of the literal in the set or LIT_NONE if an allocation failed
+ */
+uint32_t lit_addLiteral(lit_LiteralSet *set, const char *literal, size_t length, uint32_t terminal);
+
+/**
+ * Builds the transition arrays and the dense tables of a set.
+ *
+ * No literal can be added after this call.
+ *
+ * @param set a pointer to a set
+ * @return true if the set has been built, otherwise false
+ */
+bool lit_build(lit_LiteralSet *set);
+
+/**
+ * Gets the terminal of a literal of a built set.
+ *
+ * @param set a pointer to a built set
+ * @param literal a string
+ * @param length length of the string
+ * @return the terminal or LIT_NONE if the string is not in the set
+ */
+uint32_t lit_find(const lit_LiteralSet *set, const char *literal, size_t length);
+
+/**
+ * Finds the longest literal at the start of an input.
+ *
+ * @param set a pointer to a built set
+ * @param input an input
+ * @param length length of the input
+ * @param pTerminal pointer that receives the terminal of the literal
+ * @return length of the literal, 0 if no literal matches
+ */
+size_t lit_longestMatch(const lit_LiteralSet *set, const char *input, size_t length, uint32_t *pTerminal);
+
+#endif // LITERAL_SET_H
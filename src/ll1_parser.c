@@ -0,0 +1,167 @@
+#include "ll1_parser.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LL1_STACK_CAPACITY 64
+
+/**
+ * Predicts a production for a terminal, or records a conflict if the cell already has one.
+ */
+static bool predict(ll1_Parser *parser, uint32_t production, uint32_t terminal) {
+    uint32_t rule = parser->grammar->productions[production].rule;
+    uint32_t *cell = &ll1_getPrediction(parser, rule, terminal);
+
+    if (*cell == LL1_NO_PRODUCTION) {
+        *cell = production;
+        return true;
+    }
+
+    ll1_Conflict conflict = { .rule = rule, .terminal = terminal, .productions = { *cell, production } };
+
+    return vec_pushBack(&parser->conflicts, &conflict) != NULL;
+}
+
+/**
+ * Fills the table with the terminals that predict each production.
+ */
+static bool fillTable(ll1_Parser *parser, uint64_t *set) {
+    const ga_Grammar *grammar = parser->grammar;
+
+    for (uint32_t p = 0;p < grammar->productionCount;++p) {
+        const ga_Production *production = &grammar->productions[p];
+
+        memset(set, 0, grammar->setWordCount * sizeof(*set));
+
+        if (ga_addFirst(grammar, ga_getProductionSymbols(grammar, p), production->length, set)) {
+            const uint64_t *follow = ga_getFollow(grammar, production->rule);
+
+            for (size_t i = 0;i < grammar->setWordCount;++i) {
+                set[i] |= follow[i];
+            }
+        }
+
+        for (uint32_t t = 0;t < grammar->terminalCount;++t) {
+            if (ga_setContains(set, t) && !predict(parser, p, t)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+prs_ErrCode ll1_createParser(ll1_Parser *parser, const ga_Grammar *grammar) {
+    assert(parser);
+    assert(grammar);
+
+    parser->grammar = grammar;
+    vec_createVector(&parser->conflicts, sizeof(ll1_Conflict), 0, NULL);
+    vec_createVector(&parser->stack, sizeof(ga_Symbol), LL1_STACK_CAPACITY, NULL);
+
+    size_t cellCount = (size_t) grammar->ruleCount * grammar->terminalCount;
+    parser->predictTable = malloc(cellCount * sizeof(*parser->predictTable));
+    uint64_t *set = malloc(grammar->setWordCount * sizeof(*set));
+
+    prs_ErrCode errCode = PRS_ALLOCATION_ERROR;
+
+    if (parser->predictTable && set) {
+        st_recordAllocation(cellCount * sizeof(*parser->predictTable) + grammar->setWordCount * sizeof(*set));
+
+        // Every byte of LL1_NO_PRODUCTION is 0xFF
+        memset(parser->predictTable, 0xFF, cellCount * sizeof(*parser->predictTable));
+
+        if (fillTable(parser, set)) {
+            errCode = (parser->conflicts.size > 0) ? LL1_GRAMMAR_CONFLICT : PRS_OK;
+        }
+    }
+
+    free(set);
+
+    return errCode;
+}
+
+void ll1_freeParser(ll1_Parser *parser) {
+    if (parser) {
+        free(parser->predictTable);
+        parser->predictTable = NULL;
+        vec_freeVector(&parser->conflicts, NULL);
+        vec_freeVector(&parser->stack, NULL);
+    }
+}
+
+ll1_Result ll1_parse(ll1_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *derivation, size_t *pErrorIndex) {
+    assert(parser);
+    assert(parser->predictTable);
+    assert(parser->conflicts.size == 0);
+    assert(tokens);
+
+    const ga_Grammar *grammar = parser->grammar;
+    vec_Vector *stack = &parser->stack;
+    vec_clear(stack, NULL);
+
+    ga_Symbol entry = ga_getRuleSymbol(grammar, grammar->entry);
+
+    if (!vec_pushBack(stack, &grammar->endTerminal) || !vec_pushBack(stack, &entry)) {
+        return LL1_ALLOCATION_ERROR;
+    }
+
+    size_t index = 0;
+
+    for (;;) {
+        uint32_t terminal = (index < tokens->size) ? tb_getTerminal(tokens, index) : grammar->endTerminal;
+        ga_Symbol top = *((ga_Symbol*) vec_at(stack, stack->size - 1));
+
+        if (!ga_isRule(grammar, top)) {
+            if (top != terminal) {
+                break;
+            }
+
+            if (terminal == grammar->endTerminal) {
+                return LL1_ACCEPTED;
+            }
+
+            --stack->size;
+            ++index;
+            continue;
+        }
+
+        uint32_t production = ll1_getPrediction(parser, ga_getRule(grammar, top), terminal);
+
+        if (production == LL1_NO_PRODUCTION) {
+            break;
+        }
+
+        if (derivation && !vec_pushBack(derivation, &production)) {
+            return LL1_ALLOCATION_ERROR;
+        }
+
+        // The rule is replaced by its symbols, the first one on top
+        const ga_Symbol *symbols = ga_getProductionSymbols(grammar, production);
+        uint32_t length = grammar->productions[production].length;
+        --stack->size;
+
+        if (stack->size + length > stack->capacity
+            && !vec_reserve(stack, (stack->size + length > 2 * stack->capacity) ? stack->size + length
+                                                                               : 2 * stack->capacity)) {
+            return LL1_ALLOCATION_ERROR;
+        }
+
+        ga_Symbol *slot = (ga_Symbol*) stack->data + stack->size;
+
+        for (uint32_t i = 0;i < length;++i) {
+            slot[i] = symbols[length - 1 - i];
+        }
+
+        stack->size += length;
+    }
+
+    if (pErrorIndex) {
+        *pErrorIndex = index;
+    }
+
+    return LL1_SYNTAX_ERROR;
+}
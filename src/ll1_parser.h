@@ -0,0 +1,103 @@
+#ifndef LL1_PARSER_H
+#define LL1_PARSER_H
+
+/**
+ * @file
+ * Defines a table-driven LL(1) parser of a flat grammar (grammar_analysis.h).
+ *
+ * The predict table has one row per rule and one column per terminal : it
+ * gives the production to expand when a rule is on top of the stack and a
+ * terminal is the next token. Production p of rule A is predicted for the
+ * terminals of FIRST(p), and of FOLLOW(A) if p can derive the empty string.
+ *
+ * Two productions predicted for the same cell are a conflict : the grammar is
+ * not LL(1). Conflicts are found when the table is built, a parser with
+ * conflicts can not parse.
+ *
+ * The parse does not recurse : rules and terminals waiting to be matched are
+ * kept on an explicit stack. Each token is read once, without backtracking.
+ */
+
+#include "collections/vector.h"
+#include "grammar_analysis.h"
+#include "parser_errors.h"
+#include "token_buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LL1_NO_PRODUCTION UINT32_MAX
+
+/**
+ * Cell of the predict table with two productions.
+ */
+typedef struct ll1_Conflict {
+    uint32_t rule;
+    uint32_t terminal;
+    // Production kept in the table and the one that has been rejected
+    uint32_t productions[2];
+} ll1_Conflict;
+
+typedef struct ll1_Parser {
+    const ga_Grammar *grammar;
+    // ruleCount rows of terminalCount productions
+    uint32_t *predictTable;
+    // Vector of ll1_Conflict
+    vec_Vector conflicts;
+    // Vector of ga_Symbol, kept between parses
+    vec_Vector stack;
+} ll1_Parser;
+
+typedef enum ll1_Result {
+    LL1_ACCEPTED,
+    LL1_SYNTAX_ERROR,
+    LL1_ALLOCATION_ERROR
+} ll1_Result;
+
+/**
+ * Gets the production predicted for a rule and a terminal, LL1_NO_PRODUCTION if there is none.
+ */
+#define ll1_getPrediction(parser, rule, terminal) \
+    ((parser)->predictTable[(size_t) (rule) * (parser)->grammar->terminalCount + (terminal)])
+
+/**
+ * Builds the predict table of a flat grammar.
+ *
+ * If two productions are predicted for the same rule and terminal, then
+ * LL1_GRAMMAR_CONFLICT will be returned : the parser is still created and its
+ * conflicts vector holds every conflicting cell, it must be freed.
+ *
+ * @param parser a pointer to the parser to create
+ * @param grammar a pointer to a flat grammar, it must outlive the parser
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode ll1_createParser(ll1_Parser *parser, const ga_Grammar *grammar);
+
+/**
+ * Frees allocated memory for the given parser.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param parser a pointer to a parser
+ */
+void ll1_freeParser(ll1_Parser *parser);
+
+/**
+ * Parses a sequence of tokens from the entry rule of the grammar.
+ *
+ * The productions of the leftmost derivation are added to the derivation
+ * vector : a preorder walk of the parse tree. The stack of the parser keeps
+ * its capacity, parsing inputs of similar sizes does not allocate it again.
+ *
+ * If a token is not expected, then LL1_SYNTAX_ERROR will be returned and
+ * pErrorIndex will receive its index, tokens->size if the input ended too soon.
+ *
+ * @param parser a pointer to a parser without conflicts
+ * @param tokens tokens of the input, lexed by the lexer of the grammar
+ * @param derivation vector of uint32_t that receives the productions, can be NULL
+ * @param pErrorIndex pointer that receives the index of an unexpected token, can be NULL
+ * @return LL1_ACCEPTED if the tokens have been parsed, otherwise a different result
+ */
+ll1_Result ll1_parse(ll1_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *derivation, size_t *pErrorIndex);
+
+#endif // LL1_PARSER_H
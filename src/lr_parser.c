@@ -0,0 +1,84 @@
+#include "lr_parser.h"
+
+#include <assert.h>
+
+#define LR_STACK_CAPACITY 64
+
+void lr_createParser(lr_Parser *parser, const lr_Table *table) {
+    assert(parser);
+    assert(table);
+
+    parser->table = table;
+    vec_createVector(&parser->stack, sizeof(uint32_t), LR_STACK_CAPACITY, NULL);
+}
+
+void lr_freeParser(lr_Parser *parser) {
+    if (parser) {
+        vec_freeVector(&parser->stack, NULL);
+    }
+}
+
+lr_Result lr_parse(lr_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *reductions, size_t *pErrorIndex) {
+    assert(parser);
+    assert(tokens);
+
+    const lr_Table *table = parser->table;
+    const ga_Grammar *grammar = table->grammar;
+    vec_Vector *stack = &parser->stack;
+    uint32_t state = 0;
+
+    vec_clear(stack, NULL);
+
+    if (!vec_pushBack(stack, &state)) {
+        return LR_ALLOCATION_ERROR;
+    }
+
+    size_t index = 0;
+    uint32_t terminal = (tokens->size > 0) ? tb_getTerminal(tokens, 0) : grammar->endTerminal;
+
+    for (;;) {
+        lr_Action action = lr_getAction(table, state, terminal);
+
+        switch (lr_getActionType(action)) {
+            case LR_SHIFT_ACTION:
+                state = lr_getActionValue(action);
+
+                if (!vec_pushBack(stack, &state)) {
+                    return LR_ALLOCATION_ERROR;
+                }
+
+                ++index;
+                terminal = (index < tokens->size) ? tb_getTerminal(tokens, index) : grammar->endTerminal;
+                break;
+            case LR_REDUCE_ACTION: {
+                uint32_t production = lr_getActionValue(action);
+                const ga_Production *reduced = &grammar->productions[production];
+
+                if (reductions && !vec_pushBack(reductions, &production)) {
+                    return LR_ALLOCATION_ERROR;
+                }
+
+                // Popping never frees, the state of the rule takes the slot of the first symbol
+                stack->size -= reduced->length;
+                state = *((uint32_t*) vec_at(stack, stack->size - 1));
+                action = lr_getAction(table, state, ga_getRuleSymbol(grammar, reduced->rule));
+                assert(lr_getActionType(action) == LR_SHIFT_ACTION);
+                state = lr_getActionValue(action);
+
+                if (!vec_pushBack(stack, &state)) {
+                    return LR_ALLOCATION_ERROR;
+                }
+
+                break;
+            }
+            case LR_ACCEPT_ACTION:
+                return LR_ACCEPTED;
+            default:
+                if (pErrorIndex) {
+                    *pErrorIndex = index;
+                }
+
+                return LR_SYNTAX_ERROR;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef LR_PARSER_H
+#define LR_PARSER_H
+
+/**
+ * @file
+ * Defines a shift-reduce parser driven by an LALR(1) table (lr_table.h).
+ *
+ * The parser keeps a stack of states : a shift pushes the state of the
+ * token, a reduction pops one state per symbol of its production and pushes
+ * the goto state of its rule. The loop does not recurse and the stack keeps
+ * its capacity between parses, so once it has grown to the depth of the
+ * inputs, parsing does not allocate.
+ */
+
+#include "collections/vector.h"
+#include "lr_table.h"
+#include "token_buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct lr_Parser {
+    const lr_Table *table;
+    // Vector of uint32_t states, kept between parses
+    vec_Vector stack;
+} lr_Parser;
+
+typedef enum lr_Result {
+    LR_ACCEPTED,
+    LR_SYNTAX_ERROR,
+    LR_ALLOCATION_ERROR
+} lr_Result;
+
+/**
+ * Creates a parser with an empty stack.
+ *
+ * @param parser a pointer to the parser to create
+ * @param table a pointer to a table, it must outlive the parser
+ */
+void lr_createParser(lr_Parser *parser, const lr_Table *table);
+
+/**
+ * Frees allocated memory for the given parser.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param parser a pointer to a parser
+ */
+void lr_freeParser(lr_Parser *parser);
+
+/**
+ * Parses a sequence of tokens from the entry rule of the grammar.
+ *
+ * The reduced productions are added to the reductions vector : the rightmost
+ * derivation in reverse order, a postorder walk of the parse tree.
+ *
+ * If a token is not expected, then LR_SYNTAX_ERROR will be returned and
+ * pErrorIndex will receive its index, tokens->size if the input ended too soon.
+ *
+ * @param parser a pointer to a parser
+ * @param tokens tokens of the input, lexed by the lexer of the grammar
+ * @param reductions vector of uint32_t that receives the productions, can be NULL
+ * @param pErrorIndex pointer that receives the index of an unexpected token, can be NULL
+ * @return LR_ACCEPTED if the tokens have been parsed, otherwise a different result
+ */
+lr_Result lr_parse(lr_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *reductions, size_t *pErrorIndex);
+
+#endif // LR_PARSER_H
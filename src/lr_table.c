@@ -0,0 +1,932 @@
+#include "lr_table.h"
+
+#include "collections/arena.h"
+#include "collections/hash_table.h"
+#include "hash.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LR_ARENA_CHUNK_SIZE (64 * 1024)
+
+// Symbol after the dot of a complete item
+#define NO_SYMBOL UINT32_MAX
+// Transition of a terminal, it has no lookahead set
+#define NO_RULE_TRANSITION UINT32_MAX
+
+/**
+ * Items of a state that are not added by the closure, sorted.
+ */
+typedef struct Kernel {
+    const uint32_t *items;
+    uint32_t length;
+} Kernel;
+
+typedef struct State {
+    Kernel kernel;
+    uint32_t transitionStart;
+    uint32_t transitionCount;
+    // Productions of the complete items
+    uint32_t reductionStart;
+    uint32_t reductionCount;
+} State;
+
+typedef struct Transition {
+    ga_Symbol symbol;
+    uint32_t target;
+    // Index of the follow set of a rule's transition
+    uint32_t ruleTransition;
+} Transition;
+
+typedef struct Edge {
+    uint32_t from;
+    uint32_t to;
+} Edge;
+
+/**
+ * Successors of each node : the ones of node n are targets[offsets[n]] to targets[offsets[n + 1] - 1].
+ */
+typedef struct Relation {
+    uint32_t *offsets;
+    uint32_t *targets;
+} Relation;
+
+typedef struct RowEntry {
+    uint32_t column;
+    lr_Action action;
+} RowEntry;
+
+typedef struct Row {
+    uint32_t state;
+    uint32_t start;
+    uint32_t length;
+} Row;
+
+typedef struct Builder {
+    const ga_Grammar *grammar;
+    // Production `S' = entry $end`, after the productions of the grammar
+    uint32_t startProduction;
+    ga_Symbol startSymbols[2];
+    // Items of production p are firstItems[p] (dot before the first symbol) to firstItems[p + 1] - 1
+    uint32_t *firstItems;
+    uint32_t itemCount;
+    ga_Symbol *itemSymbols;
+    uint32_t *itemProductions;
+    // The symbols after the dot can derive the empty string
+    bool *nullableSuffixes;
+    vec_Vector states;
+    vec_Vector transitions;
+    vec_Vector reductions;
+    ht_Table kernels;
+    vec_Vector closure;
+    vec_Vector pairs;
+    uint32_t *ruleStamps;
+    uint32_t stamp;
+    uint32_t ruleTransitionCount;
+    uint64_t *follows;
+    uint64_t *lookaheads;
+    ar_Arena arena;
+} Builder;
+
+static uint32_t kernelHash(const Kernel *kernel) {
+    return murmurhash3_32(kernel->items, kernel->length * sizeof(*kernel->items));
+}
+
+static int kernelComparator(const Kernel *k1, const Kernel *k2) {
+    return k1->length != k2->length || memcmp(k1->items, k2->items, k1->length * sizeof(*k1->items)) != 0;
+}
+
+static const ga_Symbol *getProductionSymbols(const Builder *builder, uint32_t production) {
+    return (production == builder->startProduction) ? builder->startSymbols
+                                                    : ga_getProductionSymbols(builder->grammar, production);
+}
+
+static uint32_t getProductionLength(const Builder *builder, uint32_t production) {
+    return (production == builder->startProduction) ? 2 : builder->grammar->productions[production].length;
+}
+
+/**
+ * Numbers the items of all productions, the start production included.
+ */
+static bool createItems(Builder *builder) {
+    const ga_Grammar *grammar = builder->grammar;
+    uint32_t productionCount = grammar->productionCount + 1;
+
+    builder->firstItems = ar_alloc(&builder->arena, (productionCount + 1) * sizeof(*builder->firstItems));
+
+    if (!builder->firstItems) {
+        return false;
+    }
+
+    uint32_t itemCount = 0;
+
+    for (uint32_t p = 0;p < productionCount;++p) {
+        builder->firstItems[p] = itemCount;
+        itemCount += getProductionLength(builder, p) + 1;
+    }
+
+    builder->firstItems[productionCount] = itemCount;
+    builder->itemCount = itemCount;
+    builder->itemSymbols = ar_alloc(&builder->arena, itemCount * sizeof(*builder->itemSymbols));
+    builder->itemProductions = ar_alloc(&builder->arena, itemCount * sizeof(*builder->itemProductions));
+    builder->nullableSuffixes = ar_alloc(&builder->arena, itemCount * sizeof(*builder->nullableSuffixes));
+
+    if (!builder->itemSymbols || !builder->itemProductions || !builder->nullableSuffixes) {
+        return false;
+    }
+
+    for (uint32_t p = 0;p < productionCount;++p) {
+        const ga_Symbol *symbols = getProductionSymbols(builder, p);
+        uint32_t length = getProductionLength(builder, p);
+        uint32_t first = builder->firstItems[p];
+
+        builder->itemSymbols[first + length] = NO_SYMBOL;
+        builder->itemProductions[first + length] = p;
+        builder->nullableSuffixes[first + length] = true;
+
+        for (uint32_t d = length;d > 0;--d) {
+            ga_Symbol symbol = symbols[d - 1];
+            bool nullable = ga_isRule(grammar, symbol) && grammar->nullable[ga_getRule(grammar, symbol)];
+
+            builder->itemSymbols[first + d - 1] = symbol;
+            builder->itemProductions[first + d - 1] = p;
+            builder->nullableSuffixes[first + d - 1] = nullable && builder->nullableSuffixes[first + d];
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the state of a kernel, the state is added if the kernel is new.
+ */
+static bool addState(Builder *builder, const uint32_t *items, uint32_t length, uint32_t *pState) {
+    Kernel query = { .items = items, .length = length };
+    void *value = ht_getValue(&builder->kernels, &query);
+
+    if (value) {
+        *pState = (uint32_t) ((uintptr_t) value - 1);
+        return true;
+    }
+
+    Kernel *kernel = ar_alloc(&builder->arena, sizeof(*kernel));
+    uint32_t *kernelItems = ar_alloc(&builder->arena, length * sizeof(*kernelItems));
+
+    if (!kernel || !kernelItems) {
+        return false;
+    }
+
+    memcpy(kernelItems, items, length * sizeof(*items));
+    kernel->items = kernelItems;
+    kernel->length = length;
+
+    State state = { .kernel = *kernel };
+    *pState = (uint32_t) builder->states.size;
+
+    if (!vec_pushBack(&builder->states, &state)) {
+        return false;
+    }
+
+    return ht_insertElement(&builder->kernels, kernel, (void*) ((uintptr_t) *pState + 1));
+}
+
+/**
+ * Adds to a kernel the first item of each production of the rules after a dot.
+ */
+static bool computeClosure(Builder *builder, const Kernel *kernel) {
+    const ga_Grammar *grammar = builder->grammar;
+    vec_Vector *closure = &builder->closure;
+    vec_clear(closure, NULL);
+    ++builder->stamp;
+
+    for (uint32_t i = 0;i < kernel->length;++i) {
+        if (!vec_pushBack(closure, &kernel->items[i])) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0;i < closure->size;++i) {
+        ga_Symbol symbol = builder->itemSymbols[*((uint32_t*) vec_at(closure, i))];
+
+        if (symbol == NO_SYMBOL || !ga_isRule(grammar, symbol)) {
+            continue;
+        }
+
+        uint32_t rule = ga_getRule(grammar, symbol);
+
+        if (builder->ruleStamps[rule] == builder->stamp) {
+            continue;
+        }
+
+        builder->ruleStamps[rule] = builder->stamp;
+
+        for (uint32_t p = grammar->firstProductions[rule];p < grammar->firstProductions[rule + 1];++p) {
+            if (!vec_pushBack(closure, &builder->firstItems[p])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static int pairComparator(const void *p1, const void *p2) {
+    const Transition *t1 = p1;
+    const Transition *t2 = p2;
+
+    if (t1->symbol != t2->symbol) {
+        return (t1->symbol < t2->symbol) ? -1 : 1;
+    }
+
+    return (t1->target < t2->target) ? -1 : (t1->target > t2->target);
+}
+
+/**
+ * Finds the reductions and the transitions of a state, the states it reaches are added.
+ */
+static bool expandState(Builder *builder, uint32_t stateIndex) {
+    Kernel kernel = ((State*) vec_at(&builder->states, stateIndex))->kernel;
+
+    if (!computeClosure(builder, &kernel)) {
+        return false;
+    }
+
+    // Pairs are a symbol and the item after its dot has moved
+    vec_Vector *pairs = &builder->pairs;
+    vec_clear(pairs, NULL);
+    uint32_t reductionStart = (uint32_t) builder->reductions.size;
+
+    for (size_t i = 0;i < builder->closure.size;++i) {
+        uint32_t item = *((uint32_t*) vec_at(&builder->closure, i));
+        ga_Symbol symbol = builder->itemSymbols[item];
+
+        if (symbol == NO_SYMBOL) {
+            if (!vec_pushBack(&builder->reductions, &builder->itemProductions[item])) {
+                return false;
+            }
+
+            continue;
+        }
+
+        Transition pair = { .symbol = symbol, .target = item + 1 };
+
+        if (!vec_pushBack(pairs, &pair)) {
+            return false;
+        }
+    }
+
+    if (pairs->size > 0) {
+        qsort(pairs->data, pairs->size, sizeof(Transition), pairComparator);
+    }
+
+    uint32_t transitionStart = (uint32_t) builder->transitions.size;
+    const Transition *sortedPairs = (const Transition*) pairs->data;
+    size_t i = 0;
+
+    // The closure is not needed anymore, it holds the kernel of each transition
+    while (i < pairs->size) {
+        ga_Symbol symbol = sortedPairs[i].symbol;
+        vec_clear(&builder->closure, NULL);
+
+        for (;i < pairs->size && sortedPairs[i].symbol == symbol;++i) {
+            if (!vec_pushBack(&builder->closure, &sortedPairs[i].target)) {
+                return false;
+            }
+        }
+
+        Transition transition = { .symbol = symbol, .ruleTransition = NO_RULE_TRANSITION };
+
+        if (!addState(builder, (const uint32_t*) builder->closure.data, (uint32_t) builder->closure.size,
+                      &transition.target)) {
+            return false;
+        }
+
+        if (ga_isRule(builder->grammar, symbol)) {
+            transition.ruleTransition = builder->ruleTransitionCount++;
+        }
+
+        if (!vec_pushBack(&builder->transitions, &transition)) {
+            return false;
+        }
+    }
+
+    State *state = vec_at(&builder->states, stateIndex);
+    state->transitionStart = transitionStart;
+    state->transitionCount = (uint32_t) builder->transitions.size - transitionStart;
+    state->reductionStart = reductionStart;
+    state->reductionCount = (uint32_t) builder->reductions.size - reductionStart;
+
+    return true;
+}
+
+/**
+ * Builds the LR(0) automaton from the kernel of the start production.
+ */
+static bool buildAutomaton(Builder *builder) {
+    uint32_t start;
+
+    if (!addState(builder, &builder->firstItems[builder->startProduction], 1, &start)) {
+        return false;
+    }
+
+    for (uint32_t s = 0;s < builder->states.size;++s) {
+        if (!expandState(builder, s)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the transition of a state for a symbol, transitions of a state are sorted by symbol.
+ */
+static const Transition *findTransition(Builder *builder, uint32_t stateIndex, ga_Symbol symbol) {
+    const State *state = vec_at(&builder->states, stateIndex);
+    const Transition *transitions = (const Transition*) builder->transitions.data + state->transitionStart;
+    uint32_t low = 0;
+    uint32_t high = state->transitionCount;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (transitions[middle].symbol < symbol) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    assert(low < state->transitionCount && transitions[low].symbol == symbol);
+
+    return &transitions[low];
+}
+
+/**
+ * Stores edges as lists of successors, with a counting sort on their origin.
+ */
+static bool createRelation(Builder *builder, const vec_Vector *edges, uint32_t nodeCount, Relation *relation) {
+    relation->offsets = ar_calloc(&builder->arena, nodeCount + 1, sizeof(*relation->offsets));
+    relation->targets = ar_alloc(&builder->arena, (edges->size + 1) * sizeof(*relation->targets));
+
+    if (!relation->offsets || !relation->targets) {
+        return false;
+    }
+
+    const Edge *edgeArray = (const Edge*) edges->data;
+
+    for (size_t i = 0;i < edges->size;++i) {
+        ++relation->offsets[edgeArray[i].from + 1];
+    }
+
+    for (uint32_t n = 0;n < nodeCount;++n) {
+        relation->offsets[n + 1] += relation->offsets[n];
+    }
+
+    uint32_t *positions = ar_alloc(&builder->arena, (nodeCount + 1) * sizeof(*positions));
+
+    if (!positions) {
+        return false;
+    }
+
+    memcpy(positions, relation->offsets, (nodeCount + 1) * sizeof(*positions));
+
+    for (size_t i = 0;i < edges->size;++i) {
+        relation->targets[positions[edgeArray[i].from]++] = edgeArray[i].to;
+    }
+
+    return true;
+}
+
+static void mergeSets(uint64_t *destination, const uint64_t *source, size_t wordCount) {
+    for (size_t i = 0;i < wordCount;++i) {
+        destination[i] |= source[i];
+    }
+}
+
+/**
+ * Makes the set of each node the union of the sets of the nodes it reaches.
+ *
+ * This is the digraph algorithm of DeRemer and Pennello, without recursion :
+ * the nodes of a strongly connected component all receive the set of its root.
+ */
+static bool digraph(Builder *builder, const Relation *relation, uint32_t nodeCount, uint64_t *sets) {
+    typedef struct Frame {
+        uint32_t node;
+        uint32_t depth;
+        uint32_t edge;
+    } Frame;
+
+    size_t wordCount = builder->grammar->setWordCount;
+    uint32_t *depths = ar_calloc(&builder->arena, nodeCount + 1, sizeof(*depths));
+    uint32_t *stack = ar_alloc(&builder->arena, (nodeCount + 1) * sizeof(*stack));
+    Frame *frames = ar_alloc(&builder->arena, (nodeCount + 1) * sizeof(*frames));
+
+    if (!depths || !stack || !frames) {
+        return false;
+    }
+
+    uint32_t stackSize = 0;
+    uint32_t frameCount = 0;
+
+    for (uint32_t root = 0;root < nodeCount;++root) {
+        if (depths[root] != 0) {
+            continue;
+        }
+
+        stack[stackSize++] = root;
+        depths[root] = stackSize;
+        frames[frameCount++] = (Frame) { .node = root, .depth = stackSize, .edge = relation->offsets[root] };
+
+        while (frameCount > 0) {
+            Frame *frame = &frames[frameCount - 1];
+            uint32_t x = frame->node;
+
+            if (frame->edge < relation->offsets[x + 1]) {
+                uint32_t y = relation->targets[frame->edge++];
+
+                if (depths[y] == 0) {
+                    stack[stackSize++] = y;
+                    depths[y] = stackSize;
+                    frames[frameCount++] = (Frame) { .node = y, .depth = stackSize, .edge = relation->offsets[y] };
+                    continue;
+                }
+
+                if (depths[y] < depths[x]) {
+                    depths[x] = depths[y];
+                }
+
+                mergeSets(sets + x * wordCount, sets + y * wordCount, wordCount);
+                continue;
+            }
+
+            // x is the root of a component : its nodes are on the stack above it
+            if (depths[x] == frame->depth) {
+                uint32_t top;
+
+                do {
+                    top = stack[--stackSize];
+                    depths[top] = UINT32_MAX;
+
+                    if (top != x) {
+                        memcpy(sets + top * wordCount, sets + x * wordCount, wordCount * sizeof(*sets));
+                    }
+                } while (top != x);
+            }
+
+            --frameCount;
+
+            if (frameCount > 0) {
+                uint32_t parent = frames[frameCount - 1].node;
+
+                if (depths[x] < depths[parent]) {
+                    depths[parent] = depths[x];
+                }
+
+                mergeSets(sets + parent * wordCount, sets + x * wordCount, wordCount);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Computes the Read sets : terminals shifted after a rule's transition, and after the nullable rules that follow it.
+ */
+static bool computeReadSets(Builder *builder, vec_Vector *edges) {
+    const ga_Grammar *grammar = builder->grammar;
+    const Transition *transitions = (const Transition*) builder->transitions.data;
+    vec_clear(edges, NULL);
+
+    for (size_t i = 0;i < builder->transitions.size;++i) {
+        if (transitions[i].ruleTransition == NO_RULE_TRANSITION) {
+            continue;
+        }
+
+        uint64_t *set = builder->follows + (size_t) transitions[i].ruleTransition * grammar->setWordCount;
+        const State *target = vec_at(&builder->states, transitions[i].target);
+
+        for (uint32_t t = 0;t < target->transitionCount;++t) {
+            const Transition *next = &transitions[target->transitionStart + t];
+
+            if (!ga_isRule(grammar, next->symbol)) {
+                ga_setAdd(set, next->symbol);
+            }
+            else if (grammar->nullable[ga_getRule(grammar, next->symbol)]) {
+                Edge edge = { .from = transitions[i].ruleTransition, .to = next->ruleTransition };
+
+                if (!vec_pushBack(edges, &edge)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    Relation reads;
+
+    return createRelation(builder, edges, builder->ruleTransitionCount, &reads)
+           && digraph(builder, &reads, builder->ruleTransitionCount, builder->follows);
+}
+
+/**
+ * Finds the reduction of a production in a state.
+ */
+static uint32_t findReduction(Builder *builder, uint32_t stateIndex, uint32_t production) {
+    const State *state = vec_at(&builder->states, stateIndex);
+    const uint32_t *reductions = (const uint32_t*) builder->reductions.data;
+
+    for (uint32_t r = state->reductionStart;r < state->reductionStart + state->reductionCount;++r) {
+        if (reductions[r] == production) {
+            return r;
+        }
+    }
+
+    assert(false);
+
+    return 0;
+}
+
+/**
+ * Follows each production of a rule from the state of the rule's transition.
+ *
+ * A rule of the production includes the transition when the symbols after it
+ * can derive the empty string, and the reduction at the end looks back to it.
+ */
+static bool addIncludes(Builder *builder, uint32_t origin, const Transition *transition, vec_Vector *edges,
+                        vec_Vector *lookbacks) {
+    const ga_Grammar *grammar = builder->grammar;
+    uint32_t rule = ga_getRule(grammar, transition->symbol);
+
+    for (uint32_t p = grammar->firstProductions[rule];p < grammar->firstProductions[rule + 1];++p) {
+        uint32_t first = builder->firstItems[p];
+        uint32_t length = grammar->productions[p].length;
+        uint32_t state = origin;
+
+        for (uint32_t d = 0;d < length;++d) {
+            const Transition *next = findTransition(builder, state, builder->itemSymbols[first + d]);
+
+            if (next->ruleTransition != NO_RULE_TRANSITION && builder->nullableSuffixes[first + d + 1]) {
+                Edge edge = { .from = next->ruleTransition, .to = transition->ruleTransition };
+
+                if (!vec_pushBack(edges, &edge)) {
+                    return false;
+                }
+            }
+
+            state = next->target;
+        }
+
+        Edge lookback = { .from = findReduction(builder, state, p), .to = transition->ruleTransition };
+
+        if (!vec_pushBack(lookbacks, &lookback)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Computes the Follow sets of rules' transitions, then the lookaheads of the reductions.
+ */
+static bool computeLookaheads(Builder *builder) {
+    const ga_Grammar *grammar = builder->grammar;
+    size_t wordCount = grammar->setWordCount;
+
+    builder->follows = ar_calloc(&builder->arena, (size_t) builder->ruleTransitionCount + 1,
+                                 wordCount * sizeof(*builder->follows));
+    builder->lookaheads = ar_calloc(&builder->arena, builder->reductions.size + 1,
+                                    wordCount * sizeof(*builder->lookaheads));
+
+    if (!builder->follows || !builder->lookaheads) {
+        return false;
+    }
+
+    vec_Vector edges;
+    vec_Vector lookbacks;
+    vec_createVector(&edges, sizeof(Edge), 0, NULL);
+    vec_createVector(&lookbacks, sizeof(Edge), 0, NULL);
+
+    bool computed = computeReadSets(builder, &edges);
+    vec_clear(&edges, NULL);
+
+    for (uint32_t s = 0;computed && s < builder->states.size;++s) {
+        const State *state = vec_at(&builder->states, s);
+
+        for (uint32_t t = 0;computed && t < state->transitionCount;++t) {
+            const Transition *transition = (const Transition*) builder->transitions.data + state->transitionStart + t;
+
+            if (transition->ruleTransition != NO_RULE_TRANSITION) {
+                computed = addIncludes(builder, s, transition, &edges, &lookbacks);
+            }
+        }
+    }
+
+    Relation includes;
+    computed = computed && createRelation(builder, &edges, builder->ruleTransitionCount, &includes)
+               && digraph(builder, &includes, builder->ruleTransitionCount, builder->follows);
+
+    for (size_t i = 0;computed && i < lookbacks.size;++i) {
+        const Edge *lookback = vec_at(&lookbacks, i);
+        mergeSets(builder->lookaheads + lookback->from * wordCount, builder->follows + lookback->to * wordCount,
+                  wordCount);
+    }
+
+    vec_freeVector(&edges, NULL);
+    vec_freeVector(&lookbacks, NULL);
+
+    return computed;
+}
+
+/**
+ * Sets the action of a cell, a conflict is resolved in favor of the shift or of the first production.
+ */
+static bool setAction(lr_Table *table, lr_Action *row, uint32_t state, uint32_t terminal, lr_Action action) {
+    lr_Action current = row[terminal];
+
+    if (current == LR_ERROR_ACTION) {
+        row[terminal] = action;
+        return true;
+    }
+
+    if (lr_getActionType(current) == LR_REDUCE_ACTION && lr_getActionValue(action) < lr_getActionValue(current)) {
+        row[terminal] = action;
+        action = current;
+    }
+
+    lr_Conflict conflict = { .state = state, .terminal = terminal, .actions = { row[terminal], action } };
+
+    return vec_pushBack(&table->conflicts, &conflict) != NULL;
+}
+
+/**
+ * Fills the row of a state, its most frequent reduction becomes its default action.
+ */
+static bool fillRow(Builder *builder, lr_Table *table, uint32_t stateIndex, lr_Action *row) {
+    const ga_Grammar *grammar = builder->grammar;
+    const State *state = vec_at(&builder->states, stateIndex);
+    uint32_t columnCount = grammar->terminalCount + grammar->ruleCount;
+
+    memset(row, 0, columnCount * sizeof(*row));
+
+    for (uint32_t t = 0;t < state->transitionCount;++t) {
+        const Transition *transition = (const Transition*) builder->transitions.data + state->transitionStart + t;
+
+        row[transition->symbol] = (transition->symbol == grammar->endTerminal)
+                                  ? lr_makeAction(LR_ACCEPT_ACTION, 0)
+                                  : lr_makeAction(LR_SHIFT_ACTION, transition->target);
+    }
+
+    lr_Action defaultAction = LR_ERROR_ACTION;
+    uint32_t defaultCount = 0;
+
+    for (uint32_t r = state->reductionStart;r < state->reductionStart + state->reductionCount;++r) {
+        uint32_t production = *((uint32_t*) vec_at(&builder->reductions, r));
+        const uint64_t *lookaheads = builder->lookaheads + (size_t) r * grammar->setWordCount;
+        lr_Action action = lr_makeAction(LR_REDUCE_ACTION, production);
+
+        for (uint32_t t = 0;t < grammar->terminalCount;++t) {
+            if (ga_setContains(lookaheads, t) && !setAction(table, row, stateIndex, t, action)) {
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t r = state->reductionStart;r < state->reductionStart + state->reductionCount;++r) {
+        lr_Action action = lr_makeAction(LR_REDUCE_ACTION, *((uint32_t*) vec_at(&builder->reductions, r)));
+        uint32_t count = 0;
+
+        for (uint32_t t = 0;t < grammar->terminalCount;++t) {
+            count += (row[t] == action);
+        }
+
+        if (count > defaultCount) {
+            defaultAction = action;
+            defaultCount = count;
+        }
+    }
+
+    table->defaultActions[stateIndex] = defaultAction;
+
+    for (uint32_t t = 0;defaultCount > 0 && t < grammar->terminalCount;++t) {
+        if (row[t] == defaultAction) {
+            row[t] = LR_ERROR_ACTION;
+        }
+    }
+
+    return true;
+}
+
+static int rowComparator(const void *p1, const void *p2) {
+    const Row *r1 = p1;
+    const Row *r2 = p2;
+
+    if (r1->length != r2->length) {
+        return (r1->length > r2->length) ? -1 : 1;
+    }
+
+    return (r1->state > r2->state) - (r1->state < r2->state);
+}
+
+/**
+ * Grows the packed arrays, new entries do not belong to any state.
+ */
+static bool reserveEntries(lr_Table *table, size_t *pCapacity, size_t capacity) {
+    if (capacity <= *pCapacity) {
+        return true;
+    }
+
+    size_t newCapacity = (capacity > 2 * *pCapacity) ? capacity : 2 * *pCapacity;
+    uint32_t *checks = realloc(table->checks, newCapacity * sizeof(*checks));
+
+    if (checks) {
+        table->checks = checks;
+        st_recordAllocation(newCapacity * sizeof(*checks));
+    }
+
+    lr_Action *values = realloc(table->values, newCapacity * sizeof(*values));
+
+    if (values) {
+        table->values = values;
+        st_recordAllocation(newCapacity * sizeof(*values));
+    }
+
+    if (!checks || !values) {
+        return false;
+    }
+
+    memset(checks + *pCapacity, 0xFF, (newCapacity - *pCapacity) * sizeof(*checks));
+    memset(values + *pCapacity, 0, (newCapacity - *pCapacity) * sizeof(*values));
+    *pCapacity = newCapacity;
+
+    return true;
+}
+
+/**
+ * Packs the rows, largest first, each one at the first offset where its entries are free.
+ */
+static bool packRows(lr_Table *table, Row *rows, const RowEntry *entries, uint32_t columnCount) {
+    size_t capacity = 0;
+    size_t end = columnCount;
+
+    if (!reserveEntries(table, &capacity, columnCount)) {
+        return false;
+    }
+
+    qsort(rows, table->stateCount, sizeof(*rows), rowComparator);
+
+    // Offsets below this one have no free entry
+    size_t firstFree = 0;
+
+    for (uint32_t i = 0;i < table->stateCount;++i) {
+        const Row *row = &rows[i];
+
+        if (row->length == 0) {
+            table->bases[row->state] = 0;
+            continue;
+        }
+
+        const RowEntry *rowEntries = entries + row->start;
+        size_t base = (firstFree > rowEntries[0].column) ? firstFree - rowEntries[0].column : 0;
+
+        for (;;) {
+            if (!reserveEntries(table, &capacity, base + columnCount)) {
+                return false;
+            }
+
+            uint32_t e = 0;
+
+            while (e < row->length && table->checks[base + rowEntries[e].column] == LR_NO_STATE) {
+                ++e;
+            }
+
+            if (e == row->length) {
+                break;
+            }
+
+            ++base;
+        }
+
+        table->bases[row->state] = (uint32_t) base;
+
+        for (uint32_t e = 0;e < row->length;++e) {
+            table->checks[base + rowEntries[e].column] = row->state;
+            table->values[base + rowEntries[e].column] = rowEntries[e].action;
+        }
+
+        while (firstFree < capacity && table->checks[firstFree] != LR_NO_STATE) {
+            ++firstFree;
+        }
+
+        if (base + columnCount > end) {
+            end = base + columnCount;
+        }
+    }
+
+    table->entryCount = end;
+
+    return true;
+}
+
+/**
+ * Fills the rows of all states and packs them into the table.
+ */
+static bool fillTable(Builder *builder, lr_Table *table) {
+    const ga_Grammar *grammar = builder->grammar;
+    uint32_t columnCount = grammar->terminalCount + grammar->ruleCount;
+
+    table->stateCount = (uint32_t) builder->states.size;
+    table->bases = malloc(table->stateCount * sizeof(*table->bases));
+    table->defaultActions = malloc(table->stateCount * sizeof(*table->defaultActions));
+
+    if (table->bases && table->defaultActions) {
+        st_recordAllocation(table->stateCount * (sizeof(*table->bases) + sizeof(*table->defaultActions)));
+    }
+
+    lr_Action *row = ar_alloc(&builder->arena, columnCount * sizeof(*row));
+    Row *rows = ar_alloc(&builder->arena, table->stateCount * sizeof(*rows));
+    vec_Vector entries;
+    vec_createVector(&entries, sizeof(RowEntry), 0, NULL);
+
+    bool filled = table->bases && table->defaultActions && row && rows;
+
+    for (uint32_t s = 0;filled && s < table->stateCount;++s) {
+        filled = fillRow(builder, table, s, row);
+        rows[s] = (Row) { .state = s, .start = (uint32_t) entries.size, .length = 0 };
+
+        for (uint32_t c = 0;filled && c < columnCount;++c) {
+            RowEntry entry = { .column = c, .action = row[c] };
+
+            if (row[c] != LR_ERROR_ACTION) {
+                filled = vec_pushBack(&entries, &entry) != NULL;
+                ++rows[s].length;
+            }
+        }
+    }
+
+    filled = filled && packRows(table, rows, (const RowEntry*) entries.data, columnCount);
+    vec_freeVector(&entries, NULL);
+
+    return filled;
+}
+
+prs_ErrCode lr_createTable(lr_Table *table, const ga_Grammar *grammar) {
+    assert(table);
+    assert(grammar);
+
+    memset(table, 0, sizeof(*table));
+    table->grammar = grammar;
+    vec_createVector(&table->conflicts, sizeof(lr_Conflict), 0, NULL);
+
+    Builder builder = { .grammar = grammar, .startProduction = grammar->productionCount,
+                        .startSymbols = { ga_getRuleSymbol(grammar, grammar->entry), grammar->endTerminal } };
+
+    ar_createArena(&builder.arena, LR_ARENA_CHUNK_SIZE);
+    vec_createVector(&builder.states, sizeof(State), 0, NULL);
+    vec_createVector(&builder.transitions, sizeof(Transition), 0, NULL);
+    vec_createVector(&builder.reductions, sizeof(uint32_t), 0, NULL);
+    vec_createVector(&builder.closure, sizeof(uint32_t), 0, NULL);
+    vec_createVector(&builder.pairs, sizeof(Transition), 0, NULL);
+    builder.ruleStamps = ar_calloc(&builder.arena, grammar->ruleCount + 1, sizeof(*builder.ruleStamps));
+
+    bool built = ht_createTable(&builder.kernels, 0, (ht_HashFunction*) kernelHash,
+                                (ht_KeyComparator*) kernelComparator, NULL);
+
+    built = built && builder.ruleStamps && createItems(&builder) && buildAutomaton(&builder) && computeLookaheads(&builder)
+            && fillTable(&builder, table);
+
+    ht_freeTable(&builder.kernels);
+    vec_freeVector(&builder.states, NULL);
+    vec_freeVector(&builder.transitions, NULL);
+    vec_freeVector(&builder.reductions, NULL);
+    vec_freeVector(&builder.closure, NULL);
+    vec_freeVector(&builder.pairs, NULL);
+    ar_freeArena(&builder.arena);
+
+    if (!built) {
+        lr_freeTable(table);
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    return PRS_OK;
+}
+
+void lr_freeTable(lr_Table *table) {
+    if (table) {
+        free(table->bases);
+        free(table->checks);
+        free(table->values);
+        free(table->defaultActions);
+        table->bases = NULL;
+        table->checks = NULL;
+        table->values = NULL;
+        table->defaultActions = NULL;
+        table->stateCount = 0;
+        table->entryCount = 0;
+        vec_freeVector(&table->conflicts, NULL);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef LR_TABLE_H
+#define LR_TABLE_H
+
+/**
+ * @file
+ * Defines the LALR(1) action and goto table of a flat grammar (grammar_analysis.h).
+ *
+ * The LR(0) automaton is built from the kernel of its start state : the
+ * kernels reached from each state are looked up in a hash table, so that each
+ * set of items gets one state. The grammar is augmented with a production
+ * `S' = entry $end`, shifting $end is the accept action.
+ *
+ * Lookaheads are computed with the relations of DeRemer and Pennello on the
+ * transitions of rules : the terminals read after a transition (reads), then
+ * the terminals that follow it (includes), are propagated with their digraph
+ * algorithm, each strongly connected component being merged once. A
+ * reduction gets the follow sets of the transitions it goes back to (lookback).
+ *
+ * Conflicts are resolved like yacc does : a shift wins over a reduction, and
+ * the first declared production wins over the other reductions. Every
+ * conflicting cell is reported.
+ *
+ * The table is compressed : the reduction found the most in a row becomes the
+ * default action of its state, and the remaining entries of all rows are
+ * packed into a single array, each row at the first offset where its entries
+ * do not collide with the other rows (row displacement). Gotos are shift
+ * entries in the columns of rules.
+ */
+
+#include "collections/vector.h"
+#include "grammar_analysis.h"
+#include "parser_errors.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LR_NO_STATE UINT32_MAX
+
+typedef uint32_t lr_Action;
+
+typedef enum lr_ActionType {
+    LR_ERROR_ACTION = 0,
+    LR_ACCEPT_ACTION,
+    LR_SHIFT_ACTION,
+    LR_REDUCE_ACTION
+} lr_ActionType;
+
+/**
+ * Cell of the table with two actions.
+ */
+typedef struct lr_Conflict {
+    uint32_t state;
+    uint32_t terminal;
+    // Action kept in the table and the one that has been rejected
+    lr_Action actions[2];
+} lr_Conflict;
+
+typedef struct lr_Table {
+    const ga_Grammar *grammar;
+    uint32_t stateCount;
+    // Entry of a state and a symbol is at bases[state] + symbol if its check is the state
+    uint32_t *bases;
+    uint32_t *checks;
+    lr_Action *values;
+    size_t entryCount;
+    // Action of a terminal without entry
+    lr_Action *defaultActions;
+    // Vector of lr_Conflict
+    vec_Vector conflicts;
+} lr_Table;
+
+/**
+ * Creates an action, the value is a state for a shift and a production for a reduction.
+ */
+#define lr_makeAction(type, value) ((lr_Action) (((value) << 2) | (type)))
+
+/**
+ * Gets the type of an action.
+ */
+#define lr_getActionType(action) ((lr_ActionType) ((action) & 3))
+
+/**
+ * Gets the state or the production of an action.
+ */
+#define lr_getActionValue(action) ((action) >> 2)
+
+/**
+ * Gets the action of a state for a symbol : a terminal or a rule (goto).
+ *
+ * Arguments are evaluated several times.
+ */
+#define lr_getAction(table, state, symbol) \
+    (((table)->checks[(table)->bases[state] + (symbol)] == (state)) ? (table)->values[(table)->bases[state] + (symbol)] \
+                                                                    : (table)->defaultActions[state])
+
+/**
+ * Builds the LALR(1) table of a flat grammar.
+ *
+ * Conflicts are resolved and added to the conflicts vector, the table can be
+ * used anyway.
+ *
+ * @param table a pointer to the table to create
+ * @param grammar a pointer to a flat grammar, it must outlive the table
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode lr_createTable(lr_Table *table, const ga_Grammar *grammar);
+
+/**
+ * Frees allocated memory for the given table.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param table a pointer to a table
+ */
+void lr_freeTable(lr_Table *table);
+
+#endif // LR_TABLE_H
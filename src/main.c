@@ -1,59 +1,845 @@
 #include "parser.h"
 
-#include "collections/linked_list.h"
+#include "collections/vector.h"
+#include "codegen.h"
+#include "earley.h"
 #include "log.h"
 #include "formal_grammar.h"
+#include "glr_parser.h"
+#include "grammar_analysis.h"
+#include "grammar_source.h"
+#include "lexer.h"
+#include "lexer_parallel.h"
+#include "lexer_stream.h"
+#include "ll1_parser.h"
+#include "lr_parser.h"
+#include "lr_table.h"
+#include "packrat.h"
 #include "parser_errors.h"
+#include "stats.h"
+#include "token_buffer.h"
 
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-int main(int argc, char **argv) {
-    char *grammarBuffer = NULL;
-    log_info("Loading grammar");
-    ssize_t grammarSize;
+typedef enum ParserType {
+    LL1_PARSER,
+    LALR_PARSER,
+    PACKRAT_PARSER,
+    EARLEY_PARSER,
+    GLR_PARSER
+} ParserType;
+
+typedef struct Options {
+    bool streaming;
+    bool stats;
+    bool jsonStats;
+    const char *path;
+    const char *lexPath;
+    const char *emitPath;
+    const char *parsePath;
+    ParserType parserType;
+    unsigned threadCount;
+    // States of the lazy automaton's cache, 0 for a full automaton
+    uint32_t cacheStateCount;
+} Options;
+
+static void printUsage(const char *program) {
+    fprintf(stderr, "Usage : %s [--stream] [--stats[=json]] [--lex input file] [--threads count] [--dfa-cache states] [--emit-lexer output file] [--parse input file] [--parser ll1|lalr|packrat|earley|glr] [grammar file]\n", program);
+}
+
+static bool parseOptions(Options *options, int argc, char **argv) {
+    *options = (Options) { .streaming = false, .stats = false, .jsonStats = false, .path = NULL,
+                           .lexPath = NULL, .emitPath = NULL, .parsePath = NULL, .parserType = LL1_PARSER,
+                           .threadCount = 1,
+                           .cacheStateCount = 0 };
+
+    for (int i = 1;i < argc;++i) {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--stream") == 0) {
+            options->streaming = true;
+        }
+        else if (strcmp(arg, "--stats") == 0) {
+            options->stats = true;
+        }
+        else if (strcmp(arg, "--stats=json") == 0) {
+            options->stats = options->jsonStats = true;
+        }
+        else if (strcmp(arg, "--lex") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            options->lexPath = argv[++i];
+        }
+        else if (strcmp(arg, "--threads") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            char *end;
+            unsigned long count = strtoul(argv[++i], &end, 10);
+
+            if (*end != '\0' || count > UINT_MAX) {
+                return false;
+            }
+
+            // 0 uses all processors
+            options->threadCount = (unsigned) count;
+        }
+        else if (strcmp(arg, "--dfa-cache") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            char *end;
+            unsigned long count = strtoul(argv[++i], &end, 10);
+
+            if (*end != '\0' || count == 0 || count > UINT32_MAX) {
+                return false;
+            }
 
-    if (argc > 1) {
-        FILE *f;
-        if ((f = fopen(argv[1], "r")) == NULL) {
-            log_error("Unable to open file : %s", strerror(errno));
-            return EXIT_FAILURE;
+            options->cacheStateCount = (uint32_t) count;
         }
+        else if (strcmp(arg, "--emit-lexer") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            options->emitPath = argv[++i];
+        }
+        else if (strcmp(arg, "--parse") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            options->parsePath = argv[++i];
+        }
+        else if (strcmp(arg, "--parser") == 0) {
+            if (i + 1 == argc) {
+                return false;
+            }
+
+            const char *name = argv[++i];
+
+            if (strcmp(name, "ll1") == 0) {
+                options->parserType = LL1_PARSER;
+            }
+            else if (strcmp(name, "lalr") == 0) {
+                options->parserType = LALR_PARSER;
+            }
+            else if (strcmp(name, "packrat") == 0) {
+                options->parserType = PACKRAT_PARSER;
+            }
+            else if (strcmp(name, "earley") == 0) {
+                options->parserType = EARLEY_PARSER;
+            }
+            else if (strcmp(name, "glr") == 0) {
+                options->parserType = GLR_PARSER;
+            }
+            else {
+                return false;
+            }
+        }
+        else if (strncmp(arg, "--", 2) == 0 || options->path) {
+            return false;
+        }
+        else {
+            options->path = arg;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Parses a grammar one declaration at a time, without loading the whole file.
+ */
+static int parseStream(fg_Grammar *g, const char *path, st_Report *report) {
+    FILE *stream = (path) ? fopen(path, "r") : stdin;
+
+    if (!stream) {
+        log_error("Unable to load grammar : %s", strerror(errno));
+        return -1;
+    }
+
+    log_info("Parsing grammar stream");
+    st_beginPhase(report, "parse stream");
+    int errCode = prs_parseGrammarStream(g, stream);
+    st_endPhase(report);
+
+    if (stream != stdin) {
+        fclose(stream);
+    }
 
-        grammarSize = prs_readGrammar(f, &grammarBuffer);
-        fclose(f);
+    return errCode;
+}
+
+/**
+ * Loads the whole grammar then extracts and parses its items.
+ */
+static int parseSource(fg_Grammar *g, const char *path, st_Report *report) {
+    prs_GrammarSource source;
+    log_info("Loading grammar");
+    bool loaded;
+
+    st_beginPhase(report, "load");
+
+    if (path) {
+        loaded = prs_openGrammarFile(&source, path);
     }
     else {
-        grammarSize = prs_readGrammar(stdin, &grammarBuffer);
+        loaded = prs_loadGrammarStream(&source, stdin);
     }
 
-    if (grammarSize == -1) {
-        perror("");
-        return 0;
+    st_endPhase(report);
+
+    if (!loaded) {
+        log_error("Unable to load grammar : %s", strerror(errno));
+        return -1;
     }
 
     log_info("Done.");
 
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor *) prs_freeStringItem);
+    // Items' strings share the grammar's arena
+    vec_Vector itemList;
+    vec_createVector(&itemList, sizeof(prs_StringItem), 1024, NULL);
 
     log_info("Extracting grammar items");
-    prs_extractGrammarItems(grammarBuffer, grammarSize, &itemList);
-
-    ll_Iterator it = ll_createIterator(&itemList);
-    prs_computeItemsPosition(grammarBuffer, &it);
+    st_beginPhase(report, "extract");
+    prs_extractGrammarItems(source.data, source.length, &itemList, &g->arena);
+    st_endPhase(report);
     log_info("Done.");
 
+    report->items = itemList.size;
+
     log_info("Parsing items");
+    st_beginPhase(report, "parse");
+    int errCode = prs_parseGrammarItems(g, &itemList);
+    st_endPhase(report);
+
+    vec_freeVector(&itemList, NULL);
+    prs_closeGrammarSource(&source);
+
+    return errCode;
+}
+
+/**
+ * Splits a mapped file into tokens.
+ */
+static int lexMappedFile(const lex_Lexer *lexer, const char *path, unsigned threadCount, st_Report *report) {
+    prs_GrammarSource input;
+
+    if (!prs_openGrammarFile(&input, path)) {
+        log_error("Unable to load input : %s", strerror(errno));
+        return -1;
+    }
+
+    vec_Vector tokens;
+    vec_createVector(&tokens, sizeof(lex_Token), 1024, NULL);
+    size_t errorOffset = 0;
+
+    st_beginPhase(report, "lex");
+    ssize_t tokenCount = (threadCount == 1)
+                         ? lex_tokenize(lexer, input.data, input.length, &tokens, &errorOffset)
+                         : lex_tokenizeParallel(lexer, input.data, input.length, threadCount, &tokens, &errorOffset);
+    st_endPhase(report);
+
+    for (size_t i = 0;i < tokens.size;++i) {
+        const lex_Token *token = vec_at(&tokens, i);
+        printf("%s\t%.*s\n", lex_getTerminal(lexer, token->terminal)->name, (int) token->length,
+               input.data + token->offset);
+    }
+
+    int errCode = PRS_OK;
+
+    if (tokenCount == LEX_TOKENIZE_ERROR) {
+        log_error("Unable to lex input at offset %zu", errorOffset);
+        errCode = -1;
+    }
+    else if (tokenCount == LEX_TOKENIZE_ALLOCATION_ERROR) {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&tokens, NULL);
+    prs_closeGrammarSource(&input);
+
+    return errCode;
+}
+
+static void printToken(const lex_Token *token, const char *text, void *args) {
+    const lex_Lexer *lexer = args;
+    printf("%s\t%.*s\n", lex_getTerminal(lexer, token->terminal)->name, (int) token->length, text);
+}
+
+/**
+ * Splits a file into tokens while it is read by chunks.
+ */
+static int lexFileStream(const lex_Lexer *lexer, const char *path, st_Report *report) {
+    FILE *file = fopen(path, "r");
+
+    if (!file) {
+        log_error("Unable to load input : %s", strerror(errno));
+        return -1;
+    }
+
+    char *chunk = malloc(PRS_STREAM_CHUNK_SIZE);
+
+    if (!chunk) {
+        fclose(file);
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    st_recordAllocation(PRS_STREAM_CHUNK_SIZE);
+
+    lex_Stream stream;
+    lex_createStream(&stream, lexer, printToken, (void*) lexer);
+
+    st_beginPhase(report, "lex stream");
+    lex_Result result = LEX_END;
+    size_t length;
+
+    while (result == LEX_END && (length = fread(chunk, 1, PRS_STREAM_CHUNK_SIZE, file)) > 0) {
+        result = lex_feedStream(&stream, chunk, length);
+    }
+
+    if (result == LEX_END) {
+        result = lex_flushStream(&stream);
+    }
+
+    st_endPhase(report);
+
+    int errCode = PRS_OK;
+
+    if (result == LEX_ERROR) {
+        log_error("Unable to lex input at offset %zu", stream.errorOffset);
+        errCode = -1;
+    }
+    else if (result == LEX_ALLOCATION_ERROR) {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    lex_freeStream(&stream);
+    free(chunk);
+    fclose(file);
+
+    return errCode;
+}
+
+/**
+ * Builds the lexer of the grammar, it is lazy if a cache size is given.
+ */
+static int buildLexer(lex_Lexer *lexer, fg_Grammar *g, const Options *options, st_Report *report) {
+    log_info("Building lexer");
+    st_beginPhase(report, "build lexer");
+    int errCode = (options->cacheStateCount > 0) ? lex_createLazyLexer(lexer, g, options->cacheStateCount)
+                                                 : lex_createLexer(lexer, g);
+    st_endPhase(report);
+
+    return errCode;
+}
+
+static void logCacheCounters(const lex_Lexer *lexer) {
+    if (lexer->lazyDfa) {
+        const dfa_CacheCounters *counters = &lexer->lazyDfa->counters;
+        log_info("DFA cache : %llu hits, %llu misses, %llu flushes", (unsigned long long) counters->hits,
+                 (unsigned long long) counters->misses, (unsigned long long) counters->flushes);
+    }
+}
+
+/**
+ * Splits a file into tokens of the grammar and prints them, one per line.
+ */
+static int lexFile(fg_Grammar *g, const Options *options, st_Report *report) {
+    lex_Lexer lexer;
+    int errCode = buildLexer(&lexer, g, options, report);
+
+    if (errCode == PRS_OK) {
+        log_info("Done.");
+        errCode = (options->streaming) ? lexFileStream(&lexer, options->lexPath, report)
+                                       : lexMappedFile(&lexer, options->lexPath, options->threadCount, report);
+    }
+
+    logCacheCounters(&lexer);
+    lex_freeLexer(&lexer);
+
+    return errCode;
+}
+
+/**
+ * Writes the C source of the grammar's lexer into a file, "-" is the stdout.
+ */
+static int emitLexer(fg_Grammar *g, const char *path, st_Report *report) {
+    lex_Lexer lexer;
+    log_info("Building lexer");
+    st_beginPhase(report, "build lexer");
+    int errCode = lex_createLexer(&lexer, g);
+    st_endPhase(report);
+
+    if (errCode != PRS_OK) {
+        lex_freeLexer(&lexer);
+        return errCode;
+    }
+
+    FILE *out = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+
+    if (!out) {
+        log_error("Unable to create %s : %s", path, strerror(errno));
+        lex_freeLexer(&lexer);
+        return -1;
+    }
+
+    log_info("Generating lexer (%u states)", lexer.dfa.stateCount);
+    st_beginPhase(report, "emit lexer");
+    bool emitted = cg_emitLexer(&lexer, CG_DEFAULT_PREFIX, out);
+    st_endPhase(report);
+
+    if (out != stdout && fclose(out) != 0) {
+        emitted = false;
+    }
+
+    if (!emitted) {
+        log_error("Unable to write %s", path);
+        errCode = -1;
+    }
+
+    lex_freeLexer(&lexer);
+
+    return errCode;
+}
+
+static void printProduction(const ga_Grammar *grammar, uint32_t production) {
+    const ga_Symbol *symbols = ga_getProductionSymbols(grammar, production);
+    printf("%s =", ga_getSymbolName(grammar, ga_getRuleSymbol(grammar, grammar->productions[production].rule)));
+
+    for (uint32_t i = 0;i < grammar->productions[production].length;++i) {
+        printf(" %s", ga_getSymbolName(grammar, symbols[i]));
+    }
+
+    printf("\n");
+}
+
+/**
+ * Prints the productions of one derivation of the root of a forest in preorder.
+ */
+static int printForestDerivation(const ga_Grammar *grammar, sppf_Forest *forest, vec_Vector *derivation) {
+    sppf_Result result = sppf_addDerivation(forest, forest->root, derivation);
+
+    if (result == SPPF_ALLOCATION_ERROR) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    if (result == SPPF_NO_DERIVATION) {
+        log_error("The forest has no finite derivation of the input");
+        return -1;
+    }
+
+    for (size_t i = 0;i < derivation->size;++i) {
+        printProduction(grammar, *((uint32_t*) vec_at(derivation, i)));
+    }
+
+    return PRS_OK;
+}
+
+static void logSyntaxError(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, size_t errorIndex) {
+    if (errorIndex < tokens->size) {
+        log_error("Syntax error at offset %u : unexpected %s", tokens->offsets[errorIndex],
+                  ga_getSymbolName(grammar, tb_getTerminal(tokens, errorIndex)));
+    }
+    else {
+        log_error("Syntax error : unexpected end of input");
+    }
+}
+
+/**
+ * Parses tokens with the predict table of the grammar and prints the productions of the leftmost derivation.
+ */
+static int parseLL1(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, st_Report *report) {
+    ll1_Parser parser;
+    log_info("Building LL(1) table");
+    st_beginPhase(report, "build parser");
+    int errCode = ll1_createParser(&parser, grammar);
+    st_endPhase(report);
+
+    for (size_t i = 0;i < parser.conflicts.size;++i) {
+        const ll1_Conflict *conflict = vec_at(&parser.conflicts, i);
+        log_error("LL(1) conflict on %s for %s : productions %u and %u",
+                  ga_getSymbolName(grammar, conflict->terminal),
+                  ga_getSymbolName(grammar, ga_getRuleSymbol(grammar, conflict->rule)),
+                  conflict->productions[0], conflict->productions[1]);
+    }
+
+    if (errCode != PRS_OK) {
+        ll1_freeParser(&parser);
+        return errCode;
+    }
+
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 1024, NULL);
+    size_t errorIndex = 0;
+
+    st_beginPhase(report, "parse input");
+    ll1_Result result = ll1_parse(&parser, tokens, &derivation, &errorIndex);
+    st_endPhase(report);
+
+    if (result == LL1_ACCEPTED) {
+        for (size_t i = 0;i < derivation.size;++i) {
+            printProduction(grammar, *((uint32_t*) vec_at(&derivation, i)));
+        }
+    }
+    else if (result == LL1_SYNTAX_ERROR) {
+        logSyntaxError(grammar, tokens, errorIndex);
+        errCode = -1;
+    }
+    else {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&derivation, NULL);
+    ll1_freeParser(&parser);
+
+    return errCode;
+}
+
+static void formatLRAction(const ga_Grammar *grammar, lr_Action action, char *buffer, size_t capacity) {
+    if (lr_getActionType(action) == LR_REDUCE_ACTION) {
+        const ga_Production *production = &grammar->productions[lr_getActionValue(action)];
+        snprintf(buffer, capacity, "reduce %u (%s)", lr_getActionValue(action),
+                 ga_getSymbolName(grammar, ga_getRuleSymbol(grammar, production->rule)));
+    }
+    else {
+        snprintf(buffer, capacity, "shift %u", lr_getActionValue(action));
+    }
+}
+
+/**
+ * Parses tokens with the LALR(1) table of the grammar and prints the reduced productions.
+ */
+static int parseLALR(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, st_Report *report) {
+    lr_Table table;
+    log_info("Building LALR(1) table");
+    st_beginPhase(report, "build parser");
+    int errCode = lr_createTable(&table, grammar);
+    st_endPhase(report);
+
+    if (errCode != PRS_OK) {
+        return errCode;
+    }
+
+    log_info("Done (%u states, %zu packed entries).", table.stateCount, table.entryCount);
+
+    for (size_t i = 0;i < table.conflicts.size;++i) {
+        const lr_Conflict *conflict = vec_at(&table.conflicts, i);
+        char kept[64];
+        char rejected[64];
+
+        formatLRAction(grammar, conflict->actions[0], kept, sizeof(kept));
+        formatLRAction(grammar, conflict->actions[1], rejected, sizeof(rejected));
+        log_warn("LALR(1) conflict in state %u on %s : %s over %s", conflict->state,
+                 ga_getSymbolName(grammar, conflict->terminal), kept, rejected);
+    }
+
+    lr_Parser parser;
+    lr_createParser(&parser, &table);
+    vec_Vector reductions;
+    vec_createVector(&reductions, sizeof(uint32_t), 1024, NULL);
+    size_t errorIndex = 0;
+
+    st_beginPhase(report, "parse input");
+    lr_Result result = lr_parse(&parser, tokens, &reductions, &errorIndex);
+    st_endPhase(report);
+
+    if (result == LR_ACCEPTED) {
+        for (size_t i = 0;i < reductions.size;++i) {
+            printProduction(grammar, *((uint32_t*) vec_at(&reductions, i)));
+        }
+    }
+    else if (result == LR_SYNTAX_ERROR) {
+        logSyntaxError(grammar, tokens, errorIndex);
+        errCode = -1;
+    }
+    else {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&reductions, NULL);
+    lr_freeParser(&parser);
+    lr_freeTable(&table);
+
+    return errCode;
+}
+
+/**
+ * Parses tokens with ordered choices and a memo table, then prints the productions of the parse tree in preorder.
+ */
+static int parsePackrat(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, st_Report *report) {
+    pk_Parser parser;
+    st_beginPhase(report, "build parser");
+    int errCode = pk_createParser(&parser, grammar);
+    st_endPhase(report);
+
+    if (errCode != PRS_OK) {
+        pk_freeParser(&parser);
+        return errCode;
+    }
+
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 1024, NULL);
+    size_t errorIndex = 0;
+
+    st_beginPhase(report, "parse input");
+    pk_Result result = pk_parse(&parser, tokens, &derivation, &errorIndex);
+    st_endPhase(report);
+
+    if (result == PK_ACCEPTED) {
+        for (size_t i = 0;i < derivation.size;++i) {
+            printProduction(grammar, *((uint32_t*) vec_at(&derivation, i)));
+        }
+    }
+    else if (result == PK_SYNTAX_ERROR) {
+        logSyntaxError(grammar, tokens, errorIndex);
+        errCode = -1;
+    }
+    else {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&derivation, NULL);
+    pk_freeParser(&parser);
+
+    return errCode;
+}
+
+/**
+ * Parses tokens with Earley sets, then prints the productions of one derivation of the forest in preorder.
+ */
+static int parseEarley(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, st_Report *report) {
+    ea_Parser parser;
+    sppf_Forest forest;
+    st_beginPhase(report, "build parser");
+    int errCode = ea_createParser(&parser, grammar);
+    st_endPhase(report);
+
+    if (errCode != PRS_OK || !sppf_createForest(&forest)) {
+        ea_freeParser(&parser);
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 1024, NULL);
+    size_t errorIndex = 0;
+
+    st_beginPhase(report, "parse input");
+    ea_Result result = ea_parse(&parser, tokens, &forest, &errorIndex);
+    st_endPhase(report);
+
+    if (result == EA_ACCEPTED) {
+        log_info("Done (%zu items, %zu nodes, %zu packed nodes).", parser.items.size, forest.nodeCount,
+                 forest.packedNodeCount);
+
+        if (forest.ambiguousNodeCount > 0) {
+            log_warn("Ambiguous input : %zu nodes have several derivations", forest.ambiguousNodeCount);
+        }
+
+        errCode = printForestDerivation(grammar, &forest, &derivation);
+    }
+    else if (result == EA_SYNTAX_ERROR) {
+        logSyntaxError(grammar, tokens, errorIndex);
+        errCode = -1;
+    }
+    else {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&derivation, NULL);
+    sppf_freeForest(&forest);
+    ea_freeParser(&parser);
+
+    return errCode;
+}
+
+/**
+ * Parses tokens on a graph-structured stack that follows every action of the LALR(1) table, then prints the
+ * productions of one derivation of the forest in preorder.
+ */
+static int parseGLR(const ga_Grammar *grammar, const tb_TokenBuffer *tokens, st_Report *report) {
+    lr_Table table;
+    glr_Parser parser;
+    sppf_Forest forest;
+    log_info("Building LALR(1) table");
+    st_beginPhase(report, "build parser");
+    int errCode = lr_createTable(&table, grammar);
+
+    if (errCode == PRS_OK) {
+        errCode = glr_createParser(&parser, &table);
+
+        if (errCode != PRS_OK) {
+            glr_freeParser(&parser);
+            lr_freeTable(&table);
+        }
+    }
+
+    st_endPhase(report);
+
+    if (errCode != PRS_OK) {
+        return errCode;
+    }
+
+    log_info("Done (%u states, %zu conflicts).", table.stateCount, table.conflicts.size);
+
+    if (!sppf_createForest(&forest)) {
+        glr_freeParser(&parser);
+        lr_freeTable(&table);
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 1024, NULL);
+    size_t errorIndex = 0;
+
+    st_beginPhase(report, "parse input");
+    glr_Result result = glr_parse(&parser, tokens, &forest, &errorIndex);
+    st_endPhase(report);
+
+    if (result == GLR_ACCEPTED) {
+        log_info("Done (%zu nodes, %zu packed nodes).", forest.nodeCount, forest.packedNodeCount);
+
+        if (forest.ambiguousNodeCount > 0) {
+            log_warn("Ambiguous input : %zu nodes have several derivations", forest.ambiguousNodeCount);
+        }
+
+        errCode = printForestDerivation(grammar, &forest, &derivation);
+    }
+    else if (result == GLR_SYNTAX_ERROR) {
+        logSyntaxError(grammar, tokens, errorIndex);
+        errCode = -1;
+    }
+    else {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&derivation, NULL);
+    sppf_freeForest(&forest);
+    glr_freeParser(&parser);
+    lr_freeTable(&table);
+
+    return errCode;
+}
+
+/**
+ * Splits a file into tokens and parses them from the entry rule of the grammar.
+ */
+static int parseFile(fg_Grammar *g, const Options *options, st_Report *report) {
+    lex_Lexer lexer;
+    int errCode = buildLexer(&lexer, g, options, report);
+
+    ga_Grammar grammar;
+    prs_GrammarSource input;
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+
+    if (errCode == PRS_OK) {
+        st_beginPhase(report, "analyze grammar");
+        errCode = ga_createGrammar(&grammar, g, &lexer);
+        st_endPhase(report);
+
+        if (errCode != PRS_OK) {
+            ga_freeGrammar(&grammar);
+        }
+    }
+
+    if (errCode != PRS_OK) {
+        lex_freeLexer(&lexer);
+        return errCode;
+    }
+
+    if (!prs_openGrammarFile(&input, options->parsePath)) {
+        log_error("Unable to load input : %s", strerror(errno));
+        errCode = -1;
+        goto clean;
+    }
+
+    size_t errorOffset = 0;
+    st_beginPhase(report, "lex");
+    ssize_t tokenCount = tb_tokenize(&tokens, &lexer, input.data, input.length, &errorOffset);
+    st_endPhase(report);
+    logCacheCounters(&lexer);
+
+    if (tokenCount == LEX_TOKENIZE_ERROR) {
+        log_error("Unable to lex input at offset %zu", errorOffset);
+        errCode = -1;
+    }
+    else if (tokenCount == LEX_TOKENIZE_ALLOCATION_ERROR) {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+    else if (options->parserType == LL1_PARSER) {
+        errCode = parseLL1(&grammar, &tokens, report);
+    }
+    else if (options->parserType == LALR_PARSER) {
+        errCode = parseLALR(&grammar, &tokens, report);
+    }
+    else if (options->parserType == PACKRAT_PARSER) {
+        errCode = parsePackrat(&grammar, &tokens, report);
+    }
+    else if (options->parserType == EARLEY_PARSER) {
+        errCode = parseEarley(&grammar, &tokens, report);
+    }
+    else {
+        errCode = parseGLR(&grammar, &tokens, report);
+    }
+
+    prs_closeGrammarSource(&input);
+
+clean:
+    tb_freeTokenBuffer(&tokens);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+
+    return errCode;
+}
+
+static void collectGrammarStats(fg_Grammar *g, st_Report *report) {
+    report->tokens = g->tokens.size;
+    report->rules = g->rules.size;
+    report->productions = 0;
+
+    for (size_t i = 0;i < g->rules.size;++i) {
+        fg_Rule *rule = *((fg_Rule**) vec_at(&g->rules, i));
+        report->productions += rule->productionRuleList.size;
+    }
+
+    report->symbols = sym_getCount(&g->symbols);
+    report->symbolSlots = g->symbols.slotCount;
+    report->longestProbe = sym_getLongestProbe(&g->symbols);
+}
+
+int main(int argc, char **argv) {
+    Options options;
+
+    if (!parseOptions(&options, argc, argv)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    st_Report report;
+    st_createReport(&report);
 
     fg_Grammar g;
     fg_createGrammar(&g);
-    int errCode = prs_parseGrammarItems(&g, &itemList);
+
+    int errCode = (options.streaming) ? parseStream(&g, options.path, &report) : parseSource(&g, options.path, &report);
 
     char errMsg[255];
 
+    if (errCode == -1) {
+        goto clean;
+    }
+
     if (errCode != PRS_OK) {
         prs_getErrorMessage(errMsg, 255, errCode);
         log_error(errMsg);
@@ -61,11 +847,13 @@ int main(int argc, char **argv) {
     }
 
     log_info("Done.\nResolving symbols");
+    st_beginPhase(&report, "resolve");
     errCode = prs_resolveSymbols(&g);
+    st_endPhase(&report);
 
     if (errCode == PRS_OK) {
         log_info("Done.");
-        log_info("Extracted tokens : %d\nExtracted rules :%d", g.tokens.size, g.rules.size);
+        log_info("Extracted tokens : %zu\nExtracted rules :%zu", g.tokens.size, g.rules.size);
     }
     else {
         log_error("Error during resolution : %d", errCode);
@@ -74,9 +862,51 @@ int main(int argc, char **argv) {
         goto clean;
     }
 
+    if (options.lexPath) {
+        errCode = lexFile(&g, &options, &report);
+
+        if (errCode > 0) {
+            prs_getErrorMessage(errMsg, 255, errCode);
+            log_error(errMsg);
+        }
+
+        if (errCode != PRS_OK) {
+            goto clean;
+        }
+    }
+
+    if (options.emitPath) {
+        errCode = emitLexer(&g, options.emitPath, &report);
+
+        if (errCode > 0) {
+            prs_getErrorMessage(errMsg, 255, errCode);
+            log_error(errMsg);
+        }
+
+        if (errCode != PRS_OK) {
+            goto clean;
+        }
+    }
+
+    if (options.parsePath) {
+        errCode = parseFile(&g, &options, &report);
+
+        if (errCode > 0) {
+            prs_getErrorMessage(errMsg, 255, errCode);
+            log_error(errMsg);
+        }
+
+        if (errCode != PRS_OK) {
+            goto clean;
+        }
+    }
+
+    if (options.stats) {
+        collectGrammarStats(&g, &report);
+        st_printReport(&report, stdout, options.jsonStats);
+    }
+
 clean:
-    free(grammarBuffer);
-    ll_freeLinkedList(&itemList, NULL);
     fg_freeGrammar(&g);
-    return 0;
+    return (errCode == PRS_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,203 @@
+#include "nfa.h"
+
+#include <assert.h>
+
+void nfa_createAutomaton(nfa_Automaton *nfa) {
+    assert(nfa);
+
+    vec_createVector(&nfa->states, sizeof(nfa_State), 0, NULL);
+    vec_createVector(&nfa->starts, sizeof(uint32_t), 0, NULL);
+}
+
+void nfa_freeAutomaton(nfa_Automaton *nfa) {
+    if (nfa) {
+        vec_freeVector(&nfa->states, NULL);
+        vec_freeVector(&nfa->starts, NULL);
+    }
+}
+
+nfa_State *nfa_getState(const nfa_Automaton *nfa, uint32_t id) {
+    assert(nfa);
+
+    return vec_at((vec_Vector*) &nfa->states, id);
+}
+
+/**
+ * Adds a state and gives its ID, NFA_NONE if the allocation failed.
+ */
+static uint32_t addState(nfa_Automaton *nfa, nfa_StateType type, uint32_t out, uint32_t alt) {
+    nfa_State state = {
+            .type = type,
+            .out = out,
+            .alt = alt,
+            .terminal = NFA_NONE
+    };
+
+    if (!vec_pushBack(&nfa->states, &state)) {
+        return NFA_NONE;
+    }
+
+    return (uint32_t) (nfa->states.size - 1);
+}
+
+bool nfa_empty(nfa_Automaton *nfa, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(fragment);
+
+    uint32_t state = addState(nfa, NFA_EPSILON_STATE, NFA_NONE, NFA_NONE);
+
+    fragment->start = fragment->end = state;
+
+    return state != NFA_NONE;
+}
+
+bool nfa_charClass(nfa_Automaton *nfa, const prs_CharClass *charClass, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(charClass);
+    assert(fragment);
+
+    uint32_t end = addState(nfa, NFA_EPSILON_STATE, NFA_NONE, NFA_NONE);
+    uint32_t start = addState(nfa, NFA_RANGE_STATE, end, NFA_NONE);
+
+    if (end == NFA_NONE || start == NFA_NONE) {
+        return false;
+    }
+
+    nfa_getState(nfa, start)->charClass = *charClass;
+
+    fragment->start = start;
+    fragment->end = end;
+
+    return true;
+}
+
+bool nfa_range(nfa_Automaton *nfa, uint8_t low, uint8_t high, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(fragment);
+    assert(low <= high);
+
+    prs_CharClass charClass;
+    prs_clearCharClass(&charClass);
+    prs_addCharInterval(&charClass, low, high);
+
+    return nfa_charClass(nfa, &charClass, fragment);
+}
+
+bool nfa_rangeArray(nfa_Automaton *nfa, const prs_RangeArray *rangeArray, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(rangeArray);
+    assert(fragment);
+
+    return nfa_charClass(nfa, &rangeArray->charClass, fragment);
+}
+
+bool nfa_literal(nfa_Automaton *nfa, const char *string, size_t length, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(string || length == 0);
+    assert(fragment);
+
+    if (!nfa_empty(nfa, fragment)) {
+        return false;
+    }
+
+    for (size_t i = 0;i < length;++i) {
+        nfa_Fragment byteFragment;
+        uint8_t c = (uint8_t) string[i];
+
+        if (!nfa_range(nfa, c, c, &byteFragment)) {
+            return false;
+        }
+
+        nfa_concat(nfa, *fragment, byteFragment, fragment);
+    }
+
+    return true;
+}
+
+void nfa_concat(nfa_Automaton *nfa, nfa_Fragment a, nfa_Fragment b, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(fragment);
+
+    nfa_getState(nfa, a.end)->out = b.start;
+
+    fragment->start = a.start;
+    fragment->end = b.end;
+}
+
+bool nfa_alternate(nfa_Automaton *nfa, nfa_Fragment a, nfa_Fragment b, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(fragment);
+
+    uint32_t end = addState(nfa, NFA_EPSILON_STATE, NFA_NONE, NFA_NONE);
+    uint32_t start = addState(nfa, NFA_EPSILON_STATE, a.start, b.start);
+
+    if (end == NFA_NONE || start == NFA_NONE) {
+        return false;
+    }
+
+    nfa_getState(nfa, a.end)->out = end;
+    nfa_getState(nfa, b.end)->out = end;
+
+    fragment->start = start;
+    fragment->end = end;
+
+    return true;
+}
+
+bool nfa_quantify(nfa_Automaton *nfa, nfa_Fragment a, prs_RangeQuantifier quantifier, nfa_Fragment *fragment) {
+    assert(nfa);
+    assert(fragment);
+
+    if (quantifier == PRS_NO_QUANTIFIER) {
+        *fragment = a;
+        return true;
+    }
+
+    uint32_t end = addState(nfa, NFA_EPSILON_STATE, NFA_NONE, NFA_NONE);
+
+    if (end == NFA_NONE) {
+        return false;
+    }
+
+    uint32_t start = a.start;
+
+    if (quantifier != PRS_PLUS_QUANTIFIER) {
+        // ? and * can skip the fragment
+        start = addState(nfa, NFA_EPSILON_STATE, a.start, end);
+
+        if (start == NFA_NONE) {
+            return false;
+        }
+    }
+
+    nfa_State *aEnd = nfa_getState(nfa, a.end);
+
+    if (quantifier == PRS_QMARK_QUANTIFIER) {
+        aEnd->out = end;
+    }
+    else {
+        // + and * can repeat the fragment
+        aEnd->out = a.start;
+        aEnd->alt = end;
+    }
+
+    fragment->start = start;
+    fragment->end = end;
+
+    return true;
+}
+
+bool nfa_accept(nfa_Automaton *nfa, nfa_Fragment a, uint32_t terminal) {
+    assert(nfa);
+
+    uint32_t accept = addState(nfa, NFA_ACCEPT_STATE, NFA_NONE, NFA_NONE);
+
+    if (accept == NFA_NONE) {
+        return false;
+    }
+
+    nfa_getState(nfa, accept)->terminal = terminal;
+    nfa_getState(nfa, a.end)->out = accept;
+
+    return vec_pushBack(&nfa->starts, &a.start) != NULL;
+}
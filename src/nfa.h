@@ -0,0 +1,188 @@
+#ifndef NFA_H
+#define NFA_H
+
+/**
+ * @file
+ * Defines a nondeterministic finite automaton built with Thompson's construction.
+ *
+ * An automaton is made of fragments : each fragment has one start state and one
+ * end state. The end state is an epsilon state without output, it is linked to
+ * the next fragment by the combination functions. Fragments are consumed by
+ * these functions, a fragment can not be used twice.
+ */
+
+#include "collections/vector.h"
+#include "range.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Missing state.
+ */
+#define NFA_NONE UINT32_MAX
+
+typedef enum nfa_StateType {
+    NFA_EPSILON_STATE,
+    NFA_RANGE_STATE,
+    NFA_ACCEPT_STATE
+} nfa_StateType;
+
+/**
+ * A state of the automaton.
+ *
+ * A range state goes to out on each byte of its character class.
+ * An epsilon state goes to out and alt without reading anything, both can be
+ * NFA_NONE. An accept state recognizes the given terminal.
+ */
+typedef struct nfa_State {
+    nfa_StateType type;
+    uint32_t out;
+    uint32_t alt;
+    uint32_t terminal;
+    prs_CharClass charClass;
+} nfa_State;
+
+typedef struct nfa_Fragment {
+    uint32_t start;
+    uint32_t end;
+} nfa_Fragment;
+
+/**
+ * An automaton with several start states, one for each accepted fragment.
+ */
+typedef struct nfa_Automaton {
+    vec_Vector states;
+    vec_Vector starts;
+} nfa_Automaton;
+
+/**
+ * Creates an empty automaton.
+ *
+ * @param nfa a pointer to an automaton
+ */
+void nfa_createAutomaton(nfa_Automaton *nfa);
+
+/**
+ * Frees allocated memory for the given automaton.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param nfa a pointer to an automaton
+ */
+void nfa_freeAutomaton(nfa_Automaton *nfa);
+
+/**
+ * Gets a state of the automaton.
+ *
+ * The pointer is invalidated when a state is added.
+ *
+ * @param nfa a pointer to an automaton
+ * @param id a valid state ID
+ * @return a pointer to the state
+ */
+nfa_State *nfa_getState(const nfa_Automaton *nfa, uint32_t id);
+
+/**
+ * Creates a fragment that matches the empty string.
+ *
+ * If an allocation failed then false will be returned.
+ *
+ * @param nfa a pointer to an automaton
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_empty(nfa_Automaton *nfa, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches one byte between low and high (included).
+ *
+ * @param nfa a pointer to an automaton
+ * @param low first byte
+ * @param high last byte
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_range(nfa_Automaton *nfa, uint8_t low, uint8_t high, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches one byte of a character class.
+ *
+ * @param nfa a pointer to an automaton
+ * @param charClass a pointer to a character class, it is copied
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_charClass(nfa_Automaton *nfa, const prs_CharClass *charClass, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches one byte of a range array.
+ *
+ * The compiled bitmap of the array is used, an empty range array
+ * does not match anything.
+ *
+ * @param nfa a pointer to an automaton
+ * @param rangeArray a pointer to a range array
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_rangeArray(nfa_Automaton *nfa, const prs_RangeArray *rangeArray, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches the given string.
+ *
+ * @param nfa a pointer to an automaton
+ * @param string a string, it does not need to be null terminated
+ * @param length length of the string
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_literal(nfa_Automaton *nfa, const char *string, size_t length, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches a then b.
+ *
+ * @param nfa a pointer to an automaton
+ * @param a first fragment
+ * @param b second fragment
+ * @param fragment a pointer to the fragment to create
+ */
+void nfa_concat(nfa_Automaton *nfa, nfa_Fragment a, nfa_Fragment b, nfa_Fragment *fragment);
+
+/**
+ * Creates a fragment that matches a or b.
+ *
+ * @param nfa a pointer to an automaton
+ * @param a first fragment
+ * @param b second fragment
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_alternate(nfa_Automaton *nfa, nfa_Fragment a, nfa_Fragment b, nfa_Fragment *fragment);
+
+/**
+ * Applies a quantifier (?, *, +) to a fragment.
+ *
+ * PRS_NO_QUANTIFIER gives the same fragment.
+ *
+ * @param nfa a pointer to an automaton
+ * @param a a fragment
+ * @param quantifier quantifier to apply
+ * @param fragment a pointer to the fragment to create
+ * @return true if the fragment has been created, otherwise false
+ */
+bool nfa_quantify(nfa_Automaton *nfa, nfa_Fragment a, prs_RangeQuantifier quantifier, nfa_Fragment *fragment);
+
+/**
+ * Makes the automaton accept a fragment as the given terminal.
+ *
+ * The fragment's start becomes a start state of the automaton.
+ *
+ * @param nfa a pointer to an automaton
+ * @param a a fragment
+ * @param terminal terminal recognized by the fragment
+ * @return true if no allocation error occurs, otherwise false
+ */
+bool nfa_accept(nfa_Automaton *nfa, nfa_Fragment a, uint32_t terminal);
+
+#endif // NFA_H
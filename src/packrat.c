@@ -0,0 +1,494 @@
+#include "packrat.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PK_FRAME_CAPACITY 64
+
+// Results of the memo table, the others are node indexes plus MEMO_NODE
+#define MEMO_UNKNOWN 0
+#define MEMO_FAIL 1
+#define MEMO_NODE 2
+
+// End of a seed that has not matched yet
+#define NO_END UINT32_MAX
+
+#define getNode(parser, result) ((pk_Node*) vec_at(&(parser)->nodes, (result) - MEMO_NODE))
+
+/**
+ * Evaluation of a rule at a position.
+ */
+typedef struct Frame {
+    uint32_t rule;
+    uint32_t start;
+    // Current alternative and its next item
+    uint32_t production;
+    uint32_t item;
+    uint32_t position;
+    // Index of the first pending child of the production
+    uint32_t childStart;
+    // Leaders only : end of the longest seed
+    uint32_t seedEnd;
+} Frame;
+
+#define getBit(set, index) (((set)[(index) / 64] >> ((index) % 64)) & 1)
+
+/**
+ * Computes the rules that each rule calls at its start : calls[a] contains b if a production of a starts with b.
+ */
+static void computeLeftCalls(const ga_Grammar *grammar, uint64_t *calls, size_t wordCount) {
+    for (uint32_t p = 0;p < grammar->productionCount;++p) {
+        const ga_Production *production = &grammar->productions[p];
+        const ga_Symbol *symbols = ga_getProductionSymbols(grammar, p);
+        uint64_t *row = calls + (size_t) production->rule * wordCount;
+
+        for (uint32_t i = 0;i < production->length && ga_isRule(grammar, symbols[i]);++i) {
+            uint32_t rule = ga_getRule(grammar, symbols[i]);
+            ga_setAdd(row, rule);
+
+            if (!grammar->nullable[rule]) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Computes the transitive closure of the left calls, without the calls of leaders when they are given.
+ */
+static void closeLeftCalls(uint32_t ruleCount, const uint64_t *calls, uint64_t *reach, size_t wordCount,
+                           const bool *leaders) {
+    memcpy(reach, calls, ruleCount * wordCount * sizeof(*reach));
+
+    // A leader returns its seed to the calls it grows from, they do not recurse
+    for (uint32_t l = 0;leaders && l < ruleCount;++l) {
+        if (leaders[l]) {
+            for (uint32_t r = 0;r < ruleCount;++r) {
+                reach[r * wordCount + l / 64] &= ~((uint64_t) 1 << (l % 64));
+            }
+        }
+    }
+
+    for (uint32_t k = 0;k < ruleCount;++k) {
+        const uint64_t *through = reach + (size_t) k * wordCount;
+
+        for (uint32_t r = 0;r < ruleCount;++r) {
+            uint64_t *row = reach + (size_t) r * wordCount;
+
+            if (getBit(row, k)) {
+                for (size_t w = 0;w < wordCount;++w) {
+                    row[w] |= through[w];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Chooses leaders until no cycle of left calls remains, then finds the rules involved in the cycles of each leader.
+ */
+static bool findLeaders(pk_Parser *parser, const uint64_t *calls, uint64_t *reach, size_t wordCount) {
+    uint32_t ruleCount = parser->grammar->ruleCount;
+    uint32_t cyclic;
+
+    do {
+        closeLeftCalls(ruleCount, calls, reach, wordCount, parser->leaders);
+
+        for (cyclic = 0;cyclic < ruleCount && !getBit(reach + (size_t) cyclic * wordCount, cyclic);++cyclic);
+
+        if (cyclic < ruleCount) {
+            parser->leaders[cyclic] = true;
+        }
+    } while (cyclic < ruleCount);
+
+    // Rules of the strongly connected component of a leader depend on its seed, the other leaders included
+    closeLeftCalls(ruleCount, calls, reach, wordCount, NULL);
+    uint32_t involvedCount = 0;
+
+    for (int pass = 0;pass < 2;++pass) {
+        involvedCount = 0;
+
+        for (uint32_t l = 0;l < ruleCount;++l) {
+            parser->involvedOffsets[l] = involvedCount;
+
+            if (!parser->leaders[l]) {
+                continue;
+            }
+
+            for (uint32_t r = 0;r < ruleCount;++r) {
+                if (r != l && getBit(reach + (size_t) l * wordCount, r)
+                    && getBit(reach + (size_t) r * wordCount, l)) {
+                    if (parser->involved) {
+                        parser->involved[involvedCount] = r;
+                    }
+
+                    ++involvedCount;
+                }
+            }
+        }
+
+        parser->involvedOffsets[ruleCount] = involvedCount;
+
+        if (parser->involved || involvedCount == 0) {
+            break;
+        }
+
+        parser->involved = malloc(involvedCount * sizeof(*parser->involved));
+
+        if (!parser->involved) {
+            return false;
+        }
+
+        st_recordAllocation(involvedCount * sizeof(*parser->involved));
+    }
+
+    return true;
+}
+
+prs_ErrCode pk_createParser(pk_Parser *parser, const ga_Grammar *grammar) {
+    assert(parser);
+    assert(grammar);
+
+    uint32_t ruleCount = grammar->ruleCount;
+    parser->grammar = grammar;
+    parser->involved = NULL;
+    parser->memoCapacity = 0;
+    vec_createVector(&parser->nodes, sizeof(pk_Node), 0, NULL);
+    vec_createVector(&parser->children, sizeof(uint32_t), 0, NULL);
+    vec_createVector(&parser->frames, sizeof(Frame), PK_FRAME_CAPACITY, NULL);
+    vec_createVector(&parser->pendingChildren, sizeof(uint32_t), PK_FRAME_CAPACITY, NULL);
+
+    parser->leaders = calloc(ruleCount, sizeof(*parser->leaders));
+    parser->involvedOffsets = malloc((ruleCount + 1) * sizeof(*parser->involvedOffsets));
+    parser->memo = calloc(ruleCount, sizeof(*parser->memo));
+
+    size_t wordCount = (ruleCount + 63) / 64;
+    size_t matrixSize = (size_t) ruleCount * wordCount * sizeof(uint64_t);
+    uint64_t *calls = calloc(1, matrixSize);
+    uint64_t *reach = malloc(matrixSize);
+
+    prs_ErrCode errCode = PRS_ALLOCATION_ERROR;
+
+    if (parser->leaders && parser->involvedOffsets && parser->memo && calls && reach) {
+        st_recordAllocation(ruleCount * (sizeof(*parser->leaders) + sizeof(*parser->memo))
+                            + (ruleCount + 1) * sizeof(*parser->involvedOffsets) + 2 * matrixSize);
+        computeLeftCalls(grammar, calls, wordCount);
+
+        if (findLeaders(parser, calls, reach, wordCount)) {
+            errCode = PRS_OK;
+        }
+    }
+
+    free(calls);
+    free(reach);
+
+    return errCode;
+}
+
+void pk_freeParser(pk_Parser *parser) {
+    if (parser) {
+        for (uint32_t r = 0;parser->memo && r < parser->grammar->ruleCount;++r) {
+            free(parser->memo[r]);
+        }
+
+        free(parser->memo);
+        free(parser->leaders);
+        free(parser->involvedOffsets);
+        free(parser->involved);
+        parser->memo = NULL;
+        parser->leaders = NULL;
+        parser->involvedOffsets = NULL;
+        parser->involved = NULL;
+        vec_freeVector(&parser->nodes, NULL);
+        vec_freeVector(&parser->children, NULL);
+        vec_freeVector(&parser->frames, NULL);
+        vec_freeVector(&parser->pendingChildren, NULL);
+    }
+}
+
+/**
+ * Clears the memo arrays, they are freed if they cannot hold a result per position.
+ */
+static void prepareMemo(pk_Parser *parser, size_t positionCount) {
+    bool reallocate = positionCount > parser->memoCapacity;
+
+    for (uint32_t r = 0;r < parser->grammar->ruleCount;++r) {
+        if (!parser->memo[r]) {
+            continue;
+        }
+
+        if (reallocate) {
+            free(parser->memo[r]);
+            parser->memo[r] = NULL;
+        } else {
+            memset(parser->memo[r], 0, positionCount * sizeof(*parser->memo[r]));
+        }
+    }
+
+    if (reallocate) {
+        parser->memoCapacity = positionCount;
+    }
+}
+
+/**
+ * Calls a rule at a position : pResult receives its memoized result, or MEMO_UNKNOWN if a frame evaluates it.
+ */
+static bool enter(pk_Parser *parser, uint32_t rule, uint32_t position, uint32_t *pResult) {
+    const ga_Grammar *grammar = parser->grammar;
+    uint32_t *memo = parser->memo[rule];
+
+    if (!memo) {
+        memo = calloc(parser->memoCapacity, sizeof(*memo));
+
+        if (!memo) {
+            return false;
+        }
+
+        st_recordAllocation(parser->memoCapacity * sizeof(*memo));
+
+        parser->memo[rule] = memo;
+    }
+
+    if (memo[position] != MEMO_UNKNOWN || grammar->firstProductions[rule] == grammar->firstProductions[rule + 1]) {
+        *pResult = (memo[position] != MEMO_UNKNOWN) ? memo[position] : MEMO_FAIL;
+        return true;
+    }
+
+    // The recursive calls of a leader fail until it has a seed
+    if (parser->leaders[rule]) {
+        memo[position] = MEMO_FAIL;
+    }
+
+    Frame frame = {
+        .rule = rule,
+        .start = position,
+        .production = grammar->firstProductions[rule],
+        .item = 0,
+        .position = position,
+        .childStart = (uint32_t) parser->pendingChildren.size,
+        .seedEnd = NO_END
+    };
+
+    *pResult = MEMO_UNKNOWN;
+
+    return vec_pushBack(&parser->frames, &frame) != NULL;
+}
+
+/**
+ * Creates the node of the matched production of the top frame, its pending children are moved to the node.
+ */
+static bool addNode(pk_Parser *parser, Frame *frame, uint32_t *pResult) {
+    vec_Vector *pending = &parser->pendingChildren;
+    pk_Node node = {
+        .production = frame->production,
+        .start = frame->start,
+        .end = frame->position,
+        .childStart = (uint32_t) parser->children.size,
+        .childCount = (uint32_t) (pending->size - frame->childStart)
+    };
+
+    for (size_t i = frame->childStart;i < pending->size;++i) {
+        if (!vec_pushBack(&parser->children, vec_at(pending, i))) {
+            return false;
+        }
+    }
+
+    pending->size = frame->childStart;
+    *pResult = (uint32_t) parser->nodes.size + MEMO_NODE;
+
+    return vec_pushBack(&parser->nodes, &node) != NULL;
+}
+
+/**
+ * Checks if a leader grows a seed at the start of the top frame, below it.
+ */
+static bool isGrowing(const pk_Parser *parser, uint32_t rule, uint32_t start) {
+    // Frames of a position are above the frames of the previous positions
+    for (size_t i = parser->frames.size - 1;i > 0;--i) {
+        const Frame *frame = (const Frame*) vec_at((vec_Vector*) &parser->frames, i - 1);
+
+        if (frame->start != start) {
+            break;
+        }
+
+        if (frame->rule == rule) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Ends an evaluation of the top frame with a result.
+ *
+ * A leader whose match got longer keeps it as its seed and restarts,
+ * otherwise the frame is popped and pResult receives the result of the rule.
+ */
+static void finish(pk_Parser *parser, uint32_t result, uint32_t *pResult) {
+    const ga_Grammar *grammar = parser->grammar;
+    Frame *frame = (Frame*) vec_at(&parser->frames, parser->frames.size - 1);
+    uint32_t *memo = &parser->memo[frame->rule][frame->start];
+
+    if (parser->leaders[frame->rule]) {
+        bool grown = result != MEMO_FAIL
+                     && (frame->seedEnd == NO_END || getNode(parser, result)->end > frame->seedEnd);
+
+        // Involved rules have used the previous seed at this position, a leader that is growing keeps its own seed
+        for (uint32_t i = parser->involvedOffsets[frame->rule];i < parser->involvedOffsets[frame->rule + 1];++i) {
+            uint32_t rule = parser->involved[i];
+
+            if (parser->memo[rule] && (!parser->leaders[rule] || !isGrowing(parser, rule, frame->start))) {
+                parser->memo[rule][frame->start] = MEMO_UNKNOWN;
+            }
+        }
+
+        if (grown) {
+            *memo = result;
+            frame->seedEnd = getNode(parser, result)->end;
+            frame->production = grammar->firstProductions[frame->rule];
+            frame->item = 0;
+            frame->position = frame->start;
+            *pResult = MEMO_UNKNOWN;
+            return;
+        }
+
+        *pResult = *memo;
+    } else {
+        *memo = result;
+        *pResult = result;
+    }
+
+    --parser->frames.size;
+}
+
+/**
+ * Adds the productions of the nodes in preorder, the pending children vector is used as a stack.
+ */
+static bool addDerivation(pk_Parser *parser, uint32_t root, vec_Vector *derivation) {
+    vec_Vector *stack = &parser->pendingChildren;
+    vec_clear(stack, NULL);
+
+    if (!vec_pushBack(stack, &root)) {
+        return false;
+    }
+
+    while (stack->size > 0) {
+        const pk_Node *node = (const pk_Node*) vec_at(&parser->nodes, *((uint32_t*) vec_at(stack, stack->size - 1)));
+        --stack->size;
+
+        if (!vec_pushBack(derivation, &node->production)) {
+            return false;
+        }
+
+        // The first child on top
+        for (uint32_t i = node->childCount;i > 0;--i) {
+            if (!vec_pushBack(stack, vec_at(&parser->children, node->childStart + i - 1))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+pk_Result pk_parse(pk_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *derivation, size_t *pErrorIndex) {
+    assert(parser);
+    assert(parser->memo);
+    assert(tokens);
+
+    const ga_Grammar *grammar = parser->grammar;
+    vec_Vector *frames = &parser->frames;
+    vec_clear(&parser->nodes, NULL);
+    vec_clear(&parser->children, NULL);
+    vec_clear(frames, NULL);
+    vec_clear(&parser->pendingChildren, NULL);
+    prepareMemo(parser, tokens->size + 1);
+
+    size_t farthest = 0;
+    uint32_t result;
+
+    if (!enter(parser, grammar->entry, 0, &result)) {
+        return PK_ALLOCATION_ERROR;
+    }
+
+    while (frames->size > 0) {
+        Frame *frame = (Frame*) vec_at(frames, frames->size - 1);
+        const ga_Production *production = &grammar->productions[frame->production];
+        bool matched;
+
+        if (result != MEMO_UNKNOWN) {
+            // The frame resumes after the call of the rule at its item
+            matched = result != MEMO_FAIL;
+
+            if (matched) {
+                uint32_t child = result - MEMO_NODE;
+
+                if (!vec_pushBack(&parser->pendingChildren, &child)) {
+                    return PK_ALLOCATION_ERROR;
+                }
+
+                frame->position = getNode(parser, result)->end;
+                ++frame->item;
+            }
+
+            result = MEMO_UNKNOWN;
+        } else if (frame->item == production->length) {
+            if (!addNode(parser, frame, &result)) {
+                return PK_ALLOCATION_ERROR;
+            }
+
+            finish(parser, result, &result);
+            continue;
+        } else {
+            ga_Symbol symbol = ga_getProductionSymbols(grammar, frame->production)[frame->item];
+
+            if (ga_isRule(grammar, symbol)) {
+                if (!enter(parser, ga_getRule(grammar, symbol), frame->position, &result)) {
+                    return PK_ALLOCATION_ERROR;
+                }
+
+                continue;
+            }
+
+            matched = frame->position < tokens->size && tb_getTerminal(tokens, frame->position) == symbol;
+
+            if (matched) {
+                ++frame->position;
+                ++frame->item;
+            } else if (frame->position > farthest) {
+                farthest = frame->position;
+            }
+        }
+
+        if (!matched) {
+            // Ordered choice : the next alternative starts over
+            parser->pendingChildren.size = frame->childStart;
+
+            if (++frame->production == grammar->firstProductions[frame->rule + 1]) {
+                finish(parser, MEMO_FAIL, &result);
+            } else {
+                frame->item = 0;
+                frame->position = frame->start;
+            }
+        }
+    }
+
+    if (result != MEMO_FAIL && getNode(parser, result)->end == tokens->size) {
+        if (derivation && !addDerivation(parser, result - MEMO_NODE, derivation)) {
+            return PK_ALLOCATION_ERROR;
+        }
+
+        return PK_ACCEPTED;
+    }
+
+    if (pErrorIndex) {
+        *pErrorIndex = (result != MEMO_FAIL && getNode(parser, result)->end > farthest) ? getNode(parser, result)->end
+                                                                                          : farthest;
+    }
+
+    return PK_SYNTAX_ERROR;
+}
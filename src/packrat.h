@@ -0,0 +1,107 @@
+#ifndef PACKRAT_H
+#define PACKRAT_H
+
+/**
+ * @file
+ * Defines a packrat parser of a flat grammar (grammar_analysis.h).
+ *
+ * Productions of a rule are an ordered choice : they are tried in their
+ * declaration order and the first one that matches wins, with unlimited
+ * lookahead. The result of each rule at each position is memoized, so a rule
+ * is evaluated at most once per position and the parse time is linear in the
+ * number of tokens. The memo table has one dense array per rule, indexed by
+ * the position, allocated when the rule is first called.
+ *
+ * Left recursive rules grow a seed : the rule first fails at the position,
+ * then it is evaluated again with its last result as the result of its
+ * recursive calls, as long as the match gets longer. Every cycle of left
+ * calls has a leader that grows its seed, the other rules of its strongly
+ * connected component, other leaders included, are evaluated again at each
+ * growth of the leader. A leader that grows its own seed at the same position
+ * keeps it.
+ *
+ * Rules are evaluated with an explicit stack of frames instead of recursion.
+ */
+
+#include "collections/vector.h"
+#include "grammar_analysis.h"
+#include "parser_errors.h"
+#include "token_buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Match of a rule, children are the nodes of the rule items of its production.
+ */
+typedef struct pk_Node {
+    uint32_t production;
+    uint32_t start;
+    uint32_t end;
+    // Children are children[childStart] to children[childStart + childCount - 1]
+    uint32_t childStart;
+    uint32_t childCount;
+} pk_Node;
+
+typedef struct pk_Parser {
+    const ga_Grammar *grammar;
+    // Rules that grow a seed
+    bool *leaders;
+    // Rules evaluated again at each growth of leader l : involved[involvedOffsets[l]] to involved[involvedOffsets[l + 1] - 1]
+    uint32_t *involvedOffsets;
+    uint32_t *involved;
+    // One array of memoCapacity results per rule, NULL until the rule is called
+    uint32_t **memo;
+    size_t memoCapacity;
+    // Vectors of pk_Node and uint32_t node indexes of the last parse
+    vec_Vector nodes;
+    vec_Vector children;
+    // Evaluation state, kept between parses
+    vec_Vector frames;
+    vec_Vector pendingChildren;
+} pk_Parser;
+
+typedef enum pk_Result {
+    PK_ACCEPTED,
+    PK_SYNTAX_ERROR,
+    PK_ALLOCATION_ERROR
+} pk_Result;
+
+/**
+ * Finds the left recursive rules of a flat grammar and chooses the leaders of their cycles.
+ *
+ * @param parser a pointer to the parser to create
+ * @param grammar a pointer to a flat grammar, it must outlive the parser
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode pk_createParser(pk_Parser *parser, const ga_Grammar *grammar);
+
+/**
+ * Frees allocated memory for the given parser.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param parser a pointer to a parser
+ */
+void pk_freeParser(pk_Parser *parser);
+
+/**
+ * Parses a sequence of tokens from the entry rule of the grammar.
+ *
+ * The entry rule must match all tokens. The productions of the parse tree are
+ * added to the derivation vector in preorder, like a leftmost derivation.
+ *
+ * If the tokens are not matched, then PK_SYNTAX_ERROR will be returned and
+ * pErrorIndex will receive the index of the farthest token that a terminal
+ * did not match, tokens->size if the input ended too soon.
+ *
+ * @param parser a pointer to a parser
+ * @param tokens tokens of the input, lexed by the lexer of the grammar
+ * @param derivation vector of uint32_t that receives the productions, can be NULL
+ * @param pErrorIndex pointer that receives the index of an unexpected token, can be NULL
+ * @return PK_ACCEPTED if the tokens have been parsed, otherwise a different result
+ */
+pk_Result pk_parse(pk_Parser *parser, const tb_TokenBuffer *tokens, vec_Vector *derivation, size_t *pErrorIndex);
+
+#endif // PACKRAT_H
@@ -1,216 +1,138 @@
 #include "parser.h"
 
-#include "collections/hash_table.h"
 #include "collections/linked_list.h"
+#include "collections/vector.h"
 #include "formal_grammar.h"
 #include "log.h"
-#include "string_utils.h"
+#include "scanner.h"
+#include "stats.h"
 
 #include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <stdio.h>
 
-/**
- * Splits a string into prs_StringItem items and inserts them
- * into the given linked list.
- *
- * @param dest a pointer to a linked list
- * @param source the string to split
- * @param length length of the given string
- * @return number of extracted items or -1 if an error occurs
- */
-static int splitItems(ll_LinkedList *dest, const char *source, size_t length) {
-    ll_LinkedList rawItemList;
-    ll_createLinkedList(&rawItemList, NULL);
-
-    int result = str_splitItems(source, length, &rawItemList, ' ');
-
-    ll_Iterator it = ll_createIterator(&rawItemList);
-
-    while (ll_iteratorHasNext(&it)) {
-        char *item = ll_iteratorNext(&it);
-
-        prs_StringItem *stringItem = malloc(sizeof(*stringItem));
-        stringItem->item = item;
-        stringItem->line = stringItem->column = -1;
-
-        ll_pushBack(dest, stringItem);
-    }
-
-    ll_freeLinkedList(&rawItemList, NULL);
-
-    return result;
-}
-
-int prs_extractGrammarItems(const char *source, size_t length, ll_LinkedList *itemList) {
+int prs_extractGrammarItems(const char *source, size_t length, vec_Vector *itemList, ar_Arena *arena) {
     assert(source);
     assert(itemList);
+    assert(arena);
 
-    // This buffer will hold a copy of the source
-    char *buffer = malloc(length);
-
-    if (!buffer) {
-        return -1;
-    }
+    prs_Scanner scanner;
+    prs_initScanner(&scanner, source, length, NULL);
 
-    size_t sourcePos = 0;
+    prs_ItemSpan span;
     int extractedItems = 0;
 
-    while (sourcePos < length) {
-        *buffer = '\0';
-        const char *currentPosPtr = source + sourcePos;
-
-        // Looking for a string block, we don't want to remove any spaces from it
-        char *startBlockPos = memchr(currentPosPtr, '`', length - sourcePos);
-
-        if (startBlockPos) {
-            // We have the position of the block's start, then we need to find its end
-            char *endBlockPos = memchr(startBlockPos + 1, '`', length - (startBlockPos - currentPosPtr + 1));
-            if (!endBlockPos) {
-                log_error("Missing end of string block");
-                return -1;
-            }
-
-            // Ensuring the current character is not the start of a block
-            if (currentPosPtr != startBlockPos) {
-                size_t blockLength = str_removeMultipleSpaces(buffer, currentPosPtr, startBlockPos - currentPosPtr);
-
-                int result = splitItems(itemList, buffer, blockLength);
-
-                if (result == -1) {
-                    log_error("Items extraction failed (1)");
-                    return -1;
-                }
-
-                extractedItems += result;
-
-                size_t stringBlockLength = endBlockPos - startBlockPos + 1;
-                char *stringBlock = malloc(stringBlockLength + 1);
-
-                if (!stringBlock) {
-                    log_error("string block allocation error");
-                    return -1;
-                }
-
-                stringBlock[stringBlockLength] = '\0';
-                memcpy(stringBlock, startBlockPos, stringBlockLength);
-
-                prs_StringItem *stringItem = malloc(sizeof(*stringItem));
-                stringItem->item = stringBlock;
-                stringItem->line = stringItem->column = -1;
+    while (prs_nextItem(&scanner, &span)) {
+        const char *itemStart = source + span.offset;
 
-                ll_pushBack(itemList, stringItem);
-                extractedItems += 1;
-            }
-
-            size_t stringBlockLength = endBlockPos - currentPosPtr + 1;
-            sourcePos += stringBlockLength;
+        if (span.kind == PRS_STRING_BLOCK_ITEM && (span.length < 2 || itemStart[span.length - 1] != '`')) {
+            log_error("Missing end of string block");
+            return -1;
         }
-        else {
-            ssize_t blockSize = str_removeMultipleSpaces(buffer, currentPosPtr, strlen(currentPosPtr));
 
-            int result = splitItems(itemList, buffer, blockSize);
-
-            if (result == -1) {
-                log_error("Items extraction failed (2)");
-                return -1;
-            }
+        prs_StringItem stringItem = {
+                .item = ar_strndup(arena, itemStart, span.length),
+                .line = span.line,
+                .column = span.column
+        };
 
-            extractedItems += result;
-            break;
+        if (!stringItem.item || !vec_pushBack(itemList, &stringItem)) {
+            log_error("Items extraction failed");
+            return -1;
         }
-    }
-
-    free(buffer);
 
-    const char *delimiters = "+|?;=";
-    ll_Iterator it = ll_createIterator(itemList);
-    int pwet = prs_splitDelimiters(&it, delimiters);
+        ++extractedItems;
+    }
 
-    return extractedItems + pwet;
+    return extractedItems;
 }
 
 ssize_t prs_readGrammar(FILE *stream, char **pBuffer) {
     assert(stream);
     assert(pBuffer);
 
-    char *fileContent = NULL;
-    size_t capacity = 0;
+    // One more char is always available for the null character
+    size_t capacity = 4096;
     size_t pos = 0;
+    char *fileContent = malloc(capacity + 1);
 
-    char buffer[512] = { '\0' };
+    if (!fileContent) {
+        return -1;
+    }
 
-    while (fgets(buffer, 512, stream)) {
-        size_t charsRead = strlen(buffer);
+    st_recordAllocation(capacity + 1);
 
-        if (charsRead == 0) {
-            break;
-        }
+    size_t charsRead;
 
-        if (pos + charsRead > capacity) {
-            size_t newCapacity = capacity;
+    while ((charsRead = fread(fileContent + pos, 1, capacity - pos, stream)) > 0) {
+        pos += charsRead;
 
-            while (newCapacity < pos + charsRead) {
-                newCapacity += 512;
-            }
-            char *newFileContentBuffer = realloc(fileContent, newCapacity);
+        if (pos == capacity) {
+            // Doubling the capacity keeps the number of copies linear
+            size_t newCapacity = capacity * 2;
+            char *newFileContentBuffer = realloc(fileContent, newCapacity + 1);
 
             if (!newFileContentBuffer) {
                 free(fileContent);
                 return -1;
             }
 
+            st_recordAllocation(newCapacity + 1);
+
             capacity = newCapacity;
             fileContent = newFileContentBuffer;
         }
+    }
 
-        memcpy(fileContent + pos, buffer, charsRead);
-        pos += charsRead;
-
-        *buffer = '\0';
+    if (ferror(stream)) {
+        free(fileContent);
+        return -1;
     }
 
-    *(fileContent + pos) = '\0';
+    fileContent[pos] = '\0';
     *pBuffer = fileContent;
 
     return pos;
 }
 
-bool prs_computeItemsPosition(const char *source, ll_Iterator *it) {
+bool prs_computeItemsPosition(const char *source, vec_Cursor *it) {
     assert(source);
     assert(it);
 
-    int line = 1;
-    int column = 1;
+    prs_LineTable lines;
 
-    while (ll_iteratorHasNext(it)) {
-        prs_StringItem *stringItem = ll_iteratorNext(it);
+    if (!prs_createLineTable(&lines)) {
+        return false;
+    }
 
-        char *start = strstr(source, stringItem->item);
+    size_t length = strlen(source);
 
-        if (!start) {
-            return false;
-        }
+    if (!prs_buildLineTable(&lines, source, length)) {
+        prs_freeLineTable(&lines);
+        return false;
+    }
 
-        for (const char *curr = source;curr != start;++curr) {
-            if (*curr == '\n') {
-                column = 1;
-                ++line;
-            }
-            else {
-                ++column;
-            }
-        }
+    const char *current = source;
+    bool found = true;
+
+    while (vec_cursorHasNext(it)) {
+        prs_StringItem *stringItem = vec_cursorNext(it);
 
-        stringItem->column = column;
-        stringItem->line = line;
+        const char *start = strstr(current, stringItem->item);
+
+        if (!start) {
+            found = false;
+            break;
+        }
 
-        source = start + strlen(stringItem->item);
-        column += strlen(stringItem->item);
+        prs_getLinePosition(&lines, start - source, &stringItem->line, &stringItem->column);
+        current = start + strlen(stringItem->item);
     }
 
-    return true;
+    prs_freeLineTable(&lines);
+
+    return found;
 }
 
 bool prs_stringItemEquals(prs_StringItem *si1, prs_StringItem *si2) {
@@ -224,19 +146,18 @@ bool prs_stringItemEquals(prs_StringItem *si1, prs_StringItem *si2) {
 void prs_freeStringItem(prs_StringItem *stringItem) {
     if (stringItem) {
         free(stringItem->item);
-        free(stringItem);
+        stringItem->item = NULL;
     }
 }
 
-prs_ErrCode prs_parseGrammarItems(fg_Grammar *g, ll_LinkedList *itemList) {
+prs_ErrCode prs_parseGrammarItems(fg_Grammar *g, vec_Vector *itemList) {
     assert(g);
     assert(itemList);
 
-    ll_Iterator it = ll_createIterator(itemList);
-    fg_Rule *entryRule = NULL;
+    vec_Cursor it = vec_createCursor(itemList);
 
-    while (ll_iteratorHasNext(&it)) {
-        prs_StringItem *stringItem = ll_iteratorNext(&it);
+    while (vec_cursorHasNext(&it)) {
+        prs_StringItem *stringItem = vec_cursorNext(&it);
 
         if (strlen(stringItem->item) < 2 || *stringItem->item != '%' || !isalpha(stringItem->item[1])) {
             prs_setErrorState(stringItem);
@@ -245,75 +166,240 @@ prs_ErrCode prs_parseGrammarItems(fg_Grammar *g, ll_LinkedList *itemList) {
 
         if (isupper(stringItem->item[1])) {
             // it should be a token
-            fg_Token *token = malloc(sizeof(*token));
-            memset(token, 0, sizeof(*token));
+            fg_Token *token = ar_calloc(&g->arena, 1, sizeof(*token));
 
-            int errCode = fg_extractToken(token, &it, stringItem);
+            int errCode = fg_extractToken(g, token, &it, stringItem);
 
             if (errCode != PRS_OK) {
-                fg_freeToken(token);
-                free(token);
                 prs_setErrorState(stringItem);
                 return errCode;
             }
 
-            if (ht_getValue(&g->tokens, token->name) != NULL) {
-                fg_freeToken(token);
-                free(token);
-                prs_setErrorState(stringItem);
+            errCode = fg_addToken(g, token);
 
-                return FG_TOKEN_EXISTS;
+            if (errCode != PRS_OK) {
+                prs_setErrorState(stringItem);
+                return errCode;
             }
-
-            ht_insertElement(&g->tokens, token->name, token);
         }
         else {
             // it should be a rule
-            fg_Rule *rule = malloc(sizeof(*rule));
-            fg_createRule(rule);
+            fg_Rule *rule = ar_alloc(&g->arena, sizeof(*rule));
+            fg_createRule(g, rule);
 
-            int errCode = fg_extractRule(rule, &it, stringItem);
+            int errCode = fg_extractRule(g, rule, &it, stringItem);
 
             if (errCode != PRS_OK) {
-                fg_freeRule(rule);
-                free(rule);
-
                 if (!prs_hasErrorState()) {
                     prs_setErrorState(stringItem);
                 }
                 return errCode;
             }
 
-            if (ht_getValue(&g->rules, rule->name) != NULL) {
-                fg_freeRule(rule);
-                free(rule);
+            errCode = fg_addRule(g, rule);
+
+            if (errCode != PRS_OK) {
                 prs_setErrorState(stringItem);
-                return FG_RULE_EXISTS;
+                return errCode;
             }
 
-            ht_insertElement(&g->rules, rule->name, rule);
-
-            if (!entryRule) {
-                entryRule = rule;
+            if (!g->entry) {
+                g->entry = rule;
             }
         }
     }
 
-    g->entry = entryRule;
-
     return PRS_OK;
 }
 
-struct ResolverArg {
-    fg_Grammar *g;
-    fg_Rule *rule;
-    int errCode;
-};
+/**
+ * Finds the end of the declaration that contains the given position.
+ *
+ * A declaration ends with the first semicolon that is not in a string block.
+ * The search can be resumed : pInBlock keeps the state between two calls.
+ *
+ * @return offset of the semicolon or length if it has not been found
+ */
+static size_t findDeclarationEnd(const char *buffer, size_t pos, size_t length, bool *pInBlock) {
+    bool inBlock = *pInBlock;
+
+    for (;pos < length;++pos) {
+        char c = buffer[pos];
+
+        if (c == '`') {
+            inBlock = !inBlock;
+        }
+        else if (c == ';' && !inBlock) {
+            break;
+        }
+    }
+
+    *pInBlock = inBlock;
+
+    return pos;
+}
+
+/**
+ * Moves a position (line, column) after the given text.
+ */
+static void advancePosition(const char *text, size_t length, int *pLine, int *pColumn) {
+    const char *end = text + length;
+    const char *lineStart = NULL;
+    const char *current = text;
+
+    while (current != end && (current = memchr(current, '\n', end - current)) != NULL) {
+        lineStart = ++current;
+        ++*pLine;
+    }
+
+    if (lineStart) {
+        *pColumn = (int) (end - lineStart) + 1;
+    }
+    else {
+        *pColumn += (int) length;
+    }
+}
+
+/**
+ * Extracts the items of one declaration and adds it to the grammar.
+ *
+ * Items are stored in the scratch vector and arena, which are emptied first.
+ * Their positions are shifted to the position of the declaration in the stream.
+ */
+static prs_ErrCode parseDeclaration(fg_Grammar *g, const char *source, size_t length, int line, int column,
+                                    vec_Vector *itemList, ar_Arena *scratch) {
+    vec_clear(itemList, NULL);
+    ar_resetArena(scratch);
+
+    if (prs_extractGrammarItems(source, length, itemList, scratch) == -1) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    for (size_t i = 0;i < itemList->size;++i) {
+        prs_StringItem *stringItem = vec_at(itemList, i);
+
+        if (stringItem->line == 1) {
+            stringItem->column += column - 1;
+        }
+
+        stringItem->line += line - 1;
+    }
+
+    return prs_parseGrammarItems(g, itemList);
+}
+
+prs_ErrCode prs_parseGrammarStream(fg_Grammar *g, FILE *stream) {
+    assert(g);
+    assert(stream);
+
+    size_t capacity = PRS_STREAM_CHUNK_SIZE;
+    char *buffer = malloc(capacity);
+
+    if (!buffer) {
+        return PRS_ALLOCATION_ERROR;
+    }
+
+    st_recordAllocation(capacity);
+
+    vec_Vector itemList;
+    vec_createVector(&itemList, sizeof(prs_StringItem), 0, NULL);
+
+    ar_Arena scratch;
+    ar_createArena(&scratch, PRS_STREAM_CHUNK_SIZE);
+
+    // The pending declaration is [start, end[, its end is searched from searchPos
+    size_t start = 0;
+    size_t end = 0;
+    size_t searchPos = 0;
+    bool inBlock = false;
+    bool eof = false;
+    int line = 1;
+    int column = 1;
+
+    prs_ErrCode errCode = PRS_OK;
+
+    while (errCode == PRS_OK) {
+        size_t declarationEnd = findDeclarationEnd(buffer, searchPos, end, &inBlock);
+
+        if (declarationEnd < end) {
+            size_t length = declarationEnd + 1 - start;
+
+            errCode = parseDeclaration(g, buffer + start, length, line, column, &itemList, &scratch);
+            advancePosition(buffer + start, length, &line, &column);
+
+            start = searchPos = declarationEnd + 1;
+            continue;
+        }
+
+        searchPos = end;
+
+        if (eof) {
+            if (inBlock) {
+                errCode = FG_STRING_BLOCK_MISSING_END;
+            }
+            else if (start < end) {
+                // Trailing whitespaces or a declaration without its end marker
+                errCode = parseDeclaration(g, buffer + start, end - start, line, column, &itemList, &scratch);
+            }
+            break;
+        }
+
+        // Only the pending declaration is kept before reading the next chunk
+        if (start > 0) {
+            memmove(buffer, buffer + start, end - start);
+            end -= start;
+            searchPos -= start;
+            start = 0;
+        }
+
+        if (end == capacity) {
+            // The pending declaration is bigger than the buffer
+            char *newBuffer = realloc(buffer, capacity * 2);
+
+            if (!newBuffer) {
+                errCode = PRS_ALLOCATION_ERROR;
+                break;
+            }
+
+            st_recordAllocation(capacity * 2);
+
+            buffer = newBuffer;
+            capacity *= 2;
+        }
+
+        size_t charsRead = fread(buffer + end, 1, capacity - end, stream);
+        end += charsRead;
+
+        if (charsRead == 0) {
+            if (ferror(stream)) {
+                errCode = PRS_READ_ERROR;
+            }
 
-static void resolveProductionRulesSymbols(void *data, void *args) {
-    ll_LinkedList *pr = data;
-    struct ResolverArg *resolverArg = args;
+            eof = true;
+        }
+    }
+
+    ar_freeArena(&scratch);
+    vec_freeVector(&itemList, NULL);
+    free(buffer);
+
+    return errCode;
+}
 
+/**
+ * Sets the error state on a symbol reference.
+ */
+static void setSymbolErrorState(fg_Grammar *g, const fg_SymbolRef *symbol) {
+    prs_StringItem stringItem = {
+            .item = (char*) sym_getName(&g->symbols, symbol->id),
+            .line = symbol->line,
+            .column = symbol->column
+    };
+
+    prs_setErrorState(&stringItem);
+}
+
+static prs_ErrCode resolveProductionRuleSymbols(fg_Grammar *g, ll_LinkedList *pr) {
     ll_Iterator it;
     ll_initIterator(&it, pr);
 
@@ -321,47 +407,42 @@ static void resolveProductionRulesSymbols(void *data, void *args) {
         fg_PRItem *prItem = ll_iteratorNext(&it);
 
         if (prItem->type == FG_RULE_ITEM) {
-            fg_Rule *refRule = ht_getValue(&resolverArg->g->rules, prItem->symbol->item);
+            fg_Rule *refRule = fg_getRuleById(g, prItem->symbol.id);
 
             if (!refRule) {
-                resolverArg->errCode = FG_UNKNOWN_RULE;
-                prs_setErrorState(prItem->symbol);
-                break;
+                setSymbolErrorState(g, &prItem->symbol);
+                return FG_UNKNOWN_RULE;
             }
 
             prItem->value.rule = refRule;
         }
         else if (prItem->type == FG_TOKEN_ITEM) {
-            fg_Token *refToken = ht_getValue(&resolverArg->g->tokens, prItem->symbol->item);
+            fg_Token *refToken = fg_getTokenById(g, prItem->symbol.id);
 
             if (!refToken) {
-                resolverArg->errCode = FG_UNKNOWN_TOKEN;
-                prs_setErrorState(prItem->symbol);
-                break;
+                setSymbolErrorState(g, &prItem->symbol);
+                return FG_UNKNOWN_TOKEN;
             }
 
             prItem->value.token = refToken;
         }
     }
+
+    return PRS_OK;
 }
 
 prs_ErrCode prs_resolveSymbols(fg_Grammar *g) {
-    ht_Iterator tokensIt;
-    ht_createIterator(&tokensIt, &g->tokens);
-
-    ht_Iterator rulesIt;
-    ht_createIterator(&rulesIt, &g->rules);
+    assert(g);
 
-    while (ht_iteratorHasNext(&tokensIt)) {
-        ht_KVPair *pair = ht_iteratorNext(&tokensIt);
-        fg_Token *token = pair->value;
+    for (size_t i = 0;i < g->tokens.size;++i) {
+        fg_Token *token = *((fg_Token**) vec_at(&g->tokens, i));
 
         if (token->type == FG_REF_TOKEN) {
             struct fg_RefToken *refTokenValue = &token->value.refToken;
-            fg_Token *refToken = ht_getValue(&g->tokens, refTokenValue->symbol->item);
+            fg_Token *refToken = fg_getTokenById(g, refTokenValue->symbol.id);
 
             if (!refToken) {
-                prs_setErrorState(refTokenValue->symbol);
+                setSymbolErrorState(g, &refTokenValue->symbol);
                 return FG_UNKNOWN_TOKEN;
             }
 
@@ -369,74 +450,22 @@ prs_ErrCode prs_resolveSymbols(fg_Grammar *g) {
         }
     }
 
-    struct ResolverArg resolverArg = { .g = g, .errCode = PRS_OK };
-
-    while (ht_iteratorHasNext(&rulesIt)) {
-        ht_KVPair *pair = ht_iteratorNext(&rulesIt);
-        fg_Rule *rule = pair->value;
-
-        resolverArg.rule = rule;
-
-        ll_forEachItem(&rule->productionRuleList, resolveProductionRulesSymbols, &resolverArg);
-
-        if (resolverArg.errCode != PRS_OK) {
-            return resolverArg.errCode;
-        }
-    }
-
-    return PRS_OK;
-}
-
-int prs_splitDelimiters(ll_Iterator *it, const char *delimiters) {
-    assert(it);
-    assert(delimiters);
+    for (size_t i = 0;i < g->rules.size;++i) {
+        fg_Rule *rule = *((fg_Rule**) vec_at(&g->rules, i));
 
-    int extractedItems = 0;
+        ll_Iterator it;
+        ll_initIterator(&it, &rule->productionRuleList);
 
-    while (ll_iteratorHasNext(it)) {
-        prs_StringItem *stringItem = ll_iteratorNext(it);
-        char *item = stringItem->item;
+        while (ll_iteratorHasNext(&it)) {
+            prs_ErrCode errCode = resolveProductionRuleSymbols(g, ll_iteratorNext(&it));
 
-        if (*item == '`') {
-            // If the item is a string block then it does not
-            // require to be splitter
-            continue;
-        }
-
-        char *ptr = strpbrk(item, delimiters);
-
-        if (ptr && strlen(item) > 1) {
-            // A 1-char length item does not require to be splitted
-
-            if (ptr == item) {
-                // If the item starts with a delimiter then we should
-                // keep it and put following characters into a new item.
-                ++ptr;
+            if (errCode != PRS_OK) {
+                return errCode;
             }
-
-            // Length of the new item
-            size_t length = item + strlen(item) - ptr;
-            char *newItem = malloc(length + 1);
-            memcpy(newItem, ptr, length);
-            newItem[length] = '\0';
-
-            prs_StringItem *stringItem2 = malloc(sizeof(*stringItem2));
-            stringItem2->item = newItem;
-            stringItem2->column = stringItem->line = -1;
-
-            // Inserts the new item into the list right after the current item
-            ll_iteratorInsert(it, stringItem2);
-
-            // Adds a null character at the position of the delimiter
-            // We only keep the part that is before the delimiter
-            // or the character itself in the case of ptr==item.
-            *ptr = '\0';
-
-            ++extractedItems;
         }
     }
 
-    return extractedItems;
+    return PRS_OK;
 }
 
 static void parserItemDestructor(prs_ParserItem *parserItem) {
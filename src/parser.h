@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "collections/arena.h"
 #include "parser_errors.h"
 #include "range.h"
 
@@ -35,8 +36,8 @@ typedef struct prs_ParserItem {
     union prs_ParserItemValue value;
 } prs_ParserItem;
 
-struct ll_LinkedList;
-struct ll_Iterator;
+struct vec_Vector;
+struct vec_Cursor;
 
 struct fg_Grammar;
 struct fg_PRItem;
@@ -45,35 +46,52 @@ struct fg_Rule;
 /**
  * Extracts items from a given raw grammar.
  *
- * Available items are : ";", "=", "|", "+", "?", token name, rule items, ranges.
+ * Available items are : ";", "=", "|", "+", "?", "*", token name, rule items, ranges.
  * All extracted items are null terminated.
  *
+ * The source is read only once by a {@link prs_Scanner}, it does not need
+ * to be null terminated. The line and the column of each item are recorded
+ * during this pass.
+ * If a string block has no end marker then -1 will be returned.
+ *
+ * Items are stored by value in the given vector of prs_StringItem, their strings
+ * are allocated in the given arena : the vector should not have a destructor.
+ *
  * @param source
  * @param length length of the source
- * @param itemList list that will receive extracted items
- * @return number of extracted items
+ * @param itemList vector of prs_StringItem that will receive extracted items
+ * @param arena arena that will hold the items' strings
+ * @return number of extracted items or -1 if an error occurs
  */
-int prs_extractGrammarItems(const char *source, size_t length, struct ll_LinkedList *itemList);
+int prs_extractGrammarItems(const char *source, size_t length, struct vec_Vector *itemList, ar_Arena *arena);
 
 /**
  * Computes position of each item in the list in the given source.
  *
+ * Items extracted by {@link prs_extractGrammarItems} already have a position,
+ * this function is only needed for items that come from another source.
+ *
  * The source must be a null terminated string.
  * If an item is not found in the string, then the function will return false.
  * This functions updates fields line and column of prs_StringItem structure.
+ * Positions are found with a binary search in a table of line starts, the
+ * source is only scanned once.
  *
  * @param source a null terminated string
- * @param it pointer to an iterator on a prs_String list
+ * @param it pointer to a cursor on a vector of prs_StringItem
  * @return true if all items have been found in the string, otherwise false
  */
-bool prs_computeItemsPosition(const char *source, struct ll_Iterator *it);
+bool prs_computeItemsPosition(const char *source, struct vec_Cursor *it);
 
 bool prs_stringItemEquals(prs_StringItem *si1, prs_StringItem *si2);
 
 /**
  * Frees allocated memory for the given string item.
  *
- * The given pointer will not be freed.
+ * Only the string is freed, items whose string has been allocated
+ * in an arena must not be given to this function.
+ * The given pointer will not be freed, it can be used as
+ * a vector destructor.
  *
  * @param stringItem a pointer to a string item
  */
@@ -83,6 +101,9 @@ void prs_freeStringItem(prs_StringItem *stringItem);
  * Transforms a list of items into a grammar structure.
  *
  * A grammar is made by one or more rule and token definitions.
+ * Tokens and rules are allocated in the grammar's arena.
+ * The first rule of the grammar becomes its entry rule, the items
+ * can be given by several calls.
  *
  * If a prs_StringItem does not correspond to a rule or a token, PrS_UNKNOWN_ITEM will
  * be returned.
@@ -96,10 +117,37 @@ void prs_freeStringItem(prs_StringItem *stringItem);
  * Other error codes can be returned by {@link fg_extractToken}.
  *
  * @param g a pointer to the grammar structure
- * @param itemList a pointer to a list of prs_StringItem
+ * @param itemList a pointer to a vector of prs_StringItem
  * @return PRS_OK if not error occurs, otherwise a different error code
  */
-prs_ErrCode prs_parseGrammarItems(struct fg_Grammar *g, struct ll_LinkedList *itemList);
+prs_ErrCode prs_parseGrammarItems(struct fg_Grammar *g, struct vec_Vector *itemList);
+
+/**
+ * Size of the chunks read by {@link prs_parseGrammarStream}.
+ */
+#define PRS_STREAM_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Parses a grammar from a stream, one declaration at a time.
+ *
+ * The stream is read by chunks. Each declaration is given to the token
+ * and rule extractors as soon as its semicolon has been read, then its
+ * items are released : only one declaration is kept in memory besides
+ * the grammar itself.
+ *
+ * Symbols are not resolved, {@link prs_resolveSymbols} must be called
+ * once the whole stream has been parsed.
+ *
+ * If the stream can not be read then PRS_READ_ERROR will be returned.
+ * If the last string block has no end marker then FG_STRING_BLOCK_MISSING_END
+ * will be returned.
+ * Other error codes can be returned by {@link prs_parseGrammarItems}.
+ *
+ * @param g a pointer to the grammar structure
+ * @param stream input stream
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode prs_parseGrammarStream(struct fg_Grammar *g, FILE *stream);
 
 /**
  * Resolves symbol references.
@@ -123,8 +171,9 @@ prs_ErrCode prs_resolveSymbols(struct fg_Grammar *g);
  * The buffer should be NULL before calling this function.
  *
  * The caller has the responsability of freeing this buffer.
+ * The buffer grows geometrically while the stream is read.
  *
- * If an allocation error occurs, then -1 will be returned.
+ * If an allocation error or a read error occurs, then -1 will be returned.
  *
  * @param stream input stream
  * @param pBuffer pointer to a NULL buffer
@@ -132,22 +181,6 @@ prs_ErrCode prs_resolveSymbols(struct fg_Grammar *g);
  */
 ssize_t prs_readGrammar(FILE *stream, char **pBuffer);
 
-/**
- * Separates items from any delimiter in the given string.
- *
- * Example : RULE= -> will be separated into 2 items : RULE, =
- * Separated items (ex: =) will be added into the list with
- * the given iterator. They will be placed between the original item
- * and the next one. The list order will be preserved.
- *
- * The delimiters string must be null terminated.
- *
- * @param it iterator on the item list
- * @param delimiters string of delimiters
- * @return number of added elements into the list
- */
-int prs_splitDelimiters(struct ll_Iterator *it, const char *delimiters);
-
 /**
  * Frees allocated memory for the given parser item.
  *
@@ -34,7 +34,15 @@ static const char *errorMessages[] = {
         "Empty production rule",
         "Unknown production rule item type",
         "Missing end marker for string block",
-        "Empty string block"
+        "Empty string block",
+
+        "Unable to read grammar",
+        "Memory allocation failed",
+
+        "Cyclic token reference",
+
+        "Grammar without rule",
+        "Grammar is not LL(1)"
 };
 
 size_t prs_getErrorMessage(char *buffer, size_t capacity, prs_ErrCode errCode) {
@@ -57,10 +65,9 @@ size_t prs_getErrorMessage(char *buffer, size_t capacity, prs_ErrCode errCode) {
     size_t totalLength = copiedChars;
     char *currentBufferPos = buffer + copiedChars;
 
-    if (_currentState.stringItem) {
-        prs_StringItem *stringItem = _currentState.stringItem;
+    if (_currentState.isSet) {
         totalLength += snprintf(currentBufferPos, remainingCapacity, " %s (%d:%d)",
-                                stringItem->item, stringItem->line, stringItem->column);
+                                _currentState.item, _currentState.line, _currentState.column);
     }
 
     *(buffer + totalLength) = '\0';
@@ -69,11 +76,16 @@ size_t prs_getErrorMessage(char *buffer, size_t capacity, prs_ErrCode errCode) {
 }
 
 bool prs_hasErrorState() {
-    return _currentState.stringItem != NULL;
+    return _currentState.isSet;
 }
 
 void prs_setErrorState(prs_StringItem *stringItem) {
     assert(stringItem);
 
-    _currentState.stringItem = stringItem;
+    _currentState.isSet = true;
+    _currentState.line = stringItem->line;
+    _currentState.column = stringItem->column;
+
+    strncpy(_currentState.item, stringItem->item, PRS_ERROR_ITEM_CAPACITY - 1);
+    _currentState.item[PRS_ERROR_ITEM_CAPACITY - 1] = '\0';
 }
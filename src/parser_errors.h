@@ -42,11 +42,33 @@ typedef enum prs_ErrCode {
     FG_STRING_BLOCK_MISSING_END,
     FG_STRING_BLOCK_EMPTY,
 
+    PRS_READ_ERROR,
+    PRS_ALLOCATION_ERROR,
+
+    FG_TOKEN_REF_CYCLE,
+
+    FG_NO_RULE,
+    LL1_GRAMMAR_CONFLICT,
+
     PRS_MAX_CODE_NUMBER
 } prs_ErrCode;
 
+/**
+ * Maximum number of chars of an item kept by the error state.
+ */
+#define PRS_ERROR_ITEM_CAPACITY 64
+
+/**
+ * Item that caused the last error.
+ *
+ * The item is copied (and truncated if needed) : the error state
+ * does not depend on the lifetime of the items given to the parser.
+ */
 typedef struct prs_ErrorState {
-    struct prs_StringItem *stringItem;
+    bool isSet;
+    int line;
+    int column;
+    char item[PRS_ERROR_ITEM_CAPACITY];
 } prs_ErrorState;
 
 /**
@@ -3,8 +3,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
-
-#include "string_utils.h"
+#include <string.h>
 
 #define ASCII_DIGIT_START 48
 #define ASCII_DIGIT_END 57
@@ -48,30 +47,166 @@ prs_ErrCode prs_createLetterRange(prs_Range *range, char c1, char c2, bool upper
     return createRange(range, c1, c2, ASCII_LETTER_START, ASCII_LETTER_END);
 }
 
-/*bool lex_matchInRange(lex_Range *range, char c, bool isLetter) {
+bool prs_matchInRange(prs_Range *range, char c, bool isLetter) {
     assert(range);
 
-    for (const char *curr = range->start; curr != range->end; ++curr) {
-        if ((isLetter && range->uppercaseLetter && toupper(*curr) == c) || *curr == c) {
-            return true;
+    uint8_t byte = (uint8_t) c;
+
+    // Bounds of an uppercase range are stored in lowercase
+    if (range->uppercaseLetter) {
+        if (!isLetter || !isupper(byte)) {
+            return false;
         }
+
+        byte = (uint8_t) tolower(byte);
     }
 
-    return false;
-} */
+    return range->start <= byte && byte < range->end;
+}
 
-prs_ErrCode prs_extractRange(prs_Range *range, const char *input) {
+void prs_compileRangeArray(prs_RangeArray *rangeArray) {
+    assert(rangeArray);
+
+    prs_clearCharClass(&rangeArray->charClass);
+
+    for (size_t i = 0;i < rangeArray->size;++i) {
+        prs_addRange(&rangeArray->charClass, rangeArray->ranges + i);
+    }
+}
+
+bool prs_matchInRangeArray(const prs_RangeArray *rangeArray, char c) {
+    assert(rangeArray);
+
+    return prs_charClassContains(&rangeArray->charClass, c);
+}
+
+void prs_clearCharClass(prs_CharClass *charClass) {
+    assert(charClass);
+
+    memset(charClass->words, 0, sizeof(charClass->words));
+}
+
+void prs_addCharInterval(prs_CharClass *charClass, uint8_t low, uint8_t high) {
+    assert(charClass);
+    assert(low <= high);
+
+    for (int word = low >> 6;word <= high >> 6;++word) {
+        int first = (word == low >> 6) ? low & 63 : 0;
+        int last = (word == high >> 6) ? high & 63 : 63;
+
+        // Bits first to last, shifting by 64 is undefined
+        uint64_t mask = (~UINT64_C(0) << first) & (~UINT64_C(0) >> (63 - last));
+        charClass->words[word] |= mask;
+    }
+}
+
+void prs_addRange(prs_CharClass *charClass, const prs_Range *range) {
+    assert(charClass);
     assert(range);
-    assert(input);
 
-    char c1, c2;
+    if (range->end <= range->start) {
+        return;
+    }
+
+    uint8_t low = range->start;
+    uint8_t high = range->end - 1;
+
+    if (range->uppercaseLetter) {
+        low = (uint8_t) toupper(low);
+        high = (uint8_t) toupper(high);
+    }
+
+    prs_addCharInterval(charClass, low, high);
+}
+
+void prs_charClassUnion(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2) {
+    assert(result);
+    assert(c1);
+    assert(c2);
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        result->words[i] = c1->words[i] | c2->words[i];
+    }
+}
+
+void prs_charClassIntersection(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2) {
+    assert(result);
+    assert(c1);
+    assert(c2);
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        result->words[i] = c1->words[i] & c2->words[i];
+    }
+}
+
+void prs_charClassDifference(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2) {
+    assert(result);
+    assert(c1);
+    assert(c2);
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        result->words[i] = c1->words[i] & ~c2->words[i];
+    }
+}
+
+void prs_charClassComplement(prs_CharClass *result, const prs_CharClass *charClass) {
+    assert(result);
+    assert(charClass);
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        result->words[i] = ~charClass->words[i];
+    }
+}
 
-    int extractedElements = sscanf(input, "%c-%c", &c1, &c2);
+bool prs_charClassIsEmpty(const prs_CharClass *charClass) {
+    assert(charClass);
+
+    return (charClass->words[0] | charClass->words[1] | charClass->words[2] | charClass->words[3]) == 0;
+}
+
+bool prs_charClassEquals(const prs_CharClass *c1, const prs_CharClass *c2) {
+    assert(c1);
+    assert(c2);
+
+    return memcmp(c1->words, c2->words, sizeof(c1->words)) == 0;
+}
+
+int prs_charClassCount(const prs_CharClass *charClass) {
+    assert(charClass);
+
+    int count = 0;
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        count += __builtin_popcountll(charClass->words[i]);
+    }
+
+    return count;
+}
+
+int prs_charClassFirst(const prs_CharClass *charClass) {
+    assert(charClass);
+
+    for (int i = 0;i < PRS_CHAR_CLASS_WORDS;++i) {
+        if (charClass->words[i] != 0) {
+            return (i << 6) + __builtin_ctzll(charClass->words[i]);
+        }
+    }
 
-    if (extractedElements != 2) {
+    return -1;
+}
+
+prs_ErrCode prs_extractRange(prs_Range *range, const char *input) {
+    assert(range);
+    assert(input);
+
+    // A pattern is made of two chars separated by a dash
+    if (input[0] == '\0' || input[1] != '-' || input[2] == '\0') {
         return PRS_INVALID_RANGE_PATTERN;
     }
 
+    unsigned char c1 = (unsigned char) input[0];
+    unsigned char c2 = (unsigned char) input[2];
+
     if (isalpha(c1) && isalpha(c2)) {
         return prs_createLetterRange(range, c1, c2, isupper(c1) && isupper(c2));
     }
@@ -83,61 +218,69 @@ prs_ErrCode prs_extractRange(prs_Range *range, const char *input) {
     }
 }
 
-prs_ErrCode prs_extractRanges(prs_RangeArray *rangeArray, const char *input, size_t length) {
+prs_ErrCode prs_extractRanges(prs_RangeArray *rangeArray, const char *input, size_t length, ar_Arena *arena) {
     assert(rangeArray);
     assert(input);
+    assert(arena);
 
-    if (length == 0) {
-        return PRS_OK;
-    }
+    rangeArray->ranges = NULL;
+    rangeArray->size = 0;
+    prs_clearCharClass(&rangeArray->charClass);
 
-    char *buffer = calloc(length, 1);
+    size_t lengthWithoutSpaces = 0;
 
-    size_t lengthWithoutSpaces = str_removeWhitespaces(buffer, input, length);
+    for (size_t i = 0;i < length && input[i] != '\0';++i) {
+        if (!isspace((unsigned char) input[i])) {
+            ++lengthWithoutSpaces;
+        }
+    }
 
     if (lengthWithoutSpaces == 0) {
         return PRS_OK;
     }
 
     if (lengthWithoutSpaces % 3 != 0) {
-        free(buffer);
         return PRS_INVALID_RANGE_PATTERN;
     }
 
     size_t rangesNumber = lengthWithoutSpaces / 3;
-    prs_Range *ranges = calloc(rangesNumber, sizeof(*ranges));
+    prs_Range *ranges = ar_calloc(arena, rangesNumber, sizeof(*ranges));
 
-    const char *pos = input;
-    size_t i;
+    if (!ranges) {
+        return PRS_ALLOCATION_ERROR;
+    }
 
-    for (i = 0;i < rangesNumber;++i) {
-        prs_ErrCode errCode = prs_extractRange(ranges + i, pos);
+    // Each range pattern is made by the 3 next chars that are not spaces
+    char pattern[4] = { '\0' };
+    size_t patternLength = 0;
+    size_t i = 0;
 
-        if (errCode != PRS_OK) {
-            free(buffer);
-            free(ranges);
-            return errCode;
+    for (const char *pos = input;i < rangesNumber;++pos) {
+        if (isspace((unsigned char) *pos)) {
+            continue;
         }
 
-        pos += 3;
-    }
+        pattern[patternLength++] = *pos;
+
+        if (patternLength == 3) {
+            prs_ErrCode errCode = prs_extractRange(ranges + i, pattern);
+
+            if (errCode != PRS_OK) {
+                return errCode;
+            }
 
-    free(buffer);
+            patternLength = 0;
+            ++i;
+        }
+    }
 
     rangeArray->ranges = ranges;
     rangeArray->size = i;
+    prs_compileRangeArray(rangeArray);
 
     return PRS_OK;
 }
 
-void prs_freeRangeArray(prs_RangeArray *rangeArray) {
-    if (rangeArray) {
-        free(rangeArray->ranges);
-        rangeArray->ranges = NULL;
-        rangeArray->size = 0;
-    }
-}
-
 bool prs_rangeEquals(prs_Range *r1, prs_Range *r2) {
     assert(r1);
     assert(r2);
@@ -6,6 +6,7 @@
  * Defines structures and functions to use ranges in a grammar.
  */
 
+#include "collections/arena.h"
 #include "parser_errors.h"
 
 #include <stdbool.h>
@@ -24,11 +25,38 @@ typedef struct prs_Range {
     uint8_t end;
 } prs_Range;
 
+#define PRS_CHAR_CLASS_WORDS 4
+
+/**
+ * Set of bytes stored as a 256-bit bitmap.
+ *
+ * The bit (c % 64) of the word (c / 64) is set when the byte c is in the class.
+ */
+typedef struct prs_CharClass {
+    uint64_t words[PRS_CHAR_CLASS_WORDS];
+} prs_CharClass;
+
+/**
+ * Ranges of a token and the bitmap of the bytes they match.
+ *
+ * The bitmap is compiled by prs_extractRanges, or by prs_compileRangeArray
+ * when ranges are set by hand.
+ */
 typedef struct prs_RangeArray {
     prs_Range *ranges;
     size_t size;
+    prs_CharClass charClass;
 } prs_RangeArray;
 
+/**
+ * Checks if a byte is in a character class.
+ *
+ * @param charClass a pointer to a character class
+ * @param c a byte (char or uint8_t)
+ */
+#define prs_charClassContains(charClass, c) \
+    ((((charClass)->words[(uint8_t) (c) >> 6]) >> ((uint8_t) (c) & 63)) & 1)
+
 /**
  * Creates a digit range.
  *
@@ -90,26 +118,131 @@ prs_ErrCode prs_extractRange(prs_Range *range, const char *input);
  * Extracts several ranges from a given string.
  *
  * The string must only contain one or more patterns without square brackets.
+ * Whitespaces between patterns are ignored.
  * If the string contains an invalid pattern, then PRS_INVALID_RANGE_PATTERN will
  * be returned.
  *
- * An array of prs_Range will be allocated in the range array structure.
+ * The array of prs_Range will be allocated in the given arena.
  *
  * @param rangeArray a pointer to a range array
  * @param input source string
  * @param length length of the string
+ * @param arena arena that will hold the ranges
  * @return PRS_OK if not error occured, otherwise an error
  */
-prs_ErrCode prs_extractRanges(prs_RangeArray *rangeArray, const char *input, size_t length);
+prs_ErrCode prs_extractRanges(prs_RangeArray *rangeArray, const char *input, size_t length, ar_Arena *arena);
 
 /**
- * Frees allocated memory to store several ranges.
+ * Compiles the ranges of an array into its bitmap.
  *
- * The given pointer will not be freed.
+ * An uppercase letter range only matches uppercase letters.
  *
  * @param rangeArray a pointer to a range array
  */
-void prs_freeRangeArray(prs_RangeArray *rangeArray);
+void prs_compileRangeArray(prs_RangeArray *rangeArray);
+
+/**
+ * Checks if the given char is matched by one of the ranges of an array.
+ *
+ * The compiled bitmap is used, it costs one bit test.
+ *
+ * @param rangeArray a pointer to a compiled range array
+ * @param c a char
+ * @return true if the char is matched, otherwise false
+ */
+bool prs_matchInRangeArray(const prs_RangeArray *rangeArray, char c);
+
+/**
+ * Removes all bytes from a character class.
+ *
+ * @param charClass a pointer to a character class
+ */
+void prs_clearCharClass(prs_CharClass *charClass);
+
+/**
+ * Adds the bytes between low and high (included) to a character class.
+ *
+ * @param charClass a pointer to a character class
+ * @param low first byte
+ * @param high last byte
+ */
+void prs_addCharInterval(prs_CharClass *charClass, uint8_t low, uint8_t high);
+
+/**
+ * Adds the bytes matched by a range to a character class.
+ *
+ * @param charClass a pointer to a character class
+ * @param range a pointer to a range
+ */
+void prs_addRange(prs_CharClass *charClass, const prs_Range *range);
+
+/**
+ * Computes the union of two classes, the result can be one of them.
+ *
+ * @param result a pointer to the class that receives the union
+ * @param c1 a pointer to a character class
+ * @param c2 a pointer to a character class
+ */
+void prs_charClassUnion(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2);
+
+/**
+ * Computes the intersection of two classes, the result can be one of them.
+ *
+ * @param result a pointer to the class that receives the intersection
+ * @param c1 a pointer to a character class
+ * @param c2 a pointer to a character class
+ */
+void prs_charClassIntersection(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2);
+
+/**
+ * Computes the bytes of c1 that are not in c2, the result can be one of them.
+ *
+ * @param result a pointer to the class that receives the difference
+ * @param c1 a pointer to a character class
+ * @param c2 a pointer to a character class
+ */
+void prs_charClassDifference(prs_CharClass *result, const prs_CharClass *c1, const prs_CharClass *c2);
+
+/**
+ * Computes the complement of a class, the result can be the class itself.
+ *
+ * @param result a pointer to the class that receives the complement
+ * @param charClass a pointer to a character class
+ */
+void prs_charClassComplement(prs_CharClass *result, const prs_CharClass *charClass);
+
+/**
+ * Checks if a class does not contain any byte.
+ *
+ * @param charClass a pointer to a character class
+ * @return true if the class is empty, otherwise false
+ */
+bool prs_charClassIsEmpty(const prs_CharClass *charClass);
+
+/**
+ * Checks if two classes contain the same bytes.
+ *
+ * @param c1 a pointer to a character class
+ * @param c2 a pointer to a character class
+ * @return true if the classes are equal, otherwise false
+ */
+bool prs_charClassEquals(const prs_CharClass *c1, const prs_CharClass *c2);
+
+/**
+ * Gets the number of bytes in a class.
+ *
+ * @param charClass a pointer to a character class
+ * @return the number of bytes
+ */
+int prs_charClassCount(const prs_CharClass *charClass);
+
+/**
+ * Gets the lowest byte of a class.
+ *
+ * @param charClass a pointer to a character class
+ * @return the lowest byte or -1 if the class is empty
+ */
+int prs_charClassFirst(const prs_CharClass *charClass);
 
 bool prs_rangeEquals(prs_Range *r1, prs_Range *r2);
 bool prs_rangeArrayEquals(prs_RangeArray *ra1, prs_RangeArray *ra2);
@@ -0,0 +1,177 @@
+#include "run_scanner.h"
+
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RS_X86
+#endif
+
+#if defined(RS_X86) && defined(__SSE2__)
+#define RS_SSE2
+#endif
+
+static size_t scanScalar(const rs_RunScanner *scanner, const char *input, size_t length) {
+    const prs_CharClass *charClass = &scanner->charClass;
+    size_t i = 0;
+
+    while (i < length && prs_charClassContains(charClass, input[i])) {
+        ++i;
+    }
+
+    return i;
+}
+
+#ifdef RS_SSE2
+
+static size_t scanSse2(const rs_RunScanner *scanner, const char *input, size_t length) {
+    __m128i lows[RS_MAX_INTERVALS];
+    __m128i widths[RS_MAX_INTERVALS];
+    int intervalCount = scanner->intervalCount;
+
+    for (int k = 0;k < intervalCount;++k) {
+        lows[k] = _mm_set1_epi8((char) scanner->lows[k]);
+        widths[k] = _mm_set1_epi8((char) scanner->widths[k]);
+    }
+
+    size_t i = 0;
+
+    for (;i + 16 <= length;i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (input + i));
+        __m128i matched = _mm_setzero_si128();
+
+        // low <= b <= low + width if (b - low) does not exceed width, without sign
+        for (int k = 0;k < intervalCount;++k) {
+            __m128i shifted = _mm_sub_epi8(bytes, lows[k]);
+            matched = _mm_or_si128(matched, _mm_cmpeq_epi8(_mm_min_epu8(shifted, widths[k]), shifted));
+        }
+
+        unsigned mask = (unsigned) _mm_movemask_epi8(matched);
+
+        if (mask != 0xFFFF) {
+            return i + (size_t) __builtin_ctz(~mask);
+        }
+    }
+
+    return i + scanScalar(scanner, input + i, length - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scanAvx2(const rs_RunScanner *scanner, const char *input, size_t length) {
+    __m256i lows[RS_MAX_INTERVALS];
+    __m256i widths[RS_MAX_INTERVALS];
+    int intervalCount = scanner->intervalCount;
+
+    for (int k = 0;k < intervalCount;++k) {
+        lows[k] = _mm256_set1_epi8((char) scanner->lows[k]);
+        widths[k] = _mm256_set1_epi8((char) scanner->widths[k]);
+    }
+
+    size_t i = 0;
+
+    for (;i + 32 <= length;i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (input + i));
+        __m256i matched = _mm256_setzero_si256();
+
+        for (int k = 0;k < intervalCount;++k) {
+            __m256i shifted = _mm256_sub_epi8(bytes, lows[k]);
+            matched = _mm256_or_si256(matched, _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, widths[k]), shifted));
+        }
+
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(matched);
+
+        if (mask != UINT32_MAX) {
+            return i + (size_t) __builtin_ctz(~mask);
+        }
+    }
+
+    // The end is scanned by 16 bytes then byte by byte
+    return i + scanSse2(scanner, input + i, length - i);
+}
+
+#endif // RS_SSE2
+
+rs_Kernel rs_getBestKernel(void) {
+#ifdef RS_SSE2
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return RS_AVX2_KERNEL;
+    }
+
+    return RS_SSE2_KERNEL;
+#else
+    return RS_SCALAR_KERNEL;
+#endif
+}
+
+const char *rs_getKernelName(rs_Kernel kernel) {
+    switch (kernel) {
+        case RS_SSE2_KERNEL:
+            return "sse2";
+        case RS_AVX2_KERNEL:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+void rs_createRunScanner(rs_RunScanner *scanner, const prs_CharClass *charClass) {
+    assert(scanner);
+    assert(charClass);
+
+    scanner->charClass = *charClass;
+    scanner->intervalCount = 0;
+
+    int c = 0;
+    bool vectorizable = true;
+
+    while (c < 256) {
+        if (!prs_charClassContains(charClass, c)) {
+            ++c;
+            continue;
+        }
+
+        int low = c;
+
+        while (c < 256 && prs_charClassContains(charClass, c)) {
+            ++c;
+        }
+
+        if (scanner->intervalCount == RS_MAX_INTERVALS) {
+            vectorizable = false;
+            break;
+        }
+
+        scanner->lows[scanner->intervalCount] = (uint8_t) low;
+        scanner->widths[scanner->intervalCount] = (uint8_t) (c - 1 - low);
+        ++scanner->intervalCount;
+    }
+
+    scanner->kernel = (vectorizable) ? rs_getBestKernel() : RS_SCALAR_KERNEL;
+}
+
+size_t rs_scanRunWith(const rs_RunScanner *scanner, rs_Kernel kernel, const char *input, size_t length) {
+    assert(scanner);
+    assert(input || length == 0);
+
+    // The kernel of the scanner is the best one supported by the CPU and the class
+    if (kernel > scanner->kernel) {
+        kernel = scanner->kernel;
+    }
+
+    switch (kernel) {
+#ifdef RS_SSE2
+        case RS_AVX2_KERNEL:
+            return scanAvx2(scanner, input, length);
+        case RS_SSE2_KERNEL:
+            return scanSse2(scanner, input, length);
+#endif
+        default:
+            return scanScalar(scanner, input, length);
+    }
+}
+
+size_t rs_scanRun(const rs_RunScanner *scanner, const char *input, size_t length) {
+    return rs_scanRunWith(scanner, scanner->kernel, input, length);
+}
@@ -0,0 +1,91 @@
+#ifndef RUN_SCANNER_H
+#define RUN_SCANNER_H
+
+/**
+ * @file
+ * Finds the end of a run of bytes that belong to a character class.
+ *
+ * Runs like the digits of `[0-9]+` are scanned 16 bytes (SSE2) or 32 bytes (AVX2)
+ * at a time. The class is split into intervals of bytes : a byte is in the
+ * class if it is in one of them, each interval costs a subtraction, a minimum
+ * and a comparison per vector. Classes with too many intervals and targets
+ * without SIMD use the scalar kernel, that tests one bit of the bitmap per byte.
+ */
+
+#include "range.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Maximum number of intervals of a class that can be scanned with SIMD.
+ */
+#define RS_MAX_INTERVALS 8
+
+typedef enum rs_Kernel {
+    RS_SCALAR_KERNEL,
+    RS_SSE2_KERNEL,
+    RS_AVX2_KERNEL
+} rs_Kernel;
+
+typedef struct rs_RunScanner {
+    prs_CharClass charClass;
+    rs_Kernel kernel;
+    uint8_t intervalCount;
+    uint8_t lows[RS_MAX_INTERVALS];
+    uint8_t widths[RS_MAX_INTERVALS];
+} rs_RunScanner;
+
+/**
+ * Gets the fastest kernel supported by the running CPU.
+ *
+ * AVX2 is detected at runtime, SSE2 is always available on x86-64.
+ *
+ * @return a kernel
+ */
+rs_Kernel rs_getBestKernel(void);
+
+/**
+ * Gets the name of a kernel.
+ *
+ * @param kernel a kernel
+ * @return a static string
+ */
+const char *rs_getKernelName(rs_Kernel kernel);
+
+/**
+ * Creates a scanner for a character class.
+ *
+ * The best kernel is selected, the scalar one is used if the class has
+ * more than RS_MAX_INTERVALS intervals.
+ *
+ * @param scanner a pointer to the scanner to create
+ * @param charClass a pointer to a character class, it is copied
+ */
+void rs_createRunScanner(rs_RunScanner *scanner, const prs_CharClass *charClass);
+
+/**
+ * Gets the number of bytes at the start of an input that are in the class.
+ *
+ * @param scanner a pointer to a scanner
+ * @param input an input, can be null if length is 0
+ * @param length length of the input
+ * @return length of the run
+ */
+size_t rs_scanRun(const rs_RunScanner *scanner, const char *input, size_t length);
+
+/**
+ * Same as rs_scanRun with a given kernel.
+ *
+ * Kernels that are not supported by the CPU or the class fall back to the
+ * scalar one.
+ *
+ * @param scanner a pointer to a scanner
+ * @param kernel kernel to use
+ * @param input an input, can be null if length is 0
+ * @param length length of the input
+ * @return length of the run
+ */
+size_t rs_scanRunWith(const rs_RunScanner *scanner, rs_Kernel kernel, const char *input, size_t length);
+
+#endif // RUN_SCANNER_H
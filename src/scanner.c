@@ -0,0 +1,212 @@
+#include "scanner.h"
+
+#include "log.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum CharClass {
+    WORD_CHAR = 0,
+    SPACE_CHAR,
+    DELIMITER_CHAR,
+    BLOCK_CHAR
+};
+
+// Every character that is not listed here is part of a word
+static const unsigned char charClasses[256] = {
+        ['\0'] = SPACE_CHAR,
+        [' '] = SPACE_CHAR,
+        ['\t'] = SPACE_CHAR,
+        ['\n'] = SPACE_CHAR,
+        ['\v'] = SPACE_CHAR,
+        ['\f'] = SPACE_CHAR,
+        ['\r'] = SPACE_CHAR,
+
+        [';'] = DELIMITER_CHAR,
+        ['='] = DELIMITER_CHAR,
+        ['|'] = DELIMITER_CHAR,
+        ['+'] = DELIMITER_CHAR,
+        ['?'] = DELIMITER_CHAR,
+        ['*'] = DELIMITER_CHAR,
+
+        ['`'] = BLOCK_CHAR
+};
+
+#define charClass(c) (charClasses[(unsigned char) (c)])
+
+static bool pushLineStart(prs_LineTable *table, size_t start) {
+    assert(table);
+
+    if (table->size == table->capacity) {
+        size_t newCapacity = table->capacity * 2;
+        size_t *newStarts = realloc(table->starts, newCapacity * sizeof(*newStarts));
+
+        if (!newStarts) {
+            return false;
+        }
+
+        st_recordAllocation(newCapacity * sizeof(*newStarts));
+
+        table->starts = newStarts;
+        table->capacity = newCapacity;
+    }
+
+    table->starts[table->size++] = start;
+
+    return true;
+}
+
+/**
+ * Moves the scanner to a new line that starts at the given offset.
+ */
+static void newLine(prs_Scanner *scanner, size_t lineStart) {
+    ++scanner->line;
+    scanner->lineStart = lineStart;
+
+    if (scanner->lines && !pushLineStart(scanner->lines, lineStart)) {
+        log_error("Unable to record the start of line %d", scanner->line);
+        scanner->lines = NULL;
+    }
+}
+
+void prs_initScanner(prs_Scanner *scanner, const char *source, size_t length, prs_LineTable *lines) {
+    assert(scanner);
+    assert(source || length == 0);
+
+    scanner->source = source;
+    scanner->length = length;
+    scanner->pos = 0;
+    scanner->line = 1;
+    scanner->lineStart = 0;
+    scanner->lines = lines;
+}
+
+bool prs_nextItem(prs_Scanner *scanner, prs_ItemSpan *span) {
+    assert(scanner);
+    assert(span);
+
+    const char *source = scanner->source;
+    size_t length = scanner->length;
+    size_t pos = scanner->pos;
+
+    while (pos < length && charClass(source[pos]) == SPACE_CHAR) {
+        if (source[pos++] == '\n') {
+            newLine(scanner, pos);
+        }
+    }
+
+    if (pos == length) {
+        scanner->pos = pos;
+        return false;
+    }
+
+    size_t start = pos;
+    span->line = scanner->line;
+    span->column = (int) (start - scanner->lineStart) + 1;
+
+    switch (charClass(source[pos])) {
+        case DELIMITER_CHAR:
+            span->kind = PRS_DELIMITER_ITEM;
+            ++pos;
+            break;
+        case BLOCK_CHAR:
+            span->kind = PRS_STRING_BLOCK_ITEM;
+            ++pos;
+
+            while (pos < length && source[pos] != '`') {
+                if (source[pos++] == '\n') {
+                    newLine(scanner, pos);
+                }
+            }
+
+            // Includes the end marker if there is one
+            if (pos < length) {
+                ++pos;
+            }
+            break;
+        default:
+            span->kind = PRS_WORD_ITEM;
+
+            while (pos < length && charClass(source[pos]) == WORD_CHAR) {
+                ++pos;
+            }
+            break;
+    }
+
+    span->offset = start;
+    span->length = pos - start;
+    scanner->pos = pos;
+
+    return true;
+}
+
+bool prs_createLineTable(prs_LineTable *table) {
+    assert(table);
+
+    table->starts = malloc(16 * sizeof(*table->starts));
+
+    if (!table->starts) {
+        return false;
+    }
+
+    st_recordAllocation(16 * sizeof(*table->starts));
+
+    table->starts[0] = 0;
+    table->size = 1;
+    table->capacity = 16;
+
+    return true;
+}
+
+bool prs_buildLineTable(prs_LineTable *table, const char *source, size_t length) {
+    assert(table);
+    assert(source || length == 0);
+
+    const char *end = source + length;
+    const char *current = source;
+
+    while (current != end && (current = memchr(current, '\n', end - current)) != NULL) {
+        ++current;
+
+        if (!pushLineStart(table, current - source)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void prs_freeLineTable(prs_LineTable *table) {
+    if (table) {
+        free(table->starts);
+        table->starts = NULL;
+        table->size = table->capacity = 0;
+    }
+}
+
+void prs_getLinePosition(const prs_LineTable *table, size_t offset, int *pLine, int *pColumn) {
+    assert(table);
+    assert(table->size > 0);
+    assert(pLine);
+    assert(pColumn);
+
+    // Looking for the last line that starts before the offset
+    size_t low = 0;
+    size_t high = table->size;
+
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+
+        if (table->starts[middle] <= offset) {
+            low = middle;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    *pLine = (int) low + 1;
+    *pColumn = (int) (offset - table->starts[low]) + 1;
+}
@@ -0,0 +1,127 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+/**
+ * @file
+ * Defines a single pass scanner that splits a raw grammar into items.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum prs_ItemKind {
+    PRS_WORD_ITEM,
+    PRS_STRING_BLOCK_ITEM,
+    PRS_DELIMITER_ITEM
+} prs_ItemKind;
+
+/**
+ * Position of an item in the scanned source.
+ *
+ * A span does not own any memory : it only references
+ * a part of the source given to the scanner.
+ */
+typedef struct prs_ItemSpan {
+    size_t offset;
+    size_t length;
+    prs_ItemKind kind;
+    int line;
+    int column;
+} prs_ItemSpan;
+
+/**
+ * Offsets of the first character of each line in a source.
+ *
+ * The first line always starts at offset 0.
+ */
+typedef struct prs_LineTable {
+    size_t *starts;
+    size_t size;
+    size_t capacity;
+} prs_LineTable;
+
+typedef struct prs_Scanner {
+    const char *source;
+    size_t length;
+    size_t pos;
+    int line;
+    size_t lineStart;
+    prs_LineTable *lines;
+} prs_Scanner;
+
+/**
+ * Initializes a scanner on the given source.
+ *
+ * The source does not need to be null terminated and it will
+ * never be modified. It must outlive the scanner and every span
+ * returned by it.
+ *
+ * Lines and columns start at 1. If a line table is given, then the
+ * scanner will record the start of each line it goes through.
+ *
+ * @param scanner a pointer to a scanner
+ * @param source raw grammar
+ * @param length length of the source
+ * @param lines a pointer to an empty line table, can be NULL
+ */
+void prs_initScanner(prs_Scanner *scanner, const char *source, size_t length, prs_LineTable *lines);
+
+/**
+ * Reads the next item from the source.
+ *
+ * Items are separated by whitespaces. Delimiters (";", "=", "|", "+", "?", "*")
+ * are always items on their own, even if they are not surrounded by whitespaces.
+ * A string block starts and ends with a backtick, its content is kept untouched.
+ *
+ * If a string block has no end marker, then the span will cover the rest of the
+ * source : the caller can detect it by checking the last character of the span.
+ *
+ * The span also receives the line and the column of its first character.
+ *
+ * @param scanner a pointer to a scanner
+ * @param span a pointer to a span that will receive the item
+ * @return true if an item has been read, false if the end of the source has been reached
+ */
+bool prs_nextItem(prs_Scanner *scanner, prs_ItemSpan *span);
+
+/**
+ * Creates an empty line table.
+ *
+ * The table already contains the start of the first line.
+ * If the allocation failed then false will be returned.
+ *
+ * @param table a pointer to a line table
+ * @return true if the table has been created, otherwise false
+ */
+bool prs_createLineTable(prs_LineTable *table);
+
+/**
+ * Fills an empty line table with the start of each line in the given source.
+ *
+ * @param table a pointer to a line table created with {@link prs_createLineTable}
+ * @param source a source
+ * @param length length of the source
+ * @return true if no allocation error occurs, otherwise false
+ */
+bool prs_buildLineTable(prs_LineTable *table, const char *source, size_t length);
+
+/**
+ * Frees allocated memory for the given line table.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param table a pointer to a line table
+ */
+void prs_freeLineTable(prs_LineTable *table);
+
+/**
+ * Finds the line and the column of an offset with a binary search.
+ *
+ * @param table a pointer to a line table
+ * @param offset an offset in the source
+ * @param pLine pointer to an integer that will receive the line
+ * @param pColumn pointer to an integer that will receive the column
+ */
+void prs_getLinePosition(const prs_LineTable *table, size_t offset, int *pLine, int *pColumn);
+
+#endif // SCANNER_H
@@ -0,0 +1,374 @@
+#include "sppf.h"
+
+#include "hash.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define SPPF_ARENA_CHUNK_SIZE (64 * 1024)
+#define SPPF_STACK_CAPACITY 64
+
+// Marks of the derivation walks, the marks from FIRST_RANK are the ranks of the nodes that derive a finite tree
+#define UNMARKED 0
+#define ON_PATH 1
+#define VISITED 2
+#define FIRST_RANK 3
+
+typedef struct Frame {
+    sppf_Node *node;
+    const sppf_PackedNode *packedNode;
+    uint32_t child;
+} Frame;
+
+static uint32_t nodeHash(const sppf_Node *node) {
+    uint32_t key[] = { node->label, node->start, node->end };
+
+    return murmurhash3_32(key, sizeof(key));
+}
+
+static int nodeComparator(const sppf_Node *n1, const sppf_Node *n2) {
+    return n1->label != n2->label || n1->start != n2->start || n1->end != n2->end;
+}
+
+bool sppf_createForest(sppf_Forest *forest) {
+    assert(forest);
+
+    forest->root = NULL;
+    forest->nodeCount = 0;
+    forest->packedNodeCount = 0;
+    forest->ambiguousNodeCount = 0;
+    ar_createArena(&forest->arena, SPPF_ARENA_CHUNK_SIZE);
+    vec_createVector(&forest->stack, sizeof(Frame), SPPF_STACK_CAPACITY, NULL);
+    vec_createVector(&forest->order, sizeof(sppf_Node*), SPPF_STACK_CAPACITY, NULL);
+
+    return ht_createTable(&forest->nodes, 0, (ht_HashFunction*) nodeHash, (ht_KeyComparator*) nodeComparator, NULL);
+}
+
+void sppf_freeForest(sppf_Forest *forest) {
+    if (forest) {
+        ht_freeTable(&forest->nodes);
+        ar_freeArena(&forest->arena);
+        vec_freeVector(&forest->stack, NULL);
+        vec_freeVector(&forest->order, NULL);
+        forest->root = NULL;
+    }
+}
+
+void sppf_clearForest(sppf_Forest *forest) {
+    assert(forest);
+
+    ht_clear(&forest->nodes);
+    ar_resetArena(&forest->arena);
+    forest->root = NULL;
+    forest->nodeCount = 0;
+    forest->packedNodeCount = 0;
+    forest->ambiguousNodeCount = 0;
+}
+
+sppf_Node *sppf_addNode(sppf_Forest *forest, uint32_t label, uint32_t start, uint32_t end, bool *pCreated) {
+    assert(forest);
+
+    sppf_Node query = { .label = label, .start = start, .end = end };
+    sppf_Node *node = ht_getValue(&forest->nodes, &query);
+
+    if (pCreated) {
+        *pCreated = !node;
+    }
+
+    if (node) {
+        return node;
+    }
+
+    node = sppf_addUniqueNode(forest, label, start, end);
+
+    if (!node || !ht_insertElement(&forest->nodes, node, node)) {
+        return NULL;
+    }
+
+    return node;
+}
+
+sppf_Node *sppf_addUniqueNode(sppf_Forest *forest, uint32_t label, uint32_t start, uint32_t end) {
+    assert(forest);
+
+    sppf_Node *node = ar_alloc(&forest->arena, sizeof(*node));
+
+    if (!node) {
+        return NULL;
+    }
+
+    *node = (sppf_Node) { .label = label, .start = start, .end = end, .mark = UNMARKED, .packedNodes = NULL };
+    ++forest->nodeCount;
+
+    return node;
+}
+
+bool sppf_addPackedNode(sppf_Forest *forest, sppf_Node *node, uint32_t production, sppf_Node *const *children,
+                        uint32_t childCount) {
+    assert(forest);
+    assert(node);
+    assert(children || childCount == 0);
+
+    sppf_PackedNode **link = &node->packedNodes;
+
+    // Packed nodes are sorted by production, equal derivations are next to each other
+    for (;*link && (*link)->production <= production;link = &(*link)->next) {
+        const sppf_PackedNode *packedNode = *link;
+
+        if (packedNode->production == production && packedNode->childCount == childCount
+            && memcmp(packedNode->children, children, childCount * sizeof(*children)) == 0) {
+            return true;
+        }
+    }
+
+    sppf_PackedNode *packedNode = ar_alloc(&forest->arena, sizeof(*packedNode) + childCount * sizeof(*children));
+
+    if (!packedNode) {
+        return false;
+    }
+
+    packedNode->production = production;
+    packedNode->childCount = childCount;
+    packedNode->next = *link;
+
+    if (childCount > 0) {
+        memcpy(packedNode->children, children, childCount * sizeof(*children));
+    }
+
+    if (node->packedNodes && !node->packedNodes->next) {
+        ++forest->ambiguousNodeCount;
+    }
+
+    *link = packedNode;
+    ++forest->packedNodeCount;
+
+    return true;
+}
+
+/**
+ * Checks if a packed node can derive its node : its children are ranked before the node in a ranked walk,
+ * otherwise they are not being derived.
+ */
+static bool canDerive(const sppf_Node *node, const sppf_PackedNode *packedNode, bool ranked) {
+    for (uint32_t i = 0;i < packedNode->childCount;++i) {
+        const sppf_Node *child = packedNode->children[i];
+
+        // Terminals are leaves, they are never marked
+        if (ranked ? child->packedNodes && (child->mark < FIRST_RANK || child->mark >= node->mark)
+                   : child->mark == ON_PATH) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Chooses the first packed node of a node that can derive it.
+ */
+static const sppf_PackedNode *choosePackedNode(const sppf_Node *node, bool ranked) {
+    for (const sppf_PackedNode *packedNode = node->packedNodes;packedNode;packedNode = packedNode->next) {
+        if (canDerive(node, packedNode, ranked)) {
+            return packedNode;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Starts the derivation of a node : its production is added and a frame walks its children.
+ */
+static bool enterNode(sppf_Forest *forest, sppf_Node *node, vec_Vector *derivation, bool ranked, bool *pDerived) {
+    // Terminals are leaves
+    if (!node->packedNodes) {
+        return true;
+    }
+
+    // A node that derives itself is on its own path, ranks already keep the walk away from cycles
+    if (!ranked) {
+        node->mark = ON_PATH;
+    }
+
+    const sppf_PackedNode *packedNode = choosePackedNode(node, ranked);
+    Frame frame = { .node = node, .packedNode = packedNode, .child = 0 };
+
+    if (!packedNode) {
+        if (!ranked) {
+            node->mark = UNMARKED;
+        }
+
+        *pDerived = false;
+        return true;
+    }
+
+    if ((!sppf_isIntermediate(node) && !vec_pushBack(derivation, &packedNode->production))
+        || !vec_pushBack(&forest->stack, &frame)) {
+        if (!ranked) {
+            node->mark = UNMARKED;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Adds the productions of the packed nodes chosen from a node in preorder.
+ */
+static sppf_Result walkDerivation(sppf_Forest *forest, sppf_Node *node, vec_Vector *derivation, bool ranked) {
+    vec_Vector *stack = &forest->stack;
+    vec_clear(stack, NULL);
+    bool derived = true;
+    bool allocated = enterNode(forest, node, derivation, ranked, &derived);
+
+    while (allocated && stack->size > 0) {
+        Frame *frame = (Frame*) vec_at(stack, stack->size - 1);
+
+        if (!derived || frame->child == frame->packedNode->childCount) {
+            if (!ranked) {
+                frame->node->mark = UNMARKED;
+            }
+
+            --stack->size;
+            continue;
+        }
+
+        allocated = enterNode(forest, frame->packedNode->children[frame->child++], derivation, ranked, &derived);
+    }
+
+    // Marks of the frames left by an allocation error
+    for (size_t i = 0;!ranked && i < stack->size;++i) {
+        ((Frame*) vec_at(stack, i))->node->mark = UNMARKED;
+    }
+
+    if (!allocated) {
+        return SPPF_ALLOCATION_ERROR;
+    }
+
+    return derived ? SPPF_DERIVED : SPPF_NO_DERIVATION;
+}
+
+/**
+ * Adds the nodes below a node to the order vector, each one after the nodes that it reaches first.
+ */
+static bool orderNodes(sppf_Forest *forest, sppf_Node *root) {
+    vec_Vector *stack = &forest->stack;
+    vec_clear(stack, NULL);
+    vec_clear(&forest->order, NULL);
+
+    Frame frame = { .node = root, .packedNode = root->packedNodes, .child = 0 };
+    bool allocated = vec_pushBack(stack, &frame) != NULL;
+
+    if (allocated) {
+        root->mark = VISITED;
+    }
+
+    while (allocated && stack->size > 0) {
+        Frame *top = (Frame*) vec_at(stack, stack->size - 1);
+
+        if (!top->packedNode) {
+            allocated = vec_pushBack(&forest->order, &top->node) != NULL;
+
+            if (allocated) {
+                --stack->size;
+            }
+
+            continue;
+        }
+
+        if (top->child == top->packedNode->childCount) {
+            top->packedNode = top->packedNode->next;
+            top->child = 0;
+            continue;
+        }
+
+        sppf_Node *child = top->packedNode->children[top->child++];
+
+        if (child->packedNodes && child->mark == UNMARKED) {
+            Frame childFrame = { .node = child, .packedNode = child->packedNodes, .child = 0 };
+            allocated = vec_pushBack(stack, &childFrame) != NULL;
+
+            if (allocated) {
+                child->mark = VISITED;
+            }
+        }
+    }
+
+    // Nodes that an allocation error left on the stack
+    for (size_t i = 0;i < stack->size;++i) {
+        ((Frame*) vec_at(stack, i))->node->mark = UNMARKED;
+    }
+
+    return allocated;
+}
+
+/**
+ * Checks if the children of a packed node derive a finite tree.
+ */
+static bool hasRankedChildren(const sppf_PackedNode *packedNode) {
+    for (uint32_t i = 0;i < packedNode->childCount;++i) {
+        if (packedNode->children[i]->packedNodes && packedNode->children[i]->mark < FIRST_RANK) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Ranks the ordered nodes that derive a finite tree : a node is ranked after the children of one of its packed
+ * nodes. The nodes are swept in order until no rank is added, cycles are the only reason to sweep again.
+ */
+static void rankNodes(sppf_Forest *forest) {
+    uint32_t rank = FIRST_RANK;
+
+    for (bool ranked = true;ranked;) {
+        ranked = false;
+
+        for (size_t i = 0;i < forest->order.size;++i) {
+            sppf_Node *node = *((sppf_Node**) vec_at(&forest->order, i));
+            const sppf_PackedNode *packedNode = node->packedNodes;
+
+            for (;node->mark == VISITED && packedNode && !hasRankedChildren(packedNode);packedNode = packedNode->next);
+
+            if (node->mark == VISITED && packedNode) {
+                node->mark = rank++;
+                ranked = true;
+            }
+        }
+    }
+}
+
+sppf_Result sppf_addDerivation(sppf_Forest *forest, sppf_Node *node, vec_Vector *derivation) {
+    assert(forest);
+    assert(node);
+    assert(derivation);
+
+    size_t size = derivation->size;
+    sppf_Result result = walkDerivation(forest, node, derivation, false);
+
+    // A cycle can hide the trees of a node from the first walk
+    if (result != SPPF_NO_DERIVATION) {
+        return result;
+    }
+
+    derivation->size = size;
+
+    if (!orderNodes(forest, node)) {
+        result = SPPF_ALLOCATION_ERROR;
+    } else {
+        rankNodes(forest);
+
+        if (node->mark != VISITED) {
+            result = walkDerivation(forest, node, derivation, true);
+        }
+    }
+
+    for (size_t i = 0;i < forest->order.size;++i) {
+        (*((sppf_Node**) vec_at(&forest->order, i)))->mark = UNMARKED;
+    }
+
+    return result;
+}
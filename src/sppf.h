@@ -0,0 +1,160 @@
+#ifndef SPPF_H
+#define SPPF_H
+
+/**
+ * @file
+ * Defines a shared packed parse forest.
+ *
+ * A node is a symbol, or a prefix of a production (an intermediate node),
+ * derived from a token position to another. Nodes are shared : there is one
+ * node per label and extent, whatever the number of derivations that use it.
+ * Each way of deriving a node is one of its packed nodes : a production and
+ * the nodes of its children. A node with several packed nodes is ambiguous.
+ *
+ * Terminal nodes have no packed node. Intermediate nodes let a parser keep
+ * packed nodes binary : the children of a production are then a prefix and
+ * its last symbol. Walks of the forest see through intermediate nodes.
+ *
+ * Nodes are allocated in an arena, a forest keeps its memory when it is cleared.
+ */
+
+#include "collections/arena.h"
+#include "collections/hash_table.h"
+#include "collections/vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Flag of the labels of intermediate nodes, the rest of the label is the item of the prefix.
+ */
+#define SPPF_INTERMEDIATE 0x80000000u
+
+typedef struct sppf_PackedNode {
+    uint32_t production;
+    uint32_t childCount;
+    // Next packed node of the same node, they are sorted by production
+    struct sppf_PackedNode *next;
+    struct sppf_Node *children[];
+} sppf_PackedNode;
+
+typedef struct sppf_Node {
+    // Symbol of the node, or SPPF_INTERMEDIATE and the item of a prefix
+    uint32_t label;
+    uint32_t start;
+    uint32_t end;
+    // Used by the walks of the forest
+    uint32_t mark;
+    sppf_PackedNode *packedNodes;
+} sppf_Node;
+
+typedef struct sppf_Forest {
+    sppf_Node *root;
+    size_t nodeCount;
+    size_t packedNodeCount;
+    size_t ambiguousNodeCount;
+    // Nodes by label and extent
+    ht_Table nodes;
+    ar_Arena arena;
+    // Vectors of private frames and nodes, kept between walks
+    vec_Vector stack;
+    vec_Vector order;
+} sppf_Forest;
+
+typedef enum sppf_Result {
+    SPPF_DERIVED,
+    SPPF_NO_DERIVATION,
+    SPPF_ALLOCATION_ERROR
+} sppf_Result;
+
+/**
+ * Checks if a node is a prefix of a production.
+ */
+#define sppf_isIntermediate(node) (((node)->label & SPPF_INTERMEDIATE) != 0)
+
+/**
+ * Checks if a node has more than one derivation.
+ */
+#define sppf_isAmbiguous(node) ((node)->packedNodes && (node)->packedNodes->next)
+
+/**
+ * Creates an empty forest.
+ *
+ * @param forest a pointer to the forest to create
+ * @return true if the forest has been created, otherwise false
+ */
+bool sppf_createForest(sppf_Forest *forest);
+
+/**
+ * Frees allocated memory for the given forest.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param forest a pointer to a forest
+ */
+void sppf_freeForest(sppf_Forest *forest);
+
+/**
+ * Removes all nodes of a forest but keeps its memory.
+ *
+ * Every node pointer of the forest becomes invalid.
+ *
+ * @param forest a pointer to a forest
+ */
+void sppf_clearForest(sppf_Forest *forest);
+
+/**
+ * Gets the node of a label and an extent, it is added if it does not exist.
+ *
+ * @param forest a pointer to a forest
+ * @param label symbol of the node, or SPPF_INTERMEDIATE and an item
+ * @param start position of the first token of the node
+ * @param end position after the last token of the node
+ * @param pCreated pointer that receives true if the node has been added, can be NULL
+ * @return a pointer to the node, NULL if an allocation failed
+ */
+sppf_Node *sppf_addNode(sppf_Forest *forest, uint32_t label, uint32_t start, uint32_t end, bool *pCreated);
+
+/**
+ * Adds a node that sppf_addNode will not find, for a caller that knows no other node has its label and extent.
+ *
+ * @param forest a pointer to a forest
+ * @param label symbol of the node, or SPPF_INTERMEDIATE and an item
+ * @param start position of the first token of the node
+ * @param end position after the last token of the node
+ * @return a pointer to the node, NULL if an allocation failed
+ */
+sppf_Node *sppf_addUniqueNode(sppf_Forest *forest, uint32_t label, uint32_t start, uint32_t end);
+
+/**
+ * Adds a derivation to a node, unless it already has one with the same production and children.
+ *
+ * @param forest a pointer to a forest
+ * @param node a pointer to a node of the forest
+ * @param production production of the derivation
+ * @param children nodes of the children, can be NULL if there is none
+ * @param childCount number of children
+ * @return false if an allocation failed, otherwise true
+ */
+bool sppf_addPackedNode(sppf_Forest *forest, sppf_Node *node, uint32_t production, sppf_Node *const *children,
+                        uint32_t childCount);
+
+/**
+ * Adds the productions of one derivation of a node in preorder, like a leftmost derivation.
+ *
+ * Each node takes its first packed node that does not lead back to a node
+ * being derived. In a forest with cycles, this walk can end in a node whose
+ * packed nodes all lead back : the nodes that derive a finite tree are then
+ * ranked bottom-up, and each node takes its first packed node whose children
+ * are ranked before it.
+ *
+ * @param forest a pointer to a forest
+ * @param node a pointer to a node of the forest
+ * @param derivation vector of uint32_t that receives the productions
+ * @return SPPF_DERIVED if the productions have been added, SPPF_NO_DERIVATION if the node has no finite tree,
+ *         otherwise a different result
+ */
+sppf_Result sppf_addDerivation(sppf_Forest *forest, sppf_Node *node, vec_Vector *derivation);
+
+#endif // SPPF_H
@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <assert.h>
+#include <sys/resource.h>
+#include <time.h>
+
+static st_Counters _counters;
+
+void st_recordAllocation(size_t bytes) {
+    __atomic_fetch_add(&_counters.allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&_counters.allocatedBytes, bytes, __ATOMIC_RELAXED);
+}
+
+st_Counters st_getCounters(void) {
+    st_Counters counters = {
+            .allocations = __atomic_load_n(&_counters.allocations, __ATOMIC_RELAXED),
+            .allocatedBytes = __atomic_load_n(&_counters.allocatedBytes, __ATOMIC_RELAXED)
+    };
+
+    return counters;
+}
+
+static double clockMs(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1e6;
+}
+
+void st_createReport(st_Report *report) {
+    assert(report);
+
+    *report = (st_Report) { .phaseCount = 0 };
+}
+
+void st_beginPhase(st_Report *report, const char *name) {
+    assert(report);
+    assert(name);
+
+    if (report->phaseCount < ST_MAX_PHASES) {
+        report->phases[report->phaseCount].name = name;
+    }
+
+    report->startCounters = st_getCounters();
+    report->startCpuMs = clockMs(CLOCK_PROCESS_CPUTIME_ID);
+    report->startWallMs = clockMs(CLOCK_MONOTONIC);
+}
+
+void st_endPhase(st_Report *report) {
+    assert(report);
+
+    double wallMs = clockMs(CLOCK_MONOTONIC);
+    double cpuMs = clockMs(CLOCK_PROCESS_CPUTIME_ID);
+    st_Counters counters = st_getCounters();
+
+    struct rusage usage;
+
+    // ru_maxrss is in kilobytes on Linux
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        report->peakRssKb = (size_t) usage.ru_maxrss;
+    }
+
+    if (report->phaseCount == ST_MAX_PHASES) {
+        return;
+    }
+
+    st_Phase *phase = report->phases + report->phaseCount++;
+    phase->wallMs = wallMs - report->startWallMs;
+    phase->cpuMs = cpuMs - report->startCpuMs;
+    phase->allocations = counters.allocations - report->startCounters.allocations;
+    phase->allocatedBytes = counters.allocatedBytes - report->startCounters.allocatedBytes;
+    phase->peakRssKb = report->peakRssKb;
+}
+
+static double symbolTableLoad(const st_Report *report) {
+    return (report->symbolSlots > 0) ? (double) report->symbols / report->symbolSlots : 0.0;
+}
+
+static void printJson(const st_Report *report, FILE *stream) {
+    fprintf(stream, "{\n  \"phases\": [\n");
+
+    for (size_t i = 0;i < report->phaseCount;++i) {
+        const st_Phase *phase = report->phases + i;
+
+        fprintf(stream, "    {\"name\": \"%s\", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+                        "\"allocations\": %zu, \"allocated_bytes\": %zu, \"peak_rss_kb\": %zu}%s\n",
+                phase->name, phase->wallMs, phase->cpuMs, phase->allocations, phase->allocatedBytes,
+                phase->peakRssKb, (i + 1 < report->phaseCount) ? "," : "");
+    }
+
+    fprintf(stream, "  ],\n"
+                    "  \"items\": %zu,\n"
+                    "  \"tokens\": %zu,\n"
+                    "  \"rules\": %zu,\n"
+                    "  \"productions\": %zu,\n"
+                    "  \"symbol_table\": {\"symbols\": %zu, \"slots\": %zu, \"load\": %.3f, \"longest_probe\": %zu},\n"
+                    "  \"peak_rss_kb\": %zu\n"
+                    "}\n",
+            report->items, report->tokens, report->rules, report->productions,
+            report->symbols, report->symbolSlots, symbolTableLoad(report), report->longestProbe,
+            report->peakRssKb);
+}
+
+static void printText(const st_Report *report, FILE *stream) {
+    fprintf(stream, "%-16s %12s %12s %12s %14s %12s\n", "phase", "wall ms", "cpu ms", "allocations", "bytes",
+            "peak RSS KB");
+
+    for (size_t i = 0;i < report->phaseCount;++i) {
+        const st_Phase *phase = report->phases + i;
+
+        fprintf(stream, "%-16s %12.3f %12.3f %12zu %14zu %12zu\n",
+                phase->name, phase->wallMs, phase->cpuMs, phase->allocations, phase->allocatedBytes,
+                phase->peakRssKb);
+    }
+
+    fprintf(stream, "\nitems : %zu\ntokens : %zu\nrules : %zu\nproductions : %zu\n",
+            report->items, report->tokens, report->rules, report->productions);
+    fprintf(stream, "symbol table : %zu symbols, %zu slots, load %.3f, longest probe %zu\n",
+            report->symbols, report->symbolSlots, symbolTableLoad(report), report->longestProbe);
+    fprintf(stream, "peak RSS : %zu KB\n", report->peakRssKb);
+}
+
+void st_printReport(const st_Report *report, FILE *stream, bool json) {
+    assert(report);
+    assert(stream);
+
+    if (json) {
+        printJson(report, stream);
+    }
+    else {
+        printText(report, stream);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef STATS_H
+#define STATS_H
+
+/**
+ * @file
+ * Defines allocation counters and per-phase statistics.
+ *
+ * Every heap allocation made by the library is recorded with
+ * {@link st_recordAllocation}. A report samples these counters, the
+ * clocks and the resource usage at the start and the end of each phase.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * Maximum number of phases in a report.
+ */
+#define ST_MAX_PHASES 16
+
+typedef struct st_Counters {
+    size_t allocations;
+    size_t allocatedBytes;
+} st_Counters;
+
+typedef struct st_Phase {
+    const char *name;
+    double wallMs;
+    double cpuMs;
+    size_t allocations;
+    size_t allocatedBytes;
+    // Peak resident set size of the process at the end of the phase
+    size_t peakRssKb;
+} st_Phase;
+
+typedef struct st_Report {
+    st_Phase phases[ST_MAX_PHASES];
+    size_t phaseCount;
+
+    // State at the start of the current phase
+    double startWallMs;
+    double startCpuMs;
+    st_Counters startCounters;
+
+    size_t items;
+    size_t tokens;
+    size_t rules;
+    size_t productions;
+
+    size_t symbols;
+    size_t symbolSlots;
+    size_t longestProbe;
+
+    size_t peakRssKb;
+} st_Report;
+
+/**
+ * Records a heap allocation (malloc, calloc or realloc).
+ *
+ * It must only be called once the allocation has succeeded.
+ *
+ * Counters are updated atomically, this function can be called
+ * from several threads.
+ *
+ * @param bytes size of the allocated block
+ */
+void st_recordAllocation(size_t bytes);
+
+/**
+ * Gets the allocation counters since the start of the program.
+ *
+ * @return a copy of the counters
+ */
+st_Counters st_getCounters(void);
+
+/**
+ * Creates an empty report.
+ *
+ * @param report a pointer to a report
+ */
+void st_createReport(st_Report *report);
+
+/**
+ * Starts a new phase.
+ *
+ * The name must outlive the report. If the report already has
+ * ST_MAX_PHASES phases, then the phase will not be recorded.
+ *
+ * @param report a pointer to a report
+ * @param name name of the phase
+ */
+void st_beginPhase(st_Report *report, const char *name);
+
+/**
+ * Ends the current phase and records its time, its allocations and the
+ * peak resident set size of the process, that is also kept as the peak of
+ * the whole report.
+ *
+ * @param report a pointer to a report
+ */
+void st_endPhase(st_Report *report);
+
+/**
+ * Writes a report in a human readable format or in JSON.
+ *
+ * @param report a pointer to a report
+ * @param stream output stream
+ * @param json true to write JSON
+ */
+void st_printReport(const st_Report *report, FILE *stream, bool json);
+
+#endif // STATS_H
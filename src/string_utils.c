@@ -1,6 +1,7 @@
 #include "string_utils.h"
 
 #include "collections/linked_list.h"
+#include "stats.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -84,6 +85,8 @@ static char *extractItem(const char *source, size_t itemLength) {
         return NULL;
     }
 
+    st_recordAllocation(itemLength + 1);
+
     memcpy(item, source, itemLength);
     item[itemLength] = '\0';
 
@@ -0,0 +1,177 @@
+#include "symbol_table.h"
+
+#include "hash.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 64
+
+static sym_Id *createSlots(size_t slotCount) {
+    sym_Id *slots = malloc(slotCount * sizeof(*slots));
+
+    if (slots) {
+        st_recordAllocation(slotCount * sizeof(*slots));
+
+        // SYM_NONE is made of 0xFF bytes
+        memset(slots, 0xFF, slotCount * sizeof(*slots));
+    }
+
+    return slots;
+}
+
+bool sym_createSymbolTable(sym_SymbolTable *table, ar_Arena *arena) {
+    assert(table);
+    assert(arena);
+
+    table->arena = arena;
+    table->slotCount = INITIAL_SLOT_COUNT;
+    table->slots = createSlots(table->slotCount);
+
+    if (!table->slots) {
+        return false;
+    }
+
+    return vec_createVector(&table->symbols, sizeof(sym_Symbol), INITIAL_SLOT_COUNT / 2, NULL);
+}
+
+void sym_freeSymbolTable(sym_SymbolTable *table) {
+    if (table) {
+        free(table->slots);
+        table->slots = NULL;
+        table->slotCount = 0;
+        vec_freeVector(&table->symbols, NULL);
+    }
+}
+
+/**
+ * Finds the slot of a name with a linear probing.
+ *
+ * The slot is either empty or holds the ID of the name.
+ */
+static size_t findSlot(const sym_SymbolTable *table, const char *name, size_t length, uint32_t hash) {
+    size_t mask = table->slotCount - 1;
+    size_t slot = hash & mask;
+    const sym_Symbol *symbols = (const sym_Symbol*) table->symbols.data;
+
+    while (table->slots[slot] != SYM_NONE) {
+        const sym_Symbol *symbol = symbols + table->slots[slot];
+
+        if (symbol->hash == hash && symbol->length == length && memcmp(symbol->name, name, length) == 0) {
+            break;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static bool grow(sym_SymbolTable *table) {
+    size_t slotCount = table->slotCount * 2;
+    sym_Id *slots = createSlots(slotCount);
+
+    if (!slots) {
+        return false;
+    }
+
+    size_t mask = slotCount - 1;
+    const sym_Symbol *symbols = (const sym_Symbol*) table->symbols.data;
+
+    // Stored hashes avoid hashing names again
+    for (sym_Id id = 0;id < table->symbols.size;++id) {
+        size_t slot = symbols[id].hash & mask;
+
+        while (slots[slot] != SYM_NONE) {
+            slot = (slot + 1) & mask;
+        }
+
+        slots[slot] = id;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slotCount = slotCount;
+
+    return true;
+}
+
+sym_Id sym_intern(sym_SymbolTable *table, const char *name, size_t length) {
+    assert(table);
+    assert(name);
+
+    uint32_t hash = murmurhash3_32(name, length);
+    size_t slot = findSlot(table, name, length, hash);
+
+    if (table->slots[slot] != SYM_NONE) {
+        return table->slots[slot];
+    }
+
+    // The load factor is kept under 1/2
+    if ((table->symbols.size + 1) * 2 > table->slotCount) {
+        if (!grow(table)) {
+            return SYM_NONE;
+        }
+
+        slot = findSlot(table, name, length, hash);
+    }
+
+    sym_Symbol symbol = {
+            .name = ar_strndup(table->arena, name, length),
+            .length = length,
+            .hash = hash
+    };
+
+    if (!symbol.name || !vec_pushBack(&table->symbols, &symbol)) {
+        return SYM_NONE;
+    }
+
+    sym_Id id = (sym_Id) (table->symbols.size - 1);
+    table->slots[slot] = id;
+
+    return id;
+}
+
+sym_Id sym_find(const sym_SymbolTable *table, const char *name, size_t length) {
+    assert(table);
+    assert(name);
+
+    size_t slot = findSlot(table, name, length, murmurhash3_32(name, length));
+
+    return table->slots[slot];
+}
+
+const char *sym_getName(const sym_SymbolTable *table, sym_Id id) {
+    assert(table);
+    assert(id < table->symbols.size);
+
+    return ((const sym_Symbol*) table->symbols.data)[id].name;
+}
+
+size_t sym_getCount(const sym_SymbolTable *table) {
+    assert(table);
+
+    return table->symbols.size;
+}
+
+size_t sym_getLongestProbe(const sym_SymbolTable *table) {
+    assert(table);
+
+    size_t mask = table->slotCount - 1;
+    const sym_Symbol *symbols = (const sym_Symbol*) table->symbols.data;
+    size_t longestProbe = 0;
+
+    for (size_t slot = 0;slot < table->slotCount;++slot) {
+        if (table->slots[slot] != SYM_NONE) {
+            size_t probe = ((slot - symbols[table->slots[slot]].hash) & mask) + 1;
+
+            if (probe > longestProbe) {
+                longestProbe = probe;
+            }
+        }
+    }
+
+    return longestProbe;
+}
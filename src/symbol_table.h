@@ -0,0 +1,114 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+/**
+ * @file
+ * Defines a symbol interner.
+ *
+ * Each distinct name is stored once and gets a dense integer ID :
+ * the first interned name gets the ID 0, the next one 1, etc.
+ * IDs can be used as indexes in arrays or bitsets.
+ */
+
+#include "collections/arena.h"
+#include "collections/vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t sym_Id;
+
+/**
+ * ID that is never given to a symbol.
+ */
+#define SYM_NONE UINT32_MAX
+
+typedef struct sym_Symbol {
+    const char *name;
+    size_t length;
+    uint32_t hash;
+} sym_Symbol;
+
+typedef struct sym_SymbolTable {
+    vec_Vector symbols;
+    sym_Id *slots;
+    size_t slotCount;
+    ar_Arena *arena;
+} sym_SymbolTable;
+
+/**
+ * Creates an empty symbol table.
+ *
+ * Interned names are copied into the given arena, they stay valid
+ * until the arena is freed.
+ *
+ * If an allocation failed then false will be returned.
+ *
+ * @param table a pointer to a symbol table
+ * @param arena arena that will hold the names
+ * @return true if the table has been created, otherwise false
+ */
+bool sym_createSymbolTable(sym_SymbolTable *table, ar_Arena *arena);
+
+/**
+ * Frees allocated memory for the given symbol table.
+ *
+ * Names are not freed : they belong to the arena.
+ * The given pointer will not be freed.
+ *
+ * @param table a pointer to a symbol table
+ */
+void sym_freeSymbolTable(sym_SymbolTable *table);
+
+/**
+ * Gets the ID of a name, the name is added if it is not in the table yet.
+ *
+ * The name does not need to be null terminated.
+ * If an allocation failed then SYM_NONE will be returned.
+ *
+ * @param table a pointer to a symbol table
+ * @param name name of the symbol
+ * @param length length of the name
+ * @return ID of the symbol or SYM_NONE
+ */
+sym_Id sym_intern(sym_SymbolTable *table, const char *name, size_t length);
+
+/**
+ * Gets the ID of a name without adding it.
+ *
+ * @param table a pointer to a symbol table
+ * @param name name of the symbol
+ * @param length length of the name
+ * @return ID of the symbol or SYM_NONE if the name is unknown
+ */
+sym_Id sym_find(const sym_SymbolTable *table, const char *name, size_t length);
+
+/**
+ * Gets the null terminated name of a symbol.
+ *
+ * @param table a pointer to a symbol table
+ * @param id a valid symbol ID
+ * @return name of the symbol
+ */
+const char *sym_getName(const sym_SymbolTable *table, sym_Id id);
+
+/**
+ * Gets the number of symbols, IDs are lower than this value.
+ *
+ * @param table a pointer to a symbol table
+ * @return number of interned symbols
+ */
+size_t sym_getCount(const sym_SymbolTable *table);
+
+/**
+ * Gets the length of the longest probe sequence in the table.
+ *
+ * A name found in its ideal slot has a probe length of 1.
+ *
+ * @param table a pointer to a symbol table
+ * @return longest probe length, 0 if the table is empty
+ */
+size_t sym_getLongestProbe(const sym_SymbolTable *table);
+
+#endif // SYMBOL_TABLE_H
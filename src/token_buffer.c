@@ -0,0 +1,132 @@
+#include "token_buffer.h"
+
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#define MIN_CAPACITY 64
+
+/**
+ * Grows one array of the buffer, the pointer is only changed if the allocation succeeded.
+ */
+static bool growArray(void **array, size_t capacity, size_t elementSize) {
+    void *newArray = realloc(*array, capacity * elementSize);
+
+    if (!newArray) {
+        return false;
+    }
+
+    st_recordAllocation(capacity * elementSize);
+
+    *array = newArray;
+
+    return true;
+}
+
+void tb_createTokenBuffer(tb_TokenBuffer *buffer) {
+    assert(buffer);
+
+    *buffer = (tb_TokenBuffer) { .terminals = NULL, .offsets = NULL, .lengths = NULL, .size = 0, .capacity = 0,
+                                 .input = NULL, .inputLength = 0 };
+}
+
+void tb_freeTokenBuffer(tb_TokenBuffer *buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    free(buffer->terminals);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    tb_createTokenBuffer(buffer);
+}
+
+bool tb_reset(tb_TokenBuffer *buffer, const char *input, size_t length) {
+    assert(buffer);
+    assert(input || length == 0);
+
+    if (length > TB_MAX_INPUT_LENGTH) {
+        return false;
+    }
+
+    buffer->size = 0;
+    buffer->input = input;
+    buffer->inputLength = length;
+
+    return true;
+}
+
+bool tb_reserve(tb_TokenBuffer *buffer, size_t capacity) {
+    assert(buffer);
+
+    if (capacity <= buffer->capacity) {
+        return true;
+    }
+
+    // The capacity is only changed once the three arrays have grown
+    if (!growArray((void**) &buffer->terminals, capacity, sizeof(uint16_t))
+        || !growArray((void**) &buffer->offsets, capacity, sizeof(uint32_t))
+        || !growArray((void**) &buffer->lengths, capacity, sizeof(uint32_t))) {
+        return false;
+    }
+
+    buffer->capacity = capacity;
+
+    return true;
+}
+
+bool tb_pushToken(tb_TokenBuffer *buffer, uint32_t terminal, size_t offset, size_t length) {
+    assert(buffer);
+    assert(terminal < TB_MAX_TERMINAL_COUNT);
+    assert(offset + length <= buffer->inputLength);
+
+    if (buffer->size == buffer->capacity) {
+        size_t newCapacity = (buffer->capacity < MIN_CAPACITY) ? MIN_CAPACITY : buffer->capacity * 2;
+
+        if (!tb_reserve(buffer, newCapacity)) {
+            return false;
+        }
+    }
+
+    size_t i = buffer->size++;
+    buffer->terminals[i] = (uint16_t) terminal;
+    buffer->offsets[i] = (uint32_t) offset;
+    buffer->lengths[i] = (uint32_t) length;
+
+    return true;
+}
+
+ssize_t tb_tokenize(tb_TokenBuffer *buffer, const lex_Lexer *lexer, const char *input, size_t length,
+                    size_t *pErrorOffset) {
+    assert(buffer);
+    assert(lexer);
+
+    if (lexer->terminals.size > TB_MAX_TERMINAL_COUNT || !tb_reset(buffer, input, length)) {
+        return LEX_TOKENIZE_ERROR;
+    }
+
+    size_t pos = 0;
+    lex_Token token;
+    lex_Result result;
+
+    while ((result = lex_nextToken(lexer, input, length, &pos, &token)) == LEX_TOKEN) {
+        if (!tb_pushToken(buffer, token.terminal, token.offset, token.length)) {
+            return LEX_TOKENIZE_ALLOCATION_ERROR;
+        }
+    }
+
+    if (result == LEX_ERROR) {
+        if (pErrorOffset) {
+            *pErrorOffset = pos;
+        }
+
+        return LEX_TOKENIZE_ERROR;
+    }
+
+    if (result == LEX_ALLOCATION_ERROR) {
+        return LEX_TOKENIZE_ALLOCATION_ERROR;
+    }
+
+    return (ssize_t) buffer->size;
+}
@@ -0,0 +1,128 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+/**
+ * @file
+ * Defines a compact buffer of tokens stored as parallel arrays.
+ *
+ * A token is a 16-bit terminal, a 32-bit offset and a 32-bit length : 10 bytes
+ * instead of the 24 bytes of a lex_Token. A parser that only looks at terminals
+ * reads 2 bytes per token. Lexemes are not copied : they are views into the
+ * input, which must outlive the buffer's tokens.
+ *
+ * The buffer can be filled again with another input, its arrays are kept so
+ * that reading documents of similar sizes does not allocate.
+ */
+
+#include "lexer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// Terminals must be lower than this count to fit in 16 bits
+#define TB_MAX_TERMINAL_COUNT ((size_t) UINT16_MAX + 1)
+// Offsets and lengths are 32-bit
+#define TB_MAX_INPUT_LENGTH ((size_t) UINT32_MAX)
+
+typedef struct tb_TokenBuffer {
+    // Token i is terminals[i], offsets[i] and lengths[i]
+    uint16_t *terminals;
+    uint32_t *offsets;
+    uint32_t *lengths;
+    size_t size;
+    size_t capacity;
+    // Input of the tokens, it is not copied
+    const char *input;
+    size_t inputLength;
+} tb_TokenBuffer;
+
+/**
+ * Gets the terminal of a token.
+ */
+#define tb_getTerminal(buffer, i) ((buffer)->terminals[i])
+
+/**
+ * Gets a pointer to the first byte of a token in the input, it is not null terminated.
+ */
+#define tb_getLexeme(buffer, i) ((buffer)->input + (buffer)->offsets[i])
+
+/**
+ * Gets the length of a token in bytes.
+ */
+#define tb_getLength(buffer, i) ((size_t) (buffer)->lengths[i])
+
+/**
+ * Creates an empty token buffer without storage.
+ *
+ * @param buffer a pointer to the buffer to create
+ */
+void tb_createTokenBuffer(tb_TokenBuffer *buffer);
+
+/**
+ * Frees allocated memory of a token buffer.
+ *
+ * The given pointer will not be freed, the buffer can be used again after this call.
+ *
+ * @param buffer a pointer to a token buffer
+ */
+void tb_freeTokenBuffer(tb_TokenBuffer *buffer);
+
+/**
+ * Removes all tokens and sets the input of the next ones.
+ *
+ * The capacity is kept. If the input is longer than TB_MAX_INPUT_LENGTH, then
+ * false will be returned and the buffer is unchanged.
+ *
+ * @param buffer a pointer to a token buffer
+ * @param input input text of the tokens, it is not copied
+ * @param length length of the input
+ * @return true if the buffer has been reset, otherwise false
+ */
+bool tb_reset(tb_TokenBuffer *buffer, const char *input, size_t length);
+
+/**
+ * Grows the arrays of a token buffer to hold at least the given number of tokens.
+ *
+ * If the allocation failed then false will be returned, the tokens are kept.
+ *
+ * @param buffer a pointer to a token buffer
+ * @param capacity minimum number of tokens
+ * @return true if the buffer can hold the given number of tokens, otherwise false
+ */
+bool tb_reserve(tb_TokenBuffer *buffer, size_t capacity);
+
+/**
+ * Adds a token at the end of a buffer.
+ *
+ * The terminal must be lower than TB_MAX_TERMINAL_COUNT and the token must be in
+ * the input. The capacity is doubled when the buffer is full.
+ *
+ * @param buffer a pointer to a token buffer
+ * @param terminal terminal of the token
+ * @param offset position of the token in the input
+ * @param length length of the token
+ * @return true if the token has been added, false if the allocation failed
+ */
+bool tb_pushToken(tb_TokenBuffer *buffer, uint32_t terminal, size_t offset, size_t length);
+
+/**
+ * Replaces the tokens of a buffer by all tokens of an input.
+ *
+ * Tokens and errors are the ones of lex_tokenize : the tokens before an error
+ * are in the buffer. LEX_TOKENIZE_ERROR is also returned without offset if the
+ * lexer has more than TB_MAX_TERMINAL_COUNT terminals or if the input is longer
+ * than TB_MAX_INPUT_LENGTH.
+ *
+ * @param buffer a pointer to a token buffer
+ * @param lexer a pointer to a lexer
+ * @param input input text, it must outlive the tokens
+ * @param length length of the input
+ * @param pErrorOffset pointer that receives the offset of an unexpected byte, can be NULL
+ * @return number of read tokens, otherwise LEX_TOKENIZE_ERROR or LEX_TOKENIZE_ALLOCATION_ERROR
+ */
+ssize_t tb_tokenize(tb_TokenBuffer *buffer, const lex_Lexer *lexer, const char *input, size_t length,
+                    size_t *pErrorOffset);
+
+#endif // TOKEN_BUFFER_H
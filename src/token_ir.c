@@ -0,0 +1,213 @@
+#include "token_ir.h"
+
+#include "collections/hash_table.h"
+#include "collections/vector.h"
+#include "hash.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum ResolutionState {
+    UNRESOLVED = 0,
+    VISITING,
+    RESOLVED
+} ResolutionState;
+
+prs_RangeQuantifier tir_mergeQuantifiers(prs_RangeQuantifier inner, prs_RangeQuantifier outer) {
+    if (inner == PRS_NO_QUANTIFIER) {
+        return outer;
+    }
+
+    if (outer == PRS_NO_QUANTIFIER || outer == inner) {
+        return inner;
+    }
+
+    // Any other pair repeats the token any number of times, or not at all
+    return PRS_STAR_QUANTIFIER;
+}
+
+/**
+ * Normalizes a range block or a string token.
+ */
+static void normalizeToken(tir_Token *irToken, const fg_Token *token) {
+    irToken->quantifier = token->quantifier;
+    irToken->string = NULL;
+    irToken->length = 0;
+    prs_clearCharClass(&irToken->charClass);
+
+    if (token->type == FG_RANGE_TOKEN) {
+        irToken->type = TIR_CLASS_TOKEN;
+        irToken->charClass = token->value.rangeArray.charClass;
+        return;
+    }
+
+    size_t length = strlen(token->value.string);
+
+    if (length == 1) {
+        uint8_t c = (uint8_t) token->value.string[0];
+        irToken->type = TIR_CLASS_TOKEN;
+        prs_addCharInterval(&irToken->charClass, c, c);
+        return;
+    }
+
+    irToken->type = TIR_STRING_TOKEN;
+    irToken->string = token->value.string;
+    irToken->length = length;
+}
+
+/**
+ * Normalizes a token and every token of its reference chain.
+ *
+ * The chain is followed without recursion : its tokens are kept in the given
+ * vector, then they take the form of the token at its end from the last one
+ * to the first one.
+ */
+static prs_ErrCode resolveToken(tir_TokenSet *set, uint8_t *states, const fg_Token *token, vec_Vector *chain) {
+    vec_clear(chain, NULL);
+
+    while (states[token->index] != RESOLVED && token->type == FG_REF_TOKEN) {
+        if (states[token->index] == VISITING) {
+            return FG_TOKEN_REF_CYCLE;
+        }
+
+        states[token->index] = VISITING;
+
+        if (!vec_pushBack(chain, &token)) {
+            return PRS_ALLOCATION_ERROR;
+        }
+
+        token = token->value.refToken.token;
+
+        if (!token) {
+            return FG_UNKNOWN_TOKEN;
+        }
+    }
+
+    if (states[token->index] != RESOLVED) {
+        normalizeToken(&set->tokens[token->index], token);
+        states[token->index] = RESOLVED;
+    }
+
+    const tir_Token *end = &set->tokens[token->index];
+
+    for (size_t i = chain->size;i > 0;--i) {
+        const fg_Token *refToken = *((const fg_Token**) vec_at(chain, i - 1));
+        tir_Token *irToken = &set->tokens[refToken->index];
+
+        *irToken = *end;
+        irToken->quantifier = tir_mergeQuantifiers(end->quantifier, refToken->quantifier);
+        states[refToken->index] = RESOLVED;
+        end = irToken;
+    }
+
+    return PRS_OK;
+}
+
+static uint32_t tokenHash(const tir_Token *token) {
+    uint32_t hash = (token->type == TIR_CLASS_TOKEN)
+                    ? murmurhash3_32(token->charClass.words, sizeof(token->charClass.words))
+                    : murmurhash3_32(token->string, token->length);
+
+    return hash ^ (((uint32_t) token->type << 8 | (uint32_t) token->quantifier) * 0x9e3779b1u);
+}
+
+static int tokenComparator(const tir_Token *t1, const tir_Token *t2) {
+    if (t1->type != t2->type || t1->quantifier != t2->quantifier) {
+        return 1;
+    }
+
+    if (t1->type == TIR_CLASS_TOKEN) {
+        return !prs_charClassEquals(&t1->charClass, &t2->charClass);
+    }
+
+    return t1->length != t2->length || memcmp(t1->string, t2->string, t1->length) != 0;
+}
+
+/**
+ * Gives to each token the index of the first token with the same form.
+ */
+static bool findDuplicates(tir_TokenSet *set) {
+    ht_Table canonicals;
+
+    if (!ht_createTable(&canonicals, set->tokenCount, (ht_HashFunction*) tokenHash,
+                        (ht_KeyComparator*) tokenComparator, NULL)) {
+        return false;
+    }
+
+    for (size_t i = 0;i < set->tokenCount;++i) {
+        tir_Token *token = &set->tokens[i];
+        void *value = ht_getValue(&canonicals, token);
+
+        if (value) {
+            token->canonical = (uint32_t) ((uintptr_t) value - 1);
+            ++set->duplicateCount;
+        }
+        else if (ht_insertElement(&canonicals, token, (void*) ((uintptr_t) i + 1))) {
+            token->canonical = (uint32_t) i;
+        }
+        else {
+            ht_freeTable(&canonicals);
+            return false;
+        }
+    }
+
+    ht_freeTable(&canonicals);
+
+    return true;
+}
+
+prs_ErrCode tir_createTokenSet(tir_TokenSet *set, const fg_Grammar *g) {
+    assert(set);
+    assert(g);
+
+    set->tokenCount = g->tokens.size;
+    set->duplicateCount = 0;
+    set->tokens = NULL;
+
+    if (set->tokenCount == 0) {
+        return PRS_OK;
+    }
+
+    set->tokens = malloc(set->tokenCount * sizeof(*set->tokens));
+    uint8_t *states = calloc(set->tokenCount, sizeof(*states));
+
+    vec_Vector chain;
+    vec_createVector(&chain, sizeof(fg_Token*), 0, NULL);
+
+    prs_ErrCode errCode = (set->tokens && states) ? PRS_OK : PRS_ALLOCATION_ERROR;
+
+    if (errCode == PRS_OK) {
+        st_recordAllocation(set->tokenCount * (sizeof(*set->tokens) + sizeof(*states)));
+    }
+
+    for (size_t i = 0;errCode == PRS_OK && i < set->tokenCount;++i) {
+        const fg_Token *token = *((fg_Token**) vec_at((vec_Vector*) &g->tokens, i));
+        errCode = resolveToken(set, states, token, &chain);
+    }
+
+    if (errCode == PRS_OK && !findDuplicates(set)) {
+        errCode = PRS_ALLOCATION_ERROR;
+    }
+
+    vec_freeVector(&chain, NULL);
+    free(states);
+
+    if (errCode != PRS_OK) {
+        tir_freeTokenSet(set);
+    }
+
+    return errCode;
+}
+
+void tir_freeTokenSet(tir_TokenSet *set) {
+    if (!set) {
+        return;
+    }
+
+    free(set->tokens);
+    set->tokens = NULL;
+    set->tokenCount = 0;
+    set->duplicateCount = 0;
+}
@@ -0,0 +1,88 @@
+#ifndef TOKEN_IR_H
+#define TOKEN_IR_H
+
+/**
+ * @file
+ * Defines the normalized form of a grammar's tokens.
+ *
+ * A token is a range block, a string or a reference to another token, with an
+ * optional quantifier. Reference chains are flattened : the normalized token
+ * holds the range block or the string at the end of the chain and the
+ * quantifiers of the chain are merged into one (`(x+)*` is `x*`, `(x?)?` is
+ * `x?`, ...). A string of one byte becomes a character class, so that `a`
+ * and `[a]` have the same form.
+ *
+ * Tokens with the same normalized form are duplicates : the first declared one
+ * is their canonical token, the others can be compiled as this token.
+ */
+
+#include "formal_grammar.h"
+#include "parser_errors.h"
+#include "range.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum tir_TokenType {
+    TIR_CLASS_TOKEN,
+    TIR_STRING_TOKEN
+} tir_TokenType;
+
+typedef struct tir_Token {
+    tir_TokenType type;
+    prs_RangeQuantifier quantifier;
+    // Bytes of a class token
+    prs_CharClass charClass;
+    // Bytes of a string token, they belong to the grammar
+    const char *string;
+    size_t length;
+    // Index of the first token with the same normalized form, its own index if there is none
+    uint32_t canonical;
+} tir_Token;
+
+typedef struct tir_TokenSet {
+    // Indexed like the grammar's tokens
+    tir_Token *tokens;
+    size_t tokenCount;
+    size_t duplicateCount;
+} tir_TokenSet;
+
+/**
+ * Checks if a token has the same normalized form as a token declared before it.
+ */
+#define tir_isDuplicate(set, index) ((set)->tokens[index].canonical != (uint32_t) (index))
+
+/**
+ * Merges the quantifier of a token with the quantifier of a reference to it.
+ *
+ * @param inner quantifier of the referenced token
+ * @param outer quantifier of the reference
+ * @return a quantifier that matches the same repetitions as the two ones
+ */
+prs_RangeQuantifier tir_mergeQuantifiers(prs_RangeQuantifier inner, prs_RangeQuantifier outer);
+
+/**
+ * Normalizes every token of a grammar.
+ *
+ * Symbols of the grammar must have been resolved. The set references strings
+ * of the grammar : it must not outlive the grammar.
+ *
+ * If tokens reference each other in a cycle, then FG_TOKEN_REF_CYCLE will be
+ * returned, FG_UNKNOWN_TOKEN if a reference has not been resolved.
+ *
+ * @param set a pointer to the token set to create
+ * @param g a pointer to a resolved grammar
+ * @return PRS_OK if no error occurs, otherwise a different error code
+ */
+prs_ErrCode tir_createTokenSet(tir_TokenSet *set, const fg_Grammar *g);
+
+/**
+ * Frees allocated memory for the given token set.
+ *
+ * The given pointer will not be freed.
+ *
+ * @param set a pointer to a token set
+ */
+void tir_freeTokenSet(tir_TokenSet *set);
+
+#endif // TOKEN_IR_H
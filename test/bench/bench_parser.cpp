@@ -0,0 +1,121 @@
+/**
+ * Measures each stage of the grammar loading on generated grammars.
+ *
+ * Usage : parser_bench [max declarations] [alternatives] [fan out] [string block density]
+ *
+ * Grammars from 100 declarations up to the maximum (1e6 by default) are
+ * generated, each size is ten times bigger than the previous one.
+ * A quarter of the declarations are tokens.
+ */
+
+#include "grammar_generator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+extern "C" {
+#include <collections/arena.h>
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <log.h>
+#include <parser.h>
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void check(bool condition, const char *stage) {
+    if (!condition) {
+        fprintf(stderr, "%s failed\n", stage);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void runBenchmark(size_t declarations, const GeneratorOptions &baseOptions) {
+    GeneratorOptions options = baseOptions;
+    options.tokens = declarations / 4;
+    options.rules = declarations - options.tokens;
+
+    std::string source = generateGrammar(options);
+
+    // prs_readGrammar needs a stream
+    FILE *stream = tmpfile();
+    check(stream && fwrite(source.data(), 1, source.size(), stream) == source.size(), "Writing grammar");
+    rewind(stream);
+
+    Clock::time_point start = Clock::now();
+    char *buffer = nullptr;
+    ssize_t length = prs_readGrammar(stream, &buffer);
+    double readMs = elapsedMs(start);
+
+    fclose(stream);
+    check(length == (ssize_t) source.size(), "prs_readGrammar");
+
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    vec_Vector itemList;
+    vec_createVector(&itemList, sizeof(prs_StringItem), 1024, nullptr);
+
+    start = Clock::now();
+    int extractedItems = prs_extractGrammarItems(buffer, length, &itemList, &g.arena);
+    double extractMs = elapsedMs(start);
+    check(extractedItems >= 0, "prs_extractGrammarItems");
+
+    start = Clock::now();
+    vec_Cursor it = vec_createCursor(&itemList);
+    bool found = prs_computeItemsPosition(buffer, &it);
+    double positionMs = elapsedMs(start);
+    check(found, "prs_computeItemsPosition");
+
+    start = Clock::now();
+    prs_ErrCode errCode = prs_parseGrammarItems(&g, &itemList);
+    double parseMs = elapsedMs(start);
+    check(errCode == PRS_OK, "prs_parseGrammarItems");
+
+    start = Clock::now();
+    errCode = prs_resolveSymbols(&g);
+    double resolveMs = elapsedMs(start);
+    check(errCode == PRS_OK, "prs_resolveSymbols");
+
+    printf("%12zu %12zu %12d %10.2f %10.2f %10.2f %10.2f %10.2f\n", declarations, source.size(), extractedItems,
+           readMs, extractMs, positionMs, parseMs, resolveMs);
+
+    vec_freeVector(&itemList, nullptr);
+    fg_freeGrammar(&g);
+    free(buffer);
+}
+
+int main(int argc, char **argv) {
+    log_set_quiet(true);
+
+    size_t maxDeclarations = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    GeneratorOptions options;
+
+    if (argc > 2) {
+        options.alternatives = strtoull(argv[2], nullptr, 10);
+    }
+
+    if (argc > 3) {
+        options.fanOut = strtoull(argv[3], nullptr, 10);
+    }
+
+    if (argc > 4) {
+        options.stringBlockDensity = strtod(argv[4], nullptr);
+    }
+
+    printf("%12s %12s %12s %10s %10s %10s %10s %10s\n", "declarations", "bytes", "items",
+           "read ms", "extract ms", "position ms", "parse ms", "resolve ms");
+
+    for (size_t declarations = 100;declarations <= maxDeclarations;declarations *= 10) {
+        runBenchmark(declarations, options);
+    }
+
+    return EXIT_SUCCESS;
+}
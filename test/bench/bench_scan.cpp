@@ -0,0 +1,128 @@
+/**
+ * Measures the run scanner kernels against a byte by byte automaton.
+ *
+ * Usage : scan_bench [run length] [megabytes]
+ *
+ * The input is made of runs of digits separated by a space, like the
+ * numbers matched by `%NUMBER=[0-9]+;`. Each kernel scans every run and
+ * the throughput is printed in bytes per cycle (x86 only) and in GB/s.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_RDTSC
+#endif
+
+extern "C" {
+#include <run_scanner.h>
+}
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t readCycles() {
+#ifdef HAS_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Scans all runs of the input and returns the number of bytes in runs.
+ */
+template<typename Scan>
+static size_t scanAll(const std::string &input, Scan scan) {
+    size_t total = 0;
+    size_t pos = 0;
+
+    while (pos < input.size()) {
+        size_t run = scan(input.data() + pos, input.size() - pos);
+        total += run;
+        pos += run + 1;
+    }
+
+    return total;
+}
+
+template<typename Scan>
+static void runBenchmark(const char *name, const std::string &input, size_t expected, Scan scan) {
+    // One round to warm up caches
+    size_t total = scanAll(input, scan);
+
+    Clock::time_point start = Clock::now();
+    uint64_t cycles = readCycles();
+    total += scanAll(input, scan);
+    cycles = readCycles() - cycles;
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (total != 2 * expected) {
+        fprintf(stderr, "%s : wrong run length\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    double bytesPerCycle = (cycles > 0) ? (double) input.size() / (double) cycles : 0;
+    printf("%-8s %8.3f bytes/cycle %8.3f GB/s\n", name, bytesPerCycle, (double) input.size() / seconds / 1e9);
+}
+
+int main(int argc, char **argv) {
+    size_t runLength = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 64;
+    size_t megabytes = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 64;
+
+    std::string input;
+    input.reserve(megabytes << 20);
+    size_t expected = 0;
+
+    while (input.size() + runLength + 1 <= (megabytes << 20)) {
+        for (size_t i = 0;i < runLength;++i) {
+            input += (char) ('0' + (i * 7) % 10);
+        }
+
+        input += ' ';
+        expected += runLength;
+    }
+
+    prs_CharClass digits;
+    prs_clearCharClass(&digits);
+    prs_addCharInterval(&digits, '0', '9');
+
+    rs_RunScanner scanner;
+    rs_createRunScanner(&scanner, &digits);
+
+    printf("Run length : %zu, input : %zu MB, best kernel : %s\n", runLength, megabytes, rs_getKernelName(scanner.kernel));
+
+    // What the lexer does without a run scanner : one table lookup per byte
+    static uint8_t transitions[256];
+
+    for (int c = '0';c <= '9';++c) {
+        transitions[c] = 1;
+    }
+
+    runBenchmark("table", input, expected, [](const char *data, size_t length) {
+        size_t i = 0;
+
+        while (i < length && transitions[(uint8_t) data[i]]) {
+            ++i;
+        }
+
+        return i;
+    });
+
+    const rs_Kernel kernels[] = { RS_SCALAR_KERNEL, RS_SSE2_KERNEL, RS_AVX2_KERNEL };
+
+    for (rs_Kernel kernel : kernels) {
+        if (kernel > scanner.kernel) {
+            break;
+        }
+
+        runBenchmark(rs_getKernelName(kernel), input, expected, [&](const char *data, size_t length) {
+            return rs_scanRunWith(&scanner, kernel, data, length);
+        });
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#include "grammar_generator.hpp"
+
+#include <random>
+
+static const char *ranges[] = { "[a-z]", "[0-9]", "[a-zA-Z]", "[a-f0-9]" };
+static const char *quantifiers[] = { "", "", "+", "?", "*" };
+
+std::string generateGrammar(const GeneratorOptions &options) {
+    std::mt19937 random(options.seed);
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+
+    std::string source;
+    source.reserve((options.tokens * 24) + options.rules * options.alternatives * options.fanOut * 8);
+
+    for (size_t i = 0;i < options.tokens;++i) {
+        source += "%T" + std::to_string(i) + " = ";
+
+        if (i > 0 && probability(random) < options.tokenRefDensity) {
+            source += "T" + std::to_string(random() % i);
+        }
+        else if (random() % 2 == 0) {
+            source += ranges[random() % 4];
+            source += quantifiers[random() % 5];
+        }
+        else {
+            source += "`t" + std::to_string(i) + "`";
+        }
+
+        source += ";\n";
+    }
+
+    for (size_t i = 0;i < options.rules;++i) {
+        source += "%r" + std::to_string(i) + " =";
+
+        for (size_t alt = 0;alt < options.alternatives;++alt) {
+            if (alt > 0) {
+                source += "\n\t|";
+            }
+
+            for (size_t item = 0;item < options.fanOut;++item) {
+                source += ' ';
+
+                // The first item of the entry rule keeps every rule reachable
+                if (i == 0 && item == 0 && alt + 1 < options.rules) {
+                    source += "r" + std::to_string(alt + 1);
+                }
+                else if (probability(random) < options.stringBlockDensity) {
+                    source += "`s" + std::to_string(random() % 1000) + "`";
+                }
+                else if (options.tokens > 0 && (options.rules < 2 || random() % 2 == 0)) {
+                    source += "T" + std::to_string(random() % options.tokens);
+                }
+                else {
+                    source += "r" + std::to_string(random() % options.rules);
+                }
+            }
+        }
+
+        source += ";\n";
+    }
+
+    return source;
+}
@@ -0,0 +1,44 @@
+#ifndef GRAMMAR_GENERATOR_HPP
+#define GRAMMAR_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Shape of a generated grammar.
+ */
+struct GeneratorOptions {
+    // Number of token declarations
+    size_t tokens = 100;
+
+    // Number of rule declarations
+    size_t rules = 100;
+
+    // Number of production rules of each rule
+    size_t alternatives = 3;
+
+    // Number of items of each production rule
+    size_t fanOut = 4;
+
+    // Probability that a production rule item is a string block
+    double stringBlockDensity = 0.2;
+
+    // Probability that a token references a previous token
+    double tokenRefDensity = 0.1;
+
+    uint32_t seed = 42;
+};
+
+/**
+ * Generates a valid grammar : every referenced symbol is declared.
+ *
+ * Tokens are declared before rules. The output only depends on the options,
+ * the same seed always gives the same grammar.
+ *
+ * @param options shape of the grammar
+ * @return source of the grammar
+ */
+std::string generateGrammar(const GeneratorOptions &options);
+
+#endif // GRAMMAR_GENERATOR_HPP
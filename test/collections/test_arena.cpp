@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+extern "C" {
+#include <collections/arena.h>
+#include <collections/linked_list.h>
+}
+
+using Catch::Matchers::Equals;
+
+SCENARIO("An arena hands out blocks from chained chunks", "[arena]") {
+    ar_Arena arena;
+    ar_createArena(&arena, 64);
+
+    GIVEN("A new arena") {
+        THEN("No chunk should have been allocated") {
+            REQUIRE(0 == arena.chunkCount);
+            REQUIRE_FALSE(arena.chunks);
+        }
+    }
+
+    GIVEN("Several small allocations") {
+        void *p1 = ar_alloc(&arena, 3);
+        void *p2 = ar_alloc(&arena, 5);
+
+        THEN("Blocks should be aligned") {
+            REQUIRE(0 == (uintptr_t) p1 % AR_ALIGNMENT);
+            REQUIRE(0 == (uintptr_t) p2 % AR_ALIGNMENT);
+        }
+
+        AND_THEN("They should share the same chunk") {
+            REQUIRE(1 == arena.chunkCount);
+            REQUIRE(8 == arena.allocatedBytes);
+        }
+
+        AND_WHEN("The first chunk is full") {
+            for (int i = 0;i < 4;++i) {
+                ar_alloc(&arena, 16);
+            }
+
+            THEN("A new chunk should have been chained") {
+                REQUIRE(2 == arena.chunkCount);
+            }
+        }
+    }
+
+    GIVEN("A block that is bigger than a chunk") {
+        void *small = ar_alloc(&arena, 8);
+        char *big = (char*) ar_alloc(&arena, 1000);
+        memset(big, 'a', 1000);
+
+        THEN("It should have its own chunk") {
+            REQUIRE(big);
+            REQUIRE(2 == arena.chunkCount);
+        }
+
+        AND_THEN("The current chunk should still be used") {
+            char *next = (char*) ar_alloc(&arena, 8);
+            REQUIRE(next == (char*) small + AR_ALIGNMENT);
+        }
+    }
+
+    GIVEN("An arena that is reset after several chunks") {
+        for (int i = 0;i < 8;++i) {
+            ar_alloc(&arena, 16);
+        }
+
+        ar_alloc(&arena, 1000);
+        REQUIRE(3 == arena.chunkCount);
+
+        ar_resetArena(&arena);
+
+        THEN("Only the last chunk should be kept") {
+            REQUIRE(1 == arena.chunkCount);
+            REQUIRE(0 == arena.allocatedBytes);
+        }
+
+        AND_THEN("Its memory should be used again") {
+            REQUIRE(ar_alloc(&arena, 16));
+            REQUIRE(1 == arena.chunkCount);
+        }
+    }
+
+    GIVEN("A string") {
+        char *copy = ar_strndup(&arena, "hello world", 5);
+
+        THEN("The copy should be null terminated") {
+            REQUIRE_THAT(copy, Equals("hello"));
+        }
+    }
+
+    GIVEN("A zero initialized array") {
+        auto values = (int*) ar_calloc(&arena, 10, sizeof(int));
+
+        THEN("All values should be null") {
+            for (int i = 0;i < 10;++i) {
+                REQUIRE(0 == values[i]);
+            }
+        }
+    }
+
+    GIVEN("A linked list whose nodes are in the arena") {
+        ll_LinkedList list;
+        ll_createArenaLinkedList(&list, &arena);
+
+        int v1 = 1, v2 = 2;
+        ll_pushBackBatch(&list, 2, &v1, &v2);
+
+        THEN("Nodes should have been allocated in the arena") {
+            REQUIRE(2 == list.size);
+            REQUIRE(2 * sizeof(ll_LinkedListItem) == arena.allocatedBytes);
+        }
+
+        AND_WHEN("The list is freed") {
+            ll_freeLinkedList(&list, nullptr);
+
+            THEN("It should be empty") {
+                REQUIRE(0 == list.size);
+                REQUIRE_FALSE(list.front);
+            }
+        }
+    }
+
+    ar_freeArena(&arena);
+
+    THEN("The arena should not have any chunk after being freed") {
+        REQUIRE(0 == arena.chunkCount);
+    }
+}
@@ -2,7 +2,6 @@
 
 extern "C" {
 #include <collections/hash_table.h>
-#include <collections/linked_list.h>
 #include <hash.h>
 }
 
@@ -16,12 +15,15 @@ SCENARIO("A hash table is created with an initial capacity", "[hash_table]") {
             REQUIRE(res);
         }
 
-        AND_THEN("All 5 buckets should be empty") {
-            REQUIRE(5 == table.capacity);
+        AND_THEN("The capacity should be rounded up to a power of two") {
+            REQUIRE(8 == table.capacity);
+        }
+
+        AND_THEN("All buckets should be empty") {
             REQUIRE(table.buckets);
 
-            for (size_t i = 0;i < 5;++i) {
-                REQUIRE(0 == table.buckets[i].size);
+            for (size_t i = 0;i < table.capacity;++i) {
+                REQUIRE(0 == table.buckets[i].distance);
             }
         }
 
@@ -59,15 +61,33 @@ SCENARIO("Pair insertion with hash collision", "[hash_table]") {
             int k2 = 2;
             int v2 = 87;
 
-            ht_insertElement(&table, &k2, &v2);
+            REQUIRE(ht_insertElement(&table, &k2, &v2));
 
             THEN("The size of the table should have been updated") {
                 REQUIRE(2 == table.size);
             }
 
-            AND_THEN("The two pairs should be in the first bucket") {
-                ll_LinkedList *bucket = table.buckets;
-                REQUIRE(2 == bucket->size);
+            AND_THEN("The second pair should be stored in the next bucket") {
+                REQUIRE(&k1 == table.buckets[0].pair.key);
+                REQUIRE(1 == table.buckets[0].distance);
+
+                REQUIRE(&k2 == table.buckets[1].pair.key);
+                REQUIRE(2 == table.buckets[1].distance);
+            }
+
+            AND_WHEN("Removing the first pair") {
+                ht_removeElement(&table, &k1);
+
+                THEN("The second pair should have been shifted back") {
+                    REQUIRE(1 == table.size);
+                    REQUIRE(&k2 == table.buckets[0].pair.key);
+                    REQUIRE(1 == table.buckets[0].distance);
+                    REQUIRE(0 == table.buckets[1].distance);
+                }
+
+                AND_THEN("It should still be found") {
+                    REQUIRE(&v2 == ht_getValue(&table, &k2));
+                }
             }
         }
 
@@ -77,7 +97,7 @@ SCENARIO("Pair insertion with hash collision", "[hash_table]") {
 
             size_t previousSize = table.size;
 
-            ht_insertElement(&table, &k2, &v2);
+            REQUIRE(ht_insertElement(&table, &k2, &v2));
 
             THEN("The size of the table should not have been updated") {
                 REQUIRE(previousSize == table.size);
@@ -143,6 +163,85 @@ SCENARIO("A value can be retrieved by its key", "[hash_table]") {
     }
 }
 
+SCENARIO("A hash table grows with its number of pairs", "[hash_table]") {
+    GIVEN("A table with more pairs than its initial capacity") {
+        ht_Table table = {};
+        ht_createTable(&table, 8, intHash, intKeyComparator, nullptr);
+
+        int keys[1000];
+
+        for (int i = 0;i < 1000;++i) {
+            keys[i] = i * 7;
+            ht_insertElement(&table, keys + i, keys + i);
+        }
+
+        THEN("The table should have grown") {
+            REQUIRE(1000 == table.size);
+            REQUIRE(1024 < table.capacity);
+        }
+
+        AND_THEN("All pairs should be found") {
+            for (int i = 0;i < 1000;++i) {
+                int key = i * 7;
+                REQUIRE(keys + i == ht_getValue(&table, &key));
+            }
+        }
+
+        AND_WHEN("Half of the pairs are removed") {
+            for (int i = 0;i < 1000;i += 2) {
+                ht_removeElement(&table, keys + i);
+            }
+
+            THEN("Only the other half should be found") {
+                REQUIRE(500 == table.size);
+
+                for (int i = 0;i < 1000;++i) {
+                    int key = i * 7;
+                    void *expected = (i % 2 == 0) ? nullptr : keys + i;
+
+                    REQUIRE(expected == ht_getValue(&table, &key));
+                }
+            }
+        }
+
+        AND_WHEN("The table is cleared") {
+            size_t capacity = table.capacity;
+            ht_clear(&table);
+
+            THEN("No pair should be found but the capacity should be kept") {
+                REQUIRE(0 == table.size);
+                REQUIRE(capacity == table.capacity);
+                REQUIRE_FALSE(ht_getValue(&table, keys + 1));
+            }
+        }
+
+        ht_freeTable(&table);
+    }
+}
+
+SCENARIO("Keys are compared by address without a key comparator", "[hash_table]") {
+    GIVEN("A table without key comparator") {
+        ht_Table table = {};
+        ht_createTable(&table, 8, (ht_HashFunction*) constantHash, nullptr, nullptr);
+
+        int k1 = 1;
+        int k2 = 1;
+        int v1 = 4;
+
+        ht_insertElement(&table, &k1, &v1);
+
+        THEN("The same key should be found") {
+            REQUIRE(&v1 == ht_getValue(&table, &k1));
+        }
+
+        AND_THEN("An equal key at another address should not be found") {
+            REQUIRE_FALSE(ht_getValue(&table, &k2));
+        }
+
+        ht_freeTable(&table);
+    }
+}
+
 SCENARIO("A pair can be removed by its key", "[hash_table]") {
     GIVEN("An hash table with one pair") {
         ht_Table table = {};
@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+
+extern "C" {
+#include <collections/vector.h>
+}
+
+static int destroyedElements = 0;
+
+static void countingDestructor(void *data, void *args) {
+    (void) data;
+    (void) args;
+    ++destroyedElements;
+}
+
+static int intComparator(const void *d1, const void *d2) {
+    return *((const int*) d1) - *((const int*) d2);
+}
+
+SCENARIO("A vector stores its elements contiguously", "[vector]") {
+    vec_Vector vector;
+
+    GIVEN("An empty vector without initial capacity") {
+        REQUIRE(vec_createVector(&vector, sizeof(int), 0, nullptr));
+
+        THEN("It should not have any storage") {
+            REQUIRE(0 == vector.size);
+            REQUIRE(0 == vector.capacity);
+            REQUIRE_FALSE(vector.data);
+        }
+
+        WHEN("Pushing 20 elements") {
+            for (int i = 0;i < 20;++i) {
+                int *slot = (int*) vec_pushBack(&vector, &i);
+                REQUIRE(slot);
+                REQUIRE(i == *slot);
+            }
+
+            THEN("The capacity should have grown geometrically") {
+                REQUIRE(20 == vector.size);
+                REQUIRE(32 == vector.capacity);
+            }
+
+            AND_THEN("Elements should keep their order") {
+                for (size_t i = 0;i < 20;++i) {
+                    REQUIRE((int) i == *((int*) vec_at(&vector, i)));
+                }
+            }
+
+            AND_THEN("A cursor should go through all elements") {
+                vec_Cursor cursor = vec_createCursor(&vector);
+                int expected = 0;
+
+                while (vec_cursorHasNext(&cursor)) {
+                    REQUIRE(expected++ == *((int*) vec_cursorNext(&cursor)));
+                }
+
+                REQUIRE(20 == expected);
+            }
+        }
+
+        WHEN("Reserving room for 100 elements") {
+            REQUIRE(vec_reserve(&vector, 100));
+
+            THEN("The capacity should be exactly the reserved one") {
+                REQUIRE(0 == vector.size);
+                REQUIRE(100 == vector.capacity);
+            }
+
+            AND_WHEN("Reserving a smaller capacity") {
+                REQUIRE(vec_reserve(&vector, 10));
+
+                THEN("The capacity should not change") {
+                    REQUIRE(100 == vector.capacity);
+                }
+            }
+        }
+
+        vec_freeVector(&vector, nullptr);
+    }
+
+    GIVEN("A vector with a destructor") {
+        REQUIRE(vec_createVector(&vector, sizeof(int), 4, countingDestructor));
+        destroyedElements = 0;
+
+        int values[] = { 1, 2, 3 };
+
+        for (int value : values) {
+            vec_pushBack(&vector, &value);
+        }
+
+        WHEN("The vector is cleared") {
+            vec_clear(&vector, nullptr);
+
+            THEN("Each element should have been destroyed") {
+                REQUIRE(3 == destroyedElements);
+            }
+
+            AND_THEN("Its capacity should be kept") {
+                REQUIRE(0 == vector.size);
+                REQUIRE(4 == vector.capacity);
+            }
+        }
+
+        WHEN("The vector is freed") {
+            vec_freeVector(&vector, nullptr);
+
+            THEN("Each element should have been destroyed") {
+                REQUIRE(3 == destroyedElements);
+                REQUIRE(0 == vector.capacity);
+            }
+        }
+
+        vec_freeVector(&vector, nullptr);
+    }
+}
+
+SCENARIO("Two vectors can be compared", "[vector]") {
+    vec_Vector v1, v2;
+    vec_createVector(&v1, sizeof(int), 0, nullptr);
+    vec_createVector(&v2, sizeof(int), 0, nullptr);
+
+    int values[] = { 4, 5 };
+
+    for (int value : values) {
+        vec_pushBack(&v1, &value);
+        vec_pushBack(&v2, &value);
+    }
+
+    GIVEN("Two vectors with the same elements") {
+        THEN("They should be equal") {
+            REQUIRE(vec_isEqual(&v1, &v2, intComparator));
+        }
+    }
+
+    GIVEN("Two vectors with a different size") {
+        vec_pushBack(&v2, values);
+
+        THEN("They should not be equal") {
+            REQUIRE_FALSE(vec_isEqual(&v1, &v2, intComparator));
+        }
+    }
+
+    vec_freeVector(&v1, nullptr);
+    vec_freeVector(&v2, nullptr);
+}
@@ -1,18 +1,55 @@
 #include "helpers.hpp"
 
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+
 extern "C" {
-#include <collections/linked_list.h>
+#include <collections/vector.h>
 #include <parser.h>
+#include <sppf.h>
 }
 
-void fillItemList(ll_LinkedList *itemList, const std::vector<std::string> &items) {
+void fillItemList(vec_Vector *itemList, const std::vector<std::string> &items) {
     for (auto item : items) {
-        prs_StringItem *stringItem = (prs_StringItem*) malloc(sizeof(*stringItem));
-        stringItem->item = (char*) calloc(item.size() + 1, 1);
-        strcpy(stringItem->item, item.c_str());
+        prs_StringItem stringItem;
+        stringItem.item = (char*) calloc(item.size() + 1, 1);
+        strcpy(stringItem.item, item.c_str());
+
+        stringItem.column = stringItem.line = 0;
+
+        vec_pushBack(itemList, &stringItem);
+    }
+}
+
+void createItemList(vec_Vector *itemList) {
+    vec_createVector(itemList, sizeof(prs_StringItem), 0, (vec_DataDestructor*) prs_freeStringItem);
+}
 
-        stringItem->column = stringItem->line = 0;
+int loadGrammar(fg_Grammar *g, const std::string &input) {
+    FILE *stream = fmemopen((void*) input.data(), input.size(), "r");
+    int res = prs_parseGrammarStream(g, stream);
+    fclose(stream);
 
-        ll_pushBack(itemList, stringItem);
+    if (res != PRS_OK) {
+        return res;
     }
+
+    return prs_resolveSymbols(g);
+}
+
+void requireDerivation(const vec_Vector *derivation, const uint32_t *expected, size_t length) {
+    REQUIRE(length == derivation->size);
+
+    for (size_t i = 0;i < length;++i) {
+        REQUIRE(expected[i] == ((const uint32_t*) derivation->data)[i]);
+    }
+}
+
+void requireForestDerivation(sppf_Forest *forest, const uint32_t *expected, size_t length) {
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+    REQUIRE(SPPF_DERIVED == sppf_addDerivation(forest, forest->root, &derivation));
+    requireDerivation(&derivation, expected, length);
+    vec_freeVector(&derivation, nullptr);
 }
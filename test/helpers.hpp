@@ -1,22 +1,60 @@
 #ifndef HELPERS_HPP
 #define HELPERS_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-struct ll_LinkedList;
+struct fg_Grammar;
+struct sppf_Forest;
+struct vec_Vector;
 
 /**
- * Fills a list of prs_StringItem from a vector of C++ strings.
+ * Fills a vector of prs_StringItem from a vector of C++ strings.
  *
- * For each string, a new prs_StringItem is allocated with default columns
- * and lines (-1). The corresponding string will be copîed to an allocated buffer.
- * The new item will be inserted into the given list, it should be freed with
- * prs_freeStringItem.
+ * For each string, a new prs_StringItem is pushed with default columns
+ * and lines (0). The corresponding string will be copîed to an allocated buffer,
+ * it should be freed with prs_freeStringItem (the vector's destructor).
  *
- * @param itemList the list to fill
+ * @param itemList the vector to fill
  * @param items list of strings
  */
-void fillItemList(ll_LinkedList *itemList, const std::vector<std::string> &items);
+void fillItemList(vec_Vector *itemList, const std::vector<std::string> &items);
+
+/**
+ * Creates an empty vector of prs_StringItem that frees
+ * its items with prs_freeStringItem.
+ *
+ * @param itemList the vector to create
+ */
+void createItemList(vec_Vector *itemList);
+
+/**
+ * Parses a grammar from a string and resolves its symbols.
+ *
+ * @param g the grammar that receives the declarations
+ * @param input source of the grammar
+ * @return PRS_OK if no error occurs, otherwise the first error code
+ */
+int loadGrammar(fg_Grammar *g, const std::string &input);
+
+/**
+ * Requires a derivation to be the given sequence of productions.
+ *
+ * @param derivation a vector of production indexes
+ * @param expected expected productions
+ * @param length number of expected productions
+ */
+void requireDerivation(const vec_Vector *derivation, const uint32_t *expected, size_t length);
+
+/**
+ * Requires the derivation of the root of a forest to be the given sequence of productions.
+ *
+ * @param forest a forest with a root
+ * @param expected expected productions
+ * @param length number of expected productions
+ */
+void requireForestDerivation(sppf_Forest *forest, const uint32_t *expected, size_t length);
 
 #endif // HELPERS_HPP
@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+extern "C" {
+#include <codegen.h>
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <lexer.h>
+#include <parser.h>
+}
+
+using Catch::Matchers::Contains;
+
+static const char *grammar = "%INT=[0-9];\n"
+                             "%NUMBER=INT+;\n"
+                             "%LET=`let`;\n"
+                             "%NAME=[a-zA-Z]+;\n"
+                             "%stmt = LET NAME `=` NUMBER `\"` NUMBER `;`;\n";
+
+// Prints the tokens read by the generated lexer from the file given as argument
+static const char *driver = "#include <stdio.h>\n"
+                            "#include <stdlib.h>\n"
+                            "int main(int argc, char **argv) {\n"
+                            "    (void) argc;\n"
+                            "    static char input[4096];\n"
+                            "    FILE *f = fopen(argv[1], \"r\");\n"
+                            "    size_t length = fread(input, 1, sizeof(input), f);\n"
+                            "    size_t pos = 0;\n"
+                            "    lexer_Token token;\n"
+                            "    int result;\n"
+                            "    while ((result = lexer_nextToken(input, length, &pos, &token)) == 1) {\n"
+                            "        printf(\"%d %zu %zu\\n\", token.terminal, token.offset, token.length);\n"
+                            "    }\n"
+                            "    if (result == -1) {\n"
+                            "        printf(\"error %zu\\n\", pos);\n"
+                            "    }\n"
+                            "    return 0;\n"
+                            "}\n";
+
+static std::string emitLexer(const lex_Lexer *lexer) {
+    char *buffer = nullptr;
+    size_t size = 0;
+    FILE *out = open_memstream(&buffer, &size);
+
+    REQUIRE(cg_emitLexer(lexer, CG_DEFAULT_PREFIX, out));
+    fclose(out);
+
+    std::string source(buffer, size);
+    free(buffer);
+
+    return source;
+}
+
+static std::string readFile(const std::string &path) {
+    std::ifstream stream(path);
+    std::stringstream content;
+    content << stream.rdbuf();
+
+    return content.str();
+}
+
+SCENARIO("The lexer of a grammar can be generated as a C source", "[codegen]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    REQUIRE(PRS_OK == loadGrammar(&g, grammar));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+    GIVEN("The generated source") {
+        std::string source = emitLexer(&lexer);
+
+        THEN("Tokens and string items should have a constant") {
+            REQUIRE_THAT(source, Contains("LEXER_NUMBER = 1,"));
+            REQUIRE_THAT(source, Contains("LEXER_LITERAL_0 = 4,"));
+            REQUIRE_THAT(source, Contains("LEXER_TERMINAL_COUNT = 7"));
+        }
+
+        AND_THEN("Names should be escaped") {
+            REQUIRE_THAT(source, Contains("\"\\\"\","));
+        }
+
+        AND_THEN("Each state except the dead one should have a label") {
+            for (uint32_t state = 1;state < lexer.dfa.stateCount;++state) {
+                REQUIRE_THAT(source, Contains("    state" + std::to_string(state) + ":\n"));
+            }
+
+            REQUIRE_THAT(source, !Contains("state0:"));
+        }
+    }
+
+    GIVEN("The generated source compiled with a driver") {
+        char directory[] = "/tmp/codegen_testXXXXXX";
+        REQUIRE(mkdtemp(directory));
+        std::string dir = directory;
+
+        std::ofstream(dir + "/lexer.c") << emitLexer(&lexer) << driver;
+
+        std::string input = "let answer = 42 \"7;\n let x=1 #";
+        std::ofstream(dir + "/input.txt") << input;
+
+        std::string command = std::string(CG_TEST_COMPILER) + " -std=c99 -Wall -Werror -o " + dir + "/lexer " + dir + "/lexer.c";
+        REQUIRE(0 == system(command.c_str()));
+        REQUIRE(0 == system((dir + "/lexer " + dir + "/input.txt > " + dir + "/output.txt").c_str()));
+
+        THEN("It should read the same tokens as the lexer") {
+            vec_Vector tokens;
+            vec_createVector(&tokens, sizeof(lex_Token), 0, nullptr);
+            size_t errorOffset = 0;
+
+            REQUIRE(-1 == lex_tokenize(&lexer, input.data(), input.size(), &tokens, &errorOffset));
+
+            std::string expected;
+
+            for (size_t i = 0;i < tokens.size;++i) {
+                auto token = (lex_Token*) vec_at(&tokens, i);
+                expected += std::to_string(token->terminal) + " " + std::to_string(token->offset) + " "
+                            + std::to_string(token->length) + "\n";
+            }
+
+            expected += "error " + std::to_string(errorOffset) + "\n";
+
+            REQUIRE(readFile(dir + "/output.txt") == expected);
+
+            vec_freeVector(&tokens, nullptr);
+        }
+
+        system(("rm -rf " + dir).c_str());
+    }
+
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
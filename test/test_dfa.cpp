@@ -0,0 +1,225 @@
+#include <catch2/catch.hpp>
+
+#include <cstring>
+
+extern "C" {
+#include <dfa.h>
+#include <nfa.h>
+}
+
+/**
+ * Runs a deterministic automaton on the whole input and returns the terminal of the last state.
+ */
+static uint32_t run(const dfa_Automaton *dfa, const char *input) {
+    uint32_t state = dfa->start;
+
+    for (size_t i = 0;input[i] != '\0';++i) {
+        state = dfa_step(dfa, state, input[i]);
+    }
+
+    return dfa->accepts[state];
+}
+
+SCENARIO("A nondeterministic automaton can be made deterministic", "[dfa]") {
+    nfa_Automaton nfa;
+    nfa_createAutomaton(&nfa);
+
+    dfa_Automaton dfa;
+
+    GIVEN("The alternation of two literals sharing a prefix") {
+        nfa_Fragment f1, f2;
+        REQUIRE(nfa_literal(&nfa, "if", 2, &f1));
+        REQUIRE(nfa_literal(&nfa, "in", 2, &f2));
+        REQUIRE(nfa_accept(&nfa, f1, 0));
+        REQUIRE(nfa_accept(&nfa, f2, 1));
+
+        uint32_t ranks[] = { 0, 1 };
+        REQUIRE(dfa_createFromNfa(&dfa, &nfa, ranks));
+
+        THEN("Each literal should be recognized") {
+            REQUIRE(0 == run(&dfa, "if"));
+            REQUIRE(1 == run(&dfa, "in"));
+        }
+
+        AND_THEN("Other inputs should not be accepted") {
+            REQUIRE(DFA_NO_TERMINAL == run(&dfa, "i"));
+            REQUIRE(DFA_NO_TERMINAL == run(&dfa, "ifs"));
+        }
+
+        AND_WHEN("It is minimized") {
+            REQUIRE(dfa_minimize(&dfa));
+
+            THEN("Only the dead, start, prefix and two final states should be kept") {
+                REQUIRE(5 == dfa.stateCount);
+                REQUIRE(0 == run(&dfa, "if"));
+                REQUIRE(1 == run(&dfa, "in"));
+            }
+        }
+
+        dfa_freeAutomaton(&dfa);
+    }
+
+    GIVEN("Two terminals matching the same input") {
+        nfa_Fragment f1, f2;
+        REQUIRE(nfa_literal(&nfa, "let", 3, &f1));
+        REQUIRE(nfa_range(&nfa, 'a', 'z', &f2));
+        REQUIRE(nfa_quantify(&nfa, f2, PRS_PLUS_QUANTIFIER, &f2));
+        REQUIRE(nfa_accept(&nfa, f1, 0));
+        REQUIRE(nfa_accept(&nfa, f2, 1));
+
+        WHEN("The literal has the best rank") {
+            uint32_t ranks[] = { 0, 1 };
+            REQUIRE(dfa_createFromNfa(&dfa, &nfa, ranks));
+
+            THEN("The literal should be accepted") {
+                REQUIRE(0 == run(&dfa, "let"));
+                REQUIRE(1 == run(&dfa, "lets"));
+            }
+        }
+
+        WHEN("The range has the best rank") {
+            uint32_t ranks[] = { 1, 0 };
+            REQUIRE(dfa_createFromNfa(&dfa, &nfa, ranks));
+
+            THEN("The range should be accepted") {
+                REQUIRE(1 == run(&dfa, "let"));
+            }
+        }
+
+        dfa_freeAutomaton(&dfa);
+    }
+
+    GIVEN("A quantified range whose subset construction creates equivalent states") {
+        nfa_Fragment f1, f2;
+        REQUIRE(nfa_range(&nfa, '0', '9', &f1));
+        REQUIRE(nfa_range(&nfa, '0', '9', &f2));
+        REQUIRE(nfa_quantify(&nfa, f2, PRS_STAR_QUANTIFIER, &f2));
+        nfa_concat(&nfa, f1, f2, &f1);
+        REQUIRE(nfa_accept(&nfa, f1, 0));
+
+        uint32_t ranks[] = { 0 };
+        REQUIRE(dfa_createFromNfa(&dfa, &nfa, ranks));
+        REQUIRE(dfa_minimize(&dfa));
+
+        THEN("The minimized automaton should have a dead, a start and a final state") {
+            REQUIRE(3 == dfa.stateCount);
+            REQUIRE(DFA_DEAD_STATE == dfa_step(&dfa, dfa.start, 'a'));
+            REQUIRE(0 == run(&dfa, "2024"));
+        }
+
+        dfa_freeAutomaton(&dfa);
+    }
+
+    nfa_freeAutomaton(&nfa);
+}
+
+/**
+ * Runs a lazy automaton on the whole input and returns the terminal of the last state.
+ */
+static uint32_t runLazy(dfa_LazyAutomaton *dfa, const char *input) {
+    uint32_t state = DFA_LAZY_START_STATE;
+
+    for (size_t i = 0;input[i] != '\0';++i) {
+        uint8_t c = (uint8_t) input[i];
+        state = dfa_lazyStep(dfa, state, c);
+        REQUIRE(DFA_UNKNOWN_STATE != state);
+    }
+
+    return dfa->accepts[state];
+}
+
+SCENARIO("A lazy automaton builds its states on demand", "[dfa]") {
+    nfa_Automaton nfa;
+    nfa_createAutomaton(&nfa);
+
+    // Keywords, names and numbers : "let" and "lets" go through different states
+    const char *keywords[] = { "let", "if", "in", "else" };
+    uint32_t ranks[] = { 0, 1, 2, 3, 4, 5 };
+
+    for (uint32_t i = 0;i < 4;++i) {
+        nfa_Fragment fragment;
+        REQUIRE(nfa_literal(&nfa, keywords[i], strlen(keywords[i]), &fragment));
+        REQUIRE(nfa_accept(&nfa, fragment, i));
+    }
+
+    nfa_Fragment name, number;
+    REQUIRE(nfa_range(&nfa, 'a', 'z', &name));
+    REQUIRE(nfa_quantify(&nfa, name, PRS_PLUS_QUANTIFIER, &name));
+    REQUIRE(nfa_accept(&nfa, name, 4));
+    REQUIRE(nfa_range(&nfa, '0', '9', &number));
+    REQUIRE(nfa_quantify(&nfa, number, PRS_STAR_QUANTIFIER, &number));
+    REQUIRE(nfa_accept(&nfa, number, 5));
+
+    dfa_Automaton full;
+    REQUIRE(dfa_createFromNfa(&full, &nfa, ranks));
+
+    const char *inputs[] = { "let", "lets", "if", "i", "in", "ink", "else", "elsewhere", "42", "", "4a", "#" };
+
+    GIVEN("A cache large enough for the whole automaton") {
+        dfa_LazyAutomaton lazy;
+        REQUIRE(dfa_createLazyAutomaton(&lazy, &nfa, ranks, 64));
+
+        THEN("Only the dead and start states should be built at first") {
+            REQUIRE(2 == lazy.stateCount);
+        }
+
+        AND_THEN("Each input should give the terminal of the full automaton") {
+            for (const char *input : inputs) {
+                INFO("Input : " << input);
+                REQUIRE(run(&full, input) == runLazy(&lazy, input));
+            }
+
+            REQUIRE(0 == lazy.counters.flushes);
+            REQUIRE(lazy.stateCount <= full.stateCount);
+        }
+
+        AND_WHEN("An input is read again") {
+            runLazy(&lazy, "elsewhere");
+            dfa_CacheCounters before = lazy.counters;
+            runLazy(&lazy, "elsewhere");
+
+            THEN("Every transition should be a hit") {
+                REQUIRE(before.misses == lazy.counters.misses);
+                REQUIRE(before.hits + 9 == lazy.counters.hits);
+            }
+        }
+
+        AND_WHEN("A byte is read from a state") {
+            runLazy(&lazy, "a");
+            uint64_t misses = lazy.counters.misses;
+            runLazy(&lazy, "z");
+
+            THEN("Bytes of the same block should share its transition") {
+                REQUIRE(misses == lazy.counters.misses);
+            }
+        }
+
+        dfa_freeLazyAutomaton(&lazy);
+    }
+
+    GIVEN("A cache smaller than the automaton") {
+        dfa_LazyAutomaton lazy;
+        REQUIRE(dfa_createLazyAutomaton(&lazy, &nfa, ranks, 1));
+
+        THEN("The cache should have its minimum size") {
+            REQUIRE(DFA_MIN_CACHE_STATE_COUNT == lazy.maxStateCount);
+        }
+
+        AND_THEN("Flushes should not change the results") {
+            for (int pass = 0;pass < 2;++pass) {
+                for (const char *input : inputs) {
+                    INFO("Input : " << input);
+                    REQUIRE(run(&full, input) == runLazy(&lazy, input));
+                    REQUIRE(lazy.stateCount <= lazy.maxStateCount);
+                }
+            }
+
+            REQUIRE(0 < lazy.counters.flushes);
+        }
+
+        dfa_freeLazyAutomaton(&lazy);
+    }
+
+    dfa_freeAutomaton(&full);
+    nfa_freeAutomaton(&nfa);
+}
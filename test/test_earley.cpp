@@ -0,0 +1,345 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <map>
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <earley.h>
+#include <formal_grammar.h>
+#include <glr_parser.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <lr_table.h>
+#include <parser.h>
+#include <sppf.h>
+#include <token_buffer.h>
+}
+
+/**
+ * Counts the trees of a node of a forest without cycle.
+ */
+static double countTrees(const sppf_Node *node, std::map<const sppf_Node*, double> &counts) {
+    if (!node->packedNodes) {
+        return 1;
+    }
+
+    auto found = counts.find(node);
+
+    if (found != counts.end()) {
+        return found->second;
+    }
+
+    double count = 0;
+
+    for (const sppf_PackedNode *packedNode = node->packedNodes;packedNode;packedNode = packedNode->next) {
+        double product = 1;
+
+        for (uint32_t i = 0;i < packedNode->childCount;++i) {
+            product *= countTrees(packedNode->children[i], counts);
+        }
+
+        count += product;
+    }
+
+    counts[node] = count;
+
+    return count;
+}
+
+SCENARIO("Earley sets recognize any grammar", "[earley]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                      "%e = e `+` t | t;\n"
+                                      "%t = t `*` f | f;\n"
+                                      "%f = `(` e `)` | NUM;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    ea_Parser parser;
+    REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    size_t errorIndex = 0;
+
+    GIVEN("A valid input") {
+        std::string input = "1 + 2 * 3";
+        REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The forest should have one derivation") {
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(0 == forest.ambiguousNodeCount);
+            REQUIRE(0 == forest.root->start);
+            REQUIRE(5 == forest.root->end);
+
+            uint32_t expected[] = { 0, 1, 3, 5, 2, 3, 5, 5 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_THEN("It should be recognized without a forest") {
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, nullptr, nullptr));
+            REQUIRE(6 == parser.setStarts.size - 1);
+        }
+    }
+
+    GIVEN("Deeply nested expressions") {
+        std::string input;
+
+        for (int i = 0;i < 10000;++i) {
+            input += "(";
+        }
+
+        input += "1";
+
+        for (int i = 0;i < 10000;++i) {
+            input += ")";
+        }
+
+        REQUIRE(20001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The forest should be built without recursion") {
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(0 == forest.ambiguousNodeCount);
+        }
+    }
+
+    GIVEN("An unexpected token") {
+        std::string input = "1 + * 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("Its index should be given") {
+            REQUIRE(EA_SYNTAX_ERROR == ea_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(2 == errorIndex);
+        }
+    }
+
+    GIVEN("An input that ends too soon") {
+        std::string input = "(1 + 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The error should be after the last token") {
+            REQUIRE(EA_SYNTAX_ERROR == ea_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(4 == errorIndex);
+        }
+    }
+
+    GIVEN("An empty input") {
+        REQUIRE(0 == tb_tokenize(&tokens, &lexer, "", 0, nullptr));
+
+        THEN("The end should not be expected") {
+            REQUIRE(EA_SYNTAX_ERROR == ea_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(0 == errorIndex);
+        }
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    sppf_freeForest(&forest);
+    ea_freeParser(&parser);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Ambiguous derivations are packed into a forest", "[earley]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    lex_Lexer lexer;
+    ga_Grammar grammar;
+    ea_Parser parser;
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+
+    GIVEN("The duplicated productions of the example grammar") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%INT=[0-9];\n"
+                                          "%SUB = `-`;\n"
+                                          "%MUL = `*`;\n"
+                                          "%expr = op SUB op | op;\n"
+                                          "%op = op2 MUL op2 | op2;\n"
+                                          "%op2 = SUB INT | INT | SUB INT;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+
+        THEN("Each negative number should have two derivations") {
+            std::string input = "-1 * 2 - -3";
+            REQUIRE(7 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(2 == forest.ambiguousNodeCount);
+
+            // The first production wins in the derivation
+            uint32_t expected[] = { 0, 2, 4, 5, 3, 4 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        ea_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("An ambiguous sum") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%e = e `+` e | NUM;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+
+        THEN("Both groupings should derive the root") {
+            std::string input = "1 + 2 + 3";
+            REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+
+            REQUIRE(sppf_isAmbiguous(forest.root));
+            REQUIRE(forest.root->packedNodes->production == forest.root->packedNodes->next->production);
+            REQUIRE(nullptr == forest.root->packedNodes->next->next);
+        }
+
+        ea_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A right recursive rule") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%l = `a` l | `a`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+
+        std::string input;
+
+        for (int i = 0;i < 10000;++i) {
+            input += "a";
+        }
+
+        REQUIRE(10000 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("Leo items should keep the sets small") {
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(parser.items.size < 10 * tokens.size);
+            REQUIRE(0 == forest.ambiguousNodeCount);
+
+            vec_Vector derivation;
+            vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+            REQUIRE(SPPF_DERIVED == sppf_addDerivation(&forest, forest.root, &derivation));
+            REQUIRE(10000 == derivation.size);
+            REQUIRE(0 == *((uint32_t*) vec_at(&derivation, 0)));
+            REQUIRE(1 == *((uint32_t*) vec_at(&derivation, derivation.size - 1)));
+            vec_freeVector(&derivation, nullptr);
+        }
+
+        ea_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("Rules that derive each other before a terminal") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%p = q | `b`;\n"
+                                          "%q = p | `b` `a`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+
+        THEN("The derivation should leave the cycle") {
+            std::string input = "b";
+            REQUIRE(1 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+
+            uint32_t expected[] = { 1 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        ea_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A right recursive chain that reaches the entry rule") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%p = q r | `a`;\n"
+                                          "%q = p;\n"
+                                          "%r = p;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+
+        THEN("The complete items of the entry rule should accept the input") {
+            std::string input = "a a";
+            REQUIRE(2 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+
+            uint32_t expected[] = { 0, 2, 1, 3, 1 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        ea_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    sppf_freeForest(&forest);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Leo chains keep every derivation of the forest", "[earley]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%p = r q | `a` | `b`;\n"
+                                      "%q = p r `b`;\n"
+                                      "%r = p | `a` `b` | r r;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    ea_Parser parser;
+    REQUIRE(PRS_OK == ea_createParser(&parser, &grammar));
+    lr_Table table;
+    REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+    glr_Parser glrParser;
+    REQUIRE(PRS_OK == glr_createParser(&glrParser, &table));
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+    sppf_Forest glrForest;
+    REQUIRE(sppf_createForest(&glrForest));
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+
+    GIVEN("Inputs whose trees go through the same chains") {
+        const char *inputs[] = { "b b b b b", "a b b b b", "b b b b b b b", "a b a b b a b" };
+        double treeCounts[] = { 2, 3, 17, 26 };
+
+        THEN("The forest should have the trees of the GLR forest") {
+            for (size_t i = 0;i < sizeof(inputs) / sizeof(*inputs);++i) {
+                std::string input = inputs[i];
+                std::map<const sppf_Node*, double> counts;
+                std::map<const sppf_Node*, double> glrCounts;
+
+                REQUIRE(0 < tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+                REQUIRE(EA_ACCEPTED == ea_parse(&parser, &tokens, &forest, nullptr));
+                REQUIRE(GLR_ACCEPTED == glr_parse(&glrParser, &tokens, &glrForest, nullptr));
+                REQUIRE(treeCounts[i] == countTrees(glrForest.root, glrCounts));
+                REQUIRE(treeCounts[i] == countTrees(forest.root, counts));
+            }
+        }
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    sppf_freeForest(&glrForest);
+    sppf_freeForest(&forest);
+    glr_freeParser(&glrParser);
+    lr_freeTable(&table);
+    ea_freeParser(&parser);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
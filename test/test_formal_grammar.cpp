@@ -7,61 +7,65 @@ extern "C" {
 #include <parser_errors.h>
 #include <formal_grammar.h>
 #include <collections/linked_list.h>
+#include <collections/vector.h>
 }
 
 using Catch::Matchers::Equals;
 
 SCENARIO("A token can be extracted from a list of items", "[formal_grammar]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
+
+    fg_Grammar g;
+    fg_createGrammar(&g);
     fg_Token token = {};
 
     GIVEN("A token without a value") {
         fillItemList(&itemList, { "%TOKEN", "=", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_TOKEN_MISSING_VALUE == res);
         }
     }
 
     GIVEN("A token without the ending semicolon") {
         fillItemList(&itemList, { "%TOKEN", "=", "FUNC" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_TOKEN_MISSING_END == res);
         }
     }
 
     GIVEN("A token without the equal sign (token name directly followed by its value") {
         fillItemList(&itemList, { "%TOKEN", "`FUNC`", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_TOKEN_INVALID == res);
         }
     }
 
     GIVEN("A token without more items than its name") {
         fillItemList(&itemList, { "%TOKEN" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_TOKEN_INVALID == res);
         }
     }
 
     GIVEN("A valid string token with a quantifier") {
         fillItemList(&itemList, { "%TOKEN", "=", "`FUNC`", "+", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return ok and the token structure should have been updated") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(PRS_OK == res);
 
             REQUIRE(FG_STRING_TOKEN == token.type);
@@ -73,10 +77,10 @@ SCENARIO("A token can be extracted from a list of items", "[formal_grammar]") {
 
     GIVEN("A valid range token with 2 ranges") {
         fillItemList(&itemList, { "%TOKEN", "=", "[a-z2-4]", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return OK") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(PRS_OK == res);
 
             AND_THEN("ranges pointer in token structure should have been updated") {
@@ -89,19 +93,19 @@ SCENARIO("A token can be extracted from a list of items", "[formal_grammar]") {
 
     GIVEN("A token with a self reference") {
         fillItemList(&itemList, { "%TOKEN", "=", "TOKEN", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_TOKEN_SELF_REF == res);
         }
     }
 
     GIVEN("A token with a ref on another token") {
         fillItemList(&itemList, { "%TOKEN", "=", "TOKEN2", "?", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
-        int res = fg_extractToken(&token, &it, (prs_StringItem*) ll_iteratorNext(&it));
+        int res = fg_extractToken(&g, &token, &it, (prs_StringItem*) vec_cursorNext(&it));
 
         THEN("It should return ok") {
             REQUIRE(PRS_OK == res);
@@ -112,21 +116,24 @@ SCENARIO("A token can be extracted from a list of items", "[formal_grammar]") {
         }
 
         AND_THEN("The ref symbol should be on TOKEN2") {
-            REQUIRE_THAT("TOKEN2", Equals(token.value.refToken.symbol->item));
+            REQUIRE_THAT("TOKEN2", Equals(sym_getName(&g.symbols, token.value.refToken.symbol.id)));
         }
     }
 
-    fg_freeToken(&token);
-    ll_freeLinkedList(&itemList, nullptr);
+    fg_freeGrammar(&g);
+    vec_freeVector(&itemList, nullptr);
 }
 
 SCENARIO("A production rule item has a type and a value (or a reference)", "[formal_grammar]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
     fg_PRItem prItem;
     memset(&prItem, 0, sizeof(prItem));
 
     GIVEN("An unknown item type") {
         prs_StringItem stringItem = { .item = (char*) "@token", .line = 0, .column = 0 };
-        int res = fg_extractPRItem(&prItem, &stringItem);
+        int res = fg_extractPRItem(&g, &prItem, &stringItem);
 
         THEN("It should return an error") {
             REQUIRE(FG_PRITEM_UNKNOWN_TYPE == res);
@@ -135,7 +142,7 @@ SCENARIO("A production rule item has a type and a value (or a reference)", "[for
 
     GIVEN("A reference to a rule") {
         prs_StringItem stringItem = { .item = (char*) "rule1", .line = 0, .column = 0 };
-        int res = fg_extractPRItem(&prItem, &stringItem);
+        int res = fg_extractPRItem(&g, &prItem, &stringItem);
 
         THEN("It should return ok") {
             REQUIRE(PRS_OK == res);
@@ -143,13 +150,13 @@ SCENARIO("A production rule item has a type and a value (or a reference)", "[for
 
         AND_THEN("prItem type and symbol fields should have been updated") {
             REQUIRE(FG_RULE_ITEM == prItem.type);
-            REQUIRE_THAT("rule1", Equals(prItem.symbol->item));
+            REQUIRE_THAT("rule1", Equals(sym_getName(&g.symbols, prItem.symbol.id)));
         }
     }
 
     GIVEN("A string block without the end marker") {
         prs_StringItem stringItem = { .item = (char*) "`hello", .line = 0, .column = 0 };
-        int res = fg_extractPRItem(&prItem, &stringItem);
+        int res = fg_extractPRItem(&g, &prItem, &stringItem);
 
         THEN("It should return an error") {
             REQUIRE(FG_STRING_BLOCK_MISSING_END == res);
@@ -158,7 +165,7 @@ SCENARIO("A production rule item has a type and a value (or a reference)", "[for
 
     GIVEN("An empty string block (with start and end markers)") {
         prs_StringItem stringItem = { .item = (char*) "``", .line = 0, .column = 0 };
-        int res = fg_extractPRItem(&prItem, &stringItem);
+        int res = fg_extractPRItem(&g, &prItem, &stringItem);
 
         THEN("It should return an error") {
             REQUIRE(FG_STRING_BLOCK_EMPTY == res);
@@ -167,7 +174,7 @@ SCENARIO("A production rule item has a type and a value (or a reference)", "[for
 
     GIVEN("A valid string block") {
         prs_StringItem stringItem = { .item = (char*) "`hello`", .line = 0, .column = 0 };
-        int res = fg_extractPRItem(&prItem, &stringItem);
+        int res = fg_extractPRItem(&g, &prItem, &stringItem);
 
         THEN("It should return ok") {
             REQUIRE(PRS_OK == res);
@@ -179,23 +186,26 @@ SCENARIO("A production rule item has a type and a value (or a reference)", "[for
         }
     }
 
-    fg_freePRItem(&prItem);
+    fg_freeGrammar(&g);
 }
 
 SCENARIO("A production rule is made by one or more items (token or rule)", "[formal_grammar]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
+
+    fg_Grammar g;
+    fg_createGrammar(&g);
 
     ll_LinkedList productionRule;
-    ll_createLinkedList(&productionRule, (ll_DataDestructor*) free);
+    ll_createArenaLinkedList(&productionRule, &g.arena);
 
     GIVEN("An iterator on a valid production rule items") {
         fillItemList(&itemList, { "rule1", "TOKEN1", "|" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return OK") {
             prs_StringItem *lastItem = nullptr;
-            int res = fg_extractProductionRule(&productionRule, &it, (prs_StringItem*) ll_iteratorNext(&it), &lastItem);
+            int res = fg_extractProductionRule(&g, &productionRule, &it, (prs_StringItem*) vec_cursorNext(&it), &lastItem);
 
             REQUIRE(PRS_OK == res);
 
@@ -212,11 +222,11 @@ SCENARIO("A production rule is made by one or more items (token or rule)", "[for
 
     GIVEN("An iterator on non valid production rule items") {
         fillItemList(&itemList, { "rule1", "()()", "|" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
             prs_StringItem *lastItem = nullptr;
-            int res = fg_extractProductionRule(&productionRule, &it, (prs_StringItem*) ll_iteratorNext(&it), &lastItem);
+            int res = fg_extractProductionRule(&g, &productionRule, &it, (prs_StringItem*) vec_cursorNext(&it), &lastItem);
 
             REQUIRE(FG_PRITEM_UNKNOWN_TYPE == res);
 
@@ -232,11 +242,11 @@ SCENARIO("A production rule is made by one or more items (token or rule)", "[for
 
     GIVEN("An iterator on an empty production rule") {
         fillItemList(&itemList, { "|" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
             prs_StringItem *lastItem = nullptr;
-            int res = fg_extractProductionRule(&productionRule, &it, (prs_StringItem*) ll_iteratorNext(&it), &lastItem);
+            int res = fg_extractProductionRule(&g, &productionRule, &it, (prs_StringItem*) vec_cursorNext(&it), &lastItem);
 
             REQUIRE(FG_PR_EMPTY == res);
 
@@ -246,47 +256,50 @@ SCENARIO("A production rule is made by one or more items (token or rule)", "[for
         }
     }
 
-    ll_freeLinkedList(&itemList, nullptr);
-    ll_freeLinkedList(&productionRule, nullptr);
+    vec_freeVector(&itemList, nullptr);
+    fg_freeGrammar(&g);
 }
 
 SCENARIO("A rule is made by one or more rules separated by a pipe and ends with a semicolon", "[formal_grammar]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
+
+    fg_Grammar g;
+    fg_createGrammar(&g);
 
     fg_Rule rule;
-    fg_createRule(&rule);
+    fg_createRule(&g, &rule);
 
     GIVEN("An iterator on a rule without the end marker") {
         fillItemList(&itemList, { "%basic_rule", "=", "rule1" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractRule(&rule, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractRule(&g, &rule, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_RULE_MISSING_END == res);
         }
     }
 
     GIVEN("An iterator on an empty rule") {
         fillItemList(&itemList, { "%basic_rule", "=", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return an error") {
-            int res = fg_extractRule(&rule, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractRule(&g, &rule, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(FG_RULE_EMPTY == res);
         }
     }
 
     GIVEN("An iterator on a two production rules") {
         fillItemList(&itemList, { "%basic_rule", "=", "rule1", "|", "TOKEN1", ";" });
-        ll_Iterator it = ll_createIterator(&itemList);
+        vec_Cursor it = vec_createCursor(&itemList);
 
         THEN("It should return OK") {
-            int res = fg_extractRule(&rule, &it, (prs_StringItem*) ll_iteratorNext(&it));
+            int res = fg_extractRule(&g, &rule, &it, (prs_StringItem*) vec_cursorNext(&it));
             REQUIRE(PRS_OK == res);
         }
     }
 
-    ll_freeLinkedList(&itemList, nullptr);
-    fg_freeRule(&rule);
+    vec_freeVector(&itemList, nullptr);
+    fg_freeGrammar(&g);
 }
@@ -0,0 +1,252 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <glr_parser.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <lr_table.h>
+#include <parser.h>
+#include <sppf.h>
+#include <token_buffer.h>
+}
+
+SCENARIO("A conflict-free table keeps a single stack", "[glr_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                      "%e = e `+` t | t;\n"
+                                      "%t = t `*` f | f;\n"
+                                      "%f = `(` e `)` | NUM;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    lr_Table table;
+    REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+    REQUIRE(0 == table.conflicts.size);
+    glr_Parser parser;
+    REQUIRE(PRS_OK == glr_createParser(&parser, &table));
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    size_t errorIndex = 0;
+
+    GIVEN("A valid input") {
+        std::string input = "1 + 2 * 3";
+        REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The forest should have one derivation") {
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(0 == forest.ambiguousNodeCount);
+            REQUIRE(0 == forest.root->start);
+            REQUIRE(5 == forest.root->end);
+
+            uint32_t expected[] = { 0, 1, 3, 5, 2, 3, 5, 5 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_THEN("Reduced nodes should be dropped") {
+            // The start node and the node of the entry rule
+            REQUIRE(parser.dropsNodes);
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, nullptr, nullptr));
+            REQUIRE(2 == parser.nodes.size);
+        }
+    }
+
+    GIVEN("Deeply nested expressions") {
+        std::string input;
+
+        for (int i = 0;i < 10000;++i) {
+            input += "(";
+        }
+
+        input += "1";
+
+        for (int i = 0;i < 10000;++i) {
+            input += ")";
+        }
+
+        REQUIRE(20001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("They should be parsed without recursion") {
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(0 == forest.ambiguousNodeCount);
+        }
+    }
+
+    GIVEN("An unexpected token") {
+        std::string input = "1 + * 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("Its index should be given") {
+            REQUIRE(GLR_SYNTAX_ERROR == glr_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(2 == errorIndex);
+        }
+    }
+
+    GIVEN("An input that ends too soon") {
+        std::string input = "(1 + 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The error should be after the last token") {
+            REQUIRE(GLR_SYNTAX_ERROR == glr_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(4 == errorIndex);
+        }
+    }
+
+    GIVEN("An empty input") {
+        REQUIRE(0 == tb_tokenize(&tokens, &lexer, "", 0, nullptr));
+
+        THEN("The end should not be expected") {
+            REQUIRE(GLR_SYNTAX_ERROR == glr_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(0 == errorIndex);
+        }
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    sppf_freeForest(&forest);
+    glr_freeParser(&parser);
+    lr_freeTable(&table);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Conflicting actions fork the stack", "[glr_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    lex_Lexer lexer;
+    ga_Grammar grammar;
+    lr_Table table;
+    glr_Parser parser;
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+
+    GIVEN("The duplicated productions of the example grammar") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%INT=[0-9];\n"
+                                          "%SUB = `-`;\n"
+                                          "%MUL = `*`;\n"
+                                          "%expr = op SUB op | op;\n"
+                                          "%op = op2 MUL op2 | op2;\n"
+                                          "%op2 = SUB INT | INT | SUB INT;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+        REQUIRE(PRS_OK == glr_createParser(&parser, &table));
+
+        THEN("Each negative number should have two derivations") {
+            std::string input = "-1 * 2 - -3";
+            REQUIRE(7 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(2 == forest.ambiguousNodeCount);
+
+            // The first production wins in the derivation
+            uint32_t expected[] = { 0, 2, 4, 5, 3, 4 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        glr_freeParser(&parser);
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("An ambiguous sum") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%e = e `+` e | NUM;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+        REQUIRE(PRS_OK == glr_createParser(&parser, &table));
+
+        THEN("Both groupings should derive the root") {
+            std::string input = "1 + 2 + 3";
+            REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, nullptr));
+
+            REQUIRE(sppf_isAmbiguous(forest.root));
+            REQUIRE(forest.root->packedNodes->production == forest.root->packedNodes->next->production);
+            REQUIRE(nullptr == forest.root->packedNodes->next->next);
+            REQUIRE(3 == forest.root->packedNodes->childCount);
+        }
+
+        glr_freeParser(&parser);
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A grammar that needs two tokens of lookahead") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%s = a `x` `y` | b `x` `z`;\n"
+                                          "%a = `w`;\n"
+                                          "%b = `w`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+        REQUIRE(1 == table.conflicts.size);
+        REQUIRE(PRS_OK == glr_createParser(&parser, &table));
+
+        THEN("The stack that cannot shift should be dropped") {
+            std::string input = "w x z";
+            REQUIRE(3 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(0 == forest.ambiguousNodeCount);
+
+            uint32_t expected[] = { 1, 3 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_THEN("A token that no stack shifts should be an error") {
+            std::string input = "w x w";
+            size_t errorIndex = 0;
+            REQUIRE(3 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(GLR_SYNTAX_ERROR == glr_parse(&parser, &tokens, &forest, &errorIndex));
+            REQUIRE(2 == errorIndex);
+        }
+
+        glr_freeParser(&parser);
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("Rules that derive each other") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%a = b | `x`;\n"
+                                          "%b = a | `y`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+        REQUIRE(PRS_OK == glr_createParser(&parser, &table));
+        REQUIRE_FALSE(parser.dropsNodes);
+
+        THEN("The cycle of reductions should stop at the edges it added") {
+            std::string input = "x";
+            REQUIRE(1 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(GLR_ACCEPTED == glr_parse(&parser, &tokens, &forest, nullptr));
+            REQUIRE(sppf_isAmbiguous(forest.root));
+
+            uint32_t expected[] = { 1 };
+            requireForestDerivation(&forest, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        glr_freeParser(&parser);
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    sppf_freeForest(&forest);
+    fg_freeGrammar(&g);
+}
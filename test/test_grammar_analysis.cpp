@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <formal_grammar.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <parser.h>
+}
+
+SCENARIO("Rules of a grammar are flattened", "[grammar_analysis]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    lex_Lexer lexer;
+    ga_Grammar grammar;
+
+    GIVEN("An expression grammar") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%ID=[a-z]+;\n"
+                                          "%e = t `+` e | t;\n"
+                                          "%t = f `*` t | f;\n"
+                                          "%f = `(` e `)` | NUM | ID;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+
+        uint32_t plus = lex_getLiteralTerminal(&lexer, "+");
+        uint32_t star = lex_getLiteralTerminal(&lexer, "*");
+        uint32_t open = lex_getLiteralTerminal(&lexer, "(");
+        uint32_t close = lex_getLiteralTerminal(&lexer, ")");
+
+        THEN("Productions should be stored by rule") {
+            REQUIRE(7 == grammar.terminalCount);
+            REQUIRE(6 == grammar.endTerminal);
+            REQUIRE(3 == grammar.ruleCount);
+            REQUIRE(0 == grammar.entry);
+            REQUIRE(7 == grammar.productionCount);
+            REQUIRE(13 == grammar.symbolCount);
+            REQUIRE(2 == grammar.firstProductions[1]);
+            REQUIRE(7 == grammar.firstProductions[3]);
+
+            const ga_Symbol *symbols = ga_getProductionSymbols(&grammar, 0);
+            REQUIRE(3 == grammar.productions[0].length);
+            REQUIRE(ga_getRuleSymbol(&grammar, 1) == symbols[0]);
+            REQUIRE(plus == symbols[1]);
+            REQUIRE(ga_isRule(&grammar, symbols[2]));
+            REQUIRE(0 == ga_getRule(&grammar, symbols[2]));
+            REQUIRE(0 == *ga_getProductionSymbols(&grammar, 5));
+        }
+
+        AND_THEN("Sets should be the ones of the textbook") {
+            for (uint32_t r = 0;r < 3;++r) {
+                const uint64_t *first = ga_getFirst(&grammar, r);
+
+                REQUIRE_FALSE(grammar.nullable[r]);
+                REQUIRE(ga_setContains(first, 0));
+                REQUIRE(ga_setContains(first, 1));
+                REQUIRE(ga_setContains(first, open));
+                REQUIRE_FALSE(ga_setContains(first, plus));
+            }
+
+            const uint64_t *follow = ga_getFollow(&grammar, 0);
+            REQUIRE(ga_setContains(follow, grammar.endTerminal));
+            REQUIRE(ga_setContains(follow, close));
+            REQUIRE_FALSE(ga_setContains(follow, plus));
+
+            follow = ga_getFollow(&grammar, 1);
+            REQUIRE(ga_setContains(follow, plus));
+            REQUIRE_FALSE(ga_setContains(follow, star));
+
+            follow = ga_getFollow(&grammar, 2);
+            REQUIRE(ga_setContains(follow, plus));
+            REQUIRE(ga_setContains(follow, star));
+            REQUIRE(ga_setContains(follow, close));
+            REQUIRE(ga_setContains(follow, grammar.endTerminal));
+        }
+
+        AND_THEN("Symbols should have the names of the grammar") {
+            REQUIRE(std::string("t") == ga_getSymbolName(&grammar, ga_getRuleSymbol(&grammar, 1)));
+            REQUIRE(std::string("NUM") == ga_getSymbolName(&grammar, 0));
+            REQUIRE(std::string("$end") == ga_getSymbolName(&grammar, grammar.endTerminal));
+        }
+
+        AND_THEN("The FIRST set of a sequence should stop at its first terminal") {
+            ga_Symbol sequence[] = { star, open };
+            uint64_t set[1] = { 0 };
+
+            REQUIRE_FALSE(ga_addFirst(&grammar, sequence, 2, set));
+            REQUIRE(ga_setContains(set, star));
+            REQUIRE_FALSE(ga_setContains(set, open));
+            REQUIRE(ga_addFirst(&grammar, sequence, 0, set));
+        }
+
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A grammar without rule") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+        THEN("It can not be flattened") {
+            REQUIRE(FG_NO_RULE == ga_createGrammar(&grammar, &g, &lexer));
+        }
+
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    fg_freeGrammar(&g);
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+extern "C" {
+#include <grammar_source.h>
+}
+
+static std::string readFile(const char *path) {
+    std::ifstream is { path };
+    std::stringstream content;
+    content << is.rdbuf();
+
+    return content.str();
+}
+
+SCENARIO("A grammar can be loaded from a file or a stream", "[grammar_source]") {
+    prs_GrammarSource source = {};
+
+    GIVEN("A regular file") {
+        bool res = prs_openGrammarFile(&source, "data/test_01.txt");
+
+        THEN("It should be mapped in memory") {
+            REQUIRE(res);
+            REQUIRE(source.mapped);
+        }
+
+        AND_THEN("The view should have the file's content") {
+            std::string expected = readFile("data/test_01.txt");
+
+            REQUIRE(expected.size() == source.length);
+            REQUIRE(expected == std::string(source.data, source.length));
+        }
+    }
+
+    GIVEN("A file that does not exist") {
+        THEN("It should return false") {
+            REQUIRE_FALSE(prs_openGrammarFile(&source, "data/unknown.g"));
+        }
+    }
+
+    GIVEN("A pipe") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+
+        std::string content = "%rule = `a`;\n";
+        REQUIRE(write(fds[1], content.data(), content.size()) == (ssize_t) content.size());
+        close(fds[1]);
+
+        FILE *stream = fdopen(fds[0], "r");
+        bool res = prs_loadGrammarStream(&source, stream);
+        fclose(stream);
+
+        THEN("Its content should be read into a buffer") {
+            REQUIRE(res);
+            REQUIRE_FALSE(source.mapped);
+            REQUIRE(content == std::string(source.data, source.length));
+            REQUIRE('\0' == source.data[source.length]);
+        }
+    }
+
+    prs_closeGrammarSource(&source);
+}
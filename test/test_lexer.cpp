@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <lexer.h>
+#include <parser.h>
+}
+
+using Catch::Matchers::Equals;
+
+static std::string terminalName(const lex_Lexer *lexer, const vec_Vector *tokens, size_t index) {
+    auto token = (const lex_Token*) vec_at((vec_Vector*) tokens, index);
+    return lex_getTerminal(lexer, token->terminal)->name;
+}
+
+SCENARIO("A lexer splits an input into the tokens of a grammar", "[lexer]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    lex_Lexer lexer;
+
+    vec_Vector tokens;
+    vec_createVector(&tokens, sizeof(lex_Token), 0, nullptr);
+
+    GIVEN("A grammar with numbers, identifiers, a keyword and operators") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%INT=[0-9];\n"
+                                          "%NUMBER=INT+;\n"
+                                          "%LET=`let`;\n"
+                                          "%NAME=[a-zA-Z]+;\n"
+                                          "%PLUS=`+`;\n"
+                                          "%stmt = LET NAME `=` NUMBER PLUS NUMBER `;`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+        THEN("String items should have their own terminals after the tokens") {
+            REQUIRE(7 == lexer.terminals.size);
+            REQUIRE(5 == lexer.tokenCount);
+            REQUIRE_THAT(lex_getTerminal(&lexer, 5)->name, Equals("="));
+            REQUIRE(5 == lex_getLiteralTerminal(&lexer, "="));
+        }
+
+        AND_THEN("String tokens should be used for string items with the same value") {
+            REQUIRE(2 == lex_getLiteralTerminal(&lexer, "let"));
+            REQUIRE(LEX_NO_TERMINAL == lex_getLiteralTerminal(&lexer, "-"));
+        }
+
+        WHEN("An input is tokenized") {
+            std::string input = "let letter = 12 + 345;";
+            size_t errorOffset = 0;
+
+            REQUIRE(7 == lex_tokenize(&lexer, input.data(), input.size(), &tokens, &errorOffset));
+
+            THEN("The longest match should win, then the first declared token") {
+                REQUIRE(terminalName(&lexer, &tokens, 0) == "LET");
+                REQUIRE(terminalName(&lexer, &tokens, 1) == "NAME");
+                REQUIRE(terminalName(&lexer, &tokens, 2) == "=");
+                REQUIRE(terminalName(&lexer, &tokens, 3) == "NUMBER");
+                REQUIRE(terminalName(&lexer, &tokens, 5) == "NUMBER");
+                REQUIRE(terminalName(&lexer, &tokens, 6) == ";");
+            }
+
+            AND_THEN("Each token should have its position in the input") {
+                auto token = (lex_Token*) vec_at(&tokens, 1);
+                REQUIRE(4 == token->offset);
+                REQUIRE(6 == token->length);
+            }
+        }
+
+        WHEN("An input contains runs longer than a SIMD vector") {
+            std::string number(100, '7');
+            std::string name(40, 'z');
+            std::string input = name + " = " + number + "+1";
+
+            REQUIRE(5 == lex_tokenize(&lexer, input.data(), input.size(), &tokens, nullptr));
+
+            THEN("Each run should be a single token") {
+                auto token = (lex_Token*) vec_at(&tokens, 0);
+                REQUIRE(40 == token->length);
+
+                token = (lex_Token*) vec_at(&tokens, 2);
+                REQUIRE(terminalName(&lexer, &tokens, 2) == "NUMBER");
+                REQUIRE(43 == token->offset);
+                REQUIRE(100 == token->length);
+            }
+        }
+
+        WHEN("An input contains an unknown character") {
+            std::string input = "let x = 1 # 2";
+            size_t errorOffset = 0;
+
+            THEN("The offset of this character should be given") {
+                REQUIRE(LEX_TOKENIZE_ERROR == lex_tokenize(&lexer, input.data(), input.size(), &tokens, &errorOffset));
+                REQUIRE(10 == errorOffset);
+                REQUIRE(4 == tokens.size);
+            }
+        }
+
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A lazy lexer with a small cache") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%INT=[0-9];\n"
+                                          "%NUMBER=INT+;\n"
+                                          "%LET=`let`;\n"
+                                          "%NAME=[a-zA-Z]+;\n"
+                                          "%PLUS=`+`;\n"
+                                          "%stmt = LET NAME `=` NUMBER PLUS NUMBER `;`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+        lex_Lexer lazyLexer;
+        REQUIRE(PRS_OK == lex_createLazyLexer(&lazyLexer, &g, DFA_MIN_CACHE_STATE_COUNT));
+        REQUIRE(lazyLexer.lazyDfa);
+
+        std::string input;
+
+        for (int i = 0;i < 50;++i) {
+            input += "let letter = 12 + 345; lets=" + std::string(i, '9') + ";le+x\n";
+        }
+
+        THEN("Tokens should be the ones of the full automaton") {
+            vec_Vector lazyTokens;
+            vec_createVector(&lazyTokens, sizeof(lex_Token), 0, nullptr);
+
+            ssize_t count = lex_tokenize(&lexer, input.data(), input.size(), &tokens, nullptr);
+            REQUIRE(count == lex_tokenize(&lazyLexer, input.data(), input.size(), &lazyTokens, nullptr));
+
+            for (size_t i = 0;i < tokens.size;++i) {
+                auto token = (lex_Token*) vec_at(&tokens, i);
+                auto lazyToken = (lex_Token*) vec_at(&lazyTokens, i);
+
+                REQUIRE(token->terminal == lazyToken->terminal);
+                REQUIRE(token->offset == lazyToken->offset);
+                REQUIRE(token->length == lazyToken->length);
+            }
+
+            REQUIRE(0 < lazyLexer.lazyDfa->counters.hits);
+            REQUIRE(0 < lazyLexer.lazyDfa->counters.flushes);
+
+            vec_freeVector(&lazyTokens, nullptr);
+        }
+
+        lex_freeLexer(&lazyLexer);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A grammar whose tokens reference each other") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%A=B;\n"
+                                          "%B=A;\n"
+                                          "%r = A;\n"));
+
+        THEN("The lexer should not be created") {
+            REQUIRE(FG_TOKEN_REF_CYCLE == lex_createLexer(&lexer, &g));
+        }
+
+        lex_freeLexer(&lexer);
+    }
+
+    vec_freeVector(&tokens, nullptr);
+    fg_freeGrammar(&g);
+}
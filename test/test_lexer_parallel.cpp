@@ -0,0 +1,166 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <climits>
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <lexer.h>
+#include <lexer_parallel.h>
+#include <parser.h>
+}
+
+struct TokenizeResult {
+    vec_Vector tokens;
+    ssize_t tokenCount;
+    size_t errorOffset;
+};
+
+static TokenizeResult tokenize(const lex_Lexer *lexer, const std::string &input, unsigned threadCount) {
+    TokenizeResult result;
+    vec_createVector(&result.tokens, sizeof(lex_Token), 0, nullptr);
+    result.errorOffset = 0;
+
+    result.tokenCount = (threadCount == 1)
+                        ? lex_tokenize(lexer, input.data(), input.size(), &result.tokens, &result.errorOffset)
+                        : lex_tokenizeParallel(lexer, input.data(), input.size(), threadCount, &result.tokens,
+                                               &result.errorOffset);
+
+    return result;
+}
+
+static int compareTokens(const void *t1, const void *t2) {
+    auto token1 = (const lex_Token*) t1;
+    auto token2 = (const lex_Token*) t2;
+
+    return !(token1->terminal == token2->terminal && token1->offset == token2->offset
+             && token1->length == token2->length);
+}
+
+/**
+ * Checks that each thread count gives the same result as the sequential lexer.
+ */
+static void requireSameTokens(const lex_Lexer *lexer, const std::string &input, unsigned maxThreadCount) {
+    TokenizeResult expected = tokenize(lexer, input, 1);
+
+    for (unsigned threadCount = 2;threadCount <= maxThreadCount;++threadCount) {
+        TokenizeResult actual = tokenize(lexer, input, threadCount);
+
+        INFO("Thread count : " << threadCount);
+        REQUIRE(expected.tokenCount == actual.tokenCount);
+        REQUIRE(vec_isEqual(&expected.tokens, &actual.tokens, compareTokens));
+
+        if (expected.tokenCount == LEX_TOKENIZE_ERROR) {
+            REQUIRE(expected.errorOffset == actual.errorOffset);
+        }
+
+        vec_freeVector(&actual.tokens, nullptr);
+    }
+
+    vec_freeVector(&expected.tokens, nullptr);
+}
+
+SCENARIO("A large input is lexed by several threads", "[lexer_parallel]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    std::string grammar = "%LONG=`abcd`;\n"
+                          "%AB=`ab`;\n"
+                          "%WORD=[c-z]+;\n"
+                          "%NUMBER=[0-9]+;\n"
+                          "%r = LONG AB WORD NUMBER `->`;\n";
+
+    REQUIRE(PRS_OK == loadGrammar(&g, grammar));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+    GIVEN("An input where chunks start in the middle of tokens") {
+        const char *words[] = { "abcd", "ab", "abcx", "zz", "12345", "->", "q", "7" };
+        const char *separators[] = { " ", "", "\n", "  " };
+        std::string input;
+        unsigned seed = 42;
+
+        while (input.size() < 16 * LEX_PARALLEL_MIN_CHUNK_SIZE + 17) {
+            seed = seed * 1103515245 + 12345;
+            input += words[(seed >> 16) % 8];
+            input += separators[(seed >> 8) % 4];
+        }
+
+        THEN("Every thread count should give the tokens of the sequential lexer") {
+            requireSameTokens(&lexer, input, 17);
+        }
+
+        AND_THEN("A huge thread count should be limited by the number of chunks") {
+            TokenizeResult expected = tokenize(&lexer, input, 1);
+            TokenizeResult actual = tokenize(&lexer, input, UINT_MAX);
+
+            REQUIRE(expected.tokenCount == actual.tokenCount);
+            REQUIRE(vec_isEqual(&expected.tokens, &actual.tokens, compareTokens));
+
+            vec_freeVector(&expected.tokens, nullptr);
+            vec_freeVector(&actual.tokens, nullptr);
+        }
+    }
+
+    GIVEN("An input where speculative chunks find unexpected bytes") {
+        // A chunk that starts at '>' can not be lexed, the true lexing reads `->`
+        std::string input;
+
+        while (input.size() < 8 * LEX_PARALLEL_MIN_CHUNK_SIZE) {
+            input += "->";
+        }
+
+        THEN("The unexpected bytes should not be reported") {
+            requireSameTokens(&lexer, input, 9);
+            requireSameTokens(&lexer, input + " ", 9);
+        }
+    }
+
+    GIVEN("A token that covers several chunks") {
+        std::string input = "ab " + std::string(5 * LEX_PARALLEL_MIN_CHUNK_SIZE, '7') + " zz ab";
+
+        THEN("It should be read once") {
+            TokenizeResult result = tokenize(&lexer, input, 8);
+
+            REQUIRE(4 == result.tokenCount);
+            REQUIRE(5 * LEX_PARALLEL_MIN_CHUNK_SIZE == ((lex_Token*) vec_at(&result.tokens, 1))->length);
+
+            vec_freeVector(&result.tokens, nullptr);
+            requireSameTokens(&lexer, input, 8);
+        }
+    }
+
+    GIVEN("An input with an unexpected byte") {
+        std::string input;
+
+        while (input.size() < 8 * LEX_PARALLEL_MIN_CHUNK_SIZE) {
+            input += "abcd 12 -> ";
+        }
+
+        THEN("The error and the tokens before it should be the ones of the sequential lexer") {
+            for (size_t offset : { (size_t) 3, input.size() / 2 + 1, input.size() - 2 }) {
+                std::string invalidInput = input;
+                invalidInput[offset] = '#';
+
+                requireSameTokens(&lexer, invalidInput, 8);
+            }
+        }
+    }
+
+    GIVEN("A small input") {
+        std::string input = "abcd ab 12";
+
+        THEN("It should be lexed by a single thread") {
+            TokenizeResult result = tokenize(&lexer, input, 4);
+            REQUIRE(3 == result.tokenCount);
+            vec_freeVector(&result.tokens, nullptr);
+        }
+    }
+
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
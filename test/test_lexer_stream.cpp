@@ -0,0 +1,203 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <lexer.h>
+#include <lexer_stream.h>
+#include <parser.h>
+}
+
+struct StreamToken {
+    uint32_t terminal;
+    size_t offset;
+    std::string text;
+
+    bool operator==(const StreamToken &other) const {
+        return terminal == other.terminal && offset == other.offset && text == other.text;
+    }
+};
+
+struct LexResult {
+    std::vector<StreamToken> tokens;
+    lex_Result result;
+    size_t errorOffset;
+};
+
+static void collectToken(const lex_Token *token, const char *text, void *args) {
+    static_cast<std::vector<StreamToken>*>(args)->push_back({ token->terminal, token->offset,
+                                                              std::string(text, token->length) });
+}
+
+/**
+ * Lexes the whole input at once.
+ */
+static LexResult lexAll(const lex_Lexer *lexer, const std::string &input) {
+    vec_Vector tokens;
+    vec_createVector(&tokens, sizeof(lex_Token), 0, nullptr);
+
+    LexResult result = { {}, LEX_END, 0 };
+
+    if (lex_tokenize(lexer, input.data(), input.size(), &tokens, &result.errorOffset) == LEX_TOKENIZE_ERROR) {
+        result.result = LEX_ERROR;
+    }
+
+    for (size_t i = 0;i < tokens.size;++i) {
+        auto token = (lex_Token*) vec_at(&tokens, i);
+        result.tokens.push_back({ token->terminal, token->offset, input.substr(token->offset, token->length) });
+    }
+
+    vec_freeVector(&tokens, nullptr);
+
+    return result;
+}
+
+/**
+ * Lexes the input by chunks that end at the given positions.
+ */
+static LexResult lexChunks(const lex_Lexer *lexer, const std::string &input, const std::vector<size_t> &cuts) {
+    LexResult result = { {}, LEX_END, 0 };
+
+    lex_Stream stream;
+    lex_createStream(&stream, lexer, collectToken, &result.tokens);
+
+    size_t start = 0;
+
+    for (size_t cut : cuts) {
+        // Each chunk is a copy that is destroyed after being fed
+        std::string chunk = input.substr(start, cut - start);
+        result.result = lex_feedStream(&stream, chunk.data(), chunk.size());
+        start = cut;
+
+        if (result.result != LEX_END) {
+            break;
+        }
+    }
+
+    if (result.result == LEX_END) {
+        std::string chunk = input.substr(start);
+        result.result = lex_feedStream(&stream, chunk.data(), chunk.size());
+    }
+
+    lex_Result flushResult = lex_flushStream(&stream);
+
+    if (result.result == LEX_END) {
+        result.result = flushResult;
+    }
+
+    result.errorOffset = stream.errorOffset;
+    lex_freeStream(&stream);
+
+    return result;
+}
+
+static void requireSameResult(const LexResult &expected, const LexResult &actual) {
+    REQUIRE(expected.tokens == actual.tokens);
+    REQUIRE(expected.result == actual.result);
+
+    if (expected.result == LEX_ERROR) {
+        REQUIRE(expected.errorOffset == actual.errorOffset);
+    }
+}
+
+SCENARIO("A stream lexes an input given by chunks", "[lexer_stream]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    std::string grammar = "%LONG=`abcd`;\n"
+                          "%AB=`ab`;\n"
+                          "%WORD=[c-z]+;\n"
+                          "%NUMBER=[0-9]+;\n"
+                          "%r = LONG AB WORD NUMBER `->`;\n";
+
+    REQUIRE(PRS_OK == loadGrammar(&g, grammar));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+    GIVEN("An input with tokens that need backtracking") {
+        std::string input = "abcx abcd ab 12345 -> zz abc";
+        LexResult expected = lexAll(&lexer, input);
+
+        REQUIRE(LEX_END == expected.result);
+        REQUIRE(9 == expected.tokens.size());
+
+        THEN("Every split in two chunks should give the same tokens") {
+            for (size_t cut = 0;cut <= input.size();++cut) {
+                requireSameResult(expected, lexChunks(&lexer, input, { cut }));
+            }
+        }
+
+        AND_THEN("Chunks of one byte should give the same tokens") {
+            std::vector<size_t> cuts;
+
+            for (size_t cut = 1;cut < input.size();++cut) {
+                cuts.push_back(cut);
+            }
+
+            requireSameResult(expected, lexChunks(&lexer, input, cuts));
+        }
+    }
+
+    GIVEN("A long run split across many chunks") {
+        std::string input = std::string(1000, '7') + " " + std::string(300, 'q');
+        std::vector<size_t> cuts;
+
+        for (size_t cut = 64;cut < input.size();cut += 64) {
+            cuts.push_back(cut);
+        }
+
+        THEN("It should be a single token") {
+            LexResult result = lexChunks(&lexer, input, cuts);
+
+            REQUIRE(2 == result.tokens.size());
+            REQUIRE(1000 == result.tokens[0].text.size());
+            REQUIRE(1001 == result.tokens[1].offset);
+        }
+    }
+
+    GIVEN("An input with an unexpected byte") {
+        std::string input = "ab 12 -# zz";
+        LexResult expected = lexAll(&lexer, input);
+
+        REQUIRE(LEX_ERROR == expected.result);
+
+        THEN("The error should be found at the same offset for every split") {
+            for (size_t cut = 0;cut <= input.size();++cut) {
+                requireSameResult(expected, lexChunks(&lexer, input, { cut }));
+            }
+        }
+    }
+
+    GIVEN("A stream without callback") {
+        vec_Vector tokens;
+        vec_createVector(&tokens, sizeof(lex_Token), 0, nullptr);
+
+        lex_Stream stream;
+        lex_createStream(&stream, &lexer, nullptr, &tokens);
+
+        REQUIRE(LEX_END == lex_feedStream(&stream, "ab 4", 4));
+        REQUIRE(LEX_END == lex_feedStream(&stream, "2", 1));
+
+        THEN("Tokens should be pushed to the vector once they are complete") {
+            REQUIRE(1 == tokens.size);
+            REQUIRE(LEX_END == lex_flushStream(&stream));
+            REQUIRE(2 == tokens.size);
+
+            auto token = (lex_Token*) vec_at(&tokens, 1);
+            REQUIRE(3 == token->offset);
+            REQUIRE(2 == token->length);
+        }
+
+        lex_freeStream(&stream);
+        vec_freeVector(&tokens, nullptr);
+    }
+
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+extern "C" {
+#include <literal_set.h>
+}
+
+static uint32_t add(lit_LiteralSet *set, const std::string &literal, uint32_t terminal) {
+    return lit_addLiteral(set, literal.data(), literal.size(), terminal);
+}
+
+SCENARIO("A literal set matches several literals together", "[literal_set]") {
+    lit_LiteralSet set;
+    REQUIRE(lit_createLiteralSet(&set));
+
+    GIVEN("Operators and keywords sharing prefixes") {
+        REQUIRE(0 == add(&set, "=", 0));
+        REQUIRE(1 == add(&set, "==", 1));
+        REQUIRE(2 == add(&set, "if", 2));
+        REQUIRE(3 == add(&set, "ifdef", 3));
+        REQUIRE(4 == add(&set, "he", 4));
+        REQUIRE(5 == add(&set, "she", 5));
+        REQUIRE(6 == add(&set, "hers", 6));
+
+        THEN("A literal that is added twice should keep its first terminal") {
+            REQUIRE(1 == add(&set, "==", 42));
+            REQUIRE(7 == set.literalCount);
+        }
+
+        REQUIRE(lit_build(&set));
+
+        THEN("Each literal should be found") {
+            REQUIRE(3 == lit_find(&set, "ifdef", 5));
+            REQUIRE(LIT_NONE == lit_find(&set, "ifd", 3));
+            REQUIRE(LIT_NONE == lit_find(&set, "x", 1));
+        }
+
+        AND_THEN("The longest literal at the start of an input should be matched") {
+            uint32_t terminal;
+
+            REQUIRE(2 == lit_longestMatch(&set, "== 3", 4, &terminal));
+            REQUIRE(1 == terminal);
+
+            REQUIRE(2 == lit_longestMatch(&set, "ifde", 4, &terminal));
+            REQUIRE(2 == terminal);
+
+            REQUIRE(0 == lit_longestMatch(&set, "x", 1, &terminal));
+            REQUIRE(LIT_NONE == terminal);
+        }
+    }
+
+    GIVEN("A node with many children") {
+        for (uint32_t c = 0;c < 20;++c) {
+            add(&set, std::string("k") + (char) ('a' + c), c);
+        }
+
+        add(&set, "k", 20);
+        REQUIRE(lit_build(&set));
+
+        THEN("The root and the hot node should be dense") {
+            REQUIRE(2 == set.denseCount);
+
+            uint32_t terminal;
+            REQUIRE(2 == lit_longestMatch(&set, "kt", 2, &terminal));
+            REQUIRE(19 == terminal);
+            REQUIRE(1 == lit_longestMatch(&set, "kz", 2, &terminal));
+            REQUIRE(20 == terminal);
+        }
+    }
+
+    GIVEN("Thousands of keywords") {
+        for (uint32_t i = 0;i < 5000;++i) {
+            add(&set, "kw" + std::to_string(i), i);
+        }
+
+        REQUIRE(lit_build(&set));
+
+        THEN("Each of them should be matched") {
+            for (uint32_t i = 0;i < 5000;i += 7) {
+                std::string input = "kw" + std::to_string(i) + " ";
+                uint32_t terminal;
+
+                REQUIRE(input.size() - 1 == lit_longestMatch(&set, input.data(), input.size(), &terminal));
+                REQUIRE(i == terminal);
+            }
+        }
+    }
+
+    lit_freeLiteralSet(&set);
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <ll1_parser.h>
+#include <parser.h>
+#include <token_buffer.h>
+}
+
+SCENARIO("An LL(1) grammar is parsed with its predict table", "[ll1_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                      "%ID=[a-z]+;\n"
+                                      "%stmt = `{` block | `let` ID `=` expr `;` | `print` expr `;`;\n"
+                                      "%block = `}` | stmt block;\n"
+                                      "%expr = NUM | ID | `(` expr `+` expr `)`;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    ll1_Parser parser;
+    REQUIRE(PRS_OK == ll1_createParser(&parser, &grammar));
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+    size_t errorIndex = 0;
+
+    THEN("Each cell should predict at most one production") {
+        REQUIRE(0 == parser.conflicts.size);
+        REQUIRE(0 == ll1_getPrediction(&parser, 0, lex_getLiteralTerminal(&lexer, "{")));
+        REQUIRE(4 == ll1_getPrediction(&parser, 1, lex_getLiteralTerminal(&lexer, "let")));
+        REQUIRE(LL1_NO_PRODUCTION == ll1_getPrediction(&parser, 2, lex_getLiteralTerminal(&lexer, "let")));
+    }
+
+    GIVEN("A valid input") {
+        std::string input = "{ let x = 1; print (x + 2); }";
+        REQUIRE(14 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The leftmost derivation should be given") {
+            REQUIRE(LL1_ACCEPTED == ll1_parse(&parser, &tokens, &derivation, &errorIndex));
+
+            uint32_t expected[] = { 0, 4, 1, 5, 4, 2, 7, 6, 5, 3 };
+            REQUIRE(sizeof(expected) / sizeof(*expected) == derivation.size);
+
+            for (size_t i = 0;i < derivation.size;++i) {
+                REQUIRE(expected[i] == *((uint32_t*) vec_at(&derivation, i)));
+            }
+        }
+
+        AND_WHEN("It is parsed again") {
+            REQUIRE(LL1_ACCEPTED == ll1_parse(&parser, &tokens, nullptr, nullptr));
+            size_t capacity = parser.stack.capacity;
+
+            THEN("The stack should not grow") {
+                REQUIRE(LL1_ACCEPTED == ll1_parse(&parser, &tokens, nullptr, nullptr));
+                REQUIRE(capacity == parser.stack.capacity);
+            }
+        }
+    }
+
+    GIVEN("Deeply nested expressions") {
+        std::string input = "print ";
+
+        for (int i = 0;i < 10000;++i) {
+            input += "(1 + ";
+        }
+
+        input += "2";
+
+        for (int i = 0;i < 10000;++i) {
+            input += ")";
+        }
+
+        input += ";";
+        REQUIRE(tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr) > 0);
+
+        THEN("They should be parsed without recursion") {
+            REQUIRE(LL1_ACCEPTED == ll1_parse(&parser, &tokens, &derivation, nullptr));
+            REQUIRE(20002 == derivation.size);
+        }
+    }
+
+    GIVEN("An unexpected token") {
+        std::string input = "{ let x = ; }";
+        REQUIRE(6 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("Its index should be given") {
+            REQUIRE(LL1_SYNTAX_ERROR == ll1_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(4 == errorIndex);
+        }
+    }
+
+    GIVEN("An input that ends too soon") {
+        std::string input = "{ let x = 1;";
+        REQUIRE(6 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The error should be after the last token") {
+            REQUIRE(LL1_SYNTAX_ERROR == ll1_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(6 == errorIndex);
+        }
+    }
+
+    vec_freeVector(&derivation, nullptr);
+    tb_freeTokenBuffer(&tokens);
+    ll1_freeParser(&parser);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Conflicts of a grammar are found when the table is built", "[ll1_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    GIVEN("Alternatives with a common prefix") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%e = NUM `+` e | NUM;\n"));
+
+        lex_Lexer lexer;
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        ga_Grammar grammar;
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        ll1_Parser parser;
+
+        THEN("The conflicting cell should be reported") {
+            REQUIRE(LL1_GRAMMAR_CONFLICT == ll1_createParser(&parser, &grammar));
+            REQUIRE(1 == parser.conflicts.size);
+
+            auto conflict = (const ll1_Conflict*) vec_at(&parser.conflicts, 0);
+            REQUIRE(0 == conflict->rule);
+            REQUIRE(0 == conflict->terminal);
+            REQUIRE(0 == conflict->productions[0]);
+            REQUIRE(1 == conflict->productions[1]);
+        }
+
+        ll1_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    fg_freeGrammar(&g);
+}
@@ -0,0 +1,171 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <lr_parser.h>
+#include <lr_table.h>
+#include <parser.h>
+#include <stats.h>
+#include <token_buffer.h>
+}
+
+SCENARIO("Tokens are parsed by shifts and reductions", "[lr_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                      "%e = e `+` t | t;\n"
+                                      "%t = t `*` f | f;\n"
+                                      "%f = `(` e `)` | NUM;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    lr_Table table;
+    REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+    lr_Parser parser;
+    lr_createParser(&parser, &table);
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    vec_Vector reductions;
+    vec_createVector(&reductions, sizeof(uint32_t), 0, nullptr);
+    size_t errorIndex = 0;
+
+    GIVEN("A valid input") {
+        std::string input = "1 + 2 * 3";
+        REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The rightmost derivation should be given in reverse order") {
+            REQUIRE(LR_ACCEPTED == lr_parse(&parser, &tokens, &reductions, &errorIndex));
+
+            uint32_t expected[] = { 5, 3, 1, 5, 3, 5, 2, 0 };
+            REQUIRE(sizeof(expected) / sizeof(*expected) == reductions.size);
+
+            for (size_t i = 0;i < reductions.size;++i) {
+                REQUIRE(expected[i] == *((uint32_t*) vec_at(&reductions, i)));
+            }
+        }
+
+        AND_WHEN("The parser has been warmed up") {
+            REQUIRE(LR_ACCEPTED == lr_parse(&parser, &tokens, nullptr, nullptr));
+
+            THEN("Parsing again should not allocate") {
+                st_Counters before = st_getCounters();
+                REQUIRE(LR_ACCEPTED == lr_parse(&parser, &tokens, nullptr, nullptr));
+                st_Counters after = st_getCounters();
+
+                REQUIRE(before.allocations == after.allocations);
+            }
+        }
+    }
+
+    GIVEN("Deeply nested expressions") {
+        std::string input;
+
+        for (int i = 0;i < 10000;++i) {
+            input += "(";
+        }
+
+        input += "1";
+
+        for (int i = 0;i < 10000;++i) {
+            input += ")";
+        }
+
+        REQUIRE(20001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("They should be parsed without recursion") {
+            REQUIRE(LR_ACCEPTED == lr_parse(&parser, &tokens, nullptr, nullptr));
+        }
+    }
+
+    GIVEN("An unexpected token") {
+        std::string input = "1 + * 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("Its index should be given") {
+            REQUIRE(LR_SYNTAX_ERROR == lr_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(2 == errorIndex);
+        }
+    }
+
+    GIVEN("An input that ends too soon") {
+        std::string input = "(1 + 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The error should be after the last token") {
+            REQUIRE(LR_SYNTAX_ERROR == lr_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(4 == errorIndex);
+        }
+    }
+
+    GIVEN("An empty input") {
+        REQUIRE(0 == tb_tokenize(&tokens, &lexer, "", 0, nullptr));
+
+        THEN("The end should not be expected") {
+            REQUIRE(LR_SYNTAX_ERROR == lr_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(0 == errorIndex);
+        }
+    }
+
+    vec_freeVector(&reductions, nullptr);
+    tb_freeTokenBuffer(&tokens);
+    lr_freeParser(&parser);
+    lr_freeTable(&table);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Conflicts of the example grammar are resolved", "[lr_parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%INT=[0-9];\n"
+                                      "%SUB = `-`;\n"
+                                      "%MUL = `*`;\n"
+                                      "%expr = op SUB op | op;\n"
+                                      "%op = op2 MUL op2 | op2;\n"
+                                      "%op2 = SUB INT | INT | SUB INT;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    lr_Table table;
+    REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+    lr_Parser parser;
+    lr_createParser(&parser, &table);
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+
+    GIVEN("A duplicated production") {
+        REQUIRE(table.conflicts.size > 0);
+
+        THEN("The input should be parsed with the first one") {
+            std::string input = "-1 * 2 - -3";
+            vec_Vector reductions;
+            vec_createVector(&reductions, sizeof(uint32_t), 0, nullptr);
+
+            REQUIRE(7 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(LR_ACCEPTED == lr_parse(&parser, &tokens, &reductions, nullptr));
+            REQUIRE(4 == *((uint32_t*) vec_at(&reductions, 0)));
+
+            vec_freeVector(&reductions, nullptr);
+        }
+    }
+
+    tb_freeTokenBuffer(&tokens);
+    lr_freeParser(&parser);
+    lr_freeTable(&table);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <lr_table.h>
+#include <parser.h>
+}
+
+SCENARIO("Actions are packed into an LALR(1) table", "[lr_table]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    lex_Lexer lexer;
+    ga_Grammar grammar;
+    lr_Table table;
+
+    GIVEN("A left recursive expression grammar") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%e = e `+` t | t;\n"
+                                          "%t = t `*` f | f;\n"
+                                          "%f = `(` e `)` | NUM;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+
+        THEN("Each item set should have one state") {
+            // The 12 states of the textbook and the one reached after $end
+            REQUIRE(13 == table.stateCount);
+            REQUIRE(0 == table.conflicts.size);
+        }
+
+        AND_THEN("Actions should be found in the packed rows") {
+            uint32_t columnCount = grammar.terminalCount + grammar.ruleCount;
+            REQUIRE(table.entryCount < table.stateCount * columnCount);
+
+            lr_Action action = lr_getAction(&table, 0, 0);
+            REQUIRE(LR_SHIFT_ACTION == lr_getActionType(action));
+
+            uint32_t afterNumber = lr_getActionValue(action);
+            action = lr_getAction(&table, afterNumber, grammar.endTerminal);
+            REQUIRE(LR_REDUCE_ACTION == lr_getActionType(action));
+            REQUIRE(5 == lr_getActionValue(action));
+
+            action = lr_getAction(&table, 0, ga_getRuleSymbol(&grammar, 0));
+            REQUIRE(LR_SHIFT_ACTION == lr_getActionType(action));
+            action = lr_getAction(&table, lr_getActionValue(action), grammar.endTerminal);
+            REQUIRE(LR_ACCEPT_ACTION == lr_getActionType(action));
+
+            REQUIRE(LR_ERROR_ACTION == lr_getActionType(lr_getAction(&table, 0, grammar.endTerminal)));
+        }
+
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A grammar that is LALR(1) but not SLR(1)") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%ID=[a-z]+;\n"
+                                          "%s = l `=` r | r;\n"
+                                          "%l = `*` r | ID;\n"
+                                          "%r = l;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+
+        THEN("Lookaheads should not have conflicts") {
+            REQUIRE(0 == table.conflicts.size);
+        }
+
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A grammar that is LR(1) but not LALR(1)") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%s = `a` x `c` | `a` y `d` | `b` y `c` | `b` x `d`;\n"
+                                          "%x = `e`;\n"
+                                          "%y = `e`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+
+        THEN("The first production should win the reductions") {
+            REQUIRE(2 == table.conflicts.size);
+
+            for (size_t i = 0;i < table.conflicts.size;++i) {
+                auto conflict = (const lr_Conflict*) vec_at(&table.conflicts, i);
+
+                REQUIRE(lr_makeAction(LR_REDUCE_ACTION, 4) == conflict->actions[0]);
+                REQUIRE(lr_makeAction(LR_REDUCE_ACTION, 5) == conflict->actions[1]);
+            }
+        }
+
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A dangling else") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%X=[x-x];\n"
+                                          "%s = `if` s `else` s | `if` s | X;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == lr_createTable(&table, &grammar));
+
+        THEN("The shift should win") {
+            REQUIRE(1 == table.conflicts.size);
+
+            auto conflict = (const lr_Conflict*) vec_at(&table.conflicts, 0);
+            REQUIRE(lex_getLiteralTerminal(&lexer, "else") == conflict->terminal);
+            REQUIRE(LR_SHIFT_ACTION == lr_getActionType(conflict->actions[0]));
+            REQUIRE(lr_makeAction(LR_REDUCE_ACTION, 1) == conflict->actions[1]);
+        }
+
+        lr_freeTable(&table);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    fg_freeGrammar(&g);
+}
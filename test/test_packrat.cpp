@@ -0,0 +1,261 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <grammar_analysis.h>
+#include <lexer.h>
+#include <packrat.h>
+#include <parser.h>
+#include <stats.h>
+#include <token_buffer.h>
+}
+
+SCENARIO("Left recursive rules grow their seeds", "[packrat]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                      "%e = e `+` t | t;\n"
+                                      "%t = t `*` f | f;\n"
+                                      "%f = `(` e `)` | NUM;\n"));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+    ga_Grammar grammar;
+    REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+    pk_Parser parser;
+    REQUIRE(PRS_OK == pk_createParser(&parser, &grammar));
+
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+    size_t errorIndex = 0;
+
+    GIVEN("Directly left recursive rules") {
+        THEN("They should be the leaders of their cycles") {
+            REQUIRE(parser.leaders[0]);
+            REQUIRE(parser.leaders[1]);
+            REQUIRE_FALSE(parser.leaders[2]);
+        }
+    }
+
+    GIVEN("A valid input") {
+        std::string input = "1 + 2 * 3";
+        REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The parse tree should be given in preorder") {
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, &derivation, &errorIndex));
+
+            uint32_t expected[] = { 0, 1, 3, 5, 2, 3, 5, 5 };
+            requireDerivation(&derivation, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_WHEN("The parser has been warmed up") {
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, nullptr, nullptr));
+
+            THEN("Parsing again should not allocate") {
+                st_Counters before = st_getCounters();
+                REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, nullptr, nullptr));
+                st_Counters after = st_getCounters();
+
+                REQUIRE(before.allocations == after.allocations);
+            }
+        }
+    }
+
+    GIVEN("A long left associative sequence") {
+        std::string input = "1";
+
+        for (int i = 0;i < 10000;++i) {
+            input += " + 1";
+        }
+
+        REQUIRE(20001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("It should be parsed") {
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, &derivation, nullptr));
+            REQUIRE(0 == *((uint32_t*) vec_at(&derivation, 0)));
+        }
+    }
+
+    GIVEN("Deeply nested expressions") {
+        std::string input;
+
+        for (int i = 0;i < 10000;++i) {
+            input += "(";
+        }
+
+        input += "1";
+
+        for (int i = 0;i < 10000;++i) {
+            input += ")";
+        }
+
+        REQUIRE(20001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("They should be parsed without recursion") {
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, nullptr, nullptr));
+        }
+    }
+
+    GIVEN("An unexpected token") {
+        std::string input = "1 + * 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The farthest failure should be given") {
+            REQUIRE(PK_SYNTAX_ERROR == pk_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(2 == errorIndex);
+        }
+    }
+
+    GIVEN("An input that ends too soon") {
+        std::string input = "(1 + 2";
+        REQUIRE(4 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+
+        THEN("The error should be after the last token") {
+            REQUIRE(PK_SYNTAX_ERROR == pk_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(4 == errorIndex);
+        }
+    }
+
+    vec_freeVector(&derivation, nullptr);
+    tb_freeTokenBuffer(&tokens);
+    pk_freeParser(&parser);
+    ga_freeGrammar(&grammar);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
+
+SCENARIO("Productions are an ordered choice", "[packrat]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    lex_Lexer lexer;
+    ga_Grammar grammar;
+    pk_Parser parser;
+    tb_TokenBuffer tokens;
+    tb_createTokenBuffer(&tokens);
+    vec_Vector derivation;
+    vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+    size_t errorIndex = 0;
+
+    GIVEN("Indirectly left recursive rules") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%a = b `x` | `y`;\n"
+                                          "%b = a `z` | `w`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == pk_createParser(&parser, &grammar));
+
+        THEN("One of them should grow the seed of the cycle") {
+            REQUIRE(parser.leaders[0]);
+            REQUIRE_FALSE(parser.leaders[1]);
+
+            std::string input = "y z x z x";
+            REQUIRE(5 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, &derivation, nullptr));
+
+            uint32_t expected[] = { 0, 2, 0, 2, 1 };
+            requireDerivation(&derivation, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_THEN("A cycle should not stop in the other one") {
+            std::string input = "w x z";
+            REQUIRE(3 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_SYNTAX_ERROR == pk_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(3 == errorIndex);
+        }
+
+        pk_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("Two leaders in the same cycle") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%a = a `a` | b `b` | `x`;\n"
+                                          "%b = b `c` | a `d` | `y`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == pk_createParser(&parser, &grammar));
+
+        THEN("Each one should grow again from the seed of the other") {
+            REQUIRE(parser.leaders[0]);
+            REQUIRE(parser.leaders[1]);
+
+            std::string input = "x d b";
+            REQUIRE(3 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, &derivation, nullptr));
+
+            uint32_t expected[] = { 1, 4, 2 };
+            requireDerivation(&derivation, expected, sizeof(expected) / sizeof(*expected));
+        }
+
+        AND_THEN("Longer inputs should alternate between them") {
+            std::string input = "y c b a d b";
+            REQUIRE(6 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, nullptr, nullptr));
+        }
+
+        pk_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("A production that is a prefix of the next one") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%s = `a` | `a` `b`;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == pk_createParser(&parser, &grammar));
+
+        THEN("The first match should win") {
+            std::string input = "a b";
+            REQUIRE(2 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_SYNTAX_ERROR == pk_parse(&parser, &tokens, nullptr, &errorIndex));
+            REQUIRE(1 == errorIndex);
+        }
+
+        pk_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    GIVEN("Alternatives that backtrack over the same rule") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%NUM=[0-9]+;\n"
+                                          "%s = a `;` | a;\n"
+                                          "%a = `(` a `)` `!` | `(` a `)` | NUM;\n"));
+        REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+        REQUIRE(PRS_OK == ga_createGrammar(&grammar, &g, &lexer));
+        REQUIRE(PRS_OK == pk_createParser(&parser, &grammar));
+
+        THEN("Each rule should be evaluated once per position") {
+            // Without the memo table, each level would parse its nested levels twice
+            std::string input;
+
+            for (int i = 0;i < 5000;++i) {
+                input += "(";
+            }
+
+            input += "1";
+
+            for (int i = 0;i < 5000;++i) {
+                input += ")";
+            }
+
+            REQUIRE(10001 == tb_tokenize(&tokens, &lexer, input.data(), input.size(), nullptr));
+            REQUIRE(PK_ACCEPTED == pk_parse(&parser, &tokens, &derivation, nullptr));
+            REQUIRE(5002 == derivation.size);
+            REQUIRE(1 == *((uint32_t*) vec_at(&derivation, 0)));
+        }
+
+        pk_freeParser(&parser);
+        ga_freeGrammar(&grammar);
+        lex_freeLexer(&lexer);
+    }
+
+    vec_freeVector(&derivation, nullptr);
+    tb_freeTokenBuffer(&tokens);
+    fg_freeGrammar(&g);
+}
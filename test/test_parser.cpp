@@ -8,7 +8,9 @@
 #include <sstream>
 
 extern "C" {
+#include <collections/arena.h>
 #include <collections/linked_list.h>
+#include <collections/vector.h>
 #include <formal_grammar.h>
 #include <parser.h>
 }
@@ -20,31 +22,63 @@ static int stringItemCmp(const prs_StringItem *d1, const prs_StringItem *d2) {
 }
 
 SCENARIO("Items can be extracted from a raw grammar", "[parser]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    ar_Arena arena;
+    ar_createArena(&arena, 256);
+
+    vec_Vector itemList;
+    vec_createVector(&itemList, sizeof(prs_StringItem), 0, nullptr);
 
     GIVEN("A string containing a rule with several production rules") {
         std::string input = "%op=      NUMBER \n"
                             "\t| SUB NUMBER \n"
                             "\t| `hello world`;";
 
-        int extractedItems = prs_extractGrammarItems(input.c_str(), input.size(), &itemList);
+        int extractedItems = prs_extractGrammarItems(input.c_str(), input.size(), &itemList, &arena);
 
         THEN("9 items should have been extracted") {
             REQUIRE(9 == extractedItems);
 
-            ll_LinkedList expected;
-            ll_createLinkedList(&expected, (ll_DataDestructor*) prs_freeStringItem);
+            vec_Vector expected;
+            createItemList(&expected);
 
             fillItemList(&expected, { "%op", "=", "NUMBER", "|", "SUB", "NUMBER", "|", "`hello world`", ";" });
 
-            REQUIRE(ll_isEqual(&itemList, &expected, (ll_DataComparator*) stringItemCmp));
+            REQUIRE(vec_isEqual(&itemList, &expected, (vec_DataComparator*) stringItemCmp));
+
+            vec_freeVector(&expected, nullptr);
+        }
+
+        AND_THEN("Each item should have its position in the source") {
+            vec_Cursor it = vec_createCursor(&itemList);
+
+            auto item = (prs_StringItem*) vec_cursorNext(&it);
+            REQUIRE(1 == item->line);
+            REQUIRE(1 == item->column);
+
+            item = (prs_StringItem*) vec_cursorNext(&it);
+            REQUIRE(1 == item->line);
+            REQUIRE(4 == item->column);
+
+            for (int i = 0;i < 5;++i) {
+                item = (prs_StringItem*) vec_cursorNext(&it);
+            }
+
+            // Second pipe
+            REQUIRE(3 == item->line);
+            REQUIRE(2 == item->column);
+        }
+    }
+
+    GIVEN("A string block without the end marker") {
+        std::string input = "%TOKEN = `abc;";
 
-            ll_freeLinkedList(&expected, nullptr);
+        THEN("It should return an error") {
+            REQUIRE(-1 == prs_extractGrammarItems(input.c_str(), input.size(), &itemList, &arena));
         }
     }
 
-    ll_freeLinkedList(&itemList, nullptr);
+    vec_freeVector(&itemList, nullptr);
+    ar_freeArena(&arena);
 }
 
 SCENARIO("Read a grammar file into a dynamic buffer", "[parser]") {
@@ -84,8 +118,8 @@ SCENARIO("Read a grammar file into a dynamic buffer", "[parser]") {
 }
 
 SCENARIO("Extract tokens and rules from a list of items", "[parser]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
 
     fg_Grammar g;
     fg_createGrammar(&g);
@@ -110,14 +144,27 @@ SCENARIO("Extract tokens and rules from a list of items", "[parser]") {
         }
 
         AND_THEN("The entry rule should be rule1") {
-            auto rule1 = (fg_Rule*) ht_getValue(&g.rules, "rule1");
+            auto rule1 = fg_getRule(&g, "rule1");
 
             REQUIRE(rule1);
             REQUIRE(g.entry == rule1);
         }
 
+        AND_THEN("Tokens and rules should be indexed by their symbol ID") {
+            auto token1 = fg_getToken(&g, "TOKEN1");
+            auto rule1 = fg_getRule(&g, "rule1");
+
+            REQUIRE(token1 == fg_getTokenById(&g, token1->id));
+            REQUIRE(rule1 == fg_getRuleById(&g, rule1->id));
+            REQUIRE_FALSE(fg_getRuleById(&g, token1->id));
+
+            REQUIRE(0 == token1->index);
+            REQUIRE(token1 == *((fg_Token**) vec_at(&g.tokens, 0)));
+            REQUIRE(0 == rule1->index);
+        }
+
         AND_WHEN("Parsing an existing rule") {
-            ll_freeLinkedList(&itemList, nullptr);
+            vec_freeVector(&itemList, nullptr);
             fillItemList(&itemList, { "%rule1", "=", "rule1", ";" });
 
             res = prs_parseGrammarItems(&g, &itemList);
@@ -128,7 +175,7 @@ SCENARIO("Extract tokens and rules from a list of items", "[parser]") {
         }
 
         AND_WHEN("Parsing an existing token") {
-            ll_freeLinkedList(&itemList, nullptr);
+            vec_freeVector(&itemList, nullptr);
             fillItemList(&itemList, { "%TOKEN1", "=", "`already exists`", ";" });
 
             res = prs_parseGrammarItems(&g, &itemList);
@@ -160,12 +207,12 @@ SCENARIO("Extract tokens and rules from a list of items", "[parser]") {
     }
 
     fg_freeGrammar(&g);
-    ll_freeLinkedList(&itemList, nullptr);
+    vec_freeVector(&itemList, nullptr);
 }
 
 SCENARIO("symbols resolution is used to allow recursive rules", "[parser]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
 
     fg_Grammar g;
     fg_createGrammar(&g);
@@ -230,7 +277,7 @@ SCENARIO("symbols resolution is used to allow recursive rules", "[parser]") {
             }
 
             AND_THEN("Resolution on rule1's production rule should have be done") {
-                auto rule1 = (fg_Rule*) ht_getValue(&g.rules, "rule1");
+                auto rule1 = fg_getRule(&g, "rule1");
 
                 ll_Iterator it = ll_createIterator((ll_LinkedList*) rule1->productionRuleList.front->data);
 
@@ -239,7 +286,7 @@ SCENARIO("symbols resolution is used to allow recursive rules", "[parser]") {
                 REQUIRE(rule1 == prItem1->value.rule);
 
                 auto prItem2 = (fg_PRItem*) ll_iteratorNext(&it);
-                auto token1 = (fg_Token*) ht_getValue(&g.tokens, "TOKEN1");
+                auto token1 = fg_getToken(&g, "TOKEN1");
                 REQUIRE(token1 == prItem2->value.token);
             }
         }
@@ -259,8 +306,8 @@ SCENARIO("symbols resolution is used to allow recursive rules", "[parser]") {
             }
 
             AND_THEN("TOKEN1 should have a reference on TOKEN2") {
-                auto token1 = (fg_Token*) ht_getValue(&g.tokens, "TOKEN1");
-                auto token2 = (fg_Token*) ht_getValue(&g.tokens, "TOKEN2");
+                auto token1 = fg_getToken(&g, "TOKEN1");
+                auto token2 = fg_getToken(&g, "TOKEN2");
 
                 REQUIRE(token1);
                 REQUIRE(token2);
@@ -271,16 +318,105 @@ SCENARIO("symbols resolution is used to allow recursive rules", "[parser]") {
     }
 
     fg_freeGrammar(&g);
-    ll_freeLinkedList(&itemList, nullptr);
+    vec_freeVector(&itemList, nullptr);
+}
+
+SCENARIO("A grammar can be parsed from a stream, one declaration at a time", "[parser]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    GIVEN("A stream with rules and tokens") {
+        std::string input = "%rule1 = rule2 NUMBER\n"
+                            "\t| `a;b`;\n"
+                            "%NUMBER = [0-9]+;%rule2 = `x`;\n";
+
+        FILE *stream = fmemopen((void*) input.data(), input.size(), "r");
+        REQUIRE(stream);
+
+        int res = prs_parseGrammarStream(&g, stream);
+        fclose(stream);
+
+        THEN("All declarations should have been parsed") {
+            REQUIRE(PRS_OK == res);
+            REQUIRE(1 == g.tokens.size);
+            REQUIRE(2 == g.rules.size);
+        }
+
+        AND_THEN("Semicolons in string blocks should not end a declaration") {
+            auto rule1 = fg_getRule(&g, "rule1");
+            REQUIRE(2 == rule1->productionRuleList.size);
+
+            auto pr = (ll_LinkedList*) rule1->productionRuleList.back->data;
+            auto prItem = (fg_PRItem*) pr->front->data;
+            REQUIRE_THAT(prItem->value.string, Equals("a;b"));
+        }
+
+        AND_THEN("The first rule should be the entry rule") {
+            REQUIRE(g.entry == fg_getRule(&g, "rule1"));
+        }
+
+        AND_THEN("Symbols should be resolved after the whole stream has been read") {
+            REQUIRE(PRS_OK == prs_resolveSymbols(&g));
+        }
+    }
+
+    GIVEN("A stream with an invalid declaration after the first line") {
+        std::string input = "%A = `a`;\n"
+                            "%B = `b`; %rule = #;\n";
+
+        FILE *stream = fmemopen((void*) input.data(), input.size(), "r");
+        REQUIRE(stream);
+
+        int res = prs_parseGrammarStream(&g, stream);
+        fclose(stream);
+
+        THEN("The error should have the position of the item in the stream") {
+            REQUIRE(FG_PRITEM_UNKNOWN_TYPE == res);
+
+            char errMsg[255];
+            prs_getErrorMessage(errMsg, 255, (prs_ErrCode) res);
+            REQUIRE_THAT(errMsg, Catch::Matchers::EndsWith("# (2:19)"));
+        }
+    }
+
+    GIVEN("A stream whose last declaration has no end marker") {
+        std::string input = "%A = `a`;\n%B = `b`";
+
+        FILE *stream = fmemopen((void*) input.data(), input.size(), "r");
+        REQUIRE(stream);
+
+        int res = prs_parseGrammarStream(&g, stream);
+        fclose(stream);
+
+        THEN("It should return an error") {
+            REQUIRE(FG_TOKEN_MISSING_END == res);
+        }
+    }
+
+    GIVEN("A stream with an unterminated string block") {
+        std::string input = "%A = `a;\n";
+
+        FILE *stream = fmemopen((void*) input.data(), input.size(), "r");
+        REQUIRE(stream);
+
+        int res = prs_parseGrammarStream(&g, stream);
+        fclose(stream);
+
+        THEN("It should return an error") {
+            REQUIRE(FG_STRING_BLOCK_MISSING_END == res);
+        }
+    }
+
+    fg_freeGrammar(&g);
 }
 
 SCENARIO("string items have a position (line, column) in a source string", "[parser]") {
-    ll_LinkedList itemList;
-    ll_createLinkedList(&itemList, (ll_DataDestructor*) prs_freeStringItem);
+    vec_Vector itemList;
+    createItemList(&itemList);
 
     fillItemList(&itemList, { "TOKEN1", "`hello`", ";" });
 
-    ll_Iterator it = ll_createIterator(&itemList);
+    vec_Cursor it = vec_createCursor(&itemList);
 
     GIVEN("A random source string without any token or rule") {
         const char *source = "hello world";
@@ -299,21 +435,21 @@ SCENARIO("string items have a position (line, column) in a source string", "[par
         }
 
         AND_THEN("Each string item's position should have been update") {
-            it = ll_createIterator(&itemList);
+            it = vec_createCursor(&itemList);
 
-            auto item = (prs_StringItem*) ll_iteratorNext(&it);
+            auto item = (prs_StringItem*) vec_cursorNext(&it);
             REQUIRE(1 == item->line);
             REQUIRE(2 == item->column);
 
-            item = (prs_StringItem*) ll_iteratorNext(&it);
+            item = (prs_StringItem*) vec_cursorNext(&it);
             REQUIRE(3 == item->line);
             REQUIRE(1 == item->column);
 
-            item = (prs_StringItem*) ll_iteratorNext(&it);
+            item = (prs_StringItem*) vec_cursorNext(&it);
             REQUIRE(3 == item->line);
             REQUIRE(8 == item->column);
         }
     }
 
-    ll_freeLinkedList(&itemList, nullptr);
+    vec_freeVector(&itemList, nullptr);
 }
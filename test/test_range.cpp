@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include <cctype>
 #include <cstring>
 
 extern "C" {
@@ -124,12 +125,15 @@ SCENARIO("A range is made by two characters (alpha or digit) and a dash", "[rang
 }
 
 SCENARIO("A range block ([...]) can contain several ranges", "[range]") {
+    ar_Arena arena;
+    ar_createArena(&arena, 256);
+
     prs_RangeArray rangeArray;
     memset(&rangeArray, 0, sizeof(rangeArray));
 
     GIVEN("An empty string") {
         std::string input;
-        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size());
+        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena);
 
         THEN("It should return ok") {
             REQUIRE(PRS_OK == res);
@@ -143,7 +147,7 @@ SCENARIO("A range block ([...]) can contain several ranges", "[range]") {
 
     GIVEN("A string with 3 ranges") {
         std::string input = "a-zA-Z0-9";
-        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size());
+        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena);
 
         THEN("It should return ok") {
             REQUIRE(PRS_OK == res);
@@ -157,7 +161,7 @@ SCENARIO("A range block ([...]) can contain several ranges", "[range]") {
 
     GIVEN("A string with 2 valid patterns and one invalid") {
         std::string input = "a-z@-d1-3";
-        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size());
+        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena);
 
         THEN("It should return an error") {
             REQUIRE(PRS_INVALID_RANGE_PATTERN == res);
@@ -171,7 +175,7 @@ SCENARIO("A range block ([...]) can contain several ranges", "[range]") {
 
     GIVEN("A string with one pattern and an additional char") {
         std::string input = "a-zb";
-        int res = prs_extractRanges(&rangeArray, input.c_str(), input.size());
+        int res = prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena);
 
         THEN("It should return an error") {
             REQUIRE(PRS_INVALID_RANGE_PATTERN == res);
@@ -183,5 +187,94 @@ SCENARIO("A range block ([...]) can contain several ranges", "[range]") {
         }
     }
 
-    prs_freeRangeArray(&rangeArray);
+    GIVEN("A string with 2 ranges separated by spaces") {
+        std::string input = "a-z A-Z";
+        prs_ErrCode res = prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena);
+
+        THEN("It should return ok") {
+            REQUIRE(PRS_OK == res);
+        }
+
+        AND_THEN("The second range should be an uppercase letter range") {
+            REQUIRE(2 == rangeArray.size);
+            REQUIRE(rangeArray.ranges[1].uppercaseLetter);
+        }
+    }
+
+    ar_freeArena(&arena);
+}
+
+SCENARIO("A range block is compiled into a 256-bit bitmap", "[range]") {
+    ar_Arena arena;
+    ar_createArena(&arena, 256);
+
+    prs_RangeArray rangeArray;
+    memset(&rangeArray, 0, sizeof(rangeArray));
+
+    GIVEN("A range block with lowercase, uppercase and digit ranges") {
+        std::string input = "a-cX-Z0-1";
+        REQUIRE(PRS_OK == prs_extractRanges(&rangeArray, input.c_str(), input.size(), &arena));
+
+        THEN("Each matched byte should be in the bitmap") {
+            REQUIRE(8 == prs_charClassCount(&rangeArray.charClass));
+
+            for (char c : std::string("abcXYZ01")) {
+                REQUIRE(prs_matchInRangeArray(&rangeArray, c));
+            }
+        }
+
+        AND_THEN("The case of letters should be kept") {
+            REQUIRE_FALSE(prs_matchInRangeArray(&rangeArray, 'A'));
+            REQUIRE_FALSE(prs_matchInRangeArray(&rangeArray, 'x'));
+            REQUIRE_FALSE(prs_matchInRange(rangeArray.ranges + 1, 'y', true));
+            REQUIRE(prs_matchInRange(rangeArray.ranges + 1, 'Y', true));
+        }
+
+        AND_THEN("The bitmap should agree with the ranges for every byte") {
+            for (int c = 0;c < 256;++c) {
+                bool matched = false;
+
+                for (size_t i = 0;i < rangeArray.size;++i) {
+                    matched |= prs_matchInRange(rangeArray.ranges + i, (char) c, isalpha(c) != 0);
+                }
+
+                REQUIRE(matched == prs_matchInRangeArray(&rangeArray, (char) c));
+            }
+        }
+    }
+
+    GIVEN("Two character classes") {
+        prs_CharClass c1, c2, result;
+        prs_clearCharClass(&c1);
+        prs_clearCharClass(&c2);
+        prs_addCharInterval(&c1, 0, 100);
+        prs_addCharInterval(&c2, 60, 255);
+
+        THEN("Their union should contain all bytes") {
+            prs_charClassUnion(&result, &c1, &c2);
+            REQUIRE(256 == prs_charClassCount(&result));
+        }
+
+        AND_THEN("Their intersection should cross the word boundary") {
+            prs_charClassIntersection(&result, &c1, &c2);
+            REQUIRE(41 == prs_charClassCount(&result));
+            REQUIRE(60 == prs_charClassFirst(&result));
+            REQUIRE(prs_charClassContains(&result, 64));
+        }
+
+        AND_THEN("The complement of one should be the difference of the other") {
+            prs_CharClass difference;
+            prs_charClassComplement(&result, &c1);
+            prs_charClassDifference(&difference, &c2, &c1);
+            REQUIRE(prs_charClassEquals(&result, &difference));
+        }
+
+        AND_THEN("A class without bytes should be empty") {
+            prs_clearCharClass(&result);
+            REQUIRE(prs_charClassIsEmpty(&result));
+            REQUIRE(-1 == prs_charClassFirst(&result));
+        }
+    }
+
+    ar_freeArena(&arena);
 }
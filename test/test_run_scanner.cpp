@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+
+extern "C" {
+#include <run_scanner.h>
+}
+
+static const rs_Kernel kernels[] = { RS_SCALAR_KERNEL, RS_SSE2_KERNEL, RS_AVX2_KERNEL };
+
+SCENARIO("A run scanner finds the end of a run of bytes in a class", "[run_scanner]") {
+    prs_CharClass charClass;
+    prs_clearCharClass(&charClass);
+
+    rs_RunScanner scanner;
+
+    GIVEN("The class of letters and digits") {
+        prs_addCharInterval(&charClass, 'a', 'z');
+        prs_addCharInterval(&charClass, 'A', 'Z');
+        prs_addCharInterval(&charClass, '0', '9');
+        rs_createRunScanner(&scanner, &charClass);
+
+        THEN("The class should be split into 3 intervals") {
+            REQUIRE(3 == scanner.intervalCount);
+        }
+
+        AND_THEN("Every kernel should stop at the first byte out of the class") {
+            // Runs end before, inside and after the vector widths
+            for (size_t runLength : { 0, 1, 15, 16, 17, 31, 32, 33, 70 }) {
+                std::string input(runLength, 'x');
+                input += " and more text after the run, long enough for a vector";
+
+                for (rs_Kernel kernel : kernels) {
+                    REQUIRE(runLength == rs_scanRunWith(&scanner, kernel, input.data(), input.size()));
+                }
+            }
+        }
+
+        AND_THEN("A run that ends the input should be scanned entirely") {
+            std::string input(45, '7');
+
+            for (rs_Kernel kernel : kernels) {
+                REQUIRE(45 == rs_scanRunWith(&scanner, kernel, input.data(), input.size()));
+            }
+        }
+    }
+
+    GIVEN("A class with bytes above 127") {
+        prs_addCharInterval(&charClass, 0xC0, 0xFF);
+        rs_createRunScanner(&scanner, &charClass);
+
+        THEN("Bytes should be compared without sign") {
+            std::string input(20, (char) 0xE9);
+            input += std::string(20, (char) 0x7F);
+
+            for (rs_Kernel kernel : kernels) {
+                REQUIRE(20 == rs_scanRunWith(&scanner, kernel, input.data(), input.size()));
+            }
+        }
+    }
+
+    GIVEN("A class with more intervals than the SIMD kernels accept") {
+        for (int c = 'a';c <= 'z';c += 2) {
+            prs_addCharInterval(&charClass, (uint8_t) c, (uint8_t) c);
+        }
+
+        rs_createRunScanner(&scanner, &charClass);
+
+        THEN("The scalar kernel should be used") {
+            REQUIRE(RS_SCALAR_KERNEL == scanner.kernel);
+
+            std::string input = "acegikmb";
+            REQUIRE(7 == rs_scanRunWith(&scanner, RS_AVX2_KERNEL, input.data(), input.size()));
+        }
+    }
+
+    GIVEN("Random classes and inputs") {
+        std::mt19937 random(42);
+
+        THEN("SIMD kernels should agree with the scalar one") {
+            for (int round = 0;round < 200;++round) {
+                prs_clearCharClass(&charClass);
+                int intervals = 1 + (int) (random() % RS_MAX_INTERVALS);
+
+                for (int k = 0;k < intervals;++k) {
+                    auto low = (uint8_t) (random() % 256);
+                    auto high = (uint8_t) (low + random() % (256 - low));
+                    prs_addCharInterval(&charClass, low, high);
+                }
+
+                rs_createRunScanner(&scanner, &charClass);
+
+                std::string input;
+
+                for (int i = 0;i < 100;++i) {
+                    // Mostly bytes of the class so that runs are long enough
+                    auto c = (uint8_t) (random() % 256);
+
+                    while (random() % 8 != 0 && !prs_charClassContains(&charClass, c)) {
+                        c = (uint8_t) (random() % 256);
+                    }
+
+                    input += (char) c;
+                }
+
+                size_t expected = rs_scanRunWith(&scanner, RS_SCALAR_KERNEL, input.data(), input.size());
+
+                for (rs_Kernel kernel : kernels) {
+                    REQUIRE(expected == rs_scanRunWith(&scanner, kernel, input.data(), input.size()));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <scanner.h>
+}
+
+static std::vector<std::string> scanAll(const std::string &input, std::vector<prs_ItemKind> *kinds = nullptr) {
+    prs_Scanner scanner;
+    prs_initScanner(&scanner, input.data(), input.size(), nullptr);
+
+    std::vector<std::string> items;
+    prs_ItemSpan span;
+
+    while (prs_nextItem(&scanner, &span)) {
+        items.emplace_back(input.substr(span.offset, span.length));
+
+        if (kinds) {
+            kinds->push_back(span.kind);
+        }
+    }
+
+    return items;
+}
+
+SCENARIO("A scanner splits a raw grammar into spans", "[scanner]") {
+    GIVEN("A source with only whitespaces") {
+        THEN("No item should be read") {
+            REQUIRE(scanAll(" \n\t  ").empty());
+        }
+    }
+
+    GIVEN("A token declaration without any space") {
+        std::vector<prs_ItemKind> kinds;
+        auto items = scanAll("%NUMBER=INT+;", &kinds);
+
+        THEN("Delimiters should be separated from words") {
+            REQUIRE(items == std::vector<std::string>{ "%NUMBER", "=", "INT", "+", ";" });
+        }
+
+        AND_THEN("Each span should have the right kind") {
+            REQUIRE(kinds == std::vector<prs_ItemKind>{ PRS_WORD_ITEM, PRS_DELIMITER_ITEM, PRS_WORD_ITEM,
+                                                        PRS_DELIMITER_ITEM, PRS_DELIMITER_ITEM });
+        }
+    }
+
+    GIVEN("A rule with string blocks containing spaces and delimiters") {
+        std::vector<prs_ItemKind> kinds;
+        auto items = scanAll("%s = f\n    | `(`s`+ =;`;", &kinds);
+
+        THEN("String blocks should be kept untouched") {
+            REQUIRE(items == std::vector<std::string>{ "%s", "=", "f", "|", "`(`", "s", "`+ =;`", ";" });
+            REQUIRE(PRS_STRING_BLOCK_ITEM == kinds[4]);
+            REQUIRE(PRS_STRING_BLOCK_ITEM == kinds[6]);
+        }
+    }
+
+    GIVEN("A string block without the end marker") {
+        auto items = scanAll("%A = `abc ;");
+
+        THEN("The last span should cover the rest of the source") {
+            REQUIRE(items.back() == "`abc ;");
+        }
+    }
+
+    GIVEN("A source that is not null terminated") {
+        std::string input = "%rule = a;%TOKEN";
+
+        prs_Scanner scanner;
+        prs_initScanner(&scanner, input.data(), 10, nullptr);
+
+        prs_ItemSpan span;
+        size_t count = 0;
+
+        while (prs_nextItem(&scanner, &span)) {
+            REQUIRE(span.offset + span.length <= 10);
+            ++count;
+        }
+
+        THEN("Only the given length should be read") {
+            REQUIRE(4 == count);
+        }
+    }
+}
+
+SCENARIO("A scanner records the position of each item", "[scanner]") {
+    GIVEN("A rule declared on several lines") {
+        std::string input = "%s = f\n    | `(\n`  s;\n%f = `1`;";
+
+        prs_LineTable lines;
+        REQUIRE(prs_createLineTable(&lines));
+
+        prs_Scanner scanner;
+        prs_initScanner(&scanner, input.data(), input.size(), &lines);
+
+        std::vector<prs_ItemSpan> spans;
+        prs_ItemSpan span;
+
+        while (prs_nextItem(&scanner, &span)) {
+            spans.push_back(span);
+        }
+
+        THEN("Each span should have its line and column") {
+            REQUIRE(11 == spans.size());
+
+            REQUIRE(1 == spans[0].line);
+            REQUIRE(1 == spans[0].column);
+
+            // Pipe
+            REQUIRE(2 == spans[3].line);
+            REQUIRE(5 == spans[3].column);
+
+            // String block that contains a new line
+            REQUIRE(2 == spans[4].line);
+            REQUIRE(7 == spans[4].column);
+
+            // Item right after the string block
+            REQUIRE(3 == spans[5].line);
+            REQUIRE(4 == spans[5].column);
+
+            REQUIRE(4 == spans[7].line);
+            REQUIRE(1 == spans[7].column);
+        }
+
+        AND_THEN("The line table should give the same positions") {
+            REQUIRE(4 == lines.size);
+
+            for (const prs_ItemSpan &s : spans) {
+                int line, column;
+                prs_getLinePosition(&lines, s.offset, &line, &column);
+
+                REQUIRE(s.line == line);
+                REQUIRE(s.column == column);
+            }
+        }
+
+        prs_freeLineTable(&lines);
+    }
+
+    GIVEN("A line table built from a source") {
+        std::string input = "a\n\nbc\nd";
+
+        prs_LineTable lines;
+        REQUIRE(prs_createLineTable(&lines));
+        REQUIRE(prs_buildLineTable(&lines, input.data(), input.size()));
+
+        THEN("It should contain the start of each line") {
+            REQUIRE(4 == lines.size);
+
+            int line, column;
+            prs_getLinePosition(&lines, 4, &line, &column);
+            REQUIRE(3 == line);
+            REQUIRE(2 == column);
+
+            prs_getLinePosition(&lines, 2, &line, &column);
+            REQUIRE(2 == line);
+            REQUIRE(1 == column);
+        }
+
+        prs_freeLineTable(&lines);
+    }
+}
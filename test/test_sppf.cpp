@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+
+extern "C" {
+#include <collections/vector.h>
+#include <sppf.h>
+}
+
+SCENARIO("Derivations share the nodes of a forest", "[sppf]") {
+    sppf_Forest forest;
+    REQUIRE(sppf_createForest(&forest));
+
+    GIVEN("A label and an extent") {
+        bool created = false;
+        sppf_Node *node = sppf_addNode(&forest, 10, 0, 1, &created);
+        REQUIRE(node);
+        REQUIRE(created);
+
+        THEN("The same node should be given again") {
+            REQUIRE(node == sppf_addNode(&forest, 10, 0, 1, &created));
+            REQUIRE_FALSE(created);
+            REQUIRE(node != sppf_addNode(&forest, 10, 0, 2, nullptr));
+            REQUIRE(2 == forest.nodeCount);
+        }
+
+        AND_THEN("A unique node should not be found") {
+            sppf_Node *unique = sppf_addUniqueNode(&forest, 10, 0, 2);
+            REQUIRE(unique);
+            REQUIRE(2 == unique->end);
+            REQUIRE(unique != sppf_addNode(&forest, 10, 0, 2, &created));
+            REQUIRE(created);
+            REQUIRE(3 == forest.nodeCount);
+        }
+
+        AND_WHEN("The forest is cleared") {
+            sppf_clearForest(&forest);
+
+            THEN("The node should be added again") {
+                REQUIRE(0 == forest.nodeCount);
+                REQUIRE(sppf_addNode(&forest, 10, 0, 1, &created));
+                REQUIRE(created);
+            }
+        }
+    }
+
+    GIVEN("Several derivations of a node") {
+        sppf_Node *a = sppf_addNode(&forest, 0, 0, 1, nullptr);
+        sppf_Node *b = sppf_addNode(&forest, 1, 0, 1, nullptr);
+        sppf_Node *rule = sppf_addNode(&forest, 10, 0, 1, nullptr);
+
+        REQUIRE(sppf_addPackedNode(&forest, rule, 3, &b, 1));
+        REQUIRE_FALSE(sppf_isAmbiguous(rule));
+        REQUIRE(sppf_addPackedNode(&forest, rule, 1, &a, 1));
+        REQUIRE(sppf_addPackedNode(&forest, rule, 3, &b, 1));
+
+        THEN("Equal packed nodes should be added once") {
+            REQUIRE(2 == forest.packedNodeCount);
+            REQUIRE(1 == forest.ambiguousNodeCount);
+            REQUIRE(sppf_isAmbiguous(rule));
+        }
+
+        AND_THEN("Packed nodes should be sorted by production") {
+            REQUIRE(1 == rule->packedNodes->production);
+            REQUIRE(3 == rule->packedNodes->next->production);
+        }
+    }
+
+    GIVEN("A forest with a cycle and an intermediate node") {
+        sppf_Node *a = sppf_addNode(&forest, 0, 0, 1, nullptr);
+        sppf_Node *b = sppf_addNode(&forest, 1, 1, 2, nullptr);
+        sppf_Node *rule = sppf_addNode(&forest, 10, 0, 1, nullptr);
+        sppf_Node *prefix = sppf_addNode(&forest, SPPF_INTERMEDIATE | 7, 0, 1, nullptr);
+        sppf_Node *entry = sppf_addNode(&forest, 11, 0, 2, nullptr);
+        sppf_Node *children[] = { prefix, b };
+
+        REQUIRE(sppf_addPackedNode(&forest, rule, 0, &rule, 1));
+        REQUIRE(sppf_addPackedNode(&forest, rule, 1, &a, 1));
+        REQUIRE(sppf_addPackedNode(&forest, prefix, 2, &rule, 1));
+        REQUIRE(sppf_addPackedNode(&forest, entry, 2, children, 2));
+
+        THEN("The derivation should skip the cycle and the intermediate node") {
+            vec_Vector derivation;
+            vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+
+            REQUIRE(sppf_isIntermediate(prefix));
+            REQUIRE(SPPF_DERIVED == sppf_addDerivation(&forest, entry, &derivation));
+            REQUIRE(2 == derivation.size);
+            REQUIRE(2 == *((uint32_t*) vec_at(&derivation, 0)));
+            REQUIRE(1 == *((uint32_t*) vec_at(&derivation, 1)));
+
+            vec_freeVector(&derivation, nullptr);
+        }
+    }
+
+    GIVEN("A cycle before the only finite derivation") {
+        sppf_Node *b = sppf_addNode(&forest, 0, 0, 1, nullptr);
+        sppf_Node *p = sppf_addNode(&forest, 10, 0, 1, nullptr);
+        sppf_Node *q = sppf_addNode(&forest, 11, 0, 1, nullptr);
+        sppf_Node *loop = sppf_addNode(&forest, 12, 0, 1, nullptr);
+
+        REQUIRE(sppf_addPackedNode(&forest, p, 0, &q, 1));
+        REQUIRE(sppf_addPackedNode(&forest, p, 1, &b, 1));
+        REQUIRE(sppf_addPackedNode(&forest, q, 2, &p, 1));
+        REQUIRE(sppf_addPackedNode(&forest, loop, 3, &loop, 1));
+
+        vec_Vector derivation;
+        vec_createVector(&derivation, sizeof(uint32_t), 0, nullptr);
+
+        THEN("The derivation should leave the cycle") {
+            REQUIRE(SPPF_DERIVED == sppf_addDerivation(&forest, p, &derivation));
+            REQUIRE(1 == derivation.size);
+            REQUIRE(1 == *((uint32_t*) vec_at(&derivation, 0)));
+
+            REQUIRE(SPPF_DERIVED == sppf_addDerivation(&forest, q, &derivation));
+            REQUIRE(3 == derivation.size);
+            REQUIRE(2 == *((uint32_t*) vec_at(&derivation, 1)));
+            REQUIRE(1 == *((uint32_t*) vec_at(&derivation, 2)));
+        }
+
+        AND_THEN("A node that only derives itself should have no derivation") {
+            REQUIRE(SPPF_NO_DERIVATION == sppf_addDerivation(&forest, loop, &derivation));
+            REQUIRE(0 == derivation.size);
+            REQUIRE(0 == loop->mark);
+            REQUIRE(0 == p->mark);
+        }
+
+        vec_freeVector(&derivation, nullptr);
+    }
+
+    sppf_freeForest(&forest);
+}
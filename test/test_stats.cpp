@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <stats.h>
+}
+
+using Catch::Matchers::Contains;
+
+SCENARIO("Allocations made by the library are counted", "[stats]") {
+    GIVEN("A vector that grows") {
+        st_Counters before = st_getCounters();
+
+        vec_Vector vector;
+        vec_createVector(&vector, sizeof(int), 0, nullptr);
+
+        int value = 1;
+        vec_pushBack(&vector, &value);
+
+        st_Counters after = st_getCounters();
+        vec_freeVector(&vector, nullptr);
+
+        THEN("Its allocation should have been recorded") {
+            REQUIRE(before.allocations + 1 == after.allocations);
+            REQUIRE(before.allocatedBytes + 8 * sizeof(int) == after.allocatedBytes);
+        }
+    }
+}
+
+SCENARIO("A report records each phase", "[stats]") {
+    st_Report report;
+    st_createReport(&report);
+
+    GIVEN("A phase with two allocations") {
+        st_beginPhase(&report, "phase");
+        st_recordAllocation(10);
+        st_recordAllocation(20);
+        st_endPhase(&report);
+
+        THEN("The phase should have its allocations") {
+            REQUIRE(1 == report.phaseCount);
+            REQUIRE(2 == report.phases[0].allocations);
+            REQUIRE(30 == report.phases[0].allocatedBytes);
+            REQUIRE(0 <= report.phases[0].wallMs);
+        }
+
+        AND_THEN("The peak RSS should have been sampled for the phase") {
+            REQUIRE(0 < report.peakRssKb);
+            REQUIRE(report.peakRssKb == report.phases[0].peakRssKb);
+        }
+
+        AND_WHEN("The report is written in JSON") {
+            char buffer[1024] = {};
+            FILE *stream = fmemopen(buffer, sizeof(buffer) - 1, "w");
+            st_printReport(&report, stream, true);
+            fclose(stream);
+
+            THEN("It should contain the phase and the counters") {
+                std::string json(buffer);
+                REQUIRE_THAT(json, Contains("\"name\": \"phase\""));
+                REQUIRE_THAT(json, Contains("\"allocations\": 2"));
+                REQUIRE_THAT(json, Contains("\"peak_rss_kb\": " + std::to_string(report.phases[0].peakRssKb) + "}"));
+                REQUIRE_THAT(json, Contains("\"peak_rss_kb\""));
+            }
+        }
+    }
+}
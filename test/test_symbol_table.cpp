@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+extern "C" {
+#include <collections/arena.h>
+#include <symbol_table.h>
+}
+
+using Catch::Matchers::Equals;
+
+SCENARIO("Names are interned with dense IDs", "[symbol_table]") {
+    ar_Arena arena;
+    ar_createArena(&arena, 256);
+
+    sym_SymbolTable table;
+    REQUIRE(sym_createSymbolTable(&table, &arena));
+
+    GIVEN("Two different names") {
+        sym_Id id1 = sym_intern(&table, "rule", 4);
+        sym_Id id2 = sym_intern(&table, "TOKEN", 5);
+
+        THEN("They should get consecutive IDs") {
+            REQUIRE(0 == id1);
+            REQUIRE(1 == id2);
+            REQUIRE(2 == sym_getCount(&table));
+        }
+
+        AND_THEN("Their names should be null terminated copies") {
+            REQUIRE_THAT(sym_getName(&table, id1), Equals("rule"));
+            REQUIRE_THAT(sym_getName(&table, id2), Equals("TOKEN"));
+        }
+
+        AND_WHEN("A name is interned again") {
+            sym_Id id = sym_intern(&table, "rule1", 4);
+
+            THEN("It should get the same ID") {
+                REQUIRE(id1 == id);
+                REQUIRE(2 == sym_getCount(&table));
+            }
+        }
+    }
+
+    GIVEN("A name that has not been interned") {
+        sym_intern(&table, "rule", 4);
+
+        THEN("It should not be found") {
+            REQUIRE(SYM_NONE == sym_find(&table, "TOKEN", 5));
+            REQUIRE(0 == sym_find(&table, "rule", 4));
+        }
+    }
+
+    GIVEN("More names than the initial capacity") {
+        for (int i = 0;i < 1000;++i) {
+            std::string name = "symbol" + std::to_string(i);
+            REQUIRE((sym_Id) i == sym_intern(&table, name.c_str(), name.size()));
+        }
+
+        THEN("Every name should keep its ID") {
+            for (int i = 0;i < 1000;++i) {
+                std::string name = "symbol" + std::to_string(i);
+                REQUIRE((sym_Id) i == sym_find(&table, name.c_str(), name.size()));
+            }
+        }
+    }
+
+    sym_freeSymbolTable(&table);
+    ar_freeArena(&arena);
+}
@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <collections/vector.h>
+#include <formal_grammar.h>
+#include <lexer.h>
+#include <parser.h>
+#include <token_buffer.h>
+}
+
+SCENARIO("A token buffer stores tokens as parallel arrays", "[token_buffer]") {
+    tb_TokenBuffer buffer;
+    tb_createTokenBuffer(&buffer);
+
+    GIVEN("Tokens pushed by hand") {
+        std::string input = "let x = 42";
+        REQUIRE(tb_reset(&buffer, input.data(), input.size()));
+
+        REQUIRE(tb_pushToken(&buffer, 0, 0, 3));
+        REQUIRE(tb_pushToken(&buffer, 65535, 8, 2));
+
+        THEN("Lexemes should be views into the input") {
+            REQUIRE(2 == buffer.size);
+            REQUIRE(65535 == tb_getTerminal(&buffer, 1));
+            REQUIRE(input.data() + 8 == tb_getLexeme(&buffer, 1));
+            REQUIRE("42" == std::string(tb_getLexeme(&buffer, 1), tb_getLength(&buffer, 1)));
+        }
+
+        AND_WHEN("The buffer is reset") {
+            size_t capacity = buffer.capacity;
+            uint16_t *terminals = buffer.terminals;
+
+            REQUIRE(tb_reset(&buffer, "", 0));
+
+            THEN("Its arrays should be kept") {
+                REQUIRE(0 == buffer.size);
+                REQUIRE(capacity == buffer.capacity);
+                REQUIRE(terminals == buffer.terminals);
+            }
+        }
+    }
+
+    GIVEN("A reserved capacity") {
+        REQUIRE(tb_reserve(&buffer, 1000));
+
+        THEN("Each array should hold this number of tokens") {
+            REQUIRE(1000 == buffer.capacity);
+            REQUIRE(buffer.terminals);
+            REQUIRE(buffer.offsets);
+            REQUIRE(buffer.lengths);
+        }
+    }
+
+    tb_freeTokenBuffer(&buffer);
+
+    THEN("A freed buffer should not have any storage") {
+        REQUIRE(0 == buffer.capacity);
+        REQUIRE_FALSE(buffer.terminals);
+    }
+}
+
+SCENARIO("A token buffer is filled by a lexer", "[token_buffer]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+
+    std::string grammar = "%LET=`let`;\n"
+                          "%NAME=[a-z]+;\n"
+                          "%NUMBER=[0-9]+;\n"
+                          "%r = LET NAME `=` NUMBER;\n";
+
+    REQUIRE(PRS_OK == loadGrammar(&g, grammar));
+
+    lex_Lexer lexer;
+    REQUIRE(PRS_OK == lex_createLexer(&lexer, &g));
+
+    tb_TokenBuffer buffer;
+    tb_createTokenBuffer(&buffer);
+
+    GIVEN("A valid input") {
+        std::string input;
+
+        for (int i = 0;i < 100;++i) {
+            input += "let abc = 123\n";
+        }
+
+        THEN("Tokens should be the ones of lex_tokenize") {
+            vec_Vector tokens;
+            vec_createVector(&tokens, sizeof(lex_Token), 0, nullptr);
+
+            REQUIRE(400 == lex_tokenize(&lexer, input.data(), input.size(), &tokens, nullptr));
+            REQUIRE(400 == tb_tokenize(&buffer, &lexer, input.data(), input.size(), nullptr));
+
+            for (size_t i = 0;i < tokens.size;++i) {
+                auto token = (lex_Token*) vec_at(&tokens, i);
+
+                REQUIRE(token->terminal == tb_getTerminal(&buffer, i));
+                REQUIRE(input.data() + token->offset == tb_getLexeme(&buffer, i));
+                REQUIRE(token->length == tb_getLength(&buffer, i));
+            }
+
+            vec_freeVector(&tokens, nullptr);
+        }
+
+        AND_WHEN("Another document of the same size is read") {
+            REQUIRE(400 == tb_tokenize(&buffer, &lexer, input.data(), input.size(), nullptr));
+
+            size_t capacity = buffer.capacity;
+            std::string other = input;
+            other[4] = 'x';
+
+            THEN("The buffer should not grow again") {
+                REQUIRE(400 == tb_tokenize(&buffer, &lexer, other.data(), other.size(), nullptr));
+                REQUIRE(capacity == buffer.capacity);
+                REQUIRE('x' == *tb_getLexeme(&buffer, 1));
+            }
+        }
+    }
+
+    GIVEN("An input with an unexpected byte") {
+        std::string input = "let a = 1 ; let";
+        size_t errorOffset = 0;
+
+        THEN("The tokens before the error should be kept") {
+            REQUIRE(LEX_TOKENIZE_ERROR == tb_tokenize(&buffer, &lexer, input.data(), input.size(), &errorOffset));
+            REQUIRE(10 == errorOffset);
+            REQUIRE(4 == buffer.size);
+        }
+    }
+
+    tb_freeTokenBuffer(&buffer);
+    lex_freeLexer(&lexer);
+    fg_freeGrammar(&g);
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+
+#include "helpers.hpp"
+
+#include <string>
+
+extern "C" {
+#include <formal_grammar.h>
+#include <parser.h>
+#include <token_ir.h>
+}
+
+SCENARIO("Quantifiers of a reference chain are merged", "[token_ir]") {
+    GIVEN("A token without quantifier") {
+        THEN("The quantifier of the reference should be kept") {
+            REQUIRE(PRS_PLUS_QUANTIFIER == tir_mergeQuantifiers(PRS_NO_QUANTIFIER, PRS_PLUS_QUANTIFIER));
+            REQUIRE(PRS_QMARK_QUANTIFIER == tir_mergeQuantifiers(PRS_QMARK_QUANTIFIER, PRS_NO_QUANTIFIER));
+        }
+    }
+
+    GIVEN("Two identical quantifiers") {
+        THEN("They should collapse into one") {
+            REQUIRE(PRS_PLUS_QUANTIFIER == tir_mergeQuantifiers(PRS_PLUS_QUANTIFIER, PRS_PLUS_QUANTIFIER));
+            REQUIRE(PRS_QMARK_QUANTIFIER == tir_mergeQuantifiers(PRS_QMARK_QUANTIFIER, PRS_QMARK_QUANTIFIER));
+        }
+    }
+
+    GIVEN("Two different quantifiers") {
+        THEN("They should give a star") {
+            REQUIRE(PRS_STAR_QUANTIFIER == tir_mergeQuantifiers(PRS_PLUS_QUANTIFIER, PRS_QMARK_QUANTIFIER));
+            REQUIRE(PRS_STAR_QUANTIFIER == tir_mergeQuantifiers(PRS_QMARK_QUANTIFIER, PRS_PLUS_QUANTIFIER));
+            REQUIRE(PRS_STAR_QUANTIFIER == tir_mergeQuantifiers(PRS_STAR_QUANTIFIER, PRS_PLUS_QUANTIFIER));
+        }
+    }
+}
+
+SCENARIO("Tokens of a grammar are normalized", "[token_ir]") {
+    fg_Grammar g;
+    fg_createGrammar(&g);
+    tir_TokenSet set;
+
+    GIVEN("Reference chains and equivalent definitions") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%DIGIT=[0-9];\n"
+                                          "%DIGITS=DIGIT+;\n"
+                                          "%MAYBE=DIGITS?;\n"
+                                          "%MANY=MAYBE+;\n"
+                                          "%NUMBER=[0-9]+;\n"
+                                          "%A=`a`;\n"
+                                          "%RA=[a-a];\n"
+                                          "%LONG=`abc`;\n"
+                                          "%ALIAS=LONG;\n"
+                                          "%r = DIGIT;\n"));
+        REQUIRE(PRS_OK == tir_createTokenSet(&set, &g));
+        REQUIRE(9 == set.tokenCount);
+
+        THEN("References should hold the class at the end of their chain") {
+            for (size_t i = 0;i < 5;++i) {
+                REQUIRE(TIR_CLASS_TOKEN == set.tokens[i].type);
+                REQUIRE(10 == prs_charClassCount(&set.tokens[i].charClass));
+            }
+
+            REQUIRE(PRS_NO_QUANTIFIER == set.tokens[0].quantifier);
+            REQUIRE(PRS_PLUS_QUANTIFIER == set.tokens[1].quantifier);
+            REQUIRE(PRS_STAR_QUANTIFIER == set.tokens[2].quantifier);
+            REQUIRE(PRS_STAR_QUANTIFIER == set.tokens[3].quantifier);
+        }
+
+        AND_THEN("A string of one byte should be a class") {
+            REQUIRE(TIR_CLASS_TOKEN == set.tokens[5].type);
+            REQUIRE(1 == prs_charClassCount(&set.tokens[5].charClass));
+            REQUIRE(TIR_STRING_TOKEN == set.tokens[7].type);
+            REQUIRE(3 == set.tokens[8].length);
+        }
+
+        AND_THEN("Equivalent tokens should share the first one") {
+            REQUIRE(4 == set.duplicateCount);
+            REQUIRE(2 == set.tokens[3].canonical);
+            REQUIRE(1 == set.tokens[4].canonical);
+            REQUIRE(5 == set.tokens[6].canonical);
+            REQUIRE(7 == set.tokens[8].canonical);
+            REQUIRE_FALSE(tir_isDuplicate(&set, 0));
+            REQUIRE(tir_isDuplicate(&set, 4));
+        }
+
+        tir_freeTokenSet(&set);
+    }
+
+    GIVEN("Tokens that reference each other") {
+        REQUIRE(PRS_OK == loadGrammar(&g, "%A=B;\n"
+                                          "%B=C+;\n"
+                                          "%C=A;\n"
+                                          "%r = A;\n"));
+
+        THEN("The cycle should be found") {
+            REQUIRE(FG_TOKEN_REF_CYCLE == tir_createTokenSet(&set, &g));
+            REQUIRE_FALSE(set.tokens);
+        }
+    }
+
+    fg_freeGrammar(&g);
+}